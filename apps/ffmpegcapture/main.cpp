@@ -408,7 +408,7 @@ void keyCallback(Key key, Modifier, Action action, int) {
 int main(int argc, char** argv) {
     std::vector<std::string> arg(argv + 1, argv + argc);
     Configuration config = parseArguments(arg);
-    config::Cluster cluster = loadCluster(config.configFilename);
+    config::Cluster cluster = loadCluster(config);
 
     Engine::Callbacks callbacks;
     callbacks.initOpenGL = myInitOGLFun;
@@ -14,6 +14,7 @@
 #include <sgct/math.h>
 #include <sgct/projection.h>
 #include <sgct/projection/projectionplane.h>
+#include <span>
 #include <string>
 
 namespace sgct {
@@ -56,6 +57,15 @@ public:
      * Make projection symmetric relative to user.
      */
     void calculateNonLinearFrustum(Frustum::Mode mode, float nearClip, float farClip);
+
+    /**
+     * Same as calling #calculateNonLinearFrustum for each of the \p viewports, but the
+     * projections of all viewports are calculated together.
+     *
+     * \pre All \p viewports must belong to the same user
+     */
+    static void calculateNonLinearFrustums(std::span<BaseViewport* const> viewports,
+        Frustum::Mode mode, float nearClip, float farClip);
     void setViewPlaneCoordsUsingFOVs(float up, float down, float left, float right,
         quat rot, float dist = 10.f);
     void updateFovToMatchAspectRatio(float oldRatio, float newRatio);
@@ -0,0 +1,119 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__BUNDLE__H__
+#define __SGCT__BUNDLE__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/config.h>
+#include <sgct/network.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+struct SocketLibrary;
+
+/// The default largest size in bytes that a compressed or extracted bundle may have, which
+/// protects the clients from allocating memory for a damaged or hostile header
+constexpr uint64_t DefaultMaxBundleSize = uint64_t(1) << 30;
+
+/**
+ * \return The absolute paths of all files that are referenced by the \p cluster, without
+ *         duplicates and in the order in which they first appear in the cluster
+ */
+SGCT_EXPORT std::vector<std::filesystem::path> bundleFiles(
+    const config::Cluster& cluster);
+
+/**
+ * Creates the bundle for the \p cluster, which contains the serialized cluster and the
+ * contents of all files returned by #bundleFiles. The master serves the bundle to the
+ * clients at startup, so that only the master needs the configuration and the warping
+ * assets on its local disk. The bundle is compressed and identified by the hash of its
+ * contents, which the clients use to cache it and to skip the transfer if the
+ * configuration has not changed.
+ *
+ * \throw sgct::Error If one of the referenced files could not be read
+ */
+SGCT_EXPORT std::vector<char> createBundle(const config::Cluster& cluster);
+
+/**
+ * \return The hash of the contents of the \p bundle or `std::nullopt` if the \p bundle
+ *         does not start with a valid header
+ */
+SGCT_EXPORT std::optional<uint64_t> bundleHash(std::span<const char> bundle);
+
+/**
+ * Extracts the files of the \p bundle into the \p folder and returns the cluster of the
+ * bundle in which all file references point to the extracted files. Files that already
+ * exist in the \p folder are not written again, so the \p folder should be unique for
+ * the hash of the bundle. The bundle is rejected before its contents are decompressed if
+ * it would be larger than \p maxSize bytes.
+ *
+ * \throw sgct::Error If the \p bundle is damaged or too large, or a file could not be
+ *        written
+ */
+SGCT_EXPORT config::Cluster extractBundle(std::span<const char> bundle,
+    const std::filesystem::path& folder, uint64_t maxSize = DefaultMaxBundleSize);
+
+/**
+ * Serves a bundle on a TCP port to all clients that call #fetchBundle until the object
+ * is destroyed. Each client is handled on its own thread.
+ */
+class SGCT_EXPORT BundleServer {
+public:
+    /**
+     * Starts listening for clients on the \p port.
+     *
+     * \throw sgct::Error If the \p port could not be opened
+     */
+    BundleServer(std::vector<char> bundle, int port);
+    ~BundleServer();
+
+    BundleServer(const BundleServer&) = delete;
+    BundleServer& operator=(const BundleServer&) = delete;
+
+private:
+    void listen();
+    void serve(SGCT_SOCKET client) const;
+
+    /// Released after the sockets, also if the constructor throws
+    std::unique_ptr<SocketLibrary> _socketLibrary;
+    const std::vector<char> _bundle;
+    SGCT_SOCKET _listenSocket;
+    std::atomic_bool _shouldTerminate = false;
+    std::thread _listenThread;
+    std::vector<std::thread> _clients;
+};
+
+/**
+ * Loads the cluster from the bundle that the master at \p address serves on the \p port.
+ * The bundle is stored in a subfolder of the \p cacheFolder that is named after its hash.
+ * If that folder already contains the bundle that the master currently serves, the bundle
+ * is not transferred again. Clients might be started before the master, so connecting is
+ * retried until the \p timeout has passed. Bundles whose header announces more than
+ * \p maxSize bytes, compressed or extracted, are rejected before they are received.
+ *
+ * \throw sgct::Error If the bundle could not be received or is damaged or too large
+ */
+SGCT_EXPORT config::Cluster fetchBundle(const std::string& address, int port,
+    const std::filesystem::path& cacheFolder,
+    std::chrono::seconds timeout = std::chrono::seconds(60),
+    uint64_t maxSize = DefaultMaxBundleSize);
+
+} // namespace sgct
+
+#endif // __SGCT__BUNDLE__H__
@@ -12,6 +12,8 @@
 #include <sgct/sgctexports.h>
 #include <sgct/frustum.h>
 #include <sgct/math.h>
+#include <array>
+#include <optional>
 #include <utility>
 
 namespace sgct {
@@ -44,6 +46,24 @@ struct SGCT_EXPORT RenderData {
     mat4 modelViewProjectionMatrix;
 
     ivec2 bufferSize;
+
+    /**
+     * The matrices of all faces when the faces of a cube map are rendered in a single
+     * pass (see Settings::setUseLayeredCubemapRendering). The faces are ordered right,
+     * left, bottom, top, front, back, which is the order of the layers of the cube map,
+     * so a geometry shader emits each primitive once for every enabled face `i` with
+     * `gl_Layer = i` and the position transformed by `modelViewProjectionMatrix[i]`. The
+     * matrices outside of this struct then belong to the first enabled face. This value
+     * is empty if the draw function is called once per face.
+     */
+    struct CubemapLayers {
+        std::array<mat4, 6> viewMatrix;
+        std::array<mat4, 6> projectionMatrix;
+        std::array<mat4, 6> modelViewProjectionMatrix;
+        /// The faces that are not enabled are not shown and can be skipped
+        std::array<bool, 6> isEnabled = { false, false, false, false, false, false };
+    };
+    std::optional<CubemapLayers> cubemapLayers;
 };
 
 } // namespace sgct
@@ -20,6 +20,7 @@ namespace sgct {
 
 struct SGCT_EXPORT Configuration {
     std::optional<std::string> configFilename;
+    std::optional<bool> useConfigSnapshot;
     std::optional<bool> isServer;
     std::optional<Log::Level> logLevel;
     std::optional<bool> showHelpText;
@@ -29,6 +30,21 @@ struct SGCT_EXPORT Configuration {
     std::optional<Settings::CaptureFormat> captureFormat;
     std::optional<int> nCaptureThreads;
     std::optional<bool> exportCorrectionMeshes;
+    std::optional<bool> useCorrectionMeshCache;
+    std::optional<float> correctionMeshSimplificationError;
+    std::optional<bool> bakeCorrectionMeshes;
+    std::optional<bool> optimizeCorrectionMeshes;
+    std::optional<bool> compactCorrectionMeshes;
+    std::optional<Settings::HotReload> hotReload;
+    std::optional<bool> eventDrivenTracking;
+    std::optional<std::string> trackingRecordPath;
+    std::optional<std::string> trackingReplayPath;
+    std::optional<Settings::TrackingReplaySpeed> trackingReplaySpeed;
+    std::optional<bool> headless;
+    std::optional<int> bundleServerPort;
+    std::optional<std::string> bundleMasterAddress;
+    std::optional<int> bundleMasterPort;
+    std::optional<std::string> bundleCacheFolder;
     std::optional<std::string> screenshotPath;
     std::optional<std::string> screenshotPrefix;
     std::optional<bool> addNodeNameInScreenshot;
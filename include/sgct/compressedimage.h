@@ -0,0 +1,115 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__COMPRESSEDIMAGE__H__
+#define __SGCT__COMPRESSEDIMAGE__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/math.h>
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+namespace sgct {
+
+class Image;
+
+/**
+ * An image that is stored in one of the block-compressed formats that can be uploaded
+ * to the GPU without decompression. Images can be loaded from DDS and KTX2 containers,
+ * or they can be created from an uncompressed Image with the CPU encoder.
+ *
+ * Like Image, the rows of each mipmap level are stored bottom to top as expected by
+ * OpenGL. BC1 and BC3 data is reordered when loading from or saving to a file, which
+ * stores the rows top to bottom. The rows can only be reordered within a block, so BC7
+ * data and images with a mipmap level whose height is larger than 4 and not a multiple
+ * of 4 are kept top to bottom as they are stored in the file, see #isTopDown.
+ */
+class SGCT_EXPORT CompressedImage {
+public:
+    enum class Format {
+        /// 4 bits per pixel, RGB with optional 1 bit alpha (DXT1)
+        BC1,
+        /// 8 bits per pixel, RGB with interpolated alpha (DXT5)
+        BC3,
+        /// 8 bits per pixel, high quality RGBA
+        BC7
+    };
+
+    struct Level {
+        ivec2 size;
+        std::vector<std::byte> data;
+    };
+
+    /**
+     * Encodes the provided \p image on the CPU. The image must have 3 or 4 channels with
+     * 8 bits per channel. The encoder uses a fast bounding box fit and is intended for
+     * offline conversion or for tools, not for the highest possible quality.
+     *
+     * \param image The image that should be encoded
+     * \param format The target format, which must be either BC1 or BC3
+     * \param generateMipmaps If `true`, a full mipmap chain is generated by box filtering
+     * \return The compressed image
+     */
+    static CompressedImage encode(const Image& image, Format format,
+        bool generateMipmaps = true);
+
+    /**
+     * \return The number of bytes that one 4x4 block occupies in the \p format
+     */
+    static int blockSize(Format format);
+
+    /**
+     * \return The number of bytes that a mipmap level of the provided \p size occupies
+     */
+    static size_t levelSize(Format format, ivec2 size);
+
+    /**
+     * Loads a DDS (`.dds`) or KTX2 (`.ktx2`) file containing BC1, BC3, or BC7 data with
+     * all of the mipmap levels stored in the file.
+     */
+    void load(const std::filesystem::path& filename);
+
+    /**
+     * Saves the image as a DDS file. An image that was encoded with a mipmap level whose
+     * rows cannot be reordered cannot be saved.
+     */
+    void save(const std::filesystem::path& filename) const;
+
+    /**
+     * Decodes the mipmap \p level into an uncompressed 4 channel Image, which stores the
+     * rows bottom to top even if this image does not. Only BC1 and BC3 images can be
+     * decoded.
+     */
+    void decode(Image& image, int level = 0) const;
+
+    Format format() const;
+    ivec2 size() const;
+    const std::vector<Level>& levels() const;
+
+    /**
+     * \return `true` if the rows of all mipmap levels are stored top to bottom as they
+     *         were in the loaded file, in which case the vertical texture coordinate has
+     *         to be flipped when sampling the texture
+     */
+    bool isTopDown() const;
+
+    /**
+     * \return The total number of bytes of all mipmap levels
+     */
+    size_t dataSize() const;
+
+private:
+    Format _format = Format::BC1;
+    std::vector<Level> _levels;
+    bool _isTopDown = false;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__COMPRESSEDIMAGE__H__
@@ -103,11 +103,26 @@ SGCT_EXPORT void validateDevice(const Device& device);
 
 
 struct SGCT_EXPORT Tracker {
+    /// Predicts the pose of the head-tracked user at the time at which the next frame is
+    /// shown to compensate for the latency of the tracking system and the rendering
+    struct Prediction {
+        enum class Method { ConstantVelocity, DoubleExponential };
+
+        Method method = Method::DoubleExponential;
+        /// The time in seconds that is predicted in addition to the time until the next
+        /// frame is shown, which covers the latency of the tracker and the display
+        std::optional<float> latency;
+        /// The weight of the newest sample when smoothing the samples, which has to be in
+        /// the range (0, 1]. Smaller values smooth more, but react slower to changes
+        std::optional<float> smoothing;
+    };
+
     std::string name;
     std::vector<Device> devices;
     std::optional<vec3> offset;
     std::optional<double> scale;
     std::optional<mat4> transformation;
+    std::optional<Prediction> prediction;
 };
 SGCT_EXPORT void validateTracker(const Tracker& tracker);
 
@@ -0,0 +1,91 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CONFIGSNAPSHOT__H__
+#define __SGCT__CONFIGSNAPSHOT__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/config.h>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace sgct {
+
+/**
+ * Calculates the hash that identifies the source of a snapshot. The hash is computed
+ * from the absolute \p path of the configuration file, as relative paths in the
+ * configuration are resolved against its folder, and the contents of the
+ * \p configuration and the \p schema.
+ */
+SGCT_EXPORT uint64_t configSnapshotHash(const std::filesystem::path& path,
+    std::string_view configuration, std::string_view schema = "");
+
+/**
+ * \return The path of the snapshot for the configuration file at \p path, which is
+ *         located next to the configuration file
+ */
+SGCT_EXPORT std::filesystem::path configSnapshotPath(const std::filesystem::path& path);
+
+/**
+ * Serializes the \p cluster into the binary representation that is used by the snapshots.
+ * The representation is only valid for the same version of SGCT.
+ */
+SGCT_EXPORT std::string serializeCluster(const config::Cluster& cluster);
+
+/**
+ * Deserializes a cluster that was serialized with #serializeCluster.
+ *
+ * \return The cluster or `std::nullopt` if the \p data is damaged
+ */
+SGCT_EXPORT std::optional<config::Cluster> deserializeCluster(std::string_view data);
+
+/**
+ * Writes the \p cluster into the snapshot at \p snapshotPath together with the \p hash of
+ * its source. The file is written under a temporary name first and then renamed, so that
+ * other nodes that read the snapshot at the same time never see a partial file.
+ *
+ * \throw sgct::Error If the file could not be written
+ */
+SGCT_EXPORT void writeConfigSnapshot(const std::filesystem::path& snapshotPath,
+    const config::Cluster& cluster, uint64_t hash);
+
+/**
+ * Reads the cluster from the snapshot at \p snapshotPath.
+ *
+ * \return The cluster or `std::nullopt` if the snapshot does not exist, was written by a
+ *         different version of SGCT, is damaged, or was created from a source with a hash
+ *         different from \p hash
+ */
+SGCT_EXPORT std::optional<config::Cluster> readConfigSnapshot(
+    const std::filesystem::path& snapshotPath, uint64_t hash);
+
+/**
+ * Reads the configuration file at \p filename using its snapshot, which is a binary
+ * serialization of the parsed and validated config::Cluster. Loading the snapshot avoids
+ * parsing the JSON file and validating it against the schema, which dominates the startup
+ * time on large clusters where every node reads the same configuration. The snapshot is
+ * only used if it was created from the same configuration and \p schema. Otherwise the
+ * configuration is validated against the \p schema, if one is provided, and parsed with
+ * #readConfig, after which the snapshot is updated. Only the top-level \p schema is part
+ * of the hash, so the snapshot has to be deleted manually if only a schema that it
+ * references changes.
+ *
+ * \param filename The path to the JSON configuration file
+ * \param schema The path to the schema that the configuration is validated against or an
+ *        empty path if the configuration should not be validated
+ * \return The loaded cluster
+ */
+SGCT_EXPORT [[nodiscard]] config::Cluster readConfigWithSnapshot(
+    const std::filesystem::path& filename, const std::filesystem::path& schema = "");
+
+} // namespace sgct
+
+#endif // __SGCT__CONFIGSNAPSHOT__H__
@@ -0,0 +1,60 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_BAKE__H__
+#define __SGCT__CORRECTION_BAKE__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <vector>
+
+namespace sgct::correction {
+
+/**
+ * A correction mesh that has been rasterized into a lookup texture that contains the
+ * texture coordinates and a blend texture that contains the color of the mesh for each
+ * pixel. Rendering a screen-aligned quad with these textures produces the same warp as
+ * rendering the mesh, but at a constant cost per pixel regardless of the mesh density.
+ */
+struct SGCT_EXPORT BakedWarp {
+    /// The number of texels in the lookup and blend textures
+    ivec2 size = ivec2{ 0, 0 };
+
+    /// The area in normalized device coordinates that is covered by the textures
+    vec2 lowerLeft = vec2{ 0.f, 0.f };
+    vec2 upperRight = vec2{ 0.f, 0.f };
+
+    /// The texture coordinates for each texel in x and y, row by row starting at the
+    /// bottom. z is 1 if the texel is covered by the mesh and 0 otherwise, as a covered
+    /// texel can also be blended to black
+    std::vector<vec3> lookup;
+
+    /// The color for each texel, which is 0 in all channels if the texel is not covered
+    std::vector<vec4> blend;
+};
+
+/**
+ * Rasterizes the \p buffer into a BakedWarp. The textures cover the bounding box of the
+ * mesh, which is extended to the pixel grid of a framebuffer with the \p resolution, so
+ * that there is exactly one texel for each pixel of the framebuffer. Each texel contains
+ * the values that are interpolated at its center. The rows of the textures are
+ * distributed over \p nThreads threads.
+ *
+ * \param buffer The mesh that is baked, which has to use `GL_TRIANGLES` or
+ *        `GL_TRIANGLE_STRIP`
+ * \param resolution The resolution of the framebuffer into which the mesh is rendered
+ * \param nThreads The number of threads or 0 to use one thread per hardware thread
+ * \return The baked mesh, which is empty if the mesh does not cover any pixel
+ */
+SGCT_EXPORT BakedWarp bakeWarp(const Buffer& buffer, ivec2 resolution,
+    unsigned int nThreads = 0);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_BAKE__H__
@@ -10,6 +10,8 @@
 #define __SGCT__BUFFER__H__
 
 #include <sgct/sgctexports.h>
+#include <sgct/math.h>
+#include <optional>
 #include <vector>
 
 namespace sgct::correction {
@@ -29,9 +31,29 @@ struct SGCT_EXPORT Buffer {
         float a = 0.f;
     };
 
+    /**
+     * The field of view and orientation of the view plane for mesh formats that define
+     * the projection of their viewport in addition to the warping. The angles are in
+     * degrees and are applied with BaseViewport::setViewPlaneCoordsUsingFOVs.
+     */
+    struct ViewPlane {
+        float up = 0.f;
+        float down = 0.f;
+        float left = 0.f;
+        float right = 0.f;
+        quat orientation;
+    };
+
     std::vector<Vertex> vertices;
     std::vector<unsigned int> indices;
     unsigned int geometryType = 0x0004; // = GL_TRIANGLES
+
+    /// The view plane that the viewport of this mesh has to use, if the format defines it
+    std::optional<ViewPlane> viewPlane;
+    /// The offset of the projection plane of the viewport, if the format defines it
+    std::optional<vec3> projectionOffset;
+    /// The position of the user of the viewport, if the format defines it
+    std::optional<vec3> userPosition;
 };
 
 } // namespace sgct::correction
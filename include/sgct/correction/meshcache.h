@@ -0,0 +1,102 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_MESHCACHE__H__
+#define __SGCT__CORRECTION_MESHCACHE__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/mappedfile.h>
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace sgct::correction {
+
+/**
+ * Creates the key that identifies a parsed correction mesh in the cache. The key contains
+ * everything that the contents of the parsed Buffer depend on, which are the canonical
+ * \p path of the source mesh, its size and modification time, the parameters of the
+ * viewport that the mesh is loaded for, the error bound of the mesh simplification, and
+ * whether the mesh was optimized for the vertex cache.
+ *
+ * \throw std::filesystem::filesystem_error If the source mesh does not exist
+ */
+SGCT_EXPORT std::string meshCacheKey(const std::filesystem::path& path, vec2 pos,
+    vec2 size, float aspectRatio, bool textureRenderMode,
+    float simplificationError = 0.f, bool isOptimized = false);
+
+/**
+ * \return The path of the cache file for the mesh at \p path with the \p key, which is
+ *         located in the same folder as the source mesh. The path does not depend on
+ *         the size and modification time of the source mesh, so the cache file of a
+ *         modified mesh is overwritten rather than left behind. CachedMesh::open
+ *         compares the whole key and rejects the outdated file
+ */
+SGCT_EXPORT std::filesystem::path meshCachePath(const std::filesystem::path& path,
+    std::string_view key);
+
+/**
+ * Writes the \p buffer into the cache file at \p cachePath. The vertices and indices are
+ * stored in the same memory layout as in the Buffer so that they can be uploaded directly
+ * from the memory-mapped file. The file is written to a temporary file first and then
+ * renamed, so that other processes never see a partially written file.
+ *
+ * \throw Error If the file could not be written
+ */
+SGCT_EXPORT void writeCachedMesh(const std::filesystem::path& cachePath,
+    std::string_view key, const Buffer& buffer);
+
+/**
+ * A correction mesh that was loaded from a cache file created by #writeCachedMesh. The
+ * vertices and indices point directly into the memory-mapped file and stay valid for
+ * the lifetime of this object.
+ */
+class SGCT_EXPORT CachedMesh {
+public:
+    /**
+     * Maps the cache file at \p cachePath into memory.
+     *
+     * \return The cached mesh, or `std::nullopt` if the file does not exist, belongs to a
+     *         different \p key, or was written by an incompatible version
+     */
+    static std::optional<CachedMesh> open(const std::filesystem::path& cachePath,
+        std::string_view key);
+
+    std::span<const Buffer::Vertex> vertices() const;
+    std::span<const unsigned int> indices() const;
+    unsigned int geometryType() const;
+
+    /// The viewport setup that was stored alongside the mesh, see Buffer
+    const std::optional<Buffer::ViewPlane>& viewPlane() const;
+    const std::optional<vec3>& projectionOffset() const;
+    const std::optional<vec3>& userPosition() const;
+
+    /**
+     * \return A Buffer with a copy of the vertices, indices, and viewport setup
+     */
+    Buffer toBuffer() const;
+
+private:
+    explicit CachedMesh(MappedFile file);
+
+    MappedFile _file;
+    unsigned int _geometryType = 0;
+    std::optional<Buffer::ViewPlane> _viewPlane;
+    std::optional<vec3> _projectionOffset;
+    std::optional<vec3> _userPosition;
+    std::span<const Buffer::Vertex> _vertices;
+    std::span<const unsigned int> _indices;
+};
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_MESHCACHE__H__
@@ -0,0 +1,75 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_OPTIMIZE__H__
+#define __SGCT__CORRECTION_OPTIMIZE__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/correction/buffer.h>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sgct::correction {
+
+/**
+ * A vertex of a correction mesh in a compact format of 16 bytes instead of the 32 bytes
+ * of Buffer::Vertex. The position is unchanged, the texture coordinates are stored as
+ * normalized 16-bit integers and the color as normalized 8-bit integers.
+ */
+struct CompactVertex {
+    float x = 0.f;
+    float y = 0.f;
+    uint16_t s = 0;
+    uint16_t t = 0;
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+    uint8_t a = 0;
+};
+static_assert(sizeof(CompactVertex) == 16);
+
+/**
+ * Calculates the average cache miss ratio (ACMR) of the \p buffer, which is the number of
+ * vertices that have to be transformed per triangle when using a FIFO post-transform
+ * vertex cache with \p cacheSize entries. The value is between 0.5 for an ideal order of
+ * a large regular grid and 3 if no vertex is reused.
+ *
+ * \param buffer The mesh, which has to use `GL_TRIANGLES` or `GL_TRIANGLE_STRIP`
+ * \param cacheSize The number of vertices in the simulated cache
+ * \return The average cache miss ratio or 0 if the mesh does not contain any triangles
+ */
+SGCT_EXPORT float averageCacheMissRatio(const Buffer& buffer,
+    unsigned int cacheSize = 16);
+
+/**
+ * Reorders the triangles of the \p buffer to improve the reuse of the post-transform
+ * vertex cache, using the Tipsify algorithm by Sander, Nehab, and Barczak ("Fast
+ * Triangle Reordering for Vertex Locality and Reduced Overdraw", 2007). Triangle strips
+ * are converted into triangle lists while keeping the winding of each triangle and
+ * degenerate triangles are removed. Afterwards, the vertices are sorted in the order in
+ * which they are first used and vertices that are not used by any triangle are removed.
+ *
+ * \param buffer The mesh, which has to use `GL_TRIANGLES` or `GL_TRIANGLE_STRIP`
+ * \param cacheSize The size of the vertex cache that the order is optimized for
+ */
+SGCT_EXPORT void optimizeVertexCache(Buffer& buffer, unsigned int cacheSize = 16);
+
+/**
+ * Converts the \p vertices into the CompactVertex format. The conversion is only possible
+ * if all texture coordinates and colors are in the range [0, 1].
+ *
+ * \return The converted vertices or `std::nullopt` if any vertex is outside the range
+ */
+SGCT_EXPORT std::optional<std::vector<CompactVertex>> compactVertices(
+    std::span<const Buffer::Vertex> vertices);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_OPTIMIZE__H__
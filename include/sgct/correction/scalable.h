@@ -14,12 +14,10 @@
 #include <sgct/correction/buffer.h>
 #include <filesystem>
 
-namespace sgct { class BaseViewport; }
-
 namespace sgct::correction {
 
 SGCT_EXPORT Buffer generateScalableMesh(const std::filesystem::path& path,
-    BaseViewport& parent);
+    const vec2& pos, const vec2& size);
 
 } // namespace sgct::correction
 
@@ -10,15 +10,14 @@
 #define __SGCT__CORRECTION_SCISS__H__
 
 #include <sgct/sgctexports.h>
+#include <sgct/math.h>
 #include <sgct/correction/buffer.h>
 #include <filesystem>
 
-namespace sgct { class BaseViewport; }
-
 namespace sgct::correction {
 
 SGCT_EXPORT Buffer generateScissMesh(const std::filesystem::path& path,
-    BaseViewport& parent);
+    const vec2& pos, const vec2& size);
 
 } // namespace sgct::correction
 
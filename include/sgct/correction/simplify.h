@@ -0,0 +1,40 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_SIMPLIFY__H__
+#define __SGCT__CORRECTION_SIMPLIFY__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/correction/buffer.h>
+#include <optional>
+
+namespace sgct::correction {
+
+/**
+ * Simplifies a dense correction mesh whose vertices form a regular grid, which is the
+ * case for most of the vendor formats. The grid is re-tessellated with an adaptive
+ * quadtree in which every cell only keeps its corners and the vertices that neighboring
+ * cells add on its edges. A cell is split as long as interpolating the simplified mesh at
+ * the position of any of the original vertices inside the cell differs from the original
+ * texture coordinates by more than \p maxTexCoordError (Euclidean distance) or from the
+ * original color by more than \p maxColorError in any channel. Cells that are only
+ * partially covered by the original mesh keep their original triangles.
+ *
+ * \param buffer The mesh that should be simplified, which has to use `GL_TRIANGLES` or
+ *        `GL_TRIANGLE_STRIP`
+ * \param maxTexCoordError The maximum error in texture coordinates
+ * \param maxColorError The maximum error in each of the color channels
+ * \return The simplified mesh using `GL_TRIANGLES`, or `std::nullopt` if the vertices of
+ *         \p buffer do not form a regular grid
+ */
+SGCT_EXPORT std::optional<Buffer> simplifyMesh(const Buffer& buffer,
+    float maxTexCoordError, float maxColorError = 1.f / 255.f);
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_SIMPLIFY__H__
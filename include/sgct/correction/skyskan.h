@@ -10,15 +10,14 @@
 #define __SGCT__CORRECTION_SKYSKAN__H__
 
 #include <sgct/sgctexports.h>
+#include <sgct/math.h>
 #include <sgct/correction/buffer.h>
 #include <filesystem>
 
-namespace sgct { class BaseViewport; }
-
 namespace sgct::correction {
 
-SGCT_EXPORT Buffer generateSkySkanMesh(const std::filesystem::path& meshPath,
-    BaseViewport& parent);
+SGCT_EXPORT Buffer generateSkySkanMesh(const std::filesystem::path& path,
+    const vec2& pos, const vec2& size);
 
 } // namespace sgct::correction
 
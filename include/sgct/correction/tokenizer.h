@@ -0,0 +1,111 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CORRECTION_TOKENIZER__H__
+#define __SGCT__CORRECTION_TOKENIZER__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/mappedfile.h>
+#include <filesystem>
+#include <optional>
+#include <string_view>
+
+namespace sgct::correction {
+
+/**
+ * Converts the number at the beginning of \p str using `std::from_chars`. Leading
+ * whitespace and a leading `+` are skipped, and trailing characters after the number
+ * are ignored, which matches the behavior of `std::stof` and `std::stoi`. Unlike
+ * `std::stof`, subnormal numbers are accepted.
+ *
+ * \return The converted number or `std::nullopt` if \p str does not start with a number
+ *         or the number is out of range
+ */
+SGCT_EXPORT std::optional<float> toFloat(std::string_view str);
+SGCT_EXPORT std::optional<int> toInt(std::string_view str);
+SGCT_EXPORT std::optional<unsigned int> toUnsignedInt(std::string_view str);
+
+/**
+ * Splits a text into lines and the lines into tokens without allocating any memory. All
+ * returned views point into the text that was passed to the constructor. Lines can be
+ * terminated by `\n` or `\r\n` and empty lines are skipped. Tokens are separated by any
+ * of the separator characters and are trimmed of surrounding whitespace.
+ */
+class SGCT_EXPORT Tokenizer {
+public:
+    /**
+     * \param text The text that is tokenized and that has to outlive this object
+     * \param separators The characters that separate the tokens in each line
+     */
+    explicit Tokenizer(std::string_view text, std::string_view separators = " \t");
+
+    /**
+     * Advances to the next line that is not empty.
+     *
+     * \return `false` if the end of the text has been reached
+     */
+    bool nextLine();
+
+    /**
+     * \return The current line without the line terminator
+     */
+    std::string_view line() const;
+
+    /**
+     * \return The part of the current line that has not been consumed by #nextToken,
+     *         without leading and trailing whitespace
+     */
+    std::string_view rest() const;
+
+    /**
+     * \return The next token in the current line or an empty view if there are no more
+     *         tokens in the line
+     */
+    std::string_view nextToken();
+
+    /**
+     * Converts the next token of the current line, see #toFloat, #toInt, and
+     * #toUnsignedInt.
+     *
+     * \return The converted number or `std::nullopt` if there are no more tokens or the
+     *         token is not a number
+     */
+    std::optional<float> nextFloat();
+    std::optional<int> nextInt();
+    std::optional<unsigned int> nextUnsignedInt();
+
+private:
+    std::string_view _text;
+    std::string_view _separators;
+    std::string_view _line;
+    size_t _linePos = 0;
+    size_t _textPos = 0;
+};
+
+/**
+ * A text file that is memory-mapped for a Tokenizer. This avoids reading the file
+ * through an `std::ifstream` and the copies into line buffers.
+ */
+class SGCT_EXPORT TextFile {
+public:
+    /**
+     * Maps the file at \p path into memory. #isOpen returns `false` if the file could not
+     * be opened.
+     */
+    explicit TextFile(const std::filesystem::path& path);
+
+    bool isOpen() const;
+    std::string_view text() const;
+
+private:
+    MappedFile _file;
+};
+
+} // namespace sgct::correction
+
+#endif // __SGCT__CORRECTION_TOKENIZER__H__
@@ -10,15 +10,20 @@
 #define __SGCT__CORRECTION_MESH__H__
 
 #include <sgct/sgctexports.h>
+#include <sgct/shaderprogram.h>
+#include <sgct/correction/bake.h>
+#include <sgct/correction/buffer.h>
+#include <sgct/correction/meshcache.h>
 #include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
 #include <vector>
 
 namespace sgct {
 
 class BaseViewport;
 
-namespace correction { struct Buffer; }
-
 /**
  * Helper class for reading and rendering a correction mesh. A correction mesh is used for
  * warping and edge-blending.
@@ -26,13 +31,103 @@ namespace correction { struct Buffer; }
 class SGCT_EXPORT CorrectionMesh {
 public:
     /**
-     * This function finds a suitable parser for warping meshes and loads them.
+     * The parsed contents of a mesh file that have not yet been uploaded to the GPU,
+     * which is returned by #readMesh and consumed by #loadMesh.
+     */
+    struct MeshData {
+        std::filesystem::path path;
+
+        /// Set if the mesh was found in the mesh cache, in which case `buffer` is empty
+        std::optional<correction::CachedMesh> cached;
+        correction::Buffer buffer;
+    };
+
+    /**
+     * The values of a viewport that the parsing of a mesh depends on. They are copied
+     * from the viewport so that the mesh can be parsed on another thread while the
+     * viewport is used and modified.
+     */
+    struct ViewportSetup {
+        vec2 position = vec2{ 0.f, 0.f };
+        vec2 size = vec2{ 1.f, 1.f };
+        /// The aspect ratio of the window of the viewport
+        float aspectRatio = 1.f;
+
+        bool operator==(const ViewportSetup& rhs) const {
+            return position.x == rhs.position.x && position.y == rhs.position.y &&
+                size.x == rhs.size.x && size.y == rhs.size.y &&
+                aspectRatio == rhs.aspectRatio;
+        }
+    };
+
+    /**
+     * \return The values of \p parent that are needed to parse a mesh for it
+     */
+    static ViewportSetup viewportSetup(const BaseViewport& parent);
+
+    /**
+     * Finds a suitable parser for the warping mesh at \p path and parses it without
+     * touching any OpenGL state or any viewport. As \p parent is a copy of the values of
+     * the viewport, this function can be called from any thread, which allows the meshes
+     * of all viewports to be parsed in parallel. If Settings::useWarpingMeshCache is
+     * enabled, the mesh is read from or written to the mesh cache.
+     *
+     * \param path The path to the mesh data
+     * \param parent The setup of the viewport for which the mesh is loaded
+     * \param textureRenderMode Whether the mesh is used for texture mapped projections
+     * \return The parsed mesh that is passed to #loadMesh
+     *
+     * \throw std::runtime_error if mesh was not loaded successfully
+     */
+    static MeshData readMesh(const std::filesystem::path& path,
+        const ViewportSetup& parent, bool textureRenderMode = false);
+
+    /**
+     * Parses the mesh at \p path for the current setup of the \p parent viewport, see
+     * #readMesh. This overload must be called on the thread that owns \p parent.
+     */
+    static MeshData readMesh(const std::filesystem::path& path,
+        const BaseViewport& parent, bool textureRenderMode = false);
+
+    /**
+     * Uploads a mesh that was parsed by #readMesh and applies the viewport setup that
+     * is stored in some mesh formats to \p parent. This function requires the OpenGL
+     * context. If \p canBake and Settings::useWarpingLookupTexture are enabled, the mesh
+     * is baked into a lookup texture for the back buffer of the window with
+     * correction::bakeWarp instead, unless the window uses a stereo mode that combines
+     * both eyes in a shader.
+     *
+     * \param mesh The mesh returned by #readMesh
+     * \param parent The pointer to parent viewport
+     * \param needsMaskGeometry If `true`, a separate geometry to applying blend masks is
+     *        loaded
+     * \param canBake If `true`, the mesh is rendered in the final pass of the window,
+     *        which the baked lookup texture replaces. Meshes that are rendered with
+     *        their own shader and transformation must not be baked
+     */
+    void loadMesh(MeshData mesh, BaseViewport& parent, bool needsMaskGeometry = false,
+        bool canBake = false);
+
+    /**
+     * Bakes the mesh again if it was baked into a lookup texture for a back buffer with
+     * a different \p resolution. This function requires the OpenGL context in which the
+     * mesh was loaded.
+     */
+    void updateBakedWarp(ivec2 resolution);
+
+    /**
+     * This function finds a suitable parser for warping meshes and loads them. This is
+     * the same as calling #readMesh followed by the upload of #loadMesh.
      *
      * \param path The path to the mesh data
      * \param parent The pointer to parent viewport
      * \param needsMaskGeometry If `true`, a separate geometry to applying blend masks is
      *        loaded
      *
+     * If Settings::useWarpingMeshCache is enabled, the parsed mesh is stored in a binary
+     * cache file next to the mesh and is memory-mapped from there the next time the same
+     * mesh is loaded for the same viewport, see correction::CachedMesh.
+     *
      * \throw std::runtime_error if mesh was not loaded successfully
      */
     void loadMesh(const std::filesystem::path& path, BaseViewport& parent,
@@ -44,7 +139,9 @@ public:
     void renderQuadMesh() const;
 
     /**
-     * Render the final mesh where for mapping the frame buffer to the screen.
+     * Render the final mesh where for mapping the frame buffer to the screen. If the mesh
+     * was baked, a quad with the lookup texture is rendered instead, which expects the
+     * frame buffer texture to be bound to texture unit 0.
      */
     void renderWarpMesh() const;
 
@@ -56,6 +153,7 @@ public:
 private:
     struct CorrectionMeshGeometry {
         ~CorrectionMeshGeometry();
+        void release();
 
         unsigned int vao = 0;
         unsigned int vbo = 0;
@@ -65,11 +163,34 @@ private:
         unsigned int type = 0x0005; // = GL_TRIANGLE_STRIP;
     };
 
+    struct BakedWarpTextures {
+        ~BakedWarpTextures();
+        void release();
+
+        unsigned int lookup = 0;
+        unsigned int blend = 0;
+    };
+
     void createMesh(CorrectionMeshGeometry& geom, const correction::Buffer& buffer);
+    void createMesh(CorrectionMeshGeometry& geom,
+        std::span<const correction::Buffer::Vertex> vertices,
+        std::span<const unsigned int> indices, unsigned int geometryType,
+        bool useCompactVertices = false);
+    void bakeMesh(ivec2 resolution);
+    void createBakedWarp(const correction::BakedWarp& baked);
+    void renderBakedWarp() const;
 
     CorrectionMeshGeometry _quadGeometry;
     CorrectionMeshGeometry _warpGeometry;
     CorrectionMeshGeometry _maskGeometry;
+
+    // Only used if the mesh was baked into a lookup texture, which keeps the mesh so that
+    // it can be baked again when the resolution of the back buffer changes
+    correction::Buffer _bakedMesh;
+    ivec2 _bakedResolution = ivec2{ 0, 0 };
+    CorrectionMeshGeometry _bakedGeometry;
+    BakedWarpTextures _bakedTextures;
+    ShaderProgram _bakedShader;
 };
 
 } // namespace sgct
@@ -28,6 +28,7 @@
 namespace sgct {
 
 struct Configuration;
+class FileWatcher;
 class Node;
 class StatisticsRenderer;
 
@@ -38,6 +39,8 @@ class StatisticsRenderer;
  * window with is loaded instead.
  *
  * \param path The path to the configuration that should be loaded
+ * \param useSnapshot If this is `true`, the configuration is loaded from its binary
+ *        snapshot if the snapshot is up to date, see readConfigWithSnapshot
  * \return The loaded Cluster object that contains all of the information from the file
  *
  * \exception std::runtime_error This exception is thrown whenever an unrecoverable error
@@ -46,7 +49,24 @@ class StatisticsRenderer;
  * \pre The \p path, if it is provided, must be an existing file
  */
 SGCT_EXPORT config::Cluster loadCluster(
-    std::optional<std::filesystem::path> path = std::nullopt);
+    std::optional<std::filesystem::path> path = std::nullopt, bool useSnapshot = false);
+
+/**
+ * Loads the cluster as requested by the commandline \p configuration. If the
+ * \p configuration contains the address of a master that serves a configuration bundle,
+ * the cluster and all files that it references are loaded from the bundle, which is
+ * cached locally, see fetchBundle. Otherwise the cluster is loaded from the configuration
+ * file in the same way as by the other overload, using the snapshot of the configuration
+ * if that was requested. If the \p configuration contains a port
+ * for serving the bundle, the bundle of the loaded cluster is served on that port until
+ * the Engine is destroyed.
+ *
+ * \param configuration The commandline configuration, see parseArguments
+ * \return The loaded Cluster object, whose `success` is `false` if the configuration
+ *         could not be loaded or the bundle could not be created, served, or received,
+ *         in which case the error is logged
+ */
+SGCT_EXPORT config::Cluster loadCluster(const Configuration& configuration);
 
 /**
  * Returns the number of seconds since the program start. The resultion of this counter is
@@ -450,6 +470,13 @@ private:
      */
     void initWindows(int majorVersion, int minorVersion);
 
+    /**
+     * Starts reloading the files of the viewports that changed on disk or, on clients,
+     * all files if the master requested it, and replaces the files whose reload has
+     * finished. This function is called once per frame, see Settings::setHotReload.
+     */
+    void updateHotReload();
+
     /**
      * Locks the rendering thread for synchronization. Locks the clients until data is
      * successfully received.
@@ -585,6 +612,12 @@ private:
     /// vector is empty, all windows will have a screenshot
     std::vector<int> _shouldTakeScreenshotIds;
 
+    /// Watches the files of the viewports if Settings::hotReload is enabled
+    std::unique_ptr<FileWatcher> _fileWatcher;
+
+    /// The last reload counter received from the master, see SharedData::reloadCounter
+    uint32_t _reloadCounter = 0;
+
     /// Whether SGCT should terminate in the next frame
     bool _shouldTerminate = false;
 
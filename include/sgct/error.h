@@ -30,6 +30,8 @@ namespace sgct {
  * 1032: Device / VRPN address for buttons must not be empty
  * 1033: Device / VRPN address for axes must not be empty
  * 1040: Tracker / Tracker name must not be empty
+ * 1041: Tracker / Tracker prediction latency must not be negative
+ * 1042: Tracker / Tracker prediction smoothing must be in the range (0, 1]
  * 1050: Planar Projection / Up and down field of views can not be the same
  * 1051: Planar Projection / Left and right field of views can not be the same
  * 1060: Fisheye Projection / Field of view setting must be positive
@@ -76,6 +78,7 @@ namespace sgct {
  * 2000s: Correction Meshes
  * 2000: CorrectionMesh / Failed to export. Geometry type is not supported"
  * 2001: CorrectionMesh / Failed to export " + exportPath + ". Failed to open"
+ * 2003: CorrectionMesh / Failed to write correction mesh cache '%s'
  * 2010: DomeProjection / Failed to open '%s'
  * 2030: OBJ / Failed to open '%s'
  * 2031: OBJ / Vertex count doesn't match number of texture coordinates in '%s'
@@ -83,7 +86,7 @@ namespace sgct {
  * 2033: OBJ / Faces in mesh '%s' are using relative index positions that are unsupported
  * 2034: OBJ / Illegal vertex format in OBJ file '%s' in line '%s'
  * 2035: OBJ / Illegal face format in OBJ file '%s' in line '%s'
- * 2036: OBJ / Illegal vertex format in OBJ file '%s' in line '%s'
+ * 2036: OBJ / Illegal texture coordinate format in OBJ file '%s' in line '%s'
  * 2040: PaulBourke / Failed to open file '%s'
  * 2041: PaulBourke / Error reading mapping type in file '%s'
  * 2042: PaulBourke / Invalid data in file '%s'
@@ -95,6 +98,7 @@ namespace sgct {
  * 2060: Scalable / Failed to open file '%s'
  * 2061: Scalable / Incorrect mesh data geometry in file '%s'
  * 2062: Scalable / Illegal formatting of face in file '%s' in line '%s'
+ * 2063: Scalable / Illegal value '%s' for key %s in '%s'
  * 2070: SCISS / Failed to open '%s'
  * 2071: SCISS / Incorrect file id in file '%s'
  * 2072: SCISS / Error parsing file version from file '%s'
@@ -120,8 +124,16 @@ namespace sgct {
  * 3004: Engine / No sync signal from master after X seconds
  * 3005: Engine / No sync signal from clients after X seconds
  * 3006: Engine / Error requesting maximum number of swap groups
+ * 3007: Engine / Replaying a tracking log requires VRPN support
+ * 3008: Engine / Headless rendering requires GLFW 3.4 or newer
  * 3010: Engine / GLFW error
 
+ * 4000s: Tracking
+ * 4000: Tracking / Could not open tracking log '%s' for writing
+ * 4001: Tracking / Could not open tracking log '%s'
+ * 4002: Tracking / Invalid or damaged tracking log '%s'
+ * 4003: Tracking / Unsupported version %i of tracking log '%s'
+
  * 5000s: Network
  * 5000: Network / Failed to parse hints for connection
  * 5001: Network / Failed to listen init socket
@@ -147,6 +159,14 @@ namespace sgct {
  * 5026: NetworkManager / Empty address for connection to %i
  * 5027: NetworkManager / Failed to get host name
  * 5028: NetworkManager / Failed to get address info: %s
+ * 5030: Bundle / Failed to read file %s for the configuration bundle
+ * 5031: Bundle / Failed to compress the configuration bundle
+ * 5032: Bundle / Damaged configuration bundle
+ * 5033: Bundle / Failed to write file %s from the configuration bundle
+ * 5034: Bundle / Failed to serve the configuration bundle on port %i
+ * 5035: Bundle / Failed to connect to %s:%i for the configuration bundle
+ * 5036: Bundle / Failed to receive the configuration bundle from %s:%i
+ * 5037: Bundle / Configuration bundle of %i bytes exceeds the maximum of %i bytes
 
  * 6000s: Configuration parsing
  * 6000: PlanarProjection / Missing specification of field-of-view values
@@ -166,6 +186,7 @@ namespace sgct {
  * 6051: Settings / Wrong buffer precision value type
  * 6060: Capture / Unknown capturing format. Needs to be png, tga, jpg
  * 6070: Tracker / Tracker is missing 'name'
+ * 6071: Tracker / Unknown prediction method %s
  * 6080: Parsing / No file provided
  * 6081: Parsing / Could not find configureation file: %s
  * 6082: Parsing / Error parsing file
@@ -179,6 +200,7 @@ namespace sgct {
  * 6090: SpoutOutput / Unknown spout output mapping: %s
  * 6100: SphericalMirror / Missing geometry paths
  * 6110: TextureMappedProjection / Missing correction mesh
+ * 6120: Snapshot / Failed to write configuration snapshot %s
 
  * 7000s: Shader Handling
  * 7000: ShaderManager / Cannot add shader program %s: Already exists
@@ -205,6 +227,22 @@ namespace sgct {
  * 9010: Image / Failed to create PNG info struct
  * 9011: Image / One of the called PNG functions failed
  * 9012: Image / Invalid image size %i x %i %i channels
+ * 9013: Image / Could not decode file '%s': %s
+ * 9014: Image / Could not open compressed image '%s'
+ * 9015: Image / Unsupported container for '%s'
+ * 9016: Image / Invalid or truncated header in '%s'
+ * 9017: Image / Unsupported compressed format in '%s'
+ * 9018: Image / Supercompressed KTX2 files are not supported '%s'
+ * 9019: Image / Could not save compressed image '%s'
+ * 9020: Image / Cannot encode image: %s
+ * 9021: Image / Cannot decode compressed image: %s
+ * 9022: Image / Could not open tile pyramid '%s'
+ * 9023: Image / Invalid tile pyramid '%s'
+ * 9024: Image / Could not write tile pyramid '%s'
+ * 9025: Image / Cannot build tile pyramid: %s
+ * 9026: Image / Invalid virtual texture configuration: %s
+ * 9027: Image / Only 2D KTX2 textures are supported in '%s'
+ * 9028: Image / Cannot reorder the rows of compressed image '%s'
 
  OBS:  When adding a new error code, don't forget to update docs/errors.md accordingly
  */
@@ -226,6 +264,7 @@ struct SGCT_EXPORT Error : public std::runtime_error {
         Shader,
         SimCAD,
         SkySkan,
+        Tracking,
         Window
     };
 
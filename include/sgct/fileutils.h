@@ -0,0 +1,39 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__FILEUTILS__H__
+#define __SGCT__FILEUTILS__H__
+
+#include <sgct/sgctexports.h>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+
+namespace sgct {
+
+/// The start value of an FNV-1a hash, see fnv1a
+constexpr uint64_t Fnv1aOffsetBasis = 14695981039346656037ull;
+
+/**
+ * Continues the FNV-1a hash \p h with the bytes of \p data, which allows hashing data
+ * that consists of several parts. The hash detects changes of files and keeps the names
+ * of cache files short, but it provides no protection against deliberate collisions.
+ */
+SGCT_EXPORT uint64_t fnv1a(std::string_view data, uint64_t h = Fnv1aOffsetBasis);
+
+/**
+ * Returns a path in the folder of \p path for a temporary file that is written completely
+ * and then renamed to \p path, so that readers never see a partially written file. The
+ * name ends with a random suffix, so that threads, processes, and computers that share
+ * the folder never write to the same temporary file.
+ */
+SGCT_EXPORT std::filesystem::path temporaryPath(const std::filesystem::path& path);
+
+} // namespace sgct
+
+#endif // __SGCT__FILEUTILS__H__
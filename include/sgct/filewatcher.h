@@ -0,0 +1,70 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__FILEWATCHER__H__
+#define __SGCT__FILEWATCHER__H__
+
+#include <sgct/sgctexports.h>
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * Watches a list of files for changes on a background thread. On Linux, the folders of
+ * the files are watched with inotify, which also detects files that are replaced by
+ * renaming a new file over them, as many editors and calibration tools do. On other
+ * platforms, the modification times of the files are polled instead.
+ */
+class SGCT_EXPORT FileWatcher {
+public:
+    /**
+     * Starts watching the \p files. Changes that happen after the constructor returns
+     * are reported by #changedFiles.
+     */
+    explicit FileWatcher(std::vector<std::filesystem::path> files);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * \return The files that have changed since the last call to this function, without
+     *         duplicates. The paths are returned as they were passed to the constructor
+     */
+    std::vector<std::filesystem::path> changedFiles();
+
+private:
+    void watch();
+    void addChange(const std::filesystem::path& path);
+
+    /// The files as passed to the constructor
+    std::vector<std::filesystem::path> _files;
+    /// The normalized absolute paths of the files in the same order
+    std::vector<std::filesystem::path> _absoluteFiles;
+
+    std::mutex _mutex;
+    std::vector<std::filesystem::path> _changed;
+
+    int _inotify = -1;
+    /// Maps the inotify watch descriptors to the watched folders
+    std::map<int, std::filesystem::path> _folders;
+    /// The modification times of the files if inotify is not used
+    std::vector<std::filesystem::file_time_type> _times;
+
+    std::atomic_bool _shouldTerminate = false;
+    std::thread _thread;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__FILEWATCHER__H__
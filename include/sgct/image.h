@@ -40,6 +40,36 @@ public:
     void setChannels(int channels);
     void setBytesPerChannel(int bpc);
 
+    /**
+     * The operations that are applied by #convertPixels. All enabled operations are
+     * performed in a single pass over the image data.
+     */
+    struct Conversion {
+        /// Swaps the first and the third channel of images with 3 or 4 channels
+        bool swapRedBlue = false;
+        /// Reverses the order of the rows
+        bool flipVertically = false;
+        /// Reverses the byte order of each channel for 16 bit images
+        bool swapBytes = false;
+    };
+
+    /**
+     * Copies the pixels from \p src to \p dst while applying the operations selected
+     * in \p conversion. \p src and \p dst can point to the same buffer, in which case
+     * the conversion happens in-place. If available, the conversion uses SSE2, SSSE3,
+     * AVX2, or NEON instructions with a scalar implementation as a fallback.
+     *
+     * \param src The source pixels that are tightly packed with no row padding
+     * \param dst The destination that must have space for the same number of bytes
+     * \param size The size of the image in pixels
+     * \param channels The number of channels, must be between 1 and 4
+     * \param bytesPerChannel The number of bytes per channel, must be 1 or 2
+     * \param conversion The operations that should be applied
+     * \param useSimd If this is `false`, the scalar implementation is always used
+     */
+    static void convertPixels(const unsigned char* src, unsigned char* dst, ivec2 size,
+        int channels, int bytesPerChannel, Conversion conversion, bool useSimd = true);
+
 private:
     /**
      * Compression levels 1-9.
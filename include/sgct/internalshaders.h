@@ -41,6 +41,29 @@ constexpr std::string_view BaseFrag = R"(
   }
 )";
 
+// Warps the frame buffer texture using the lookup and blend textures of a baked
+// correction mesh. tr_uv spans the area covered by the baked textures
+constexpr std::string_view BakedWarpFrag = R"(
+  #version 330 core
+
+  in vec2 tr_uv;
+  in vec4 tr_color;
+  out vec4 out_color;
+
+  uniform sampler2D tex;
+  uniform sampler2D lookup;
+  uniform sampler2D blend;
+
+  void main() {
+    vec3 l = texture(lookup, tr_uv).xyz;
+    if (l.z == 0.0) {
+      // Not covered by the correction mesh
+      discard;
+    }
+    out_color = texture(blend, tr_uv) * texture(tex, l.xy);
+  }
+)";
+
 constexpr std::string_view OverlayFrag = R"(
   #version 330 core
 
@@ -0,0 +1,60 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__MAPPEDFILE__H__
+#define __SGCT__MAPPEDFILE__H__
+
+#include <sgct/sgctexports.h>
+#include <cstddef>
+#include <filesystem>
+
+namespace sgct {
+
+/**
+ * Provides read-only access to the contents of a file by mapping it into memory. The
+ * contents are paged in lazily by the operating system when they are accessed, which
+ * avoids copying the file through an intermediate buffer.
+ */
+class SGCT_EXPORT MappedFile {
+public:
+    /**
+     * Maps the file at the provided \p path into memory. If the file does not exist or
+     * cannot be mapped, #isOpen returns `false` afterwards.
+     */
+    explicit MappedFile(const std::filesystem::path& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile(MappedFile&& rhs) noexcept;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile& operator=(MappedFile&& rhs) noexcept;
+    ~MappedFile();
+
+    /**
+     * Returns whether the file was successfully opened. An empty file counts as open
+     * with a #size of 0 and no #data.
+     */
+    bool isOpen() const;
+
+    const std::byte* data() const;
+    size_t size() const;
+
+private:
+    void close();
+
+    bool _isOpen = false;
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+
+#ifdef WIN32
+    void* _fileHandle = nullptr;
+    void* _mappingHandle = nullptr;
+#endif // WIN32
+};
+
+} // namespace sgct
+
+#endif // __SGCT__MAPPEDFILE__H__
@@ -11,6 +11,7 @@
 
 #include <sgct/sgctexports.h>
 #include <sgct/math.h>
+#include <vector>
 
 namespace sgct {
 
@@ -19,6 +20,20 @@ namespace sgct {
  */
 class SGCT_EXPORT OffScreenBuffer {
 public:
+    /**
+     * The textures that are rendered into together. A texture id of 0 means that the
+     * attachment is not used, in which case the depth is rendered into the depth render
+     * buffer of this buffer instead.
+     */
+    struct Target {
+        unsigned int color = 0;
+        unsigned int depth = 0;
+        unsigned int normals = 0;
+        unsigned int positions = 0;
+
+        bool operator==(const Target&) const = default;
+    };
+
     static void unbind();
 
     ~OffScreenBuffer();
@@ -43,6 +58,16 @@ public:
         unsigned int attachment);
     void attachCubeMapDepthTexture(unsigned int texId, unsigned int face);
 
+    /**
+     * Attaches all layers of a layered texture, such as all faces of a cube map, so that
+     * the layer of each primitive can be selected while rendering.
+     *
+     * \param texId GL id of the texture to attach
+     * \param attachment The gl attachment enum in the form of `GL_COLOR_ATTACHMENT`i or
+     *        `GL_DEPTH_ATTACHMENT`
+     */
+    void attachLayeredTexture(unsigned int texId, unsigned int attachment);
+
     /**
      * Bind framebuffer, auto-set multisampling and draw buffers.
      */
@@ -57,10 +82,44 @@ public:
      */
     void bind(bool isMultisampled, int n, const unsigned int* bufs) const;
     void bindBlit() const;
+
+    /**
+     * Binds a framebuffer that has the textures of the \p target attached. The
+     * framebuffer is created the first time that a target is bound and is reused until
+     * the buffer is resized, so that the attachments do not have to change every frame.
+     * If the buffer is multisampled, the multisampled framebuffer is bound for reading
+     * so that #blit resolves it into the textures of the \p target.
+     */
+    void bindTarget(const Target& target);
+
+    /**
+     * Returns the framebuffer that has the textures of the \p target attached, which
+     * #bindTarget binds, so that the textures can be read from or blitted by other
+     * framebuffers. The framebuffer is created if it does not exist yet, in which case
+     * it is left bound.
+     */
+    unsigned int targetFramebuffer(const Target& target);
     void blit() const;
+
+    /**
+     * Copies the \p source rectangle of the texture that is attached to
+     * `GL_COLOR_ATTACHMENT0` into the \p destination rectangle of a face of a cube map
+     * with linear filtering, so that a face that was rendered at a lower resolution can
+     * be scaled up. The rectangles are given as x, y, width, and height and the
+     * framebuffer must not be multisampled.
+     *
+     * \param texId GL id of the cube map texture
+     * \param face The target cubemap face
+     * \param source The rectangle of the attached texture that is copied
+     * \param destination The rectangle of the face that is written
+     */
+    void blitToCubeMapFace(unsigned int texId, unsigned int face, ivec4 source,
+        ivec4 destination) const;
     bool isMultiSampled() const;
 
 private:
+    void deleteTargets();
+
     unsigned int _frameBuffer = 0;
     unsigned int _multiSampledFrameBuffer = 0;
     unsigned int _colorBuffer = 0;
@@ -69,6 +128,12 @@ private:
     unsigned int _depthBuffer = 0;
     unsigned int _internalColorFormat = 0x8058; // GL_RGBA8;
 
+    struct TargetFramebuffer {
+        Target target;
+        unsigned int frameBuffer = 0;
+    };
+    std::vector<TargetFramebuffer> _targets;
+
     ivec2 _size = ivec2{ -1, -1 };
     bool _isMultiSampled = false;
     bool _mirror = false;
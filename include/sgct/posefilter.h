@@ -0,0 +1,86 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__POSEFILTER__H__
+#define __SGCT__POSEFILTER__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/config.h>
+#include <sgct/math.h>
+#include <optional>
+
+namespace sgct {
+
+/**
+ * Smooths the samples of a tracking device and predicts its pose at a time in the future,
+ * such as the time at which the next frame is shown. The filter only works on raw sensor
+ * positions and rotations with their time stamps, so that it can be tested with recorded
+ * traces independent of the tracking system.
+ *
+ * With the ConstantVelocity method, the linear and angular velocities between consecutive
+ * samples are smoothed exponentially and the latest sample is extrapolated with them.
+ * With the DoubleExponential method, the position and the rotation are smoothed twice
+ * and the trend between the two smoothed values is extrapolated (LaViola, "Double
+ * Exponential Smoothing: An Alternative to Kalman Filter-Based Predictive Tracking",
+ * 2003), which uses slerp for the rotations.
+ */
+class SGCT_EXPORT PoseFilter {
+public:
+    struct Pose {
+        vec3 position = vec3{ 0.f, 0.f, 0.f };
+        quat rotation = quat{ 0.f, 0.f, 0.f, 1.f };
+    };
+
+    /**
+     * Creates a filter with the method and the smoothing of the \p prediction. The
+     * latency of the \p prediction is not used by the filter itself, but has to be added
+     * to the time that is passed to #predict.
+     */
+    explicit PoseFilter(const config::Tracker::Prediction& prediction);
+
+    /**
+     * Adds the \p pose that was sampled at the \p time in seconds. Samples have to be
+     * added in the order of their times and samples that are not newer than the previous
+     * sample are ignored.
+     */
+    void addSample(double time, const Pose& pose);
+
+    /**
+     * \return The pose predicted for the \p time, which should be measured with the same
+     *         clock as the samples, or `std::nullopt` if no sample has been added yet
+     */
+    std::optional<Pose> predict(double time) const;
+
+    /**
+     * \return The time of the newest sample or `std::nullopt` if no sample has been added
+     */
+    std::optional<double> latestTime() const;
+
+private:
+    const config::Tracker::Prediction::Method _method;
+    const float _smoothing;
+
+    int _nSamples = 0;
+    double _time = 0.0;
+
+    /// The latest sample, which is extrapolated by the constant velocity method
+    Pose _latest;
+    vec3 _velocity = vec3{ 0.f, 0.f, 0.f };
+    /// The rotation axis scaled by the angular velocity in radians per second
+    vec3 _angularVelocity = vec3{ 0.f, 0.f, 0.f };
+
+    /// The single and double smoothed poses of the double exponential method
+    Pose _smoothed;
+    Pose _smoothedTwice;
+    /// The smoothed time between samples, which converts the prediction time into samples
+    double _interval = 0.0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__POSEFILTER__H__
@@ -12,6 +12,8 @@
 #include <sgct/sgctexports.h>
 #include <sgct/frustum.h>
 #include <sgct/math.h>
+#include <cstdint>
+#include <span>
 
 namespace sgct {
 
@@ -22,9 +24,27 @@ class ProjectionPlane;
  */
 class SGCT_EXPORT Projection {
 public:
+    /**
+     * Calculates the view and projection matrices for an eye at \p base + \p offset
+     * looking at the projection plane \p proj. Nothing is recalculated if neither the
+     * inputs nor the coordinates of the plane have changed since the last call.
+     */
     void calculateProjection(vec3 base, const ProjectionPlane& proj, float nearClip,
         float farClip, vec3 offset = vec3{ 0.f, 0.f, 0.f });
 
+    /**
+     * Same as calling #calculateProjection for each of the \p projections with the
+     * corresponding plane of the \p planes, which is used when the same eye looks at
+     * multiple planes, such as the faces of a cube map. The projections that have to be
+     * recalculated are processed together with the values of the planes stored as a
+     * structure of arrays, so that the compiler can vectorize the calculation.
+     *
+     * \pre \p projections and \p planes must have the same size
+     */
+    static void calculateProjections(std::span<Projection* const> projections,
+        std::span<const ProjectionPlane* const> planes, vec3 base, float nearClip,
+        float farClip, vec3 offset = vec3{ 0.f, 0.f, 0.f });
+
     const mat4& viewProjectionMatrix() const;
     const mat4& viewMatrix() const;
     const mat4& projectionMatrix() const;
@@ -35,6 +55,17 @@ private:
     mat4 _projectionMatrix = mat4(1.f);
 
     Frustum _frustum;
+
+    /// The inputs of the last calculation, which is skipped if they have not changed
+    struct Inputs {
+        const ProjectionPlane* plane = nullptr;
+        uint64_t planeVersion = 0;
+        vec3 base = vec3{ 0.f, 0.f, 0.f };
+        vec3 offset = vec3{ 0.f, 0.f, 0.f };
+        float nearClip = 0.f;
+        float farClip = 0.f;
+    };
+    Inputs _inputs;
 };
 
 } // namespace sgct
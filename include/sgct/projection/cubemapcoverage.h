@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__CUBEMAPCOVERAGE__H__
+#define __SGCT__CUBEMAPCOVERAGE__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/math.h>
+#include <sgct/correction/buffer.h>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace sgct {
+
+/**
+ * The parts of the faces of a cube map that are sampled by a non-linear projection. The
+ * faces are in the order right, left, bottom, top, front, back, which is the order of
+ * the layers of the cube map.
+ */
+struct SGCT_EXPORT CubemapCoverage {
+    struct Face {
+        /// `false` if the projection never samples this face
+        bool isCovered = false;
+
+        /// The smallest rectangle of pixels of the face that contains all samples, as x,
+        /// y, width, and height, with the origin in the lower left corner
+        ivec4 rect = ivec4{ 0, 0, 0, 0 };
+    };
+    std::array<Face, 6> faces;
+};
+
+/**
+ * The face of a cube map and the texture coordinates on that face that OpenGL samples
+ * for a direction.
+ */
+struct SGCT_EXPORT CubemapCoordinate {
+    /// The index of the face in the order +x, -x, +y, -y, +z, -z
+    int face = 0;
+    vec2 uv = vec2{ 0.f, 0.f };
+};
+
+/**
+ * Selects the face and texture coordinates like OpenGL does when sampling a cube map in
+ * the \p direction.
+ */
+SGCT_EXPORT CubemapCoordinate cubemapCoordinate(vec3 direction);
+
+/**
+ * Calculates the area of each face that is sampled in any of the \p directions. The
+ * directions are only samples of the area that is actually used, so the rectangles are
+ * extended by the number of pixels that the \p spacing between neighboring directions
+ * can cover, and a bit more to account for texture filtering, but never exceed the face.
+ *
+ * \param directions The sampled directions, which do not have to be normalized
+ * \param resolution The resolution of each face of the cube map
+ * \param spacing The largest angle in radians between neighboring directions
+ */
+SGCT_EXPORT CubemapCoverage cubemapCoverage(std::span<const vec3> directions,
+    ivec2 resolution, float spacing);
+
+/**
+ * Calculates the resolution that each face of a cube map needs so that its pixels are
+ * about as large as the output pixels that sample it. The faces are divided into bins and
+ * the resolution is chosen for the 90th percentile of the number of samples in the bins
+ * of a face, so that only small parts of a face are rendered at a lower density than
+ * they are shown.
+ *
+ * \param directions The sampled directions, which do not have to be normalized
+ * \param pixelsPerDirection The number of output pixels that each direction represents
+ * \return The resolution of each face, which is 0 for faces that are never sampled
+ */
+SGCT_EXPORT std::array<int, 6> cubemapFaceResolutions(std::span<const vec3> directions,
+    float pixelsPerDirection);
+
+/**
+ * Scales the \p resolutions of the faces of a cube map down by a common factor so that
+ * rendering all faces takes at most \p budget pixels. Only the covered part of each face
+ * is rendered, so \p coverage decides how many of the pixels of a face count towards the
+ * budget. The \p resolutions are returned unchanged if they already fit into the budget.
+ */
+SGCT_EXPORT std::array<int, 6> limitToPixelBudget(std::array<int, 6> resolutions,
+    const CubemapCoverage& coverage, ivec2 coverageResolution, int64_t budget);
+
+/**
+ * Calculates the direction in which the fisheye projection samples the cube map at the
+ * texture coordinates \p tc of its quad. This mirrors the sampling and rotation functions
+ * of the fisheye shaders.
+ *
+ * \param tc The texture coordinates, where the fisheye circle is centered at (0.5, 0.5)
+ * \param halfFov Half of the field of view of the fisheye in radians
+ * \param offset The offset of the fisheye that is used for off-axis rendering
+ * \param isFourFaceCube `true` if the cube map uses four faces, `false` if it uses five
+ *        or six faces
+ * \return The direction or `std::nullopt` if \p tc is outside of the fisheye circle
+ */
+SGCT_EXPORT std::optional<vec3> fisheyeDirection(vec2 tc, float halfFov, vec3 offset,
+    bool isFourFaceCube);
+
+/**
+ * Calculates the direction in which the cylindrical projection samples the cube map at
+ * the texture coordinates \p uv of its quad, which mirrors its fragment shader.
+ *
+ * \param uv The texture coordinates, where x goes around the cylinder
+ * \param rotation The rotation of the cylinder in radians
+ * \param heightOffset The vertical offset of the cylinder
+ */
+SGCT_EXPORT vec3 cylindricalDirection(vec2 uv, float rotation, float heightOffset);
+
+/**
+ * Finds the positions in a viewport that are shown through the correction \p mesh, one
+ * for each pixel of a framebuffer with the \p resolution that the mesh covers. The
+ * texture coordinates of the mesh refer to the whole framebuffer, while the returned
+ * positions are normalized to the viewport at \p position with the \p size.
+ */
+SGCT_EXPORT std::vector<vec2> sampledPositions(const correction::Buffer& mesh,
+    ivec2 resolution, vec2 position, vec2 size);
+
+} // namespace sgct
+
+#endif // __SGCT__CUBEMAPCOVERAGE__H__
@@ -37,6 +37,8 @@ private:
     void initVBO() override;
     void initViewports() override;
     void initShaders() override;
+    std::optional<CubemapSamples> cubemapSamples(std::span<const vec2> positions,
+        float spacing) const override;
 
     float _rotation = 0.f;
     float _heightOffset = 0.f;
@@ -13,6 +13,7 @@
 #include <sgct/projection/nonlinearprojection.h>
 
 #include <sgct/callbackdata.h>
+#include <array>
 
 namespace sgct {
 
@@ -98,6 +99,12 @@ private:
     void initVBO() override;
     void initViewports() override;
     void initShaders() override;
+    std::optional<CubemapSamples> cubemapSamples(std::span<const vec2> positions,
+        float spacing) const override;
+
+    /// The offset of the projection and the eye separation that the cube map samples
+    /// depend on, with the eye separation being 0 for a mono projection
+    std::array<float, 4> coverageParameters() const;
 
     float _fov = 180.f;
     float _tilt = 0.f;
@@ -114,6 +121,10 @@ private:
     vec3 _offset = vec3{ 0.f, 0.f, 0.f };
     vec3 _baseOffset = vec3{ 0.f, 0.f, 0.f };
     vec3 _totalOffset = vec3{ 0.f, 0.f, 0.f };
+    /// Half of the extent of the quad in normalized device coordinates
+    vec2 _quadSize = vec2{ 1.f, 1.f };
+    /// The coverageParameters with which the coverage of the cube map was calculated
+    std::array<float, 4> _coverageParameters = { 0.f, 0.f, 0.f, 0.f };
 
     FisheyeMethod _method = FisheyeMethod::FourFaceCube;
 
@@ -11,9 +11,16 @@
 
 #include <sgct/sgctexports.h>
 #include <sgct/baseviewport.h>
+#include <sgct/callbackdata.h>
 #include <sgct/shaderprogram.h>
+#include <sgct/projection/cubemapcoverage.h>
+#include <array>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace sgct {
 
@@ -78,6 +85,20 @@ public:
 
     virtual void setUser(User* user);
 
+    /**
+     * Sets the positions in the viewport of this projection that are visible in the
+     * window, for example the positions that are sampled through a correction mesh. The
+     * positions are normalized to the viewport and are used to skip the faces of the cube
+     * map that are never sampled and to restrict the rendering of the other faces to the
+     * sampled area. If an adaptive cube map resolution is used, each position stands for
+     * one pixel of the viewport. If no positions are set, the whole viewport is assumed
+     * to be visible.
+     *
+     * \param positions The visible positions, normalized to the viewport
+     * \param spacing The largest distance between neighboring positions
+     */
+    void setCubemapSamples(std::vector<vec2> positions, float spacing);
+
     /**
      * \return the resolution of the cubemap
      */
@@ -85,6 +106,28 @@ public:
 
     ivec4 viewportCoords();
 
+    /**
+     * Checks whether the cube map \p faces, which are ordered right, left, bottom, top,
+     * front, and back, can be rendered in a single pass (see
+     * Settings::setUseLayeredCubemapRendering). This needs layered attachments, which do
+     * not exist for the multisampled renderbuffers and the 2D swap textures of the depth
+     * transformation, and all enabled faces have to cover the whole cube map.
+     *
+     * \return The reason why the faces have to be rendered separately, or `std::nullopt`
+     *         if they can be rendered in a single pass
+     */
+    static std::optional<std::string_view> layeredRenderingFallback(int samples,
+        bool useDepthTexture, std::span<const BaseViewport* const, 6> faces);
+
+    /**
+     * \return The matrices of the cube map \p faces for a single pass, in which only the
+     *         faces that are enabled and covered according to \p isCovered are rendered
+     */
+    static RenderData::CubemapLayers cubemapLayers(
+        std::span<const BaseViewport* const, 6> faces,
+        const std::array<bool, 6>& isCovered, Frustum::Mode frustumMode,
+        const mat4& sceneTransform);
+
 protected:
     virtual void initTextures();
     virtual void initFBO();
@@ -92,7 +135,48 @@ protected:
     virtual void initViewports() = 0;
     virtual void initShaders() = 0;
 
-    void setupViewport(BaseViewport& vp);
+    /**
+     * The directions in which the cube map is sampled when the projection is shown at
+     * some positions of its viewport.
+     */
+    struct CubemapSamples {
+        std::vector<vec3> directions;
+        /// The largest angle in radians between the directions of neighboring positions
+        float spacing = 0.f;
+        /// The number of directions for each position, for example one for each eye
+        int directionsPerPosition = 1;
+    };
+
+    /**
+     * Calculates the directions in which the cube map is sampled when the projection is
+     * shown at the \p positions of the viewport, which are normalized to the viewport
+     * and are at most \p spacing apart. Projections that cannot determine these return
+     * `std::nullopt`, in which case all enabled faces are rendered completely.
+     */
+    virtual std::optional<CubemapSamples> cubemapSamples(
+        std::span<const vec2> positions, float spacing) const;
+
+    /**
+     * Recalculates the coverage of the cube map faces, which has to be called whenever
+     * the parameters of the projection change. If an adaptive resolution is selected in
+     * the Settings, this also chooses the resolution of each face from the resolution of
+     * the viewport and recreates the textures if the resolution of the cube map changed.
+     */
+    void updateCubemapCoverage();
+
+    /**
+     * Chooses the resolution of each face for the Settings::CubemapResolution policy from
+     * the directions in which the cube map is sampled, where each of the \p samples
+     * stands for \p pixelsPerDirection pixels of the viewport.
+     */
+    void updateFaceResolutions(const CubemapSamples& samples, float pixelsPerDirection);
+
+    /**
+     * \return `false` if the face with the index \p face is known to be never sampled
+     */
+    bool isFaceCovered(int face) const;
+
+    void setupViewport(const BaseViewport& vp);
     void generateMap(unsigned int& texture, unsigned int internalFormat,
         unsigned int format, unsigned int type);
     void generateCubeMap(unsigned int& texture, unsigned int internalFormat,
@@ -103,6 +187,12 @@ protected:
     void renderCubeFace(const Window& win, BaseViewport& vp, int idx, Frustum::Mode mode);
     void renderCubeFaces(Window& window, Frustum::Mode frustumMode);
 
+    /**
+     * Renders all enabled faces with a single call to the draw function into all layers
+     * of the cube maps at once, which is only used if #_useLayeredRendering is `true`.
+     */
+    void renderCubeFacesLayered(const Window& window, Frustum::Mode frustumMode);
+
     struct {
         unsigned int cubeMapColor = 0;
         unsigned int cubeMapDepth = 0;
@@ -116,6 +206,9 @@ protected:
         unsigned int cubeFaceTop = 0;
         unsigned int cubeFaceFront = 0;
         unsigned int cubeFaceBack = 0;
+        /// The face that is rendered at a lower resolution before it is scaled up into
+        /// the cube map
+        unsigned int scaledFace = 0;
     } _textures;
 
     struct {
@@ -135,12 +228,31 @@ protected:
     ivec4 _vpCoords = ivec4(0, 0, 0, 0);
     bool _useDepthTransformation = false;
     bool _isStereo = false;
+    /// Whether the faces of the cube map are rendered in a single pass. This is decided
+    /// when the projection is initialized and requires the application to opt in
+    bool _useLayeredRendering = false;
+    /// Whether faces that need a lower resolution than the cube map are rendered at their
+    /// own resolution and then scaled up, which is only possible for a single color
+    /// texture without multisampling
+    bool _useScaledFaces = false;
     unsigned int _texInternalFormat = 0;
     unsigned int _texFormat = 0;
     unsigned int _texType = 0;
     int _samples = 1;
 
     std::unique_ptr<OffScreenBuffer> _cubeMapFbo;
+
+    /// The sampled parts of the cube map faces or `std::nullopt` if all faces are used
+    std::optional<CubemapCoverage> _coverage;
+    /// The visible positions in the viewport that were set with #setCubemapSamples
+    std::vector<vec2> _coverageSamples;
+    float _coverageSpacing = 0.f;
+    /// The resolution of the viewport in pixels, which is set by the projections that
+    /// can choose the resolution of their cube map faces
+    vec2 _viewportResolution = vec2(0.f, 0.f);
+    /// The resolution at which each face is rendered, which is 0 for faces that use the
+    /// resolution of the cube map
+    std::array<int, 6> _faceResolutions = { 0, 0, 0, 0, 0, 0 };
 };
 
 } // namespace sgct
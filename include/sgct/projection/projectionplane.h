@@ -11,14 +11,19 @@
 
 #include <sgct/sgctexports.h>
 #include <sgct/math.h>
+#include <cstdint>
 
 namespace sgct {
 
 /**
- * This class holds and manages the 3D projection plane.
+ * This class holds and manages the 3D projection plane. Besides the corners, the plane
+ * stores the values that Projection::calculateProjection needs and that only depend on
+ * the corners, so that they are not recomputed whenever the eye position changes.
  */
 class SGCT_EXPORT ProjectionPlane {
 public:
+    ProjectionPlane();
+
     void setCoordinates(vec3 lowerLeft, vec3 upperLeft, vec3 upperRight);
     void offset(const vec3& p);
 
@@ -37,10 +42,39 @@ public:
      */
     const vec3& coordinateUpperRight() const;
 
+    /**
+     * \return The rotation from world coordinates into the coordinate system of the
+     *         plane, in which the x and y axes are aligned with the edges of the
+     *         plane, in the upper left 3x3 part of the matrix
+     */
+    const mat4& rotation() const;
+
+    /**
+     * \return The lower left corner in the coordinate system of the plane
+     */
+    const vec3& rotatedLowerLeft() const;
+
+    /**
+     * \return The upper right corner in the coordinate system of the plane
+     */
+    const vec3& rotatedUpperRight() const;
+
+    /**
+     * \return A number that changes whenever the coordinates of the plane change
+     */
+    uint64_t version() const;
+
 private:
+    void updateRotation();
+
     vec3 _lowerLeft = vec3{ -1.f, -1.f, -2.f };
     vec3 _upperLeft = vec3{ -1.f, 1.f, -2.f };
     vec3 _upperRight = vec3{ 1.f, 1.f, -2.f };
+
+    mat4 _rotation = mat4(1.f);
+    vec3 _rotatedLowerLeft = vec3{ 0.f, 0.f, 0.f };
+    vec3 _rotatedUpperRight = vec3{ 0.f, 0.f, 0.f };
+    uint64_t _version = 0;
 };
 
 } // namespace sgct
@@ -0,0 +1,133 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__SEQLOCK__H__
+#define __SGCT__SEQLOCK__H__
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace sgct {
+
+/**
+ * Holds a value that is written rarely compared to how often it is read, such as the
+ * state of a tracking device that is written by the sampling thread and read by the
+ * render thread. Readers never block the writer and never block each other; instead, a
+ * reader retries if the value was written while it was read. The value is stored as
+ * atomic words, so a read that overlaps with a write is not a data race. Writers are
+ * serialized among each other by spinning, which is only suitable for short writes.
+ */
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "The value must be copied bytewise");
+
+public:
+    SeqLock() : SeqLock(T{}) {}
+
+    explicit SeqLock(const T& value) {
+        write(value);
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /**
+     * \return A copy of the value that was not modified while it was copied
+     */
+    T load() const {
+        while (true) {
+            const uint32_t begin = _sequence.load(std::memory_order_acquire);
+            if (begin % 2 == 0) {
+                T value = read();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (_sequence.load(std::memory_order_relaxed) == begin) {
+                    return value;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Replaces the value with the \p value.
+     */
+    void store(const T& value) {
+        const uint32_t sequence = lock();
+        write(value);
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Calls the \p function with a reference to the value, which the \p function can
+     * modify, and publishes the modified value to the readers. The \p function is called
+     * while other writers are blocked, so it should not do more than update the value.
+     */
+    template <typename F>
+    void update(F&& function) {
+        const uint32_t sequence = lock();
+        T value = read();
+        function(value);
+        write(value);
+        _sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t NWords =
+        (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // Makes the sequence odd, which marks the value as being written, and returns the
+    // previous, even sequence
+    uint32_t lock() {
+        uint32_t sequence = _sequence.load(std::memory_order_relaxed);
+        while (sequence % 2 != 0 ||
+               !_sequence.compare_exchange_weak(
+                   sequence,
+                   sequence + 1,
+                   std::memory_order_acquire,
+                   std::memory_order_relaxed
+               ))
+        {
+            std::this_thread::yield();
+            sequence = _sequence.load(std::memory_order_relaxed);
+        }
+        // The value must not be written before the sequence is marked as odd
+        std::atomic_thread_fence(std::memory_order_release);
+        return sequence;
+    }
+
+    T read() const {
+        std::array<uint64_t, NWords> words;
+        for (size_t i = 0; i < NWords; i++) {
+            words[i] = _words[i].load(std::memory_order_relaxed);
+        }
+        // The value might have a non-trivial default constructor, but it is trivially
+        // copyable, so it can be overwritten bytewise
+        T value;
+        std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+        return value;
+    }
+
+    void write(const T& value) {
+        std::array<uint64_t, NWords> words = {};
+        std::memcpy(words.data(), &value, sizeof(T));
+        for (size_t i = 0; i < NWords; i++) {
+            _words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint32_t> _sequence = 0;
+    std::array<std::atomic<uint64_t>, NWords> _words;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__SEQLOCK__H__
@@ -11,6 +11,7 @@
 
 #include <sgct/sgctexports.h>
 #include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <string>
@@ -38,6 +39,35 @@ public:
     };
     enum class BufferFloatPrecision { Float16Bit, Float32Bit };
 
+    enum class HotReload {
+        /// Files are only loaded at startup
+        Disabled,
+        /// Each node reloads its own files when they change
+        Local,
+        /// Each node reloads its own files when they change and the master additionally
+        /// tells all clients to reload their files when one of its files changes
+        Cluster
+    };
+
+    enum class CubemapResolution {
+        /// All faces use the resolution that is set in the configuration
+        Fixed,
+        /// Each face is rendered at the resolution for which its pixels are about as
+        /// large as the output pixels that show it
+        PreserveQuality,
+        /// Like PreserveQuality, but the resolutions of all faces are reduced by a common
+        /// factor if rendering the cube map would take more than the pixel budget
+        PixelBudget
+    };
+
+    enum class TrackingReplaySpeed {
+        /// The events are applied with the same timing with which they were recorded
+        Original,
+        /// Every rendered frame applies the next 1/60 s of the recording regardless of how
+        /// long the frame took, which replays the same events in every frame every time
+        AsFastAsPossible
+    };
+
     static Settings& instance();
     static void destroy();
 
@@ -76,6 +106,33 @@ public:
      */
     void setUsePositionTexture(bool state);
 
+    /**
+     * Set to true if the faces of the cube maps of non-linear projections should be
+     * rendered in a single pass into a layered framebuffer. The draw function is then
+     * called once per eye instead of once per cube face and has to select the layer of
+     * each primitive itself using the matrices in RenderData::cubemapLayers, for example
+     * in a geometry shader that writes `gl_Layer`. Projections that cannot render their
+     * faces in a single pass, for example because multisampling or depth textures are
+     * used, keep rendering each face separately.
+     */
+    void setUseLayeredCubemapRendering(bool state);
+
+    /**
+     * Sets how the resolution of the cube map faces of non-linear projections is chosen.
+     * The adaptive policies replace the resolution from the configuration with the one
+     * that is calculated from the resolution of the viewport and the parameters of the
+     * projection. Faces that need fewer pixels than others are rendered at their own
+     * resolution and scaled up into the cube map, unless multisampling, depth textures,
+     * normal or position textures, or layered rendering are used.
+     */
+    void setCubemapResolution(CubemapResolution policy);
+
+    /**
+     * Sets the largest number of pixels that are rendered for all faces of a cube map if
+     * the CubemapResolution::PixelBudget policy is used.
+     */
+    void setCubemapPixelBudget(int64_t pixels);
+
     /**
      * Set the float precision of the float buffers (normal and position buffer).
      *
@@ -88,6 +145,32 @@ public:
      */
     void setNumberOfCaptureThreads(int count);
 
+    /**
+     * Set the number of threads that are used to decode textures that are loaded
+     * through TextureManager::loadTextureAsync.
+     */
+    void setNumberOfTextureLoadThreads(int count);
+
+    /**
+     * Set the maximum time in milliseconds that is spent each frame uploading textures
+     * that have been loaded asynchronously. At least one texture is uploaded each frame
+     * regardless of this value to guarantee progress.
+     */
+    void setTextureUploadBudget(double milliseconds);
+
+    /**
+     * Set the GPU memory in bytes that the TextureManager may use before it starts to
+     * delete cached textures that are no longer referenced. With a budget of 0, textures
+     * are deleted as soon as they are no longer referenced.
+     */
+    void setTextureMemoryBudget(size_t bytes);
+
+    /**
+     * Set the folder in which the TextureManager stores decoded images so that they do
+     * not have to be decoded again on the next start. An empty path disables the cache.
+     */
+    void setTextureCachePath(std::filesystem::path path);
+
     /**
      * Set capture/screenshot path used by SGCT.
      *
@@ -116,6 +199,85 @@ public:
      */
     void setExportWarpingMeshes(bool state);
 
+    /**
+     * Set to true if warping meshes should be stored in a binary cache file next to the
+     * source mesh after they have been parsed, and loaded from that file on the next
+     * start if the source mesh and the viewport did not change.
+     */
+    void setUseWarpingMeshCache(bool state);
+
+    /**
+     * Set the maximum error in texture coordinates that is allowed when dense warping
+     * meshes are simplified after loading, see correction::simplifyMesh. A value of 0
+     * disables the simplification.
+     */
+    void setWarpingMeshSimplificationError(float error);
+
+    /**
+     * Set to true if warping meshes should be baked into a lookup texture and a blend
+     * texture after loading, which are then applied in a single pass over the area of
+     * the mesh instead of rendering the mesh, see correction::bakeWarp.
+     */
+    void setUseWarpingLookupTexture(bool state);
+
+    /**
+     * Set to true if the triangles of warping meshes should be reordered after loading to
+     * improve the reuse of the vertex cache, see correction::optimizeVertexCache.
+     */
+    void setOptimizeWarpingMeshes(bool state);
+
+    /**
+     * Set to true if the vertices of warping meshes should be uploaded in the compact
+     * format with 16-bit texture coordinates and 8-bit colors, see
+     * correction::compactVertices. Meshes whose texture coordinates or colors are
+     * outside the range [0, 1] always use the full format.
+     */
+    void setUseCompactWarpingMeshVertices(bool state);
+
+    /**
+     * Sets whether the correction meshes and the overlay and mask textures of the
+     * viewports are reloaded while the application is running when their files change,
+     * see Viewport::beginReloadData. With HotReload::Cluster, the clients reload their
+     * files when those of the master change, which is useful if the clients read the
+     * files from a network share on which they are not notified of changes. As this adds
+     * a reload counter to every synchronization, all nodes have to use HotReload::Cluster
+     * if any of them does.
+     */
+    void setHotReload(HotReload hotReload);
+
+    /**
+     * Set to true if the VRPN devices should be sampled when data arrives on their
+     * connections instead of at a fixed interval. Each connection is then handled by its
+     * own thread that waits for data on the sockets of the connection.
+     */
+    void setUseEventDrivenTracking(bool state);
+
+    /**
+     * Sets the file into which all updates of the tracking devices are recorded, see
+     * TrackingRecorder. Nothing is recorded if the \p path is empty.
+     */
+    void setTrackingRecordPath(std::filesystem::path path);
+
+    /**
+     * Sets the tracking log that is replayed into the tracking devices with the \p speed
+     * instead of connecting to the VRPN servers, see TrackingPlayer. The tracking devices
+     * are connected to the VRPN servers if the \p path is empty. The events are applied
+     * by the render loop of the master before each frame.
+     */
+    void setTrackingReplay(std::filesystem::path path, TrackingReplaySpeed speed);
+
+    /**
+     * Sets whether the windows are created without a display server. GLFW then uses its
+     * null platform and creates the OpenGL contexts with EGL, which works without a
+     * display with the surfaceless platform of Mesa, for example with llvmpipe. Nothing
+     * is shown on screen; the final pass with the warping, blending, and masks renders
+     * into an offscreen framebuffer of each window instead, see
+     * Window::bindHeadlessFramebuffer, and screenshots are always taken from the
+     * framebuffer textures of the windows. This requires GLFW 3.4 or newer and has to be
+     * set before the Engine is created.
+     */
+    void setUseHeadlessRendering(bool state);
+
     /**
      * If set to true, the node name is added to screenshots.
      */
@@ -161,6 +323,64 @@ public:
      */
     bool exportWarpingMeshes() const;
 
+    /**
+     * Get if warping meshes are read from and written to the binary mesh cache.
+     */
+    bool useWarpingMeshCache() const;
+
+    /**
+     * Get the maximum error in texture coordinates for the simplification of warping
+     * meshes, or 0 if warping meshes are not simplified.
+     */
+    float warpingMeshSimplificationError() const;
+
+    /**
+     * Get if warping meshes are baked into lookup textures instead of being rendered.
+     */
+    bool useWarpingLookupTexture() const;
+
+    /**
+     * Get if the triangles of warping meshes are reordered for the vertex cache.
+     */
+    bool optimizeWarpingMeshes() const;
+
+    /**
+     * Get if the vertices of warping meshes are uploaded in the compact format.
+     */
+    bool useCompactWarpingMeshVertices() const;
+
+    /**
+     * Get if and how files of the viewports are reloaded when they change.
+     */
+    HotReload hotReload() const;
+
+    /**
+     * Get if the VRPN devices are sampled when data arrives on their connections.
+     */
+    bool useEventDrivenTracking() const;
+
+    /**
+     * Get the file into which the updates of the tracking devices are recorded or an
+     * empty path if they are not recorded.
+     */
+    const std::filesystem::path& trackingRecordPath() const;
+
+    /**
+     * Get the tracking log that is replayed or an empty path if the tracking devices are
+     * connected to the VRPN servers.
+     */
+    const std::filesystem::path& trackingReplayPath() const;
+
+    /**
+     * Get how fast the tracking log is replayed.
+     */
+    TrackingReplaySpeed trackingReplaySpeed() const;
+
+    /**
+     * Get if the windows are created without a display server.
+     */
+    bool useHeadlessRendering() const;
+
     /**
      * Get the capture/screenshot path.
      *
@@ -183,11 +403,46 @@ public:
      */
     bool usePositionTexture() const;
 
+    /**
+     * \return `true` if cube map faces should be rendered in a single pass
+     */
+    bool useLayeredCubemapRendering() const;
+
+    /**
+     * \return How the resolution of the cube map faces is chosen
+     */
+    CubemapResolution cubemapResolution() const;
+
+    /**
+     * \return The largest number of pixels rendered for a cube map with a pixel budget
+     */
+    int64_t cubemapPixelBudget() const;
+
     /**
      * \return The number of capture threads (for screenshot recording)
      */
     int numberCaptureThreads() const;
 
+    /**
+     * \return The number of threads used to decode asynchronously loaded textures
+     */
+    int numberTextureLoadThreads() const;
+
+    /**
+     * \return The time budget in milliseconds per frame for texture uploads
+     */
+    double textureUploadBudget() const;
+
+    /**
+     * \return The GPU memory budget in bytes for cached textures
+     */
+    size_t textureMemoryBudget() const;
+
+    /**
+     * \return The folder for decoded images or an empty path if the cache is disabled
+     */
+    const std::filesystem::path& textureCachePath() const;
+
     /**
      * \return Should screenshots contain the node name
      */
@@ -236,12 +491,30 @@ private:
     int _swapInterval = 1;
     int _refreshRate = 0;
     int _nCaptureThreads = std::max(std::thread::hardware_concurrency() - 1, 0u);
+    int _nTextureLoadThreads = std::max(std::thread::hardware_concurrency() / 2, 1u);
+    double _textureUploadBudget = 2.0;
+    size_t _textureMemoryBudget = 0;
+    std::filesystem::path _textureCachePath;
 
     bool _useDepthTexture = false;
     bool _useNormalTexture = false;
     bool _usePositionTexture = false;
+    bool _useLayeredCubemapRendering = false;
+    CubemapResolution _cubemapResolution = CubemapResolution::Fixed;
+    int64_t _cubemapPixelBudget = 4 * 1024 * 1024;
     bool _captureBackBuffer = false;
     bool _exportWarpingMeshes = false;
+    bool _useWarpingMeshCache = true;
+    float _warpingMeshSimplificationError = 0.f;
+    bool _useWarpingLookupTexture = false;
+    bool _optimizeWarpingMeshes = false;
+    bool _useCompactWarpingMeshVertices = false;
+    HotReload _hotReload = HotReload::Disabled;
+    bool _useEventDrivenTracking = false;
+    std::filesystem::path _trackingRecordPath;
+    std::filesystem::path _trackingReplayPath;
+    TrackingReplaySpeed _trackingReplaySpeed = TrackingReplaySpeed::Original;
+    bool _useHeadlessRendering = false;
 
     struct Capture {
         std::filesystem::path capturePath;
@@ -13,6 +13,7 @@
 #include <sgct/mutexes.h>
 #include <sgct/network.h>
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <string>
 #include <string_view>
@@ -46,6 +47,21 @@ public:
     int dataSize();
     int bufferSize();
 
+    /**
+     * Sets the counter that the master increments whenever the files used by the
+     * viewports changed and have to be reloaded by all nodes. With
+     * Settings::HotReload::Cluster, which all nodes have to use, the counter is
+     * transmitted to the clients with every synchronization before the application's
+     * data. Otherwise, the synchronization only contains the application's data.
+     */
+    void setReloadCounter(uint32_t counter);
+
+    /**
+     * \return The last reload counter that was set on the master or received from the
+     *         master on a client
+     */
+    uint32_t reloadCounter() const;
+
 private:
     SharedData();
 
@@ -55,6 +71,7 @@ private:
     static SharedData* _instance;
     std::vector<std::byte> _dataBlock;
     std::array<std::byte, Network::HeaderSize> _headerSpace;
+    std::atomic<uint32_t> _reloadCounter = 0;
 };
 
 template <typename T>
@@ -10,7 +10,16 @@
 #define __SGCT__TEXTUREMANAGER__H__
 
 #include <sgct/sgctexports.h>
+#include <array>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace sgct {
@@ -19,15 +28,44 @@ class Image;
 
 /**
  * The TextureManager loads and handles textures. It is a singleton and can be accessed
- * anywhere using its static instance. Currently only PNG textures are supported.
+ * anywhere using its static instance.
+ *
+ * Textures that are loaded from a file are cached by their path, their modification
+ * time, and their sampling parameters. Loading the same file again returns the same
+ * texture and increases its reference count, which is decreased by #removeTexture.
+ * Textures that are no longer referenced stay in the cache until the memory of all
+ * textures exceeds Settings::textureMemoryBudget, at which point the least recently used
+ * ones are deleted. If Settings::textureCachePath is set, decoded images are also stored
+ * on disk so that later runs can skip decoding the image files.
+ *
+ * Files with the `.dds` or `.ktx2` extension are loaded as a CompressedImage and their
+ * BC1, BC3, or BC7 blocks are uploaded without decompression, including the mipmap
+ * levels stored in the file.
  */
 class SGCT_EXPORT TextureManager {
 public:
+    /**
+     * The handle to a texture that is loaded through #loadTextureAsync.
+     */
+    struct AsyncTexture {
+        /// The OpenGL name of the texture. The name is valid immediately and the texture
+        /// contains a placeholder until the image has been uploaded, after which the
+        /// same name refers to the loaded image
+        unsigned int id = 0;
+
+        /// Becomes ready once the image has been uploaded. If the image could not be
+        /// loaded, the future holds the exception that describes the error and the
+        /// texture keeps the placeholder. The failed texture is not cached, so loading
+        /// the same file again retries instead of returning the placeholder
+        std::shared_future<void> loaded;
+    };
+
     static TextureManager& instance();
     static void destroy();
 
     /**
-     * Loads a texture to the TextureManager.
+     * Loads a texture to the TextureManager. If the same file was already loaded with the
+     * same parameters and has not been modified since, the cached texture is returned.
      *
      * \param filename The path to the texture
      * \param interpolate Set to true for using interpolation (bi-linear filtering)
@@ -55,17 +93,108 @@ public:
         float anisotropicFilterSize = 1.f, int mipmapLevels = 8);
 
     /**
-     * Removes a previously generated OpenGL texture.
+     * Loads a texture to the TextureManager without blocking the calling thread. The
+     * file is memory-mapped and decoded on one of the texture load threads (see
+     * Settings::setNumberOfTextureLoadThreads) and the decoded image is uploaded through
+     * a ring of pixel buffer objects in #processUploads. Until then, the returned
+     * texture contains a single placeholder texel. Textures are shared with #loadTexture
+     * through the same cache.
+     *
+     * \param path The path to the texture
+     * \param interpolate Set to true for using interpolation (bi-linear filtering)
+     * \param anisotropicFilterSize The filter size that is used for the anisotropic
+     *        filtering. If this value is 1.f, only bilinear filtering is used
+     * \param mipmapLevels The number of mipmap levels that will be generated, setting
+     *        this value to 1 or less disables mipmaps
+     * \return The handle to the texture that is being loaded
+     */
+    AsyncTexture loadTextureAsync(std::filesystem::path path,
+        bool interpolate = true, float anisotropicFilterSize = 1.f, int mipmapLevels = 8);
+
+    /**
+     * Uploads the textures whose images have finished decoding. The uploads stop once
+     * the per-frame budget (see Settings::setTextureUploadBudget) has been used up and
+     * the remaining textures are uploaded in later calls. This function is called by the
+     * Engine once per frame with the shared OpenGL context active.
+     */
+    void processUploads();
+
+    /**
+     * \return The number of textures that were requested through #loadTextureAsync but
+     *         have not been uploaded yet
+     */
+    int numberOfPendingTextures() const;
+
+    /**
+     * Releases a reference to a previously generated OpenGL texture. The texture is
+     * deleted once it is no longer referenced and it is either not cached or evicted from
+     * the cache. A texture that was not created by the texture manager is deleted
+     * immediately.
      *
-     * \param textureId The id of the texture that should be deleted, this has to be an id
-     *        that was returned from a previous call to loadTexture
+     * \param textureId The id of the texture that should be deleted
      */
     void removeTexture(unsigned int textureId);
 
+    /**
+     * \return The estimated GPU memory in bytes used by all textures, including cached
+     *         textures that are no longer referenced
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * \return The estimated GPU memory in bytes used by the texture with the provided
+     *         \p textureId or 0 if the texture does not exist
+     */
+    size_t memoryUsage(unsigned int textureId) const;
+
 private:
+    /// Contains all information about a texture that is loaded asynchronously
+    struct PendingTexture;
+
+    /// A pixel buffer object in the staging ring that is used for the uploads
+    struct StagingBuffer {
+        unsigned int pbo = 0;
+        size_t size = 0;
+        /// The GLsync object that is signalled once the last upload from the PBO is done
+        void* fence = nullptr;
+    };
+
+    struct TextureInfo {
+        /// The key in the cache or empty if the texture was not created from a file
+        std::string key;
+        int refCount = 0;
+        size_t memory = 0;
+        /// The value of the usage counter when the texture was last requested
+        uint64_t lastUsed = 0;
+        /// `true` while the image of an asynchronously loaded texture is not uploaded
+        bool isPending = false;
+        std::shared_future<void> loaded;
+    };
+
     ~TextureManager();
+    void decodeLoop();
+    bool uploadPendingTexture(PendingTexture& texture);
+
+    unsigned int acquireCachedTexture(const std::string& key);
+    TextureInfo& addTexture(unsigned int textureId, std::string key, size_t memory);
+    void evictTextures();
+
     static TextureManager* _instance;
-    std::vector<unsigned int> _textures;
+    std::map<unsigned int, TextureInfo> _textures;
+    std::map<std::string, unsigned int> _cache;
+    size_t _memoryUsage = 0;
+    uint64_t _usageCounter = 0;
+
+    std::vector<std::thread> _decodeThreads;
+    mutable std::mutex _pendingMutex;
+    std::condition_variable _decodeCondition;
+    std::deque<std::unique_ptr<PendingTexture>> _decodeQueue;
+    std::deque<std::unique_ptr<PendingTexture>> _uploadQueue;
+    int _nPendingTextures = 0;
+    bool _isShuttingDown = false;
+
+    std::array<StagingBuffer, 4> _stagingBuffers;
+    size_t _nextStagingBuffer = 0;
 };
 
 } // namespace sgct
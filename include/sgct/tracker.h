@@ -10,9 +10,13 @@
 #define __SGCT__TRACKER__H__
 
 #include <sgct/sgctexports.h>
+#include <sgct/config.h>
 #include <sgct/math.h>
+#include <sgct/seqlock.h>
 #include <sgct/trackingdevice.h>
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -25,7 +29,7 @@ class SGCT_EXPORT Tracker {
 public:
     explicit Tracker(std::string name);
     Tracker(const Tracker&) = delete;
-    Tracker(Tracker&&) = default;
+    Tracker(Tracker&&) = delete;
     Tracker& operator=(const Tracker&) = delete;
     Tracker& operator=(Tracker&&) = delete;
 
@@ -58,6 +62,14 @@ public:
     mat4 getTransform() const;
     double scale() const;
 
+    /**
+     * Sets how the pose of the head device is predicted when this tracker tracks the
+     * user's head, or disables the prediction if \p prediction is `std::nullopt`. The
+     * prediction is applied when the sampling starts.
+     */
+    void setPrediction(std::optional<config::Tracker::Prediction> prediction);
+    const std::optional<config::Tracker::Prediction>& prediction() const;
+
     const std::string& name() const;
 
 private:
@@ -65,10 +77,12 @@ private:
 
     std::vector<std::unique_ptr<TrackingDevice>> _trackingDevices;
 
-    double _scale = 1.0;
-    mat4 _transform = mat4(1.f);
+    /// The scale and the transform are read by the sampling thread
+    std::atomic<double> _scale = 1.0;
+    SeqLock<mat4> _transform { mat4(1.f) };
     mat4 _orientation = mat4(1.f);
     vec3 _offset = vec3{ 0.f, 0.f, 0.f };
+    std::optional<config::Tracker::Prediction> _prediction;
 };
 
 } // namespace sgct
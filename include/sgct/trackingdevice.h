@@ -11,16 +11,68 @@
 
 #include <sgct/sgctexports.h>
 #include <sgct/math.h>
+#include <sgct/seqlock.h>
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace sgct {
 
 /**
- * Helper class that holds tracking device/sensor data.
+ * Helper class that holds tracking device/sensor data. The data is written by the VRPN
+ * sampling thread and read by the render thread. Each part of the data is stored in its
+ * own SeqLock, so that the readers never block the sampling thread and the devices do
+ * not contend with each other.
  */
 class SGCT_EXPORT TrackingDevice {
 public:
+    /**
+     * A sample of the sensor of this device together with the previous sample. All values
+     * of a Pose belong to the same pair of samples.
+     */
+    struct Pose {
+        /// The sensor's transform matrix in world coordinates
+        mat4 worldTransform = mat4(1.f);
+        mat4 worldTransformPrevious = mat4(1.f);
+
+        /// The raw sensor rotation quaternion
+        quat sensorRotation = quat{ 0.f, 0.f, 0.f, 0.f };
+        quat sensorRotationPrevious = quat{ 0.f, 0.f, 0.f, 0.f };
+
+        /// The raw sensor position vector
+        vec3 sensorPosition = vec3{ 0.f, 0.f, 0.f };
+        vec3 sensorPositionPrevious = vec3{ 0.f, 0.f, 0.f };
+
+        /// The time at which the samples were received
+        double time = 0.0;
+        double timePrevious = 0.0;
+    };
+
+    /**
+     * A sample of the sensor of this device as it was received from the tracking system.
+     */
+    struct Sample {
+        /// The raw sensor position vector
+        vec3 sensorPosition = vec3{ 0.f, 0.f, 0.f };
+
+        /// The raw sensor rotation quaternion
+        quat sensorRotation = quat{ 0.f, 0.f, 0.f, 0.f };
+
+        /// The time in seconds at which the tracking system created the sample, measured
+        /// with the clock of the tracking system
+        double sourceTime = 0.0;
+
+        /// The time at which the sample was received, see sgct::time
+        double receiveTime = 0.0;
+    };
+
+    /// The number of samples that are kept in the history of each device
+    static constexpr int HistorySize = 128;
+
     /**
      * Constructor.
      */
@@ -45,7 +97,16 @@ public:
      * Set the number of analog axes.
      */
     void setNumberOfAxes(int numOfAxes);
-    void setSensorTransform(vec3 vec, quat rot);
+
+    /**
+     * Sets the raw sensor position and rotation and adds them to the history of samples.
+     * The \p sourceTime is the time at which the tracking system created the sample,
+     * measured with its own clock. If it is not provided, the time at which the sample
+     * was received is used instead.
+     */
+    void setSensorTransform(vec3 vec, quat rot,
+        std::optional<double> sourceTime = std::nullopt);
+
     void setButtonValue(bool val, int index);
     void setAnalogValue(const double* array, int size);
 
@@ -69,6 +130,43 @@ public:
      */
     void setTransform(mat4 mat);
 
+    /**
+     * \return The latest and the previous sample of the sensor
+     */
+    Pose pose() const;
+
+    /**
+     * \return The samples of the sensor that are still in the history, ordered from the
+     *         oldest to the newest sample
+     */
+    std::vector<Sample> history() const;
+
+    /**
+     * Returns the sensor sample at the \p time, which is interpolated between the two
+     * samples in the history that surround it. The \p time is measured with the clock of
+     * sgct::time, such as the predicted time at which the next frame is displayed. It is
+     * converted into the clock of the tracking system with the smallest difference
+     * between the receive time and the source time in the history, which is the
+     * difference for the samples with the least transport latency. Times before the
+     * oldest or after the newest sample are clamped to that sample.
+     *
+     * \return The interpolated sample or `std::nullopt` if no sample has been received
+     */
+    std::optional<Sample> sampleAt(double time) const;
+
+    /**
+     * \return The sensor's transform matrix in world coordinates at the \p time, see
+     *         #sampleAt, or `std::nullopt` if no sample has been received
+     */
+    std::optional<mat4> worldTransformAt(double time) const;
+
+    /**
+     * \return The transform matrix in world coordinates for a sensor at the \p position
+     *         with the \p rotation, such as a predicted pose, or `std::nullopt` if the
+     *         device does not belong to a tracker
+     */
+    std::optional<mat4> sensorToWorld(const vec3& position, const quat& rotation) const;
+
     const std::string& name() const;
     int numberOfButtons() const;
     int numberOfAxes() const;
@@ -176,12 +274,33 @@ public:
     double buttonDeltaTime(int index) const;
 
 private:
+    struct Button {
+        bool value = false;
+        bool valuePrevious = false;
+        double time = 0.0;
+        double timePrevious = 0.0;
+    };
+
+    struct Axis {
+        double value = 0.0;
+        double valuePrevious = 0.0;
+    };
+
+    struct TimeStamp {
+        double time = 0.0;
+        double timePrevious = 0.0;
+    };
+
+    struct HistoryEntry {
+        Sample sample;
+        /// The number of samples that were received before this sample, which identifies
+        /// entries that were overwritten by newer samples while they were read
+        uint64_t index = 0;
+    };
+
     void calculateTransform();
-    void setTrackerTimeStamp();
-    void setAnalogTimeStamp();
-    void setButtonTimeStamp(int index);
 
-    bool _isEnabled = true;
+    std::atomic_bool _isEnabled = true;
     const std::string _name;
 #ifdef SGCT_HAS_VRPN
     const int _parentIndex; // the index of parent Tracker
@@ -190,31 +309,21 @@ private:
     int _nAxes = 0;
     int _sensorId = -1;
 
-    mat4 _deviceTransform = mat4(1.f);
-
-    mat4 _worldTransform = mat4(1.f);
-    mat4 _worldTransformPrevious = mat4(1.f);
-
-    quat _sensorRotation = quat{ 0.f, 0.f, 0.f, 0.f };
-    quat _sensorRotationPrevious = quat{ 0.f, 0.f, 0.f, 0.f };
-
-    vec3 _sensorPos = vec3{ 0.f, 0.f, 0.f };
-    vec3 _sensorPosPrevious = vec3{ 0.f, 0.f, 0.f };
+    SeqLock<mat4> _deviceTransform { mat4(1.f) };
     quat _orientation = quat{ 0.f, 0.f, 0.f, 0.f };
     vec3 _offset = vec3{ 0.f, 0.f, 0.f };
 
-    double _trackerTime = 0.0;
-    double _trackerTimePrevious = 0.0;
+    SeqLock<Pose> _pose;
 
-    double _analogTime = 0.0;
-    double _analogTimePrevious = 0.0;
+    /// Ring buffer of the latest samples, which is only written by the sampling thread
+    std::array<SeqLock<HistoryEntry>, HistorySize> _history;
+    std::atomic<uint64_t> _nSamples = 0;
 
-    std::vector<double> _buttonTime;
-    std::vector<double> _buttonTimePrevious;
-    std::vector<bool> _buttons;
-    std::vector<bool> _buttonsPrevious;
-    std::vector<double> _axes;
-    std::vector<double> _axesPrevious;
+    /// The buttons and axes are allocated when the device is configured, before the
+    /// sampling thread is started
+    std::unique_ptr<SeqLock<Button>[]> _buttons;
+    std::unique_ptr<SeqLock<Axis>[]> _axes;
+    SeqLock<TimeStamp> _analogTime;
 };
 
 } // namespace sgct
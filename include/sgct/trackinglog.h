@@ -0,0 +1,158 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__TRACKINGLOG__H__
+#define __SGCT__TRACKINGLOG__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/math.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+namespace sgct {
+
+class Tracker;
+class TrackingDevice;
+
+/**
+ * The sensor, button, and analog updates of the tracking devices in the order in which
+ * they were received, which can be recorded with the TrackingRecorder and replayed with
+ * the TrackingPlayer to reproduce a tracked session without the tracking system.
+ */
+struct SGCT_EXPORT TrackingLog {
+    /// Identifies a device by the name of its tracker and its own name, so that a log can
+    /// be replayed with any configuration that contains the same trackers and devices
+    struct Device {
+        std::string tracker;
+        std::string device;
+    };
+
+    // The events have no default member initializers as they are alternatives of the
+    // variant, which has to be default constructible inside of this struct
+    struct Sensor {
+        vec3 position;
+        quat rotation;
+        /// The time at which the tracking system created the sample
+        double sourceTime;
+    };
+
+    struct Button {
+        int index;
+        bool value;
+    };
+
+    struct Analog {
+        std::vector<double> values;
+    };
+
+    struct Event {
+        /// The index of the device in the #devices
+        int device = 0;
+        /// The time in seconds since the recording started
+        double time = 0.0;
+        std::variant<Sensor, Button, Analog> data;
+    };
+
+    std::vector<Device> devices;
+    std::vector<Event> events;
+};
+
+/**
+ * Reads the tracking log at \p path that was written by a TrackingRecorder. If the last
+ * event was only partially written, for example because the application crashed while
+ * recording, the log ends with the last complete event.
+ *
+ * \throw sgct::Error If the file could not be opened or is not a valid tracking log
+ */
+SGCT_EXPORT TrackingLog readTrackingLog(const std::filesystem::path& path);
+
+/**
+ * Records the updates of tracking devices into a compact binary log. The record functions
+ * can be called from multiple sampling threads at the same time.
+ */
+class SGCT_EXPORT TrackingRecorder {
+public:
+    /**
+     * Creates the log at \p path, which contains all devices of the \p trackers, and
+     * starts the clock of the recording.
+     *
+     * \throw sgct::Error If the file could not be created
+     */
+    TrackingRecorder(const std::filesystem::path& path,
+        const std::vector<std::unique_ptr<Tracker>>& trackers);
+
+    void recordSensor(const TrackingDevice& device, vec3 position, quat rotation,
+        double sourceTime);
+    void recordButton(const TrackingDevice& device, int index, bool value);
+    void recordAnalog(const TrackingDevice& device, const double* values, int size);
+
+private:
+    void write(const TrackingDevice& device, const TrackingLog::Event& event);
+
+    std::mutex _mutex;
+    std::ofstream _file;
+    std::unordered_map<const TrackingDevice*, int> _deviceIndices;
+    const double _startTime;
+};
+
+/**
+ * Replays a TrackingLog through the setters of the tracking devices, which makes the
+ * devices behave as if the updates were received from the tracking system.
+ */
+class SGCT_EXPORT TrackingPlayer {
+public:
+    /**
+     * Prepares the replay of the \p log into the devices of the \p trackers. Devices of
+     * the log that do not exist in the \p trackers are skipped with a warning.
+     */
+    TrackingPlayer(TrackingLog log,
+        const std::vector<std::unique_ptr<Tracker>>& trackers);
+
+    /**
+     * Applies all events that were recorded up to the \p time, in seconds since the start
+     * of the recording, and that have not been applied yet.
+     */
+    void advance(double time);
+
+    /**
+     * Applies the next event regardless of its time.
+     */
+    void step();
+
+    /**
+     * \return `true` if all events have been applied
+     */
+    bool isDone() const;
+
+    /**
+     * \return The recording time of the next event that will be applied or the duration
+     *         of the recording if all events have been applied
+     */
+    double nextEventTime() const;
+
+    /**
+     * \return The time of the last event of the recording
+     */
+    double duration() const;
+
+private:
+    const TrackingLog _log;
+    /// The devices in the same order as the devices of the log
+    std::vector<TrackingDevice*> _devices;
+    size_t _next = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__TRACKINGLOG__H__
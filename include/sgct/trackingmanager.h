@@ -10,8 +10,11 @@
 #define __SGCT__TRACKINGMANAGER__H__
 
 #include <sgct/sgctexports.h>
+#include <sgct/posefilter.h>
 #include <sgct/tracker.h>
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string_view>
 #include <thread>
@@ -41,9 +44,13 @@ public:
     void startSampling();
 
     /**
-     * Update the user position if headtracking is used. The engine calls this function.
+     * Update the user position if headtracking is used. The engine calls this function
+     * with the \p swapTime at which the frame that is about to be rendered is expected to
+     * be shown, which is the time the head pose is predicted for if the head tracker has
+     * a prediction. If a tracking log is replayed, the events for this frame are applied
+     * to the devices first.
      */
-    void updateTrackingDevices();
+    void updateTrackingDevices(double swapTime);
     void addTracker(std::string name);
 
     TrackingDevice* headDevice() const;
@@ -64,19 +71,25 @@ private:
 
     Tracker* tracker(std::string_view name) const;
 
+    /// Feeds the new samples of the head device to the filter and returns the world
+    /// transform that is predicted for the \p swapTime
+    std::optional<mat4> predictHead(double swapTime);
+
     void addDeviceToCurrentTracker(std::string name);
     void addSensorToCurrentDevice(std::string address, int id);
     void addButtonsToCurrentDevice(std::string address, int nButtons);
     void addAnalogsToCurrentDevice(std::string address, int nAxes);
 
-    std::unique_ptr<std::thread> _samplingThread;
+    std::vector<std::thread> _samplingThreads;
     std::vector<std::unique_ptr<Tracker>> _trackers;
     std::set<std::string> _addresses;
-    double _samplingTime = 0.0;
-    bool _isRunning = true;
+    std::atomic<double> _samplingTime = 0.0;
+    std::atomic_bool _isRunning = true;
 
     User* _headUser = nullptr;
     TrackingDevice* _head = nullptr;
+    std::unique_ptr<PoseFilter> _headFilter;
+    float _headLatency = 0.f;
 };
 
 } // namespace sgct
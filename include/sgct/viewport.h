@@ -12,8 +12,12 @@
 #include <sgct/sgctexports.h>
 #include <sgct/baseviewport.h>
 #include <sgct/correctionmesh.h>
+#include <sgct/texturemanager.h>
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -45,8 +49,45 @@ public:
         unsigned int format, unsigned int type, int samples);
 
     void applyViewport(const sgct::config::Viewport& viewport);
+
+    /**
+     * Starts parsing the correction mesh of this viewport on a worker thread. The parsed
+     * mesh is then only uploaded in #loadData. Calling this function is optional, if it
+     * was not called, the mesh is parsed in #loadData instead.
+     */
+    void beginLoadData();
     void loadData();
 
+    /**
+     * \return The paths of the correction mesh and of the overlay and mask textures of
+     *         this viewport that can be reloaded with #beginReloadData
+     */
+    std::vector<std::filesystem::path> dataFiles() const;
+
+    /**
+     * Starts reloading the correction mesh and the textures of this viewport whose paths
+     * are contained in \p files. The files are parsed on background threads while the
+     * previous mesh and textures continue to be used until #finishReloadData replaces
+     * them. Files that are not used by this viewport are ignored.
+     */
+    void beginReloadData(std::span<const std::filesystem::path> files);
+
+    /**
+     * Replaces the correction mesh and the textures whose reload has finished. The old
+     * data is kept if a file could not be parsed. This function requires the OpenGL
+     * context of the parent window to be active, as the correction mesh is not shared
+     * between contexts.
+     *
+     * \return `true` if anything was replaced
+     */
+    bool finishReloadData();
+
+    /**
+     * \return `true` while a reload that was started with #beginReloadData has not been
+     *         finished by #finishReloadData
+     */
+    bool isReloadingData() const;
+
     /**
      * Render the viewport mesh which the framebuffer texture is attached to.
      */
@@ -62,6 +103,12 @@ public:
      */
     void renderMaskMesh() const;
 
+    /**
+     * Bakes the correction mesh again if it was baked into a lookup texture for a back
+     * buffer with a different \p resolution, see CorrectionMesh::updateBakedWarp.
+     */
+    void updateBakedWarp(ivec2 resolution);
+
     bool hasOverlayTexture() const;
     bool hasBlendMaskTexture() const;
     bool hasBlackLevelMaskTexture() const;
@@ -83,6 +130,19 @@ private:
     void applyTextureProjection(const config::TextureMappedProjection& proj);
 
     CorrectionMesh _mesh;
+    std::future<CorrectionMesh::MeshData> _meshData;
+    /// The values of this viewport with which the mesh in _meshData is parsed
+    CorrectionMesh::ViewportSetup _meshDataSetup;
+
+    struct PendingReload {
+        std::future<CorrectionMesh::MeshData> mesh;
+        // Set if the mesh changed again while it was being reloaded
+        bool isMeshOutdated = false;
+        std::optional<TextureManager::AsyncTexture> overlay;
+        std::optional<TextureManager::AsyncTexture> blendMask;
+        std::optional<TextureManager::AsyncTexture> blackLevelMask;
+    };
+    PendingReload _reload;
     std::filesystem::path _overlayFilename;
     std::filesystem::path _blendMaskFilename;
     std::filesystem::path _blackLevelMaskFilename;
@@ -0,0 +1,345 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#ifndef __SGCT__VIRTUALTEXTURE__H__
+#define __SGCT__VIRTUALTEXTURE__H__
+
+#include <sgct/sgctexports.h>
+#include <sgct/mappedfile.h>
+#include <sgct/math.h>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace sgct {
+
+class Image;
+
+/**
+ * Identifies a single tile of a TilePyramid. Level 0 is the full resolution image and the
+ * tile (0, 0) is the bottom-left tile of each level.
+ */
+struct SGCT_EXPORT TileId {
+    int level = 0;
+    int x = 0;
+    int y = 0;
+
+    auto operator<=>(const TileId&) const = default;
+};
+
+/**
+ * The layout of the tiles of a mipmapped image. Every level is half the size of the
+ * previous level (rounded down) and is split into tiles of `tileSize` x `tileSize`
+ * pixels. The last level is the first one that fits into a single tile.
+ */
+struct SGCT_EXPORT TileLayout {
+    ivec2 size = ivec2(0, 0);
+    int tileSize = 256;
+    /// The number of pixels that are duplicated from the neighboring tiles on each side
+    /// of a tile so that bilinear filtering does not show seams between tiles
+    int border = 1;
+    int nLevels = 0;
+
+    /**
+     * \return A layout for an image of the provided \p size with all levels computed
+     */
+    static TileLayout create(ivec2 size, int tileSize, int border = 1);
+
+    /**
+     * \return The size in pixels of the mipmap \p level
+     */
+    ivec2 levelSize(int level) const;
+
+    /**
+     * \return The number of tiles in x and y of the mipmap \p level
+     */
+    ivec2 tiles(int level) const;
+
+    /**
+     * \return The number of bytes of a single tile including its border
+     */
+    size_t tileBytes() const;
+};
+
+/**
+ * A mipmap pyramid of tiles that is stored in a single file on disk. The pixels of each
+ * tile are stored as BGRA with 8 bits per channel, in the same bottom to top row order as
+ * the Image. The file is memory-mapped, so reading a tile only touches the pages that
+ * belong to that tile.
+ */
+class SGCT_EXPORT TilePyramid {
+public:
+    /**
+     * Splits the \p image into tiles for all mipmap levels and writes them into the
+     * pyramid file at \p path. The image must have 3 or 4 channels with 8 bits per
+     * channel. The mipmap levels are generated with a box filter.
+     *
+     * \param image The full resolution image
+     * \param path The path of the pyramid file that is created
+     * \param tileSize The size of the tiles in pixels, not including the border
+     */
+    static void build(const Image& image, const std::filesystem::path& path,
+        int tileSize = 256);
+
+    /**
+     * Opens an existing pyramid \p path that was created by #build.
+     *
+     * \throw Error If the file does not exist or is not a valid pyramid
+     */
+    explicit TilePyramid(const std::filesystem::path& path);
+
+    const TileLayout& layout() const;
+
+    /**
+     * Copies the pixels of the \p tile, including its border, into \p buffer, which must
+     * be at least TileLayout::tileBytes bytes large. This function can be called from
+     * multiple threads at the same time.
+     */
+    void readTile(TileId tile, std::byte* buffer) const;
+
+private:
+    MappedFile _file;
+    TileLayout _layout;
+    /// The index of the first tile of each level in the file
+    std::vector<size_t> _levelOffsets;
+};
+
+/**
+ * Describes how the directions of the viewer map into the texture coordinates of a
+ * virtual texture.
+ */
+enum class TextureMapping {
+    /// An azimuthal equidistant dome master as it is used by utils::Dome, with the zenith
+    /// (+y) in the center of the image
+    Fisheye,
+    /// A latitude-longitude panorama with -z in the horizontal center of the image
+    Equirectangular
+};
+
+/**
+ * Determines which tiles of the virtual texture with the \p layout are visible from the
+ * views described by the \p viewProjections. For fisheye and cubemap rendering, these
+ * are the matrices of all rendered cube faces. Each view is sampled on a regular grid
+ * and the mipmap level of each grid cell is chosen so that one texel covers at most one
+ * pixel of the rendering with the \p resolution. This function does not require an
+ * OpenGL context.
+ *
+ * \param layout The layout of the tile pyramid
+ * \param viewProjections The view-projection matrices of all views
+ * \param resolution The resolution in pixels of each view
+ * \param mapping The mapping from view direction to texture coordinates
+ * \param fov The field of view in degrees of the fisheye mapping
+ * \return The sorted list of unique tiles that are visible
+ */
+SGCT_EXPORT std::vector<TileId> selectVisibleTiles(const TileLayout& layout,
+    std::span<const mat4> viewProjections, ivec2 resolution,
+    TextureMapping mapping = TextureMapping::Fisheye, float fov = 180.f);
+
+/**
+ * The residency management of a virtual texture that is independent of OpenGL. Tiles
+ * that are requested are read from the TilePyramid by a pool of worker threads and,
+ * once collected, are assigned a slot in a square atlas of tiles. Tiles that are no
+ * longer requested are evicted from the atlas in least-recently-used order when a slot is
+ * needed. The coarsest level is always resident so that every lookup has a fallback.
+ *
+ * The page table contains one entry per tile for each level. Each entry is an RGBA8 value
+ * of the atlas slot x and y, the level of the tile that is stored in that slot, and 255
+ * for valid entries. Tiles that are not resident point to their closest resident
+ * ancestor.
+ */
+class SGCT_EXPORT TileCache {
+public:
+    /// A tile that was read from disk and assigned a slot in the atlas
+    struct LoadedTile {
+        TileId id;
+        ivec2 slot = ivec2(0, 0);
+        std::vector<std::byte> data;
+    };
+
+    /**
+     * \param path The path to the pyramid file created by TilePyramid::build
+     * \param atlasTiles The number of tile slots in each dimension of the atlas
+     * \param nThreads The number of worker threads that read the tiles
+     */
+    TileCache(const std::filesystem::path& path, int atlasTiles, int nThreads);
+    ~TileCache();
+
+    TileCache(const TileCache&) = delete;
+    TileCache& operator=(const TileCache&) = delete;
+
+    /**
+     * Marks the \p tiles and their ancestors as used in the current frame and queues
+     * all of them that are not resident yet for loading, coarser levels first. Tiles
+     * that were queued in earlier calls but are no longer requested are dropped from the
+     * queue.
+     */
+    void request(std::span<const TileId> tiles);
+
+    /**
+     * Returns up to \p maxTiles tiles that have been read by the worker threads since the
+     * last call, assigns their atlas slots, and updates the page table. The caller is
+     * responsible for copying the data into the atlas slot.
+     */
+    std::vector<LoadedTile> collectLoadedTiles(int maxTiles);
+
+    /**
+     * \return The number of tiles that are queued or currently being read
+     */
+    int numberOfPendingTiles() const;
+
+    bool isResident(TileId tile) const;
+    const TilePyramid& pyramid() const;
+    int atlasTiles() const;
+
+    /**
+     * \return The page table entries of the mipmap \p level with
+     *         TileLayout::tiles(level) entries in row-major order
+     */
+    const std::vector<uint32_t>& pageTable(int level) const;
+
+    /**
+     * \return `true` if the page table changed since the last call to #clearDirty
+     */
+    bool isDirty() const;
+    void clearDirty();
+
+private:
+    struct Resident {
+        ivec2 slot;
+        uint64_t lastUsed = 0;
+    };
+
+    void workerLoop();
+    void updatePageTable();
+
+    TilePyramid _pyramid;
+    int _atlasTiles = 0;
+    uint64_t _frame = 0;
+
+    std::map<TileId, Resident> _resident;
+    std::vector<ivec2> _freeSlots;
+    /// All tiles that were requested in the last call to #request
+    std::set<TileId> _needed;
+    std::vector<std::vector<uint32_t>> _pageTable;
+    bool _isDirty = true;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    std::deque<TileId> _queue;
+    /// Tiles that are queued or being read by a worker thread
+    std::set<TileId> _inFlight;
+    std::vector<std::pair<TileId, std::vector<std::byte>>> _loaded;
+    std::vector<std::thread> _threads;
+    bool _isShuttingDown = false;
+};
+
+/**
+ * A texture that can be larger than the maximum texture size and the available GPU
+ * memory by streaming only the visible tiles of a TilePyramid into an atlas texture. Each
+ * frame, the application determines the visible tiles, for example with
+ * #selectVisibleTiles, passes them to #request, and calls #update with the OpenGL
+ * context active. Shaders sample the texture through the function in #SamplerShader
+ * after the uniforms have been set with #bind.
+ */
+class SGCT_EXPORT VirtualTexture {
+public:
+    /**
+     * GLSL code that declares the uniforms and the `vec4 sampleVirtualTexture(vec2 uv)`
+     * function. It has to be included in a fragment shader after the `#version` line.
+     */
+    static constexpr std::string_view SamplerShader = R"(
+  uniform sampler2D vt_atlas;
+  uniform sampler2D vt_pageTable;
+  uniform vec2 vt_imageSize;
+  uniform float vt_tileSize;
+  uniform float vt_border;
+  uniform float vt_atlasTiles;
+  uniform float vt_maxLevel;
+
+  vec4 sampleVirtualTexture(vec2 uv) {
+    // Select the mipmap level from the screen-space derivatives of the texel position
+    vec2 texel = uv * vt_imageSize;
+    vec2 dx = dFdx(texel);
+    vec2 dy = dFdy(texel);
+    float lod = 0.5 * log2(max(max(dot(dx, dx), dot(dy, dy)), 1.0));
+    int level = int(min(floor(lod), vt_maxLevel));
+
+    vec2 levelSize = max(floor(vt_imageSize / exp2(float(level))), vec2(1.0));
+    ivec2 nTiles = ivec2(ceil(levelSize / vt_tileSize));
+    ivec2 tile = clamp(ivec2(floor(uv * levelSize / vt_tileSize)), ivec2(0), nTiles - 1);
+    vec4 entry = texelFetch(vt_pageTable, tile, level) * 255.0;
+    if (entry.a < 0.5) {
+      return vec4(0.0);
+    }
+
+    // The entry might point to a coarser tile if the requested one is not loaded
+    vec2 residentSize = max(floor(vt_imageSize / exp2(entry.z)), vec2(1.0));
+    vec2 inTile = clamp(
+      uv * residentSize - floor(uv * residentSize / vt_tileSize) * vt_tileSize,
+      vec2(0.0),
+      vec2(vt_tileSize)
+    );
+    float slotSize = vt_tileSize + 2.0 * vt_border;
+    vec2 pos = entry.xy * slotSize + vt_border + inTile;
+    return textureLod(vt_atlas, pos / (vt_atlasTiles * slotSize), 0.0);
+  }
+)";
+
+    /**
+     * Creates the atlas and page table textures. Requires an active OpenGL context.
+     *
+     * \param path The path to the pyramid file created by TilePyramid::build
+     * \param atlasTiles The number of tile slots in each dimension of the atlas
+     */
+    explicit VirtualTexture(const std::filesystem::path& path, int atlasTiles = 16);
+    ~VirtualTexture();
+
+    VirtualTexture(const VirtualTexture&) = delete;
+    VirtualTexture& operator=(const VirtualTexture&) = delete;
+
+    /**
+     * Requests the \p tiles for the current frame, see TileCache::request.
+     */
+    void request(std::span<const TileId> tiles);
+
+    /**
+     * Copies the tiles that have finished loading into the atlas and uploads the changed
+     * page table. The uploads stop when the time set by Settings::setTextureUploadBudget
+     * has been used up, but at least one batch of tiles is copied every frame.
+     */
+    void update();
+
+    /**
+     * Binds the atlas and page table to the texture units \p atlasUnit and
+     * \p pageTableUnit and sets the uniforms of #SamplerShader in the currently bound
+     * \p program.
+     */
+    void bind(unsigned int program, int atlasUnit = 0, int pageTableUnit = 1) const;
+
+    const TileLayout& layout() const;
+    const TileCache& cache() const;
+
+private:
+    TileCache _cache;
+    unsigned int _atlas = 0;
+    unsigned int _pageTable = 0;
+};
+
+} // namespace sgct
+
+#endif // __SGCT__VIRTUALTEXTURE__H__
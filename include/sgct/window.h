@@ -398,6 +398,21 @@ public:
      */
     ivec2 framebufferResolution() const;
 
+    /**
+     * \return The size of the back buffer in pixels, which the final pass renders into
+     *         through the correction meshes of the viewports
+     */
+    ivec2 backBufferResolution() const;
+
+    /**
+     * Binds the offscreen framebuffer that replaces the back buffer of the window when
+     * rendering headless, see Settings::setUseHeadlessRendering, for the \p eye. Each eye
+     * has its own framebuffer whose texture is attached only when it is created with the
+     * backBufferResolution. The framebuffers are created in the context of this window,
+     * which has to be current.
+     */
+    void bindHeadlessFramebuffer(Eye eye);
+
     /**
      * \return Get the initial window resolution
      */
@@ -520,6 +535,15 @@ private:
         unsigned int positions = 0;
     } _frameBufferTextures;
 
+    /// Replaces the default framebuffer, which does not exist when rendering headless
+    struct {
+        unsigned int leftFramebuffer = 0;
+        unsigned int rightFramebuffer = 0;
+        unsigned int leftEye = 0;
+        unsigned int rightEye = 0;
+        ivec2 resolution = ivec2{ 0, 0 };
+    } _headless;
+
     std::unique_ptr<ScreenCapture> _screenCaptureLeftOrMono;
     std::unique_ptr<ScreenCapture> _screenCaptureRight;
 
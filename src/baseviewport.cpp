@@ -16,6 +16,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/quaternion.hpp>
+#include <array>
 #include <stdexcept>
 #include <type_traits>
 
@@ -139,45 +140,86 @@ void BaseViewport::calculateFrustum(Frustum::Mode mode, float nearClip, float fa
 void BaseViewport::calculateNonLinearFrustum(Frustum::Mode mode, float nearClip,
                                              float farClip)
 {
-    const vec3& eyePos = _user->posMono();
+    BaseViewport* viewport = this;
+    calculateNonLinearFrustums(std::span(&viewport, 1), mode, nearClip, farClip);
+}
+
+void BaseViewport::calculateNonLinearFrustums(std::span<BaseViewport* const> viewports,
+                                              Frustum::Mode mode, float nearClip,
+                                              float farClip)
+{
+    ZoneScoped;
+
+    // Up to six faces of a cube map
+    constexpr size_t MaxViewports = 6;
+    if (viewports.empty()) {
+        return;
+    }
+    if (viewports.size() > MaxViewports) {
+        calculateNonLinearFrustums(
+            viewports.first(MaxViewports),
+            mode,
+            nearClip,
+            farClip
+        );
+        calculateNonLinearFrustums(
+            viewports.subspan(MaxViewports),
+            mode,
+            nearClip,
+            farClip
+        );
+        return;
+    }
+
+    const User& user = *viewports.front()->_user;
+    const vec3& eyePos = user.posMono();
 
+    vec3 offset = vec3{ 0.f, 0.f, 0.f };
     switch (mode) {
         case Frustum::Mode::MonoEye:
-            _monoProj.calculateProjection(
-                eyePos,
-                _projPlane,
-                nearClip,
-                farClip
-            );
             break;
         case Frustum::Mode::StereoLeftEye:
-        {
-            const vec3 p {
-                _user->posLeftEye().x - eyePos.x,
-                _user->posLeftEye().y - eyePos.y,
-                _user->posLeftEye().z - eyePos.z
+            offset = vec3{
+                user.posLeftEye().x - eyePos.x,
+                user.posLeftEye().y - eyePos.y,
+                user.posLeftEye().z - eyePos.z
             };
-            _stereoLeftProj.calculateProjection(eyePos, _projPlane, nearClip, farClip, p);
             break;
-        }
         case Frustum::Mode::StereoRightEye:
-        {
-            const vec3 p {
-                _user->posRightEye().x + eyePos.x,
-                _user->posRightEye().y + eyePos.y,
-                _user->posRightEye().z + eyePos.z
+            offset = vec3{
+                user.posRightEye().x + eyePos.x,
+                user.posRightEye().y + eyePos.y,
+                user.posRightEye().z + eyePos.z
             };
-
-            _stereoRightProj.calculateProjection(
-                eyePos,
-                _projPlane,
-                nearClip,
-                farClip,
-                p
-            );
             break;
+    }
+
+    std::array<Projection*, MaxViewports> projections;
+    std::array<const ProjectionPlane*, MaxViewports> planes;
+    for (size_t i = 0; i < viewports.size(); i++) {
+        BaseViewport& vp = *viewports[i];
+        switch (mode) {
+            case Frustum::Mode::MonoEye:
+                projections[i] = &vp._monoProj;
+                break;
+            case Frustum::Mode::StereoLeftEye:
+                projections[i] = &vp._stereoLeftProj;
+                break;
+            case Frustum::Mode::StereoRightEye:
+                projections[i] = &vp._stereoRightProj;
+                break;
         }
+        planes[i] = &vp._projPlane;
     }
+
+    Projection::calculateProjections(
+        std::span(projections.data(), viewports.size()),
+        std::span(planes.data(), viewports.size()),
+        eyePos,
+        nearClip,
+        farClip,
+        offset
+    );
 }
 
 void BaseViewport::setViewPlaneCoordsUsingFOVs(float up, float down, float left,
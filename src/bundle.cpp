@@ -0,0 +1,656 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/bundle.h>
+
+#ifdef WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define VC_EXTRALEAN
+    #define NOMINMAX
+    #include <Windows.h>
+    #include <winsock2.h>
+    #include <ws2tcpip.h>
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <sys/select.h>
+    #include <sys/time.h>
+    #include <netinet/in.h>
+    #include <netdb.h>
+    #include <unistd.h>
+    #define INVALID_SOCKET (~0)
+#endif
+
+#include <sgct/configsnapshot.h>
+#include <sgct/error.h>
+#include <sgct/fileutils.h>
+#include <sgct/format.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <zlib.h>
+
+#define Err(code, msg) sgct::Error(sgct::Error::Component::Network, code, msg)
+
+namespace {
+    // Increase this version whenever the layout of the bundle changes. The cluster inside
+    // the bundle is versioned separately by the snapshot serialization
+    constexpr uint32_t BundleVersion = 1;
+    constexpr std::array<char, 4> BundleMagic = { 'S', 'G', 'C', 'B' };
+
+    struct BundleHeader {
+        std::array<char, 4> magic = BundleMagic;
+        uint32_t version = BundleVersion;
+        uint64_t hash = 0;
+        uint64_t size = 0;
+        uint64_t compressedSize = 0;
+
+        bool operator==(const BundleHeader&) const = default;
+    };
+    static_assert(sizeof(BundleHeader) == 32);
+
+    // Clients only wait this long for the master to answer once they are connected
+    constexpr int ReceiveTimeout = 10;
+
+    // Sent by the client after receiving the header
+    constexpr char RequestBundle = 1;
+    constexpr char BundleIsCached = 0;
+
+    // Calls the function for every file that is referenced by the cluster. The paths of
+    // the SphericalMirrorProjection meshes are stored as strings, so they are converted
+    void forEachFile(sgct::config::Cluster& cluster,
+                     const std::function<void(std::filesystem::path&)>& fn)
+    {
+        using namespace sgct::config;
+
+        auto apply = [&fn](std::optional<std::filesystem::path>& path) {
+            if (path) {
+                fn(*path);
+            }
+        };
+        for (Node& node : cluster.nodes) {
+            for (Window& window : node.windows) {
+                for (Viewport& vp : window.viewports) {
+                    apply(vp.overlayTexture);
+                    apply(vp.blendMaskTexture);
+                    apply(vp.blackLevelMaskTexture);
+                    apply(vp.correctionMeshTexture);
+
+                    auto* mirror = std::get_if<SphericalMirrorProjection>(&vp.projection);
+                    if (!mirror) {
+                        continue;
+                    }
+                    SphericalMirrorProjection::Mesh& mesh = mirror->mesh;
+                    std::array<std::string*, 4> paths = {
+                        &mesh.bottom, &mesh.left, &mesh.right, &mesh.top
+                    };
+                    for (std::string* s : paths) {
+                        if (s->empty()) {
+                            continue;
+                        }
+                        std::filesystem::path path = *s;
+                        fn(path);
+                        *s = path.string();
+                    }
+                }
+            }
+        }
+    }
+
+    std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file = std::ifstream(path, std::ios::in | std::ios::binary);
+        if (file.fail()) {
+            throw Err(
+                5030,
+                std::format("Failed to read file '{}' for the configuration bundle", path)
+            );
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    void writeFile(const std::filesystem::path& path, std::span<const char> data) {
+        // Several nodes on the same computer can share the cache folder
+        const std::filesystem::path tmp = sgct::temporaryPath(path);
+        {
+            std::ofstream file = std::ofstream(tmp, std::ios::out | std::ios::binary);
+            file.write(data.data(), data.size());
+            if (!file.good()) {
+                file.close();
+                std::filesystem::remove(tmp);
+                throw Err(
+                    5033,
+                    std::format(
+                        "Failed to write file '{}' from the configuration bundle", path
+                    )
+                );
+            }
+        }
+        std::filesystem::rename(tmp, path);
+    }
+
+    void appendSize(std::string& output, uint64_t size) {
+        output.append(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+    }
+
+    void appendString(std::string& output, std::string_view str) {
+        appendSize(output, str.size());
+        output.append(str);
+    }
+
+    // Reads the parts of the uncompressed bundle and throws if the bundle ends early
+    class Reader {
+    public:
+        explicit Reader(std::string_view data) : _data(data) {}
+
+        uint64_t size() {
+            uint64_t v = 0;
+            std::memcpy(&v, bytes(sizeof(uint64_t)).data(), sizeof(uint64_t));
+            return v;
+        }
+
+        std::string_view string() {
+            return bytes(size());
+        }
+
+        bool isAtEnd() const {
+            return _data.empty();
+        }
+
+    private:
+        std::string_view bytes(uint64_t n) {
+            if (n > _data.size()) {
+                throw Err(5032, "Damaged configuration bundle");
+            }
+            std::string_view res = _data.substr(0, n);
+            _data.remove_prefix(n);
+            return res;
+        }
+
+        std::string_view _data;
+    };
+
+    void closeSocket(SGCT_SOCKET socket) {
+        if (socket == INVALID_SOCKET) {
+            return;
+        }
+#ifdef WIN32
+        closesocket(socket);
+#else
+        close(socket);
+#endif
+    }
+
+    void setReceiveTimeout(SGCT_SOCKET socket, int seconds) {
+#ifdef WIN32
+        const DWORD timeout = seconds * 1000;
+#else
+        const timeval timeout = { .tv_sec = seconds, .tv_usec = 0 };
+#endif
+        setsockopt(
+            socket,
+            SOL_SOCKET,
+            SO_RCVTIMEO,
+            reinterpret_cast<const char*>(&timeout),
+            sizeof(timeout)
+        );
+    }
+
+    bool sendAll(SGCT_SOCKET socket, std::span<const char> data) {
+#ifdef MSG_NOSIGNAL
+        // A client that disconnects during the transfer should not terminate the master
+        constexpr int Flags = MSG_NOSIGNAL;
+#else
+        constexpr int Flags = 0;
+#endif
+        constexpr size_t MaxChunk = 1 << 20;
+        while (!data.empty()) {
+            const int n = static_cast<int>(std::min(data.size(), MaxChunk));
+            const int sent = send(socket, data.data(), n, Flags);
+            if (sent <= 0) {
+                return false;
+            }
+            data = data.subspan(sent);
+        }
+        return true;
+    }
+
+    bool receiveAll(SGCT_SOCKET socket, std::span<char> data) {
+        constexpr size_t MaxChunk = 1 << 20;
+        while (!data.empty()) {
+            const int n = static_cast<int>(std::min(data.size(), MaxChunk));
+            const int received = recv(socket, data.data(), n, 0);
+            if (received <= 0) {
+                return false;
+            }
+            data = data.subspan(received);
+        }
+        return true;
+    }
+
+    void checkSize(const BundleHeader& header, uint64_t maxSize) {
+        const uint64_t size = std::max(header.size, header.compressedSize);
+        if (size > maxSize) {
+            throw Err(
+                5037,
+                std::format(
+                    "Configuration bundle of {} bytes exceeds the maximum of {} bytes",
+                    size, maxSize
+                )
+            );
+        }
+    }
+
+    std::optional<BundleHeader> readHeader(std::span<const char> bundle) {
+        if (bundle.size() < sizeof(BundleHeader)) {
+            return std::nullopt;
+        }
+        BundleHeader header;
+        std::memcpy(&header, bundle.data(), sizeof(BundleHeader));
+        if (header.magic != BundleMagic || header.version != BundleVersion) {
+            return std::nullopt;
+        }
+        return header;
+    }
+
+    // Returns the cached bundle if it is the same as the one described by the header
+    std::vector<char> readCachedBundle(const std::filesystem::path& path,
+                                       const BundleHeader& header)
+    {
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(path, ec);
+        if (ec || size != sizeof(BundleHeader) + header.compressedSize) {
+            return {};
+        }
+        std::ifstream file = std::ifstream(path, std::ios::in | std::ios::binary);
+        std::vector<char> bundle = std::vector<char>(size);
+        file.read(bundle.data(), bundle.size());
+        if (file.gcount() != static_cast<std::streamsize>(size) ||
+            readHeader(bundle) != header)
+        {
+            return {};
+        }
+        return bundle;
+    }
+} // namespace
+
+namespace sgct {
+
+// Windows requires the socket library to be initialized before it is used. The
+// initialization is reference counted, so it does not interfere with the NetworkManager
+struct SocketLibrary {
+    SocketLibrary() {
+#ifdef WIN32
+        WSADATA data;
+        WSAStartup(MAKEWORD(2, 2), &data);
+#endif // WIN32
+    }
+
+    ~SocketLibrary() {
+#ifdef WIN32
+        WSACleanup();
+#endif // WIN32
+    }
+};
+
+std::vector<std::filesystem::path> bundleFiles(const config::Cluster& cluster) {
+    std::vector<std::filesystem::path> res;
+    // forEachFile can modify the paths, so it needs a copy that is not used afterwards
+    config::Cluster c = cluster;
+    forEachFile(
+        c,
+        [&res](std::filesystem::path& path) {
+            const std::filesystem::path p = std::filesystem::absolute(path);
+            if (std::find(res.begin(), res.end(), p) == res.end()) {
+                res.push_back(p);
+            }
+        }
+    );
+    return res;
+}
+
+std::vector<char> createBundle(const config::Cluster& cluster) {
+    ZoneScoped;
+
+    // The paths are stored as absolute paths so that the clients can find the files in
+    // the bundle independent of the working directory of the master
+    config::Cluster c = cluster;
+    forEachFile(
+        c,
+        [](std::filesystem::path& path) { path = std::filesystem::absolute(path); }
+    );
+
+    std::string payload;
+    appendString(payload, serializeCluster(c));
+    const std::vector<std::filesystem::path> files = bundleFiles(c);
+    appendSize(payload, files.size());
+    for (const std::filesystem::path& path : files) {
+        appendString(payload, path.string());
+        appendString(payload, readFile(path));
+    }
+
+    BundleHeader header;
+    header.hash = fnv1a(payload);
+    header.size = payload.size();
+
+    uLongf compressedSize = compressBound(static_cast<uLong>(payload.size()));
+    std::vector<char> bundle = std::vector<char>(sizeof(BundleHeader) + compressedSize);
+    const int res = compress2(
+        reinterpret_cast<Bytef*>(bundle.data() + sizeof(BundleHeader)),
+        &compressedSize,
+        reinterpret_cast<const Bytef*>(payload.data()),
+        static_cast<uLong>(payload.size()),
+        Z_DEFAULT_COMPRESSION
+    );
+    if (res != Z_OK) {
+        throw Err(5031, "Failed to compress the configuration bundle");
+    }
+    header.compressedSize = compressedSize;
+    bundle.resize(sizeof(BundleHeader) + compressedSize);
+    std::memcpy(bundle.data(), &header, sizeof(BundleHeader));
+
+    Log::Debug(std::format(
+        "Created configuration bundle {:016x} with {} files ({} bytes, {} compressed)",
+        header.hash, files.size(), header.size, header.compressedSize
+    ));
+    return bundle;
+}
+
+std::optional<uint64_t> bundleHash(std::span<const char> bundle) {
+    std::optional<BundleHeader> header = readHeader(bundle);
+    return header ? std::optional<uint64_t>(header->hash) : std::nullopt;
+}
+
+config::Cluster extractBundle(std::span<const char> bundle,
+                              const std::filesystem::path& folder, uint64_t maxSize)
+{
+    ZoneScoped;
+
+    std::optional<BundleHeader> header = readHeader(bundle);
+    if (!header || header->compressedSize != bundle.size() - sizeof(BundleHeader) ||
+        header->size > std::numeric_limits<uLong>::max())
+    {
+        throw Err(5032, "Damaged configuration bundle");
+    }
+    checkSize(*header, maxSize);
+
+    std::string payload = std::string(header->size, '\0');
+    uLongf size = static_cast<uLongf>(header->size);
+    const int res = uncompress(
+        reinterpret_cast<Bytef*>(payload.data()),
+        &size,
+        reinterpret_cast<const Bytef*>(bundle.data() + sizeof(BundleHeader)),
+        static_cast<uLong>(header->compressedSize)
+    );
+    if (res != Z_OK || size != header->size || fnv1a(payload) != header->hash) {
+        throw Err(5032, "Damaged configuration bundle");
+    }
+
+    Reader reader = Reader(payload);
+    std::optional<config::Cluster> cluster = deserializeCluster(reader.string());
+    if (!cluster) {
+        throw Err(5032, "Damaged configuration bundle");
+    }
+
+    std::filesystem::create_directories(folder);
+    std::map<std::string, std::filesystem::path, std::less<>> files;
+    const uint64_t nFiles = reader.size();
+    for (uint64_t i = 0; i < nFiles; i++) {
+        const std::string_view path = reader.string();
+        const std::string_view data = reader.string();
+
+        // The index keeps files with the same name from different folders apart
+        const std::filesystem::path target =
+            folder / std::format("{}_{}", i, std::filesystem::path(path).filename());
+        if (!std::filesystem::exists(target)) {
+            writeFile(target, data);
+        }
+        files[std::string(path)] = target;
+    }
+    if (!reader.isAtEnd()) {
+        throw Err(5032, "Damaged configuration bundle");
+    }
+
+    forEachFile(
+        *cluster,
+        [&files](std::filesystem::path& path) {
+            auto it = files.find(path.string());
+            if (it == files.end()) {
+                throw Err(5032, "Damaged configuration bundle");
+            }
+            path = it->second;
+        }
+    );
+    return std::move(*cluster);
+}
+
+BundleServer::BundleServer(std::vector<char> bundle, int port)
+    : _socketLibrary(std::make_unique<SocketLibrary>())
+    , _bundle(std::move(bundle))
+    , _listenSocket(INVALID_SOCKET)
+{
+    ZoneScoped;
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* res = nullptr;
+    if (getaddrinfo(nullptr, std::to_string(port).c_str(), &hints, &res) != 0) {
+        throw Err(
+            5034,
+            std::format("Failed to serve the configuration bundle on port {}", port)
+        );
+    }
+
+    _listenSocket = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    const int reuse = 1;
+    setsockopt(
+        _listenSocket,
+        SOL_SOCKET,
+        SO_REUSEADDR,
+        reinterpret_cast<const char*>(&reuse),
+        sizeof(reuse)
+    );
+    const bool success =
+        _listenSocket != INVALID_SOCKET &&
+        bind(_listenSocket, res->ai_addr, static_cast<int>(res->ai_addrlen)) == 0 &&
+        ::listen(_listenSocket, SOMAXCONN) == 0;
+    freeaddrinfo(res);
+    if (!success) {
+        closeSocket(_listenSocket);
+        throw Err(
+            5034,
+            std::format("Failed to serve the configuration bundle on port {}", port)
+        );
+    }
+
+    Log::Info(std::format("Serving the configuration bundle on port {}", port));
+    _listenThread = std::thread(&BundleServer::listen, this);
+}
+
+BundleServer::~BundleServer() {
+    _shouldTerminate = true;
+    _listenThread.join();
+    for (std::thread& client : _clients) {
+        client.join();
+    }
+    closeSocket(_listenSocket);
+}
+
+void BundleServer::listen() {
+    while (!_shouldTerminate) {
+        // Wait with a timeout so that the termination of the server is noticed
+        fd_set set;
+        FD_ZERO(&set);
+        FD_SET(_listenSocket, &set);
+        timeval timeout = { .tv_sec = 0, .tv_usec = 100000 };
+        const int n = select(
+            static_cast<int>(_listenSocket + 1),
+            &set,
+            nullptr,
+            nullptr,
+            &timeout
+        );
+        if (n <= 0) {
+            continue;
+        }
+
+        const SGCT_SOCKET client = accept(_listenSocket, nullptr, nullptr);
+        if (client == INVALID_SOCKET) {
+            continue;
+        }
+        _clients.emplace_back(&BundleServer::serve, this, client);
+    }
+}
+
+void BundleServer::serve(SGCT_SOCKET client) const {
+    ZoneScoped;
+
+    setReceiveTimeout(client, ReceiveTimeout);
+
+    const std::span<const char> bundle = _bundle;
+    char request = BundleIsCached;
+    const bool success =
+        sendAll(client, bundle.first(sizeof(BundleHeader))) &&
+        receiveAll(client, std::span<char>(&request, 1));
+    if (success && request == RequestBundle) {
+        Log::Debug(std::format(
+            "Sending the configuration bundle ({} bytes)", bundle.size()
+        ));
+        if (!sendAll(client, bundle.subspan(sizeof(BundleHeader)))) {
+            Log::Warning("Failed to send the configuration bundle");
+        }
+    }
+    closeSocket(client);
+}
+
+config::Cluster fetchBundle(const std::string& address, int port,
+                            const std::filesystem::path& cacheFolder,
+                            std::chrono::seconds timeout, uint64_t maxSize)
+{
+    ZoneScoped;
+
+    SocketLibrary library;
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* res = nullptr;
+    const std::string p = std::to_string(port);
+    if (getaddrinfo(address.c_str(), p.c_str(), &hints, &res) != 0) {
+        throw Err(
+            5035,
+            std::format(
+                "Failed to connect to {}:{} for the configuration bundle", address, port
+            )
+        );
+    }
+
+    Log::Info(std::format(
+        "Requesting the configuration bundle from {}:{}", address, port
+    ));
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    SGCT_SOCKET s = INVALID_SOCKET;
+    while (true) {
+        s = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (s != INVALID_SOCKET &&
+            connect(s, res->ai_addr, static_cast<int>(res->ai_addrlen)) == 0)
+        {
+            break;
+        }
+        closeSocket(s);
+        s = INVALID_SOCKET;
+        if (std::chrono::steady_clock::now() > deadline) {
+            break;
+        }
+        // The master might not have started yet
+        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    }
+    freeaddrinfo(res);
+    if (s == INVALID_SOCKET) {
+        throw Err(
+            5035,
+            std::format(
+                "Failed to connect to {}:{} for the configuration bundle", address, port
+            )
+        );
+    }
+    setReceiveTimeout(s, ReceiveTimeout);
+
+    std::array<char, sizeof(BundleHeader)> h;
+    if (!receiveAll(s, h)) {
+        closeSocket(s);
+        throw Err(
+            5036,
+            std::format(
+                "Failed to receive the configuration bundle from {}:{}", address, port
+            )
+        );
+    }
+    const std::optional<BundleHeader> header = readHeader(h);
+    if (!header) {
+        closeSocket(s);
+        throw Err(5032, "Damaged configuration bundle");
+    }
+    try {
+        checkSize(*header, maxSize);
+    }
+    catch (const Error&) {
+        closeSocket(s);
+        throw;
+    }
+
+    const std::filesystem::path folder =
+        cacheFolder / std::format("{:016x}", header->hash);
+    const std::filesystem::path cachePath = folder / "bundle.sgctbundle";
+    std::vector<char> bundle = readCachedBundle(cachePath, *header);
+    const bool isCached = !bundle.empty();
+    const char request = isCached ? BundleIsCached : RequestBundle;
+    bool success = sendAll(s, std::span<const char>(&request, 1));
+    if (success && !isCached) {
+        bundle.resize(sizeof(BundleHeader) + header->compressedSize);
+        std::copy(h.begin(), h.end(), bundle.begin());
+        success = receiveAll(s, std::span<char>(bundle).subspan(sizeof(BundleHeader)));
+    }
+    closeSocket(s);
+    if (!success) {
+        throw Err(
+            5036,
+            std::format(
+                "Failed to receive the configuration bundle from {}:{}", address, port
+            )
+        );
+    }
+
+    Log::Info(std::format(
+        "{} configuration bundle {:016x}",
+        isCached ? "Using cached" : "Received", header->hash
+    ));
+    config::Cluster cluster = extractBundle(bundle, folder, maxSize);
+    if (!isCached) {
+        // The bundle is only cached after it was extracted successfully
+        writeFile(cachePath, bundle);
+    }
+    return cluster;
+}
+
+} // namespace sgct
@@ -9,6 +9,7 @@
 #include <sgct/commandline.h>
 
 #include <iostream>
+#include <stdexcept>
 
 namespace sgct {
 
@@ -21,6 +22,10 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.configFilename = arg[i + 1];
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
         }
+        else if (arg[i] == "--config-snapshot") {
+            config.useConfigSnapshot = true;
+            arg.erase(arg.begin() + i);
+        }
         else if (arg[i] == "--client") {
             config.isServer = false;
             arg.erase(arg.begin() + i);
@@ -81,6 +86,78 @@ Configuration parseArguments(std::vector<std::string>& arg) {
             config.exportCorrectionMeshes = true;
             arg.erase(arg.begin() + i);
         }
+        else if (arg[i] == "--disable-correction-mesh-cache") {
+            config.useCorrectionMeshCache = false;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--simplify-correction-meshes" && arg.size() > (i + 1)) {
+            config.correctionMeshSimplificationError = std::stof(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--bake-correction-meshes") {
+            config.bakeCorrectionMeshes = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--optimize-correction-meshes") {
+            config.optimizeCorrectionMeshes = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--compact-correction-meshes") {
+            config.compactCorrectionMeshes = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--hot-reload") {
+            config.hotReload = Settings::HotReload::Local;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--hot-reload-cluster") {
+            config.hotReload = Settings::HotReload::Cluster;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--event-driven-tracking") {
+            config.eventDrivenTracking = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--record-tracking" && arg.size() > (i + 1)) {
+            config.trackingRecordPath = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--replay-tracking" && arg.size() > (i + 1)) {
+            config.trackingReplayPath = arg[i + 1];
+            config.trackingReplaySpeed = Settings::TrackingReplaySpeed::Original;
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--replay-tracking-fast" && arg.size() > (i + 1)) {
+            config.trackingReplayPath = arg[i + 1];
+            config.trackingReplaySpeed = Settings::TrackingReplaySpeed::AsFastAsPossible;
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--headless") {
+            config.headless = true;
+            arg.erase(arg.begin() + i);
+        }
+        else if (arg[i] == "--serve-bundle" && arg.size() > (i + 1)) {
+            config.bundleServerPort = std::stoi(arg[i + 1]);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--bundle-from" && arg.size() > (i + 1)) {
+            const std::string_view master = arg[i + 1];
+            const size_t colon = master.rfind(':');
+            if (colon == std::string_view::npos) {
+                // Reported in the same way as other arguments that cannot be converted
+                throw std::invalid_argument(
+                    "Missing port for the bundle master: " + arg[i + 1]
+                );
+            }
+            const std::string port = std::string(master.substr(colon + 1));
+            config.bundleMasterAddress = std::string(master.substr(0, colon));
+            config.bundleMasterPort = std::stoi(port);
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
+        else if (arg[i] == "--bundle-cache" && arg.size() > (i + 1)) {
+            config.bundleCacheFolder = arg[i + 1];
+            arg.erase(arg.begin() + i, arg.begin() + i + 2);
+        }
         else if (arg[i] == "--screenshot-path") {
             config.screenshotPath = arg[i + 1];
             arg.erase(arg.begin() + i, arg.begin() + i + 2);
@@ -124,6 +201,10 @@ std::string helpMessage() {
 Parameters:
 --config <filename.json> or -c <filename.json>
     Set configuration file
+--config-snapshot
+    Loads the configuration from the binary snapshot next to the configuration file
+    if the snapshot is up to date. Otherwise the configuration is parsed and the
+    snapshot is written for the next start
 --help or -h
     Display help message and exit
 --local <integer> or -l <integer>
@@ -146,6 +227,52 @@ Parameters:
     Use tga images for screen capture
 --export-correction-meshes
     Exports the correction warping meshes to OBJ files when loading them
+--disable-correction-mesh-cache
+    Always parses the correction warping meshes instead of loading them from the
+    binary cache files that are stored next to them
+--simplify-correction-meshes <float>
+    Simplifies dense correction warping meshes after loading them while keeping the
+    error in texture coordinates below the provided value, for example 0.0005
+--bake-correction-meshes
+    Bakes the correction warping meshes into lookup textures that are applied in a
+    single pass instead of rendering the meshes every frame
+--optimize-correction-meshes
+    Reorders the triangles of the correction warping meshes after loading them to
+    improve the reuse of the vertex cache
+--compact-correction-meshes
+    Stores the vertices of the correction warping meshes with 16-bit texture
+    coordinates and 8-bit colors on the GPU
+--hot-reload
+    Reloads the correction warping meshes and the overlay and mask textures while the
+    application is running when their files change
+--hot-reload-cluster
+    Same as --hot-reload, but changes to the files of the master additionally cause
+    all clients to reload their files
+--event-driven-tracking
+    Samples the VRPN tracking devices as soon as data arrives on their connections
+    instead of polling them every millisecond
+--record-tracking <file>
+    Records all updates of the VRPN tracking devices with their timestamps into the
+    provided binary tracking log
+--replay-tracking <file>
+    Replays a tracking log that was written with --record-tracking into the tracking
+    devices with the recorded timing instead of connecting to the VRPN servers
+--replay-tracking-fast <file>
+    Same as --replay-tracking, but every rendered frame advances the recording by a
+    fixed 1/60 s, which replays it as fast as possible and reproducibly
+--headless
+    Renders without a display server into offscreen framebuffers by creating the
+    OpenGL contexts with EGL, for example with Mesa's llvmpipe. Screenshots are taken
+    from the rendered textures
+--serve-bundle <integer>
+    Serves the configuration and all files that it references as a compressed bundle
+    on the provided port, so that clients can start with --bundle-from
+--bundle-from <address:port>
+    Loads the configuration and all files that it references from the bundle that the
+    master serves on the provided address and port instead of from the local disk
+--bundle-cache <folder>
+    Sets the folder in which received bundles are cached. The default is a folder in
+    the temporary directory of the system
 --screenshot-path
     Sets the file path for the screenshots location
 --screenshot-prefix
@@ -0,0 +1,878 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/compressedimage.h>
+
+#include <sgct/error.h>
+#include <sgct/format.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/mappedfile.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#define Err(code, msg) Error(Error::Component::Image, code, msg)
+
+namespace {
+    using Format = sgct::CompressedImage::Format;
+
+    // A 4x4 block of RGBA pixels in row-major order
+    using Block = std::array<uint8_t, 16 * 4>;
+
+    //
+    // Color endpoint helpers
+    //
+    uint16_t to565(int r, int g, int b) {
+        const int r5 = (r * 31 + 127) / 255;
+        const int g6 = (g * 63 + 127) / 255;
+        const int b5 = (b * 31 + 127) / 255;
+        return static_cast<uint16_t>((r5 << 11) | (g6 << 5) | b5);
+    }
+
+    std::array<int, 3> from565(uint16_t c) {
+        const int r5 = (c >> 11) & 0x1F;
+        const int g6 = (c >> 5) & 0x3F;
+        const int b5 = c & 0x1F;
+        return { (r5 << 3) | (r5 >> 2), (g6 << 2) | (g6 >> 4), (b5 << 3) | (b5 >> 2) };
+    }
+
+    // Creates the four palette entries for a color block. In three-color mode, the last
+    // entry is transparent black
+    std::array<std::array<int, 4>, 4> colorPalette(uint16_t c0, uint16_t c1,
+                                                   bool allowThreeColor)
+    {
+        const std::array<int, 3> p0 = from565(c0);
+        const std::array<int, 3> p1 = from565(c1);
+        std::array<std::array<int, 4>, 4> res;
+        res[0] = { p0[0], p0[1], p0[2], 255 };
+        res[1] = { p1[0], p1[1], p1[2], 255 };
+        if (c0 > c1 || !allowThreeColor) {
+            for (int i = 0; i < 3; i++) {
+                res[2][i] = (2 * p0[i] + p1[i]) / 3;
+                res[3][i] = (p0[i] + 2 * p1[i]) / 3;
+            }
+            res[2][3] = 255;
+            res[3][3] = 255;
+        }
+        else {
+            for (int i = 0; i < 3; i++) {
+                res[2][i] = (p0[i] + p1[i]) / 2;
+            }
+            res[2][3] = 255;
+            res[3] = { 0, 0, 0, 0 };
+        }
+        return res;
+    }
+
+    std::array<int, 8> alphaPalette(uint8_t a0, uint8_t a1) {
+        std::array<int, 8> res;
+        res[0] = a0;
+        res[1] = a1;
+        if (a0 > a1) {
+            for (int i = 2; i < 8; i++) {
+                res[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+            }
+        }
+        else {
+            for (int i = 2; i < 6; i++) {
+                res[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+            }
+            res[6] = 0;
+            res[7] = 255;
+        }
+        return res;
+    }
+
+    //
+    // Encoding
+    //
+    void encodeColorBlock(const Block& block, bool useThreeColorAlpha, uint8_t* out) {
+        std::array<int, 3> minColor = { 255, 255, 255 };
+        std::array<int, 3> maxColor = { 0, 0, 0 };
+        std::array<int, 3> center = { 0, 0, 0 };
+        for (int i = 0; i < 16; i++) {
+            for (int c = 0; c < 3; c++) {
+                minColor[c] = std::min<int>(minColor[c], block[i * 4 + c]);
+                maxColor[c] = std::max<int>(maxColor[c], block[i * 4 + c]);
+                center[c] += block[i * 4 + c];
+            }
+        }
+
+        // The bounding box diagonal from min to max only follows the colors if all
+        // channels are positively correlated. Flip the green and blue extents if they are
+        // anti-correlated with red
+        for (int c = 0; c < 3; c++) {
+            center[c] /= 16;
+        }
+        int covG = 0;
+        int covB = 0;
+        for (int i = 0; i < 16; i++) {
+            const int r = block[i * 4 + 0] - center[0];
+            covG += r * (block[i * 4 + 1] - center[1]);
+            covB += r * (block[i * 4 + 2] - center[2]);
+        }
+        if (covG < 0) {
+            std::swap(minColor[1], maxColor[1]);
+        }
+        if (covB < 0) {
+            std::swap(minColor[2], maxColor[2]);
+        }
+
+        // Inset the bounding box by 1/16 of its size to move the endpoints closer to the
+        // typical color distribution and reduce the average error
+        for (int c = 0; c < 3; c++) {
+            const int inset = (maxColor[c] - minColor[c]) / 16;
+            minColor[c] = std::clamp(minColor[c] + inset, 0, 255);
+            maxColor[c] = std::clamp(maxColor[c] - inset, 0, 255);
+        }
+
+        uint16_t c0 = to565(maxColor[0], maxColor[1], maxColor[2]);
+        uint16_t c1 = to565(minColor[0], minColor[1], minColor[2]);
+        // In four-color mode c0 has to be larger than c1, in three-color mode smaller
+        if ((useThreeColorAlpha && c0 > c1) || (!useThreeColorAlpha && c0 < c1)) {
+            std::swap(c0, c1);
+        }
+
+        const std::array<std::array<int, 4>, 4> palette =
+            colorPalette(c0, c1, useThreeColorAlpha);
+        const int nColors = useThreeColorAlpha ? 3 : 4;
+        uint32_t indices = 0;
+        if (c0 != c1 || useThreeColorAlpha) {
+            for (int i = 0; i < 16; i++) {
+                uint32_t best = 0;
+                if (useThreeColorAlpha && block[i * 4 + 3] < 128) {
+                    best = 3;
+                }
+                else {
+                    int bestDist = std::numeric_limits<int>::max();
+                    for (int p = 0; p < nColors; p++) {
+                        const int dr = block[i * 4 + 0] - palette[p][0];
+                        const int dg = block[i * 4 + 1] - palette[p][1];
+                        const int db = block[i * 4 + 2] - palette[p][2];
+                        const int dist = dr * dr + dg * dg + db * db;
+                        if (dist < bestDist) {
+                            bestDist = dist;
+                            best = static_cast<uint32_t>(p);
+                        }
+                    }
+                }
+                indices |= best << (2 * i);
+            }
+        }
+
+        std::memcpy(out, &c0, sizeof(uint16_t));
+        std::memcpy(out + 2, &c1, sizeof(uint16_t));
+        std::memcpy(out + 4, &indices, sizeof(uint32_t));
+    }
+
+    void encodeAlphaBlock(const Block& block, uint8_t* out) {
+        uint8_t a0 = 0;
+        uint8_t a1 = 255;
+        for (int i = 0; i < 16; i++) {
+            a0 = std::max(a0, block[i * 4 + 3]);
+            a1 = std::min(a1, block[i * 4 + 3]);
+        }
+
+        uint64_t indices = 0;
+        if (a0 != a1) {
+            const std::array<int, 8> palette = alphaPalette(a0, a1);
+            for (int i = 0; i < 16; i++) {
+                uint64_t best = 0;
+                int bestDist = std::numeric_limits<int>::max();
+                for (int p = 0; p < 8; p++) {
+                    const int dist = std::abs(block[i * 4 + 3] - palette[p]);
+                    if (dist < bestDist) {
+                        bestDist = dist;
+                        best = static_cast<uint64_t>(p);
+                    }
+                }
+                indices |= best << (3 * i);
+            }
+        }
+
+        out[0] = a0;
+        out[1] = a1;
+        for (int i = 0; i < 6; i++) {
+            out[2 + i] = static_cast<uint8_t>((indices >> (8 * i)) & 0xFF);
+        }
+    }
+
+    //
+    // Decoding
+    //
+    void decodeColorBlock(const uint8_t* in, bool allowThreeColor, Block& block) {
+        uint16_t c0 = 0;
+        uint16_t c1 = 0;
+        uint32_t indices = 0;
+        std::memcpy(&c0, in, sizeof(uint16_t));
+        std::memcpy(&c1, in + 2, sizeof(uint16_t));
+        std::memcpy(&indices, in + 4, sizeof(uint32_t));
+
+        const std::array<std::array<int, 4>, 4> palette =
+            colorPalette(c0, c1, allowThreeColor);
+        for (int i = 0; i < 16; i++) {
+            const std::array<int, 4>& p = palette[(indices >> (2 * i)) & 0x3];
+            for (int c = 0; c < 4; c++) {
+                block[i * 4 + c] = static_cast<uint8_t>(p[c]);
+            }
+        }
+    }
+
+    void decodeAlphaBlock(const uint8_t* in, Block& block) {
+        const std::array<int, 8> palette = alphaPalette(in[0], in[1]);
+        uint64_t indices = 0;
+        for (int i = 0; i < 6; i++) {
+            indices |= static_cast<uint64_t>(in[2 + i]) << (8 * i);
+        }
+        for (int i = 0; i < 16; i++) {
+            block[i * 4 + 3] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 0x7]);
+        }
+    }
+
+    //
+    // Vertical flipping of BC1 and BC3 data
+    //
+    // Reverses the order of the first 'nRows' rows of pixels inside of the block
+    void flipBlockRows(uint8_t* block, Format format, int nRows) {
+        uint8_t* color = format == Format::BC3 ? block + 8 : block;
+        std::reverse(color + 4, color + 4 + nRows);
+
+        if (format == Format::BC3) {
+            // 16 3-bit indices, 12 bits per row
+            uint64_t indices = 0;
+            for (int i = 0; i < 6; i++) {
+                indices |= static_cast<uint64_t>(block[2 + i]) << (8 * i);
+            }
+            std::array<uint64_t, 4> rows;
+            for (int r = 0; r < 4; r++) {
+                rows[r] = (indices >> (12 * r)) & 0xFFF;
+            }
+            std::reverse(rows.begin(), rows.begin() + nRows);
+            indices = 0;
+            for (int r = 0; r < 4; r++) {
+                indices |= rows[r] << (12 * r);
+            }
+            for (int i = 0; i < 6; i++) {
+                block[2 + i] = static_cast<uint8_t>((indices >> (8 * i)) & 0xFF);
+            }
+        }
+    }
+
+    // Rows can only be reordered within a block, so all but the last row of blocks have
+    // to be fully used. The BC7 blocks cannot be reordered without re-encoding
+    bool canFlip(Format format, const std::vector<sgct::CompressedImage::Level>& levels) {
+        if (format == Format::BC7) {
+            return false;
+        }
+        return std::all_of(
+            levels.begin(),
+            levels.end(),
+            [](const sgct::CompressedImage::Level& level) {
+                return level.size.y < 4 || level.size.y % 4 == 0;
+            }
+        );
+    }
+
+    void flipLevel(sgct::CompressedImage::Level& level, Format format) {
+        const int blockSize = sgct::CompressedImage::blockSize(format);
+        const int blocksX = (level.size.x + 3) / 4;
+        const int blocksY = (level.size.y + 3) / 4;
+        const size_t rowSize = static_cast<size_t>(blocksX) * blockSize;
+        uint8_t* data = reinterpret_cast<uint8_t*>(level.data.data());
+
+        if (level.size.y < 4) {
+            // A single row of blocks that is only partially used
+            for (int x = 0; x < blocksX; x++) {
+                flipBlockRows(data + x * blockSize, format, level.size.y);
+            }
+            return;
+        }
+
+        for (int y = 0; y < blocksY / 2; y++) {
+            std::swap_ranges(
+                data + y * rowSize,
+                data + (y + 1) * rowSize,
+                data + (blocksY - 1 - y) * rowSize
+            );
+        }
+        for (int i = 0; i < blocksX * blocksY; i++) {
+            flipBlockRows(data + i * blockSize, format, 4);
+        }
+    }
+
+    //
+    // Container formats
+    //
+    constexpr uint32_t fourCC(char a, char b, char c, char d) {
+        return static_cast<uint32_t>(a) | (static_cast<uint32_t>(b) << 8) |
+            (static_cast<uint32_t>(c) << 16) | (static_cast<uint32_t>(d) << 24);
+    }
+
+    struct DDSPixelFormat {
+        uint32_t size = 32;
+        uint32_t flags = 0;
+        uint32_t fourCC = 0;
+        uint32_t rgbBitCount = 0;
+        uint32_t rBitMask = 0;
+        uint32_t gBitMask = 0;
+        uint32_t bBitMask = 0;
+        uint32_t aBitMask = 0;
+    };
+
+    struct DDSHeader {
+        uint32_t size = 124;
+        uint32_t flags = 0;
+        uint32_t height = 0;
+        uint32_t width = 0;
+        uint32_t pitchOrLinearSize = 0;
+        uint32_t depth = 0;
+        uint32_t mipMapCount = 0;
+        std::array<uint32_t, 11> reserved1 = {};
+        DDSPixelFormat pixelFormat;
+        uint32_t caps = 0;
+        uint32_t caps2 = 0;
+        uint32_t caps3 = 0;
+        uint32_t caps4 = 0;
+        uint32_t reserved2 = 0;
+    };
+    static_assert(sizeof(DDSHeader) == 124);
+
+    struct DDSHeaderDX10 {
+        uint32_t dxgiFormat = 0;
+        uint32_t resourceDimension = 0;
+        uint32_t miscFlag = 0;
+        uint32_t arraySize = 0;
+        uint32_t miscFlags2 = 0;
+    };
+    static_assert(sizeof(DDSHeaderDX10) == 20);
+
+    constexpr uint32_t DDSMagic = fourCC('D', 'D', 'S', ' ');
+    constexpr uint32_t DDPFFourCC = 0x4;
+    constexpr uint32_t DXGIFormatBC1 = 71;
+    constexpr uint32_t DXGIFormatBC1Srgb = 72;
+    constexpr uint32_t DXGIFormatBC3 = 77;
+    constexpr uint32_t DXGIFormatBC3Srgb = 78;
+    constexpr uint32_t DXGIFormatBC7 = 98;
+    constexpr uint32_t DXGIFormatBC7Srgb = 99;
+
+    constexpr std::array<uint8_t, 12> KTX2Identifier = {
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+
+    struct KTX2Header {
+        uint32_t vkFormat = 0;
+        uint32_t typeSize = 0;
+        uint32_t pixelWidth = 0;
+        uint32_t pixelHeight = 0;
+        uint32_t pixelDepth = 0;
+        uint32_t layerCount = 0;
+        uint32_t faceCount = 0;
+        uint32_t levelCount = 0;
+        uint32_t supercompressionScheme = 0;
+        uint32_t dfdByteOffset = 0;
+        uint32_t dfdByteLength = 0;
+        uint32_t kvdByteOffset = 0;
+        uint32_t kvdByteLength = 0;
+        // Followed by the 64-bit offset and length of the supercompression global data,
+        // which are not needed as supercompressed files are not supported
+    };
+    static_assert(sizeof(KTX2Header) == 52);
+    constexpr size_t KTX2LevelIndexOffset =
+        12 + sizeof(KTX2Header) + 2 * sizeof(uint64_t);
+
+    struct KTX2Level {
+        uint64_t byteOffset = 0;
+        uint64_t byteLength = 0;
+        uint64_t uncompressedByteLength = 0;
+    };
+
+    // Vulkan format enums as used by KTX2
+    constexpr uint32_t VkFormatBC1RGB = 131;
+    constexpr uint32_t VkFormatBC1RGBSrgb = 132;
+    constexpr uint32_t VkFormatBC1RGBA = 133;
+    constexpr uint32_t VkFormatBC1RGBASrgb = 134;
+    constexpr uint32_t VkFormatBC3 = 137;
+    constexpr uint32_t VkFormatBC3Srgb = 138;
+    constexpr uint32_t VkFormatBC7 = 145;
+    constexpr uint32_t VkFormatBC7Srgb = 146;
+
+    // Copies a trivially copyable struct from the file contents with bounds checking
+    template <typename T>
+    bool readStruct(const sgct::MappedFile& file, size_t offset, T& value) {
+        if (offset + sizeof(T) > file.size()) {
+            return false;
+        }
+        std::memcpy(&value, file.data() + offset, sizeof(T));
+        return true;
+    }
+
+    std::string lowerCaseExtension(const std::filesystem::path& path) {
+        std::string ext = path.extension().string();
+        std::transform(
+            ext.begin(),
+            ext.end(),
+            ext.begin(),
+            [](char c) { return static_cast<char>(::tolower(c)); }
+        );
+        return ext;
+    }
+} // namespace
+
+namespace sgct {
+
+CompressedImage CompressedImage::encode(const Image& image, Format format,
+                                        bool generateMipmaps)
+{
+    if (format == Format::BC7) {
+        throw Err(9020, "Cannot encode image: The BC7 format is not supported");
+    }
+    if ((image.channels() != 3 && image.channels() != 4) ||
+        image.bytesPerChannel() != 1 || image.data() == nullptr)
+    {
+        throw Err(
+            9020,
+            "Cannot encode image: Only images with 3 or 4 channels of 8 bit are supported"
+        );
+    }
+
+    // Convert the BGR(A) image into RGBA so that all levels use the same layout
+    const ivec2 size = image.size();
+    const int nChannels = image.channels();
+    std::vector<uint8_t> rgba(static_cast<size_t>(size.x) * size.y * 4);
+    for (size_t i = 0; i < static_cast<size_t>(size.x) * size.y; i++) {
+        const unsigned char* src = image.data() + i * nChannels;
+        rgba[i * 4 + 0] = src[2];
+        rgba[i * 4 + 1] = src[1];
+        rgba[i * 4 + 2] = src[0];
+        rgba[i * 4 + 3] = nChannels == 4 ? src[3] : 255;
+    }
+
+    CompressedImage res;
+    res._format = format;
+
+    ivec2 mipSize = size;
+    while (true) {
+        Level level;
+        level.size = mipSize;
+        level.data.resize(levelSize(format, mipSize));
+
+        const int blocksX = (mipSize.x + 3) / 4;
+        const int blocksY = (mipSize.y + 3) / 4;
+        const int bs = blockSize(format);
+        uint8_t* out = reinterpret_cast<uint8_t*>(level.data.data());
+        for (int by = 0; by < blocksY; by++) {
+            for (int bx = 0; bx < blocksX; bx++) {
+                // Gather the block, replicating the edge pixels for partial blocks
+                Block block;
+                bool hasTransparency = false;
+                for (int y = 0; y < 4; y++) {
+                    const int py = std::min(by * 4 + y, mipSize.y - 1);
+                    for (int x = 0; x < 4; x++) {
+                        const int px = std::min(bx * 4 + x, mipSize.x - 1);
+                        const size_t src = (static_cast<size_t>(py) * mipSize.x + px);
+                        std::memcpy(&block[(y * 4 + x) * 4], &rgba[src * 4], 4);
+                        hasTransparency |= rgba[src * 4 + 3] < 128;
+                    }
+                }
+
+                uint8_t* dst = out + (static_cast<size_t>(by) * blocksX + bx) * bs;
+                if (format == Format::BC1) {
+                    encodeColorBlock(block, hasTransparency, dst);
+                }
+                else {
+                    encodeAlphaBlock(block, dst);
+                    encodeColorBlock(block, false, dst + 8);
+                }
+            }
+        }
+        res._levels.push_back(std::move(level));
+
+        if (!generateMipmaps || (mipSize.x == 1 && mipSize.y == 1)) {
+            break;
+        }
+
+        // Box filter the next mipmap level
+        const ivec2 next = ivec2(
+            std::max(mipSize.x / 2, 1),
+            std::max(mipSize.y / 2, 1)
+        );
+        std::vector<uint8_t> down(static_cast<size_t>(next.x) * next.y * 4);
+        for (int y = 0; y < next.y; y++) {
+            const int y0 = std::min(y * 2, mipSize.y - 1);
+            const int y1 = std::min(y * 2 + 1, mipSize.y - 1);
+            for (int x = 0; x < next.x; x++) {
+                const int x0 = std::min(x * 2, mipSize.x - 1);
+                const int x1 = std::min(x * 2 + 1, mipSize.x - 1);
+                for (int c = 0; c < 4; c++) {
+                    const int sum =
+                        rgba[(static_cast<size_t>(y0) * mipSize.x + x0) * 4 + c] +
+                        rgba[(static_cast<size_t>(y0) * mipSize.x + x1) * 4 + c] +
+                        rgba[(static_cast<size_t>(y1) * mipSize.x + x0) * 4 + c] +
+                        rgba[(static_cast<size_t>(y1) * mipSize.x + x1) * 4 + c];
+                    down[(static_cast<size_t>(y) * next.x + x) * 4 + c] =
+                        static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        rgba = std::move(down);
+        mipSize = next;
+    }
+
+    return res;
+}
+
+int CompressedImage::blockSize(Format format) {
+    switch (format) {
+        case Format::BC1: return 8;
+        case Format::BC3: return 16;
+        case Format::BC7: return 16;
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+size_t CompressedImage::levelSize(Format format, ivec2 size) {
+    const size_t blocksX = static_cast<size_t>(std::max((size.x + 3) / 4, 1));
+    const size_t blocksY = static_cast<size_t>(std::max((size.y + 3) / 4, 1));
+    return blocksX * blocksY * blockSize(format);
+}
+
+void CompressedImage::load(const std::filesystem::path& filename) {
+    const MappedFile file = MappedFile(filename);
+    if (!file.isOpen()) {
+        throw Err(9014, std::format("Could not open compressed image '{}'", filename));
+    }
+
+    ivec2 size;
+    int nLevels = 0;
+    std::vector<std::pair<size_t, size_t>> ranges;
+
+    const std::string ext = lowerCaseExtension(filename);
+    if (ext == ".dds") {
+        uint32_t magic = 0;
+        DDSHeader header;
+        if (!readStruct(file, 0, magic) || magic != DDSMagic ||
+            !readStruct(file, sizeof(uint32_t), header) || header.size != 124)
+        {
+            throw Err(9016, std::format("Invalid or truncated header in '{}'", filename));
+        }
+
+        size_t offset = sizeof(uint32_t) + sizeof(DDSHeader);
+        uint32_t dxgiFormat = 0;
+        const uint32_t cc = header.pixelFormat.fourCC;
+        if ((header.pixelFormat.flags & DDPFFourCC) == 0) {
+            throw Err(
+                9017, std::format("Unsupported compressed format in '{}'", filename)
+            );
+        }
+        if (cc == fourCC('D', 'X', '1', '0')) {
+            DDSHeaderDX10 dx10;
+            if (!readStruct(file, offset, dx10)) {
+                throw Err(
+                    9016, std::format("Invalid or truncated header in '{}'", filename)
+                );
+            }
+            offset += sizeof(DDSHeaderDX10);
+            dxgiFormat = dx10.dxgiFormat;
+        }
+        else if (cc == fourCC('D', 'X', 'T', '1')) {
+            dxgiFormat = DXGIFormatBC1;
+        }
+        else if (cc == fourCC('D', 'X', 'T', '5')) {
+            dxgiFormat = DXGIFormatBC3;
+        }
+
+        switch (dxgiFormat) {
+            case DXGIFormatBC1:
+            case DXGIFormatBC1Srgb:
+                _format = Format::BC1;
+                break;
+            case DXGIFormatBC3:
+            case DXGIFormatBC3Srgb:
+                _format = Format::BC3;
+                break;
+            case DXGIFormatBC7:
+            case DXGIFormatBC7Srgb:
+                _format = Format::BC7;
+                break;
+            default:
+                throw Err(
+                    9017, std::format("Unsupported compressed format in '{}'", filename)
+                );
+        }
+
+        size = ivec2(static_cast<int>(header.width), static_cast<int>(header.height));
+        nLevels = std::max(static_cast<int>(header.mipMapCount), 1);
+        ivec2 s = size;
+        for (int i = 0; i < nLevels; i++) {
+            const size_t nBytes = levelSize(_format, s);
+            ranges.emplace_back(offset, nBytes);
+            offset += nBytes;
+            s = ivec2(std::max(s.x / 2, 1), std::max(s.y / 2, 1));
+        }
+    }
+    else if (ext == ".ktx2") {
+        std::array<uint8_t, 12> identifier;
+        KTX2Header header;
+        if (!readStruct(file, 0, identifier) || identifier != KTX2Identifier ||
+            !readStruct(file, identifier.size(), header))
+        {
+            throw Err(9016, std::format("Invalid or truncated header in '{}'", filename));
+        }
+        if (header.supercompressionScheme != 0) {
+            throw Err(
+                9018,
+                std::format("Supercompressed KTX2 files are not supported '{}'", filename)
+            );
+        }
+        if (header.pixelDepth > 1 || header.layerCount > 1 || header.faceCount != 1) {
+            throw Err(
+                9027,
+                std::format("Only 2D KTX2 textures are supported in '{}'", filename)
+            );
+        }
+
+        switch (header.vkFormat) {
+            case VkFormatBC1RGB:
+            case VkFormatBC1RGBSrgb:
+            case VkFormatBC1RGBA:
+            case VkFormatBC1RGBASrgb:
+                _format = Format::BC1;
+                break;
+            case VkFormatBC3:
+            case VkFormatBC3Srgb:
+                _format = Format::BC3;
+                break;
+            case VkFormatBC7:
+            case VkFormatBC7Srgb:
+                _format = Format::BC7;
+                break;
+            default:
+                throw Err(
+                    9017, std::format("Unsupported compressed format in '{}'", filename)
+                );
+        }
+
+        size = ivec2(
+            static_cast<int>(header.pixelWidth),
+            static_cast<int>(header.pixelHeight)
+        );
+        nLevels = std::max(static_cast<int>(header.levelCount), 1);
+        for (int i = 0; i < nLevels; i++) {
+            KTX2Level level;
+            // The 64-bit values are checked before they are narrowed, written such that
+            // a large offset cannot overflow
+            if (!readStruct(file, KTX2LevelIndexOffset + i * sizeof(KTX2Level), level) ||
+                level.byteOffset > file.size() ||
+                level.byteLength > file.size() - level.byteOffset)
+            {
+                throw Err(
+                    9016, std::format("Invalid or truncated header in '{}'", filename)
+                );
+            }
+            ranges.emplace_back(
+                static_cast<size_t>(level.byteOffset),
+                static_cast<size_t>(level.byteLength)
+            );
+        }
+    }
+    else {
+        throw Err(9015, std::format("Unsupported container for '{}'", filename));
+    }
+
+    if (size.x <= 0 || size.y <= 0) {
+        throw Err(9016, std::format("Invalid or truncated header in '{}'", filename));
+    }
+
+    _levels.clear();
+    ivec2 s = size;
+    for (const std::pair<size_t, size_t>& range : ranges) {
+        if (range.second != levelSize(_format, s) || range.first > file.size() ||
+            range.second > file.size() - range.first)
+        {
+            throw Err(9016, std::format("Invalid or truncated header in '{}'", filename));
+        }
+
+        Level level;
+        level.size = s;
+        level.data.assign(
+            file.data() + range.first,
+            file.data() + range.first + range.second
+        );
+        _levels.push_back(std::move(level));
+        s = ivec2(std::max(s.x / 2, 1), std::max(s.y / 2, 1));
+    }
+
+    // The containers store the rows top to bottom
+    _isTopDown = !canFlip(_format, _levels);
+    if (_isTopDown) {
+        Log::Warning(std::format(
+            "The rows of '{}' cannot be reordered and are kept top to bottom, so the "
+            "texture has to be sampled with flipped texture coordinates", filename
+        ));
+    }
+    else {
+        for (Level& level : _levels) {
+            flipLevel(level, _format);
+        }
+    }
+}
+
+void CompressedImage::save(const std::filesystem::path& filename) const {
+    if (_levels.empty()) {
+        throw Err(9019, std::format("Missing image data to save '{}'", filename));
+    }
+    if (!_isTopDown && !canFlip(_format, _levels)) {
+        throw Err(
+            9028,
+            std::format("Cannot reorder the rows of compressed image '{}'", filename)
+        );
+    }
+
+    DDSHeader header;
+    // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT |
+    // DDSD_LINEARSIZE
+    header.flags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+    header.width = static_cast<uint32_t>(size().x);
+    header.height = static_cast<uint32_t>(size().y);
+    header.pitchOrLinearSize = static_cast<uint32_t>(_levels.front().data.size());
+    header.mipMapCount = static_cast<uint32_t>(_levels.size());
+    header.pixelFormat.flags = DDPFFourCC;
+    // DDSCAPS_TEXTURE, and DDSCAPS_COMPLEX | DDSCAPS_MIPMAP if there are mipmaps
+    header.caps = 0x1000 | (_levels.size() > 1 ? 0x8 | 0x400000 : 0);
+
+    DDSHeaderDX10 dx10;
+    switch (_format) {
+        case Format::BC1:
+            header.pixelFormat.fourCC = fourCC('D', 'X', 'T', '1');
+            break;
+        case Format::BC3:
+            header.pixelFormat.fourCC = fourCC('D', 'X', 'T', '5');
+            break;
+        case Format::BC7:
+            header.pixelFormat.fourCC = fourCC('D', 'X', '1', '0');
+            dx10.dxgiFormat = DXGIFormatBC7;
+            dx10.resourceDimension = 3; // D3D10_RESOURCE_DIMENSION_TEXTURE2D
+            dx10.arraySize = 1;
+            break;
+        default:
+            throw std::logic_error("Unhandled case label");
+    }
+
+    std::ofstream file = std::ofstream(filename, std::ofstream::binary);
+    file.write(reinterpret_cast<const char*>(&DDSMagic), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(DDSHeader));
+    if (_format == Format::BC7) {
+        file.write(reinterpret_cast<const char*>(&dx10), sizeof(DDSHeaderDX10));
+    }
+    for (const Level& level : _levels) {
+        if (_isTopDown) {
+            file.write(
+                reinterpret_cast<const char*>(level.data.data()),
+                level.data.size()
+            );
+            continue;
+        }
+
+        // The file stores the rows top to bottom
+        Level flipped = level;
+        flipLevel(flipped, _format);
+        file.write(
+            reinterpret_cast<const char*>(flipped.data.data()),
+            flipped.data.size()
+        );
+    }
+
+    if (!file.good()) {
+        throw Err(9019, std::format("Could not save compressed image '{}'", filename));
+    }
+}
+
+void CompressedImage::decode(Image& image, int level) const {
+    if (_format == Format::BC7) {
+        throw Err(9021, "Cannot decode compressed image: BC7 is not supported");
+    }
+    if (level < 0 || level >= static_cast<int>(_levels.size())) {
+        throw Err(
+            9021,
+            std::format("Cannot decode compressed image: Missing level {}", level)
+        );
+    }
+
+    const Level& l = _levels[level];
+    image.setSize(l.size);
+    image.setChannels(4);
+    image.setBytesPerChannel(1);
+    image.allocateOrResizeData();
+
+    const int blocksX = (l.size.x + 3) / 4;
+    const int blocksY = (l.size.y + 3) / 4;
+    const int bs = blockSize(_format);
+    const uint8_t* in = reinterpret_cast<const uint8_t*>(l.data.data());
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            const uint8_t* src = in + (static_cast<size_t>(by) * blocksX + bx) * bs;
+            Block block;
+            if (_format == Format::BC1) {
+                decodeColorBlock(src, true, block);
+            }
+            else {
+                decodeColorBlock(src + 8, false, block);
+                decodeAlphaBlock(src, block);
+            }
+
+            for (int y = 0; y < 4 && by * 4 + y < l.size.y; y++) {
+                // The Image always stores the rows bottom to top
+                const int row = _isTopDown ? l.size.y - 1 - (by * 4 + y) : by * 4 + y;
+                for (int x = 0; x < 4 && bx * 4 + x < l.size.x; x++) {
+                    const size_t px =
+                        static_cast<size_t>(row) * l.size.x + bx * 4 + x;
+                    // The Image stores the pixels as BGRA
+                    unsigned char* dst = image.data() + px * 4;
+                    const uint8_t* p = &block[(y * 4 + x) * 4];
+                    dst[0] = p[2];
+                    dst[1] = p[1];
+                    dst[2] = p[0];
+                    dst[3] = p[3];
+                }
+            }
+        }
+    }
+}
+
+CompressedImage::Format CompressedImage::format() const {
+    return _format;
+}
+
+ivec2 CompressedImage::size() const {
+    return _levels.empty() ? ivec2(0, 0) : _levels.front().size;
+}
+
+const std::vector<CompressedImage::Level>& CompressedImage::levels() const {
+    return _levels;
+}
+
+bool CompressedImage::isTopDown() const {
+    return _isTopDown;
+}
+
+size_t CompressedImage::dataSize() const {
+    size_t res = 0;
+    for (const Level& level : _levels) {
+        res += level.data.size();
+    }
+    return res;
+}
+
+} // namespace sgct
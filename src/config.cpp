@@ -100,6 +100,14 @@ void validateTracker(const Tracker& t) {
     if (t.name.empty()) {
         throw Error(1040, "Tracker name must not be empty");
     }
+    if (t.prediction && t.prediction->latency && *t.prediction->latency < 0.f) {
+        throw Error(1041, "Tracker prediction latency must not be negative");
+    }
+    if (t.prediction && t.prediction->smoothing &&
+        (*t.prediction->smoothing <= 0.f || *t.prediction->smoothing > 1.f))
+    {
+        throw Error(1042, "Tracker prediction smoothing must be in the range (0, 1]");
+    }
     std::for_each(t.devices.begin(), t.devices.end(), validateDevice);
 }
 
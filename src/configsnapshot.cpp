@@ -0,0 +1,524 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/configsnapshot.h>
+
+#include <sgct/error.h>
+#include <sgct/fileutils.h>
+#include <sgct/format.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <sgct/readconfig.h>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#define Err(code, msg) sgct::Error(sgct::Error::Component::ReadConfig, code, msg)
+
+namespace {
+    using namespace sgct::config;
+    using sgct::ivec2;
+    using sgct::vec2;
+    using sgct::vec3;
+    using sgct::vec4;
+    using sgct::quat;
+    using sgct::mat4;
+
+    // Increase this version whenever any of the config structs or the serialization
+    // changes so that old snapshots are ignored
+    constexpr uint32_t SnapshotVersion = 2;
+    constexpr std::array<char, 4> SnapshotMagic = { 'S', 'G', 'C', 'S' };
+
+    struct SnapshotHeader {
+        std::array<char, 4> magic = SnapshotMagic;
+        uint32_t version = SnapshotVersion;
+        uint64_t hash = 0;
+        uint64_t size = 0;
+    };
+    static_assert(sizeof(SnapshotHeader) == 24);
+
+    // Used to signal a damaged snapshot while reading, which is never visible outside
+    struct DamagedSnapshot {};
+
+    // The same serialization functions are used for reading and writing, so that the
+    // order of the fields can not diverge between the two
+    class Archive {
+    public:
+        explicit Archive(std::string& output) : _output(&output) {}
+        explicit Archive(std::string_view input) : _input(input) {}
+
+        bool isReading() const { return _output == nullptr; }
+        bool isAtEnd() const { return _input.empty(); }
+
+        void bytes(void* data, size_t size) {
+            if (_output) {
+                _output->append(static_cast<const char*>(data), size);
+            }
+            else {
+                if (_input.size() < size) {
+                    throw DamagedSnapshot();
+                }
+                std::memcpy(data, _input.data(), size);
+                _input.remove_prefix(size);
+            }
+        }
+
+    private:
+        std::string* _output = nullptr;
+        std::string_view _input;
+    };
+
+    template <typename T>
+        requires (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    void io(Archive& a, T& v) {
+        a.bytes(&v, sizeof(T));
+    }
+
+    void io(Archive& a, bool& v) {
+        uint8_t b = v ? 1 : 0;
+        a.bytes(&b, sizeof(uint8_t));
+        if (b > 1) {
+            throw DamagedSnapshot();
+        }
+        v = b == 1;
+    }
+
+    void io(Archive& a, ivec2& v) { a.bytes(&v, sizeof(ivec2)); }
+    void io(Archive& a, vec2& v) { a.bytes(&v, sizeof(vec2)); }
+    void io(Archive& a, vec3& v) { a.bytes(&v, sizeof(vec3)); }
+    void io(Archive& a, vec4& v) { a.bytes(&v, sizeof(vec4)); }
+    void io(Archive& a, quat& v) { a.bytes(&v, sizeof(quat)); }
+    void io(Archive& a, mat4& v) { a.bytes(&v, sizeof(mat4)); }
+
+    void io(Archive& a, std::string& v) {
+        uint64_t size = v.size();
+        io(a, size);
+        if (a.isReading()) {
+            if (size > std::numeric_limits<uint32_t>::max()) {
+                throw DamagedSnapshot();
+            }
+            v.resize(size);
+        }
+        a.bytes(v.data(), size);
+    }
+
+    void io(Archive& a, std::filesystem::path& v) {
+        std::string str = v.string();
+        io(a, str);
+        v = str;
+    }
+
+    // The overloads for the config structs have to be declared before the templates for
+    // the containers so that they are found when the templates are instantiated
+    void io(Archive& a, User::Tracking& v);
+    void io(Archive& a, User& v);
+    void io(Archive& a, Capture::ScreenShotRange& v);
+    void io(Archive& a, Capture& v);
+    void io(Archive& a, Scene& v);
+    void io(Archive& a, Settings::Display& v);
+    void io(Archive& a, Settings& v);
+    void io(Archive& a, Device::Sensors& v);
+    void io(Archive& a, Device::Buttons& v);
+    void io(Archive& a, Device::Axes& v);
+    void io(Archive& a, Device& v);
+    void io(Archive& a, Tracker::Prediction& v);
+    void io(Archive& a, Tracker& v);
+    void io(Archive& a, NoProjection& v);
+    void io(Archive& a, PlanarProjection::FOV& v);
+    void io(Archive& a, PlanarProjection& v);
+    void io(Archive& a, TextureMappedProjection& v);
+    void io(Archive& a, FisheyeProjection::Crop& v);
+    void io(Archive& a, FisheyeProjection& v);
+    void io(Archive& a, SphericalMirrorProjection::Mesh& v);
+    void io(Archive& a, SphericalMirrorProjection& v);
+    void io(Archive& a, SpoutOutputProjection::Channels& v);
+    void io(Archive& a, SpoutOutputProjection& v);
+    void io(Archive& a, SpoutFlatProjection& v);
+    void io(Archive& a, CylindricalProjection& v);
+    void io(Archive& a, EquirectangularProjection& v);
+    void io(Archive& a, ProjectionPlane& v);
+    void io(Archive& a, Viewport& v);
+    void io(Archive& a, Window& v);
+    void io(Archive& a, Node& v);
+
+    template <typename T>
+    void io(Archive& a, std::optional<T>& v) {
+        bool hasValue = v.has_value();
+        io(a, hasValue);
+        if (a.isReading()) {
+            v = hasValue ? std::optional<T>(T()) : std::nullopt;
+        }
+        if (hasValue) {
+            io(a, *v);
+        }
+    }
+
+    template <typename T>
+    void io(Archive& a, std::vector<T>& v) {
+        uint64_t size = v.size();
+        io(a, size);
+        if (a.isReading()) {
+            if (size > std::numeric_limits<uint32_t>::max()) {
+                throw DamagedSnapshot();
+            }
+            v.resize(size);
+        }
+        for (T& e : v) {
+            io(a, e);
+        }
+    }
+
+    template <typename... Ts, size_t... Is>
+    std::variant<Ts...> variantFromIndex(size_t index, std::index_sequence<Is...>) {
+        std::variant<Ts...> res;
+        ((index == Is ? (res.template emplace<Is>(), true) : false) || ...);
+        return res;
+    }
+
+    template <typename... Ts>
+    void io(Archive& a, std::variant<Ts...>& v) {
+        uint32_t index = static_cast<uint32_t>(v.index());
+        io(a, index);
+        if (a.isReading()) {
+            if (index >= sizeof...(Ts)) {
+                throw DamagedSnapshot();
+            }
+            v = variantFromIndex<Ts...>(index, std::index_sequence_for<Ts...>());
+        }
+        std::visit([&a](auto& alternative) { io(a, alternative); }, v);
+    }
+
+    template <typename... Ts>
+    void fields(Archive& a, Ts&... values) {
+        (io(a, values), ...);
+    }
+
+    void io(Archive& a, User::Tracking& v) {
+        fields(a, v.tracker, v.device);
+    }
+
+    void io(Archive& a, User& v) {
+        fields(a, v.name, v.eyeSeparation, v.position, v.transformation, v.tracking);
+    }
+
+    void io(Archive& a, Capture::ScreenShotRange& v) {
+        fields(a, v.first, v.last);
+    }
+
+    void io(Archive& a, Capture& v) {
+        fields(a, v.path, v.format, v.range);
+    }
+
+    void io(Archive& a, Scene& v) {
+        fields(a, v.offset, v.orientation, v.scale);
+    }
+
+    void io(Archive& a, Settings::Display& v) {
+        fields(a, v.swapInterval, v.refreshRate);
+    }
+
+    void io(Archive& a, Settings& v) {
+        fields(
+            a,
+            v.useDepthTexture, v.useNormalTexture, v.usePositionTexture,
+            v.bufferFloatPrecision, v.display
+        );
+    }
+
+    void io(Archive& a, Device::Sensors& v) {
+        fields(a, v.vrpnAddress, v.identifier);
+    }
+
+    void io(Archive& a, Device::Buttons& v) {
+        fields(a, v.vrpnAddress, v.count);
+    }
+
+    void io(Archive& a, Device::Axes& v) {
+        fields(a, v.vrpnAddress, v.count);
+    }
+
+    void io(Archive& a, Device& v) {
+        fields(a, v.name, v.sensors, v.buttons, v.axes, v.offset, v.transformation);
+    }
+
+    void io(Archive& a, Tracker::Prediction& v) {
+        fields(a, v.method, v.latency, v.smoothing);
+    }
+
+    void io(Archive& a, Tracker& v) {
+        fields(a, v.name, v.devices, v.offset, v.scale, v.transformation, v.prediction);
+    }
+
+    void io(Archive&, NoProjection&) {}
+
+    void io(Archive& a, PlanarProjection::FOV& v) {
+        fields(a, v.down, v.left, v.right, v.up, v.distance);
+    }
+
+    void io(Archive& a, PlanarProjection& v) {
+        fields(a, v.fov, v.orientation, v.offset);
+    }
+
+    void io(Archive& a, TextureMappedProjection& v) {
+        io(a, static_cast<PlanarProjection&>(v));
+    }
+
+    void io(Archive& a, FisheyeProjection::Crop& v) {
+        fields(a, v.left, v.right, v.bottom, v.top);
+    }
+
+    void io(Archive& a, FisheyeProjection& v) {
+        fields(
+            a,
+            v.fov, v.quality, v.interpolation, v.tilt, v.diameter, v.crop,
+            v.keepAspectRatio, v.offset, v.background
+        );
+    }
+
+    void io(Archive& a, SphericalMirrorProjection::Mesh& v) {
+        fields(a, v.bottom, v.left, v.right, v.top);
+    }
+
+    void io(Archive& a, SphericalMirrorProjection& v) {
+        fields(a, v.quality, v.tilt, v.background, v.mesh);
+    }
+
+    void io(Archive& a, SpoutOutputProjection::Channels& v) {
+        fields(a, v.right, v.zLeft, v.bottom, v.top, v.left, v.zRight);
+    }
+
+    void io(Archive& a, SpoutOutputProjection& v) {
+        fields(
+            a,
+            v.quality, v.mapping, v.mappingSpoutName, v.background, v.channels,
+            v.orientation, v.drawMain
+        );
+    }
+
+    void io(Archive& a, SpoutFlatProjection& v) {
+        fields(
+            a,
+            v.proj, v.width, v.height, v.mappingSpoutName, v.background, v.drawMain
+        );
+    }
+
+    void io(Archive& a, CylindricalProjection& v) {
+        fields(a, v.quality, v.rotation, v.heightOffset, v.radius);
+    }
+
+    void io(Archive& a, EquirectangularProjection& v) {
+        fields(a, v.quality);
+    }
+
+    void io(Archive& a, ProjectionPlane& v) {
+        fields(a, v.lowerLeft, v.upperLeft, v.upperRight);
+    }
+
+    void io(Archive& a, Viewport& v) {
+        fields(
+            a,
+            v.user, v.overlayTexture, v.blendMaskTexture, v.blackLevelMaskTexture,
+            v.correctionMeshTexture, v.isTracked, v.eye, v.position, v.size, v.projection
+        );
+    }
+
+    void io(Archive& a, Window& v) {
+        fields(
+            a,
+            v.id, v.name, v.tags, v.bufferBitDepth, v.isFullScreen, v.shouldAutoiconify,
+            v.hideMouseCursor, v.isFloating, v.alwaysRender, v.isHidden,
+            v.doubleBuffered, v.msaa, v.useFxaa, v.isDecorated, v.isResizable, v.draw2D,
+            v.draw3D, v.isMirrored, v.blitWindowId, v.monitor, v.stereo, v.pos, v.size,
+            v.resolution, v.viewports
+        );
+    }
+
+    void io(Archive& a, Node& v) {
+        fields(a, v.address, v.port, v.dataTransferPort, v.swapLock, v.windows);
+    }
+
+    void io(Archive& a, Cluster& v) {
+        fields(
+            a,
+            v.masterAddress, v.debugLog, v.setThreadAffinity, v.firmSync, v.scene,
+            v.nodes, v.users, v.capture, v.trackers, v.settings
+        );
+    }
+
+    std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file = std::ifstream(path, std::ios::in | std::ios::binary);
+        if (file.fail()) {
+            throw Err(6082, std::format("Failed to open '{}'", path));
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+} // namespace
+
+namespace sgct {
+
+uint64_t configSnapshotHash(const std::filesystem::path& path,
+                            std::string_view configuration, std::string_view schema)
+{
+    // The sizes separate the parts so that moving text between them changes the hash
+    uint64_t h = Fnv1aOffsetBasis;
+    const std::string p = std::filesystem::absolute(path).string();
+    for (std::string_view part : { std::string_view(p), configuration, schema }) {
+        h = fnv1a(std::format("{}|", part.size()), h);
+        h = fnv1a(part, h);
+    }
+    return h;
+}
+
+std::filesystem::path configSnapshotPath(const std::filesystem::path& path) {
+    std::filesystem::path res = path;
+    res += ".sgctsnapshot";
+    return res;
+}
+
+std::string serializeCluster(const config::Cluster& cluster) {
+    // The archive only reads from the cluster while writing, but uses the same non-const
+    // functions as the reading
+    config::Cluster c = cluster;
+    std::string payload;
+    Archive archive = Archive(payload);
+    io(archive, c);
+    return payload;
+}
+
+std::optional<config::Cluster> deserializeCluster(std::string_view data) {
+    try {
+        config::Cluster cluster;
+        Archive archive = Archive(data);
+        io(archive, cluster);
+        if (!archive.isAtEnd()) {
+            return std::nullopt;
+        }
+        cluster.success = true;
+        return cluster;
+    }
+    catch (const DamagedSnapshot&) {
+        return std::nullopt;
+    }
+}
+
+void writeConfigSnapshot(const std::filesystem::path& snapshotPath,
+                         const config::Cluster& cluster, uint64_t hash)
+{
+    ZoneScoped;
+
+    const std::string payload = serializeCluster(cluster);
+
+    SnapshotHeader header;
+    header.hash = hash;
+    header.size = payload.size();
+
+    // Every node that finds an outdated snapshot writes it
+    const std::filesystem::path tmp = temporaryPath(snapshotPath);
+    {
+        std::ofstream file = std::ofstream(tmp, std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            throw Err(
+                6120,
+                std::format("Failed to write configuration snapshot '{}'", snapshotPath)
+            );
+        }
+        file.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader));
+        file.write(payload.data(), payload.size());
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(tmp);
+            throw Err(
+                6120,
+                std::format("Failed to write configuration snapshot '{}'", snapshotPath)
+            );
+        }
+    }
+    std::filesystem::rename(tmp, snapshotPath);
+}
+
+std::optional<config::Cluster> readConfigSnapshot(
+                                                const std::filesystem::path& snapshotPath,
+                                                uint64_t hash)
+{
+    ZoneScoped;
+
+    std::ifstream file = std::ifstream(snapshotPath, std::ios::in | std::ios::binary);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+    SnapshotHeader header;
+    file.read(reinterpret_cast<char*>(&header), sizeof(SnapshotHeader));
+    if (!file.good() || header.magic != SnapshotMagic ||
+        header.version != SnapshotVersion || header.hash != hash ||
+        header.size > std::numeric_limits<uint32_t>::max())
+    {
+        return std::nullopt;
+    }
+    std::string payload = std::string(header.size, '\0');
+    file.read(payload.data(), header.size);
+    if (file.gcount() != static_cast<std::streamsize>(header.size)) {
+        return std::nullopt;
+    }
+
+    return deserializeCluster(payload);
+}
+
+config::Cluster readConfigWithSnapshot(const std::filesystem::path& filename,
+                                       const std::filesystem::path& schema)
+{
+    ZoneScoped;
+
+    const std::filesystem::path name = std::filesystem::absolute(filename);
+    if (filename.empty() || !std::filesystem::exists(name)) {
+        // Report the missing file in the same way as without a snapshot
+        return readConfig(filename);
+    }
+
+    const uint64_t h = configSnapshotHash(
+        name,
+        readFile(name),
+        schema.empty() ? "" : readFile(schema)
+    );
+    const std::filesystem::path snapshotPath = configSnapshotPath(name);
+    std::optional<config::Cluster> snapshot = readConfigSnapshot(snapshotPath, h);
+    if (snapshot) {
+        Log::Debug(std::format("Using configuration snapshot '{}'", snapshotPath));
+        return std::move(*snapshot);
+    }
+
+    if (!schema.empty()) {
+        loadFileAndSchemaThenValidate(
+            name,
+            schema,
+            "The configuration file could not be validated before creating its snapshot"
+        );
+    }
+    config::Cluster cluster = readConfig(name);
+    try {
+        writeConfigSnapshot(snapshotPath, cluster, h);
+    }
+    catch (const std::exception& e) {
+        // A read-only configuration folder should not prevent the configuration from
+        // being used
+        Log::Warning(std::format(
+            "Failed to write configuration snapshot '{}': {}", snapshotPath, e.what()
+        ));
+    }
+    return cluster;
+}
+
+} // namespace sgct
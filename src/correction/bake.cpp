@@ -0,0 +1,185 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/bake.h>
+
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <span>
+#include <thread>
+
+namespace {
+    using sgct::correction::Buffer;
+
+    // A triangle in framebuffer pixel coordinates
+    struct Triangle {
+        std::array<const Buffer::Vertex*, 3> vertices;
+        std::array<float, 3> x;
+        std::array<float, 3> y;
+        float area = 0.f;
+        int minRow = 0;
+        int maxRow = 0;
+    };
+
+    std::vector<Triangle> triangles(const Buffer& buffer, sgct::ivec2 resolution) {
+        const std::vector<unsigned int>& idx = buffer.indices;
+        const size_t step = buffer.geometryType == GL_TRIANGLE_STRIP ? 1 : 3;
+
+        std::vector<Triangle> res;
+        res.reserve(idx.size() / step);
+        for (size_t i = 0; i + 2 < idx.size(); i += step) {
+            Triangle t;
+            for (size_t k = 0; k < 3; k++) {
+                const Buffer::Vertex& v = buffer.vertices[idx[i + k]];
+                t.vertices[k] = &v;
+                t.x[k] = (v.x + 1.f) * 0.5f * resolution.x;
+                t.y[k] = (v.y + 1.f) * 0.5f * resolution.y;
+            }
+            t.area = (t.x[1] - t.x[0]) * (t.y[2] - t.y[0]) -
+                     (t.y[1] - t.y[0]) * (t.x[2] - t.x[0]);
+            if (t.area == 0.f) {
+                // Degenerate triangles, for example to connect rows of a strip
+                continue;
+            }
+            const auto [minY, maxY] = std::minmax({ t.y[0], t.y[1], t.y[2] });
+            t.minRow = static_cast<int>(std::floor(minY));
+            t.maxRow = static_cast<int>(std::ceil(maxY));
+            res.push_back(t);
+        }
+        return res;
+    }
+
+    // Rasterizes all triangles into the rows [rowBegin, rowEnd) of the textures, where
+    // (x0, y0) is the framebuffer pixel of the first texel
+    void rasterize(std::span<const Triangle> triangles, sgct::correction::BakedWarp& res,
+                   int x0, int y0, int rowBegin, int rowEnd)
+    {
+        // Pixels on the shared edge of two triangles are written by both triangles, which
+        // is harmless as both interpolate the same value there
+        constexpr float Epsilon = -1e-5f;
+
+        for (const Triangle& t : triangles) {
+            const int r0 = std::max(t.minRow - y0, rowBegin);
+            const int r1 = std::min(t.maxRow - y0, rowEnd);
+            if (r0 >= r1) {
+                continue;
+            }
+            const auto [minX, maxX] = std::minmax({ t.x[0], t.x[1], t.x[2] });
+            const int c0 = std::max(static_cast<int>(std::floor(minX)) - x0, 0);
+            const int c1 = std::min(static_cast<int>(std::ceil(maxX)) - x0, res.size.x);
+
+            const float invArea = 1.f / t.area;
+            for (int r = r0; r < r1; r++) {
+                const float py = static_cast<float>(y0 + r) + 0.5f;
+                for (int c = c0; c < c1; c++) {
+                    const float px = static_cast<float>(x0 + c) + 0.5f;
+                    const float l0 = ((t.x[1] - px) * (t.y[2] - py) -
+                                      (t.y[1] - py) * (t.x[2] - px)) * invArea;
+                    const float l1 = ((t.x[2] - px) * (t.y[0] - py) -
+                                      (t.y[2] - py) * (t.x[0] - px)) * invArea;
+                    const float l2 = 1.f - l0 - l1;
+                    if (l0 < Epsilon || l1 < Epsilon || l2 < Epsilon) {
+                        continue;
+                    }
+
+                    const Buffer::Vertex& v0 = *t.vertices[0];
+                    const Buffer::Vertex& v1 = *t.vertices[1];
+                    const Buffer::Vertex& v2 = *t.vertices[2];
+                    const size_t i = static_cast<size_t>(r) * res.size.x + c;
+                    res.lookup[i] = sgct::vec3{
+                        l0 * v0.s + l1 * v1.s + l2 * v2.s,
+                        l0 * v0.t + l1 * v1.t + l2 * v2.t,
+                        1.f
+                    };
+                    res.blend[i] = sgct::vec4{
+                        l0 * v0.r + l1 * v1.r + l2 * v2.r,
+                        l0 * v0.g + l1 * v1.g + l2 * v2.g,
+                        l0 * v0.b + l1 * v1.b + l2 * v2.b,
+                        l0 * v0.a + l1 * v1.a + l2 * v2.a
+                    };
+                }
+            }
+        }
+    }
+} // namespace
+
+namespace sgct::correction {
+
+BakedWarp bakeWarp(const Buffer& buffer, ivec2 resolution, unsigned int nThreads) {
+    ZoneScoped;
+
+    BakedWarp res;
+    const std::vector<Triangle> tris = triangles(buffer, resolution);
+    if (tris.empty()) {
+        return res;
+    }
+
+    // Bounding box of the mesh in framebuffer pixels, clamped to the framebuffer
+    float minX = std::numeric_limits<float>::max();
+    float minY = std::numeric_limits<float>::max();
+    float maxX = -std::numeric_limits<float>::max();
+    float maxY = -std::numeric_limits<float>::max();
+    for (const Triangle& t : tris) {
+        minX = std::min({ minX, t.x[0], t.x[1], t.x[2] });
+        minY = std::min({ minY, t.y[0], t.y[1], t.y[2] });
+        maxX = std::max({ maxX, t.x[0], t.x[1], t.x[2] });
+        maxY = std::max({ maxY, t.y[0], t.y[1], t.y[2] });
+    }
+    const int x0 = std::clamp(static_cast<int>(std::floor(minX)), 0, resolution.x);
+    const int y0 = std::clamp(static_cast<int>(std::floor(minY)), 0, resolution.y);
+    const int x1 = std::clamp(static_cast<int>(std::ceil(maxX)), 0, resolution.x);
+    const int y1 = std::clamp(static_cast<int>(std::ceil(maxY)), 0, resolution.y);
+    if (x1 <= x0 || y1 <= y0) {
+        return res;
+    }
+
+    res.size = ivec2{ x1 - x0, y1 - y0 };
+    res.lowerLeft = vec2{
+        2.f * x0 / resolution.x - 1.f,
+        2.f * y0 / resolution.y - 1.f
+    };
+    res.upperRight = vec2{
+        2.f * x1 / resolution.x - 1.f,
+        2.f * y1 / resolution.y - 1.f
+    };
+    const size_t nTexels = static_cast<size_t>(res.size.x) * res.size.y;
+    res.lookup.resize(nTexels, vec3{ 0.f, 0.f, 0.f });
+    res.blend.resize(nTexels, vec4{ 0.f, 0.f, 0.f, 0.f });
+
+    // Each thread rasterizes all triangles into its own band of rows, so the threads
+    // never write the same texel and the result does not depend on the number of threads
+    if (nThreads == 0) {
+        nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    const int nBands = std::min(static_cast<int>(nThreads), res.size.y);
+    const int bandSize = (res.size.y + nBands - 1) / nBands;
+    std::vector<std::thread> threads;
+    for (int band = 1; band < nBands; band++) {
+        threads.emplace_back(
+            rasterize,
+            std::span<const Triangle>(tris),
+            std::ref(res),
+            x0,
+            y0,
+            band * bandSize,
+            std::min((band + 1) * bandSize, res.size.y)
+        );
+    }
+    rasterize(tris, res, x0, y0, 0, std::min(bandSize, res.size.y));
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return res;
+}
+
+} // namespace sgct::correction
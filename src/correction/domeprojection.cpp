@@ -13,10 +13,10 @@
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
+#include <sgct/correction/tokenizer.h>
 #include <glm/glm.hpp>
-#include <scn/scan.h>
 #include <algorithm>
-#include <fstream>
+#include <optional>
 
 namespace sgct::correction {
 
@@ -27,8 +27,8 @@ Buffer generateDomeProjectionMesh(const std::filesystem::path& path, const vec2&
 
     Log::Info(std::format("Reading DomeProjection mesh data from '{}'", path));
 
-    std::ifstream meshFile(path);
-    if (!meshFile.good()) {
+    const TextFile file = TextFile(path);
+    if (!file.isOpen()) {
         throw Error(
             Error::Component::DomeProjection, 2010,
             std::format("Failed to open '{}'", path)
@@ -39,14 +39,15 @@ Buffer generateDomeProjectionMesh(const std::filesystem::path& path, const vec2&
 
     unsigned int nCols = 0;
     unsigned int nRows = 0;
-    std::string line;
-    while (std::getline(meshFile, line)) {
-        auto r = scn::scan<float, float, float, float, unsigned int, unsigned int>(
-            line, "{};{};{};{};{};{}"
-        );
-        if (r) {
-            auto [x, y, u, v, col, row] = r->values();
-
+    Tokenizer tokenizer = Tokenizer(file.text(), ";");
+    while (tokenizer.nextLine()) {
+        const std::optional<float> x = tokenizer.nextFloat();
+        const std::optional<float> y = tokenizer.nextFloat();
+        const std::optional<float> u = tokenizer.nextFloat();
+        const std::optional<float> v = tokenizer.nextFloat();
+        const std::optional<unsigned int> col = tokenizer.nextUnsignedInt();
+        const std::optional<unsigned int> row = tokenizer.nextUnsignedInt();
+        if (x && y && u && v && col && row) {
             // init to max intensity (opaque white)
             Buffer::Vertex vertex;
             vertex.r = 1.f;
@@ -55,22 +56,22 @@ Buffer generateDomeProjectionMesh(const std::filesystem::path& path, const vec2&
             vertex.a = 1.f;
 
             // find dimensions of meshdata
-            nCols = std::max(nCols, col);
-            nRows = std::max(nRows, row);
+            nCols = std::max(nCols, *col);
+            nRows = std::max(nRows, *row);
 
-            x = std::clamp(x, 0.f, 1.f);
-            y = std::clamp(y, 0.f, 1.f);
+            const float cx = std::clamp(*x, 0.f, 1.f);
+            const float cy = std::clamp(*y, 0.f, 1.f);
 
             // convert to [-1, 1]
-            vertex.x = 2.f * (pos.x + x * size.x) - 1.f;
+            vertex.x = 2.f * (pos.x + cx * size.x) - 1.f;
 
             // (abock, 2019-08-30); I'm not sure why the y inversion happens
             // here. It seems like a mistake, but who knows
-            vertex.y = 2.f * (pos.y + (1.f - y) * size.y) - 1.f;
+            vertex.y = 2.f * (pos.y + (1.f - cy) * size.y) - 1.f;
 
             // scale to viewport coordinates
-            vertex.s = pos.x + u * size.x;
-            vertex.t = pos.y + (1.f - v) * size.y;
+            vertex.s = pos.x + *u * size.x;
+            vertex.t = pos.y + (1.f - *v) * size.y;
 
             buf.vertices.push_back(std::move(vertex));
         }
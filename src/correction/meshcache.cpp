@@ -0,0 +1,256 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/meshcache.h>
+
+#include <sgct/error.h>
+#include <sgct/fileutils.h>
+#include <sgct/format.h>
+#include <sgct/profiling.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    // Increase this version whenever the layout of the file or the processing of the
+    // loaders changes so that old cache files are ignored
+    constexpr uint32_t CacheVersion = 2;
+    constexpr std::array<char, 4> CacheMagic = { 'S', 'G', 'C', 'M' };
+
+    enum CacheFlags : uint32_t {
+        HasViewPlane = 1 << 0,
+        HasProjectionOffset = 1 << 1,
+        HasUserPosition = 1 << 2
+    };
+
+    struct CacheHeader {
+        std::array<char, 4> magic = CacheMagic;
+        uint32_t version = CacheVersion;
+        uint32_t keyLength = 0;
+        uint32_t geometryType = 0;
+        uint64_t nVertices = 0;
+        uint64_t nIndices = 0;
+        uint32_t flags = 0;
+        // up, down, left, right, and the orientation as x, y, z, w
+        std::array<float, 8> viewPlane = {};
+        std::array<float, 3> projectionOffset = {};
+        std::array<float, 3> userPosition = {};
+        uint32_t padding = 0;
+    };
+    static_assert(sizeof(CacheHeader) == 96);
+    static_assert(sizeof(sgct::correction::Buffer::Vertex) == 8 * sizeof(float));
+
+    // Separates the state of the source file from the rest of the key
+    constexpr char FileStateSeparator = '#';
+
+    // The key is padded so that the vertices start at an 8 byte boundary
+    size_t paddedKeyLength(size_t keyLength) {
+        return (keyLength + 7) & ~size_t(7);
+    }
+} // namespace
+
+namespace sgct::correction {
+
+std::string meshCacheKey(const std::filesystem::path& path, vec2 pos, vec2 size,
+                         float aspectRatio, bool textureRenderMode,
+                         float simplificationError, bool isOptimized)
+{
+    const std::filesystem::path p = std::filesystem::canonical(path);
+    const auto modified = std::filesystem::last_write_time(p).time_since_epoch().count();
+    // The state of the source file is last so that meshCachePath can ignore it
+    return std::format(
+        "{}|{},{}|{},{}|{}|{}|{}|{}{}{}|{}",
+        p.string(), pos.x, pos.y, size.x, size.y, aspectRatio, textureRenderMode,
+        simplificationError, isOptimized, FileStateSeparator,
+        std::filesystem::file_size(p), modified
+    );
+}
+
+std::filesystem::path meshCachePath(const std::filesystem::path& path,
+                                    std::string_view key)
+{
+    // A modified source mesh overwrites its previous cache file instead of adding another
+    const std::string_view name = key.substr(0, key.rfind(FileStateSeparator));
+    const uint64_t hash = fnv1a(name);
+    std::filesystem::path res = path;
+    res.replace_filename(std::format("{}.{:016x}.sgctmesh", path.filename(), hash));
+    return res;
+}
+
+void writeCachedMesh(const std::filesystem::path& cachePath, std::string_view key,
+                     const Buffer& buffer)
+{
+    ZoneScoped;
+
+    CacheHeader header;
+    header.keyLength = static_cast<uint32_t>(key.size());
+    header.geometryType = buffer.geometryType;
+    header.nVertices = buffer.vertices.size();
+    header.nIndices = buffer.indices.size();
+    if (buffer.viewPlane) {
+        const Buffer::ViewPlane& vp = *buffer.viewPlane;
+        header.flags |= HasViewPlane;
+        header.viewPlane = {
+            vp.up, vp.down, vp.left, vp.right,
+            vp.orientation.x, vp.orientation.y, vp.orientation.z, vp.orientation.w
+        };
+    }
+    if (buffer.projectionOffset) {
+        const vec3& o = *buffer.projectionOffset;
+        header.flags |= HasProjectionOffset;
+        header.projectionOffset = { o.x, o.y, o.z };
+    }
+    if (buffer.userPosition) {
+        const vec3& u = *buffer.userPosition;
+        header.flags |= HasUserPosition;
+        header.userPosition = { u.x, u.y, u.z };
+    }
+
+    // Several nodes can share the same cache
+    const std::filesystem::path tmp = temporaryPath(cachePath);
+    {
+        std::ofstream file = std::ofstream(tmp, std::ios::out | std::ios::binary);
+        if (!file.is_open()) {
+            throw Error(
+                Error::Component::CorrectionMesh, 2003,
+                std::format("Failed to write correction mesh cache '{}'", cachePath)
+            );
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+        std::array<char, 8> padding = {};
+        file.write(key.data(), key.size());
+        file.write(padding.data(), paddedKeyLength(key.size()) - key.size());
+        file.write(
+            reinterpret_cast<const char*>(buffer.vertices.data()),
+            buffer.vertices.size() * sizeof(Buffer::Vertex)
+        );
+        file.write(
+            reinterpret_cast<const char*>(buffer.indices.data()),
+            buffer.indices.size() * sizeof(unsigned int)
+        );
+        if (!file.good()) {
+            file.close();
+            std::filesystem::remove(tmp);
+            throw Error(
+                Error::Component::CorrectionMesh, 2003,
+                std::format("Failed to write correction mesh cache '{}'", cachePath)
+            );
+        }
+    }
+    std::filesystem::rename(tmp, cachePath);
+}
+
+CachedMesh::CachedMesh(MappedFile file) : _file(std::move(file)) {}
+
+std::optional<CachedMesh> CachedMesh::open(const std::filesystem::path& cachePath,
+                                           std::string_view key)
+{
+    ZoneScoped;
+
+    MappedFile file = MappedFile(cachePath);
+    if (!file.isOpen() || file.size() < sizeof(CacheHeader)) {
+        return std::nullopt;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, file.data(), sizeof(CacheHeader));
+    if (header.magic != CacheMagic || header.version != CacheVersion ||
+        header.keyLength != key.size())
+    {
+        return std::nullopt;
+    }
+
+    const size_t keyOffset = sizeof(CacheHeader);
+    const size_t verticesOffset = keyOffset + paddedKeyLength(key.size());
+    const size_t indicesOffset =
+        verticesOffset + header.nVertices * sizeof(Buffer::Vertex);
+    const size_t end = indicesOffset + header.nIndices * sizeof(unsigned int);
+    if (file.size() != end) {
+        return std::nullopt;
+    }
+    const std::string_view storedKey = std::string_view(
+        reinterpret_cast<const char*>(file.data() + keyOffset),
+        key.size()
+    );
+    if (storedKey != key) {
+        return std::nullopt;
+    }
+
+    CachedMesh mesh = CachedMesh(std::move(file));
+    mesh._geometryType = header.geometryType;
+    if (header.flags & HasViewPlane) {
+        const std::array<float, 8>& vp = header.viewPlane;
+        mesh._viewPlane = Buffer::ViewPlane{
+            .up = vp[0],
+            .down = vp[1],
+            .left = vp[2],
+            .right = vp[3],
+            .orientation = quat(vp[4], vp[5], vp[6], vp[7])
+        };
+    }
+    if (header.flags & HasProjectionOffset) {
+        const std::array<float, 3>& o = header.projectionOffset;
+        mesh._projectionOffset = vec3{ o[0], o[1], o[2] };
+    }
+    if (header.flags & HasUserPosition) {
+        const std::array<float, 3>& u = header.userPosition;
+        mesh._userPosition = vec3{ u[0], u[1], u[2] };
+    }
+
+    // The mapping starts at a page boundary and all offsets are multiples of 4, so the
+    // vertices and indices are correctly aligned inside the mapped file
+    const std::byte* data = mesh._file.data();
+    mesh._vertices = std::span<const Buffer::Vertex>(
+        reinterpret_cast<const Buffer::Vertex*>(data + verticesOffset),
+        header.nVertices
+    );
+    mesh._indices = std::span<const unsigned int>(
+        reinterpret_cast<const unsigned int*>(data + indicesOffset),
+        header.nIndices
+    );
+    return mesh;
+}
+
+std::span<const Buffer::Vertex> CachedMesh::vertices() const {
+    return _vertices;
+}
+
+std::span<const unsigned int> CachedMesh::indices() const {
+    return _indices;
+}
+
+unsigned int CachedMesh::geometryType() const {
+    return _geometryType;
+}
+
+const std::optional<Buffer::ViewPlane>& CachedMesh::viewPlane() const {
+    return _viewPlane;
+}
+
+const std::optional<vec3>& CachedMesh::projectionOffset() const {
+    return _projectionOffset;
+}
+
+const std::optional<vec3>& CachedMesh::userPosition() const {
+    return _userPosition;
+}
+
+Buffer CachedMesh::toBuffer() const {
+    Buffer buf;
+    buf.vertices.assign(_vertices.begin(), _vertices.end());
+    buf.indices.assign(_indices.begin(), _indices.end());
+    buf.geometryType = _geometryType;
+    buf.viewPlane = _viewPlane;
+    buf.projectionOffset = _projectionOffset;
+    buf.userPosition = _userPosition;
+    return buf;
+}
+
+} // namespace sgct::correction
@@ -6,15 +6,17 @@
  * For conditions of distribution and use, see copyright notice in LICENSE.md            *
  ****************************************************************************************/
 
-#include <sgct/correction/skyskan.h>
+#include <sgct/correction/obj.h>
 
 #include <sgct/error.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
+#include <sgct/correction/tokenizer.h>
+#include <algorithm>
 #include <cassert>
-#include <fstream>
+#include <optional>
 
 namespace {
     struct Position {
@@ -39,8 +41,8 @@ Buffer generateOBJMesh(const std::filesystem::path& path) {
 
     Log::Info(std::format("Reading Wavefront OBJ mesh data from '{}'", path));
 
-    std::ifstream file(path);
-    if (!file.good()) {
+    const TextFile file = TextFile(path);
+    if (!file.isOpen()) {
         throw Error(
             Error::Component::OBJ, 2030, std::format("Failed to open '{}'", path)
         );
@@ -52,110 +54,64 @@ Buffer generateOBJMesh(const std::filesystem::path& path) {
 
     std::vector<std::string> reported;
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        else if (line.back() == '\r') {
-            line.pop_back();
-        }
-
-        const std::string_view v = line;
-        const size_t separator = v.find(' ');
-        std::string_view first = v.substr(0, separator);
-        std::string_view rest = v.substr(separator + 1);
+    Tokenizer tokenizer = Tokenizer(file.text());
+    while (tokenizer.nextLine()) {
+        const std::string_view first = tokenizer.nextToken();
 
         if (first == "v") {
-            size_t sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
-                throw Error(
-                    Error::Component::OBJ, 2034,
-                    std::format(
-                        "Illegal vertex format in OBJ file '{}' in line {}", path, line
-                    )
-                );
-            }
-            const std::string_view v1 = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
+            const std::optional<float> x = tokenizer.nextFloat();
+            const std::optional<float> y = tokenizer.nextFloat();
+            const std::optional<float> z = tokenizer.nextFloat();
+            if (!x || !y || !z) {
                 throw Error(
                     Error::Component::OBJ, 2034,
                     std::format(
-                        "Illegal vertex format in OBJ file '{}' in line {}", path, line
+                        "Illegal vertex format in OBJ file '{}' in line {}",
+                        path, tokenizer.line()
                     )
                 );
             }
-            const std::string_view v2 = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            const std::string_view v3 = rest;
-            const float z = std::stof(std::string(v3));
-            if (z != 0.f) {
+            if (*z != 0.f) {
                 Log::Warning(std::format(
                     "Vertex in '{}' was using z coordinate which is not supported", path
                 ));
             }
 
-            Position p;
-            p.x = std::stof(std::string(v1));
-            p.y = std::stof(std::string(v2));
-            positions.push_back(p);
+            positions.push_back({ .x = *x, .y = *y });
         }
         else if (first == "vt") {
-            size_t sep = rest.find(' ');
-            const std::string_view v1 = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            sep = rest.find(' ');
-            const std::string_view v2 = rest.substr(0, sep);
-
-            Texture t;
-            t.s = std::stof(std::string(v1));
-            t.t = std::stof(std::string(v2));
-            texCoords.push_back(t);
-        }
-        else if (first == "f") {
-            size_t sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
+            const std::optional<float> s = tokenizer.nextFloat();
+            const std::optional<float> t = tokenizer.nextFloat();
+            if (!s || !t) {
                 throw Error(
-                    Error::Component::OBJ, 2035,
+                    Error::Component::OBJ, 2036,
                     std::format(
-                        "Illegal face format in OBJ file '{}' in line {}", path, line
+                        "Illegal texture coordinate format in OBJ file '{}' in line {}",
+                        path, tokenizer.line()
                     )
                 );
             }
-            const std::string_view f1 = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
 
-            sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
+            texCoords.push_back({ .s = *s, .t = *t });
+        }
+        else if (first == "f") {
+            // Each vertex of the face might consist of the position, texture coordinate,
+            // and normal index separated by '/'. Only the position index is used and the
+            // conversion stops at the first '/'
+            const std::optional<int> f1 = tokenizer.nextInt();
+            const std::optional<int> f2 = tokenizer.nextInt();
+            const std::optional<int> f3 = tokenizer.nextInt();
+            if (!f1 || !f2 || !f3) {
                 throw Error(
                     Error::Component::OBJ, 2035,
                     std::format(
-                        "Illegal face format in OBJ file '{}' in line {}", path, line
+                        "Illegal face format in OBJ file '{}' in line {}",
+                        path, tokenizer.line()
                     )
                 );
             }
-            const std::string_view f2 = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            sep = rest.find(' ');
-            const std::string_view f3 =
-                sep == std::string_view::npos ?
-                rest :
-                rest.substr(0, sep);
 
-            // The face description might just consist of a single value, in which case
-            // the f.find method will return npos, which tells substr to "extract" the
-            // entire string -> et voila; it still works
-            Face f;
-            f.f1 = std::stoi(std::string(f1.substr(0, f1.find('/'))));
-            f.f2 = std::stoi(std::string(f2.substr(0, f2.find('/'))));
-            f.f3 = std::stoi(std::string(f3.substr(0, f3.find('/'))));
-            faces.emplace_back(f);
+            faces.push_back({ .f1 = *f1, .f2 = *f2, .f3 = *f3 });
         }
         else if (first == "vn") {
             if (std::find(reported.begin(), reported.end(), "vn") == reported.end()) {
@@ -0,0 +1,241 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/optimize.h>
+
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+    using sgct::correction::Buffer;
+
+    constexpr unsigned int Unused = std::numeric_limits<unsigned int>::max();
+
+    // Converts a value in [0, 1] into a normalized integer as used by OpenGL
+    template <typename T>
+    T normalized(float v) {
+        constexpr float Max = static_cast<float>(std::numeric_limits<T>::max());
+        return static_cast<T>(std::lround(std::clamp(v, 0.f, 1.f) * Max));
+    }
+
+    // Returns the indices of all non-degenerate triangles of the buffer with three
+    // indices per triangle. Every other triangle of a strip has its first two indices
+    // swapped to keep the same winding as in the strip
+    std::vector<unsigned int> triangleList(const Buffer& buffer) {
+        const std::vector<unsigned int>& idx = buffer.indices;
+        if (buffer.geometryType != GL_TRIANGLE_STRIP) {
+            std::vector<unsigned int> res;
+            res.reserve(idx.size());
+            for (size_t i = 0; i + 2 < idx.size(); i += 3) {
+                if (idx[i] != idx[i + 1] && idx[i] != idx[i + 2] &&
+                    idx[i + 1] != idx[i + 2])
+                {
+                    res.insert(res.end(), { idx[i], idx[i + 1], idx[i + 2] });
+                }
+            }
+            return res;
+        }
+
+        std::vector<unsigned int> res;
+        res.reserve(idx.size() * 3);
+        for (size_t i = 0; i + 2 < idx.size(); i++) {
+            const unsigned int v0 = idx[i];
+            const unsigned int v1 = idx[i + 1];
+            const unsigned int v2 = idx[i + 2];
+            if (v0 == v1 || v0 == v2 || v1 == v2) {
+                continue;
+            }
+            if (i % 2 == 0) {
+                res.insert(res.end(), { v0, v1, v2 });
+            }
+            else {
+                res.insert(res.end(), { v1, v0, v2 });
+            }
+        }
+        return res;
+    }
+
+    // Tipsify as described in Algorithm 1 of the paper. Triangles are emitted in fans
+    // around a fanning vertex and the next fanning vertex is the one among the vertices
+    // of the last fan that will still be in the cache after all of its remaining
+    // triangles are emitted, preferring the oldest one
+    std::vector<unsigned int> tipsify(const std::vector<unsigned int>& indices,
+                                      size_t nVertices, unsigned int cacheSize)
+    {
+        const size_t nTriangles = indices.size() / 3;
+
+        // Triangles adjacent to each vertex in a compressed row layout
+        std::vector<unsigned int> offsets(nVertices + 1, 0);
+        for (unsigned int v : indices) {
+            offsets[v + 1]++;
+        }
+        for (size_t v = 0; v < nVertices; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+        std::vector<unsigned int> adjacency(indices.size());
+        std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++) {
+            adjacency[fill[indices[i]]++] = static_cast<unsigned int>(i / 3);
+        }
+
+        // Number of triangles of each vertex that have not been emitted yet
+        std::vector<int> live(nVertices);
+        for (size_t v = 0; v < nVertices; v++) {
+            live[v] = static_cast<int>(offsets[v + 1] - offsets[v]);
+        }
+        std::vector<int> cacheTime(nVertices, 0);
+        std::vector<bool> isEmitted(nTriangles, false);
+        std::vector<unsigned int> deadEnd;
+        std::vector<unsigned int> candidates;
+        const int k = static_cast<int>(cacheSize);
+        int time = k + 1;
+        size_t cursor = 0;
+
+        std::vector<unsigned int> res;
+        res.reserve(indices.size());
+        unsigned int fan = indices.empty() ? Unused : indices[0];
+        while (fan != Unused) {
+            candidates.clear();
+            for (unsigned int i = offsets[fan]; i < offsets[fan + 1]; i++) {
+                const unsigned int t = adjacency[i];
+                if (isEmitted[t]) {
+                    continue;
+                }
+                for (size_t j = 0; j < 3; j++) {
+                    const unsigned int v = indices[3 * t + j];
+                    res.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    live[v]--;
+                    if (time - cacheTime[v] > k) {
+                        cacheTime[v] = time;
+                        time++;
+                    }
+                }
+                isEmitted[t] = true;
+            }
+
+            fan = Unused;
+            int best = -1;
+            for (unsigned int v : candidates) {
+                if (live[v] == 0) {
+                    continue;
+                }
+                const int priority =
+                    time - cacheTime[v] + 2 * live[v] <= k ? time - cacheTime[v] : 0;
+                if (priority > best) {
+                    best = priority;
+                    fan = v;
+                }
+            }
+
+            // Skip the dead end by first using a recently referenced vertex and then by
+            // sequentially searching for any vertex that still has triangles left
+            while (fan == Unused && !deadEnd.empty()) {
+                const unsigned int v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) {
+                    fan = v;
+                }
+            }
+            while (fan == Unused && cursor < nVertices) {
+                if (live[cursor] > 0) {
+                    fan = static_cast<unsigned int>(cursor);
+                }
+                cursor++;
+            }
+        }
+        return res;
+    }
+} // namespace
+
+namespace sgct::correction {
+
+float averageCacheMissRatio(const Buffer& buffer, unsigned int cacheSize) {
+    ZoneScoped;
+
+    const std::vector<unsigned int> indices = triangleList(buffer);
+    if (indices.empty() || cacheSize == 0) {
+        return 0.f;
+    }
+
+    // The position at which each vertex was inserted into the FIFO, so that a vertex is
+    // in the cache if it was inserted within the last cacheSize insertions
+    std::vector<size_t> inserted(buffer.vertices.size(), 0);
+    size_t nInsertions = 0;
+    for (unsigned int v : indices) {
+        if (inserted[v] == 0 || nInsertions - inserted[v] >= cacheSize) {
+            nInsertions++;
+            inserted[v] = nInsertions;
+        }
+    }
+    return static_cast<float>(nInsertions) / static_cast<float>(indices.size() / 3);
+}
+
+void optimizeVertexCache(Buffer& buffer, unsigned int cacheSize) {
+    ZoneScoped;
+
+    const std::vector<unsigned int> indices = tipsify(
+        triangleList(buffer),
+        buffer.vertices.size(),
+        std::max(cacheSize, 3u)
+    );
+
+    // Sort the vertices in the order of their first use, which also removes the vertices
+    // that are not referenced by any triangle
+    std::vector<unsigned int> remap(buffer.vertices.size(), Unused);
+    std::vector<Buffer::Vertex> vertices;
+    vertices.reserve(buffer.vertices.size());
+    buffer.indices.resize(indices.size());
+    for (size_t i = 0; i < indices.size(); i++) {
+        const unsigned int v = indices[i];
+        if (remap[v] == Unused) {
+            remap[v] = static_cast<unsigned int>(vertices.size());
+            vertices.push_back(buffer.vertices[v]);
+        }
+        buffer.indices[i] = remap[v];
+    }
+    buffer.vertices = std::move(vertices);
+    buffer.geometryType = GL_TRIANGLES;
+}
+
+std::optional<std::vector<CompactVertex>> compactVertices(
+                                                 std::span<const Buffer::Vertex> vertices)
+{
+    ZoneScoped;
+
+    // Allow for small rounding errors of the loaders at the borders of the range
+    constexpr float Epsilon = 1e-4f;
+    const auto isInRange = [](float v) { return v >= -Epsilon && v <= 1.f + Epsilon; };
+
+    std::vector<CompactVertex> res;
+    res.reserve(vertices.size());
+    for (const Buffer::Vertex& v : vertices) {
+        if (!isInRange(v.s) || !isInRange(v.t) || !isInRange(v.r) || !isInRange(v.g) ||
+            !isInRange(v.b) || !isInRange(v.a))
+        {
+            return std::nullopt;
+        }
+        res.push_back({
+            .x = v.x,
+            .y = v.y,
+            .s = normalized<uint16_t>(v.s),
+            .t = normalized<uint16_t>(v.t),
+            .r = normalized<uint8_t>(v.r),
+            .g = normalized<uint8_t>(v.g),
+            .b = normalized<uint8_t>(v.b),
+            .a = normalized<uint8_t>(v.a)
+        });
+    }
+    return res;
+}
+
+} // namespace sgct::correction
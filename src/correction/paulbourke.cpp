@@ -15,9 +15,9 @@
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
 #include <sgct/window.h>
+#include <sgct/correction/tokenizer.h>
 #include <glm/glm.hpp>
-#include <scn/scan.h>
-#include <fstream>
+#include <optional>
 
 namespace sgct::correction {
 
@@ -30,57 +30,57 @@ Buffer generatePaulBourkeMesh(const std::filesystem::path& path, const vec2& pos
 
     Log::Info(std::format("Reading Paul Bourke spherical mirror mesh from '{}'", path));
 
-    std::ifstream meshFile(path);
-    if (!meshFile.good()) {
+    const TextFile file = TextFile(path);
+    if (!file.isOpen()) {
         throw Error(
             Error::Component::PaulBourke, 2040,
             std::format("Failed to open '{}'", path)
         );
     }
 
-    std::string line;
+    Tokenizer tokenizer = Tokenizer(file.text());
 
     // get the first line containing the mapping type _id
-    if (std::getline(meshFile, line)) {
-        auto r = scn::scan_value<int>(line);
-        if (!r) {
-            throw Error(
-                Error::Component::PaulBourke, 2041,
-                std::format("Error reading mapping type in file '{}'", path)
-            );
-        }
+    if (tokenizer.nextLine() && !tokenizer.nextInt()) {
+        throw Error(
+            Error::Component::PaulBourke, 2041,
+            std::format("Error reading mapping type in file '{}'", path)
+        );
     }
 
     // get the mesh dimensions
-    std::optional<glm::ivec2> meshSize;
-    if (std::getline(meshFile, line)) {
-        auto r = scn::scan<int, int>(line, "{} {}");
-        if (!r) {
-            throw Error(
-                Error::Component::PaulBourke, 2042,
-                std::format("Invalid data in file '{}'", path)
-            );
-        }
-        auto [valX, valY] = r->values();
-        buf.vertices.reserve(static_cast<size_t>(valX) * static_cast<size_t>(valY));
-        meshSize = glm::ivec2(valX, valY);
+    std::optional<int> valX;
+    std::optional<int> valY;
+    if (tokenizer.nextLine()) {
+        valX = tokenizer.nextInt();
+        valY = tokenizer.nextInt();
     }
+    if (!valX || !valY) {
+        throw Error(
+            Error::Component::PaulBourke, 2042,
+            std::format("Invalid data in file '{}'", path)
+        );
+    }
+    buf.vertices.reserve(static_cast<size_t>(*valX) * static_cast<size_t>(*valY));
+    const glm::ivec2 meshSize = glm::ivec2(*valX, *valY);
 
     // get all data
-    while (std::getline(meshFile, line)) {
-        auto r = scn::scan<float, float, float, float, float>(line, "{} {} {} {} {}");
-        if (r) {
-            auto [x, y, s, t, intensity] = r->values();
-
+    while (tokenizer.nextLine()) {
+        const std::optional<float> x = tokenizer.nextFloat();
+        const std::optional<float> y = tokenizer.nextFloat();
+        const std::optional<float> s = tokenizer.nextFloat();
+        const std::optional<float> t = tokenizer.nextFloat();
+        const std::optional<float> intensity = tokenizer.nextFloat();
+        if (x && y && s && t && intensity) {
             Buffer::Vertex vertex;
-            vertex.x = x;
-            vertex.y = y;
-            vertex.s = s;
-            vertex.t = t;
-
-            vertex.r = intensity;
-            vertex.g = intensity;
-            vertex.b = intensity;
+            vertex.x = *x;
+            vertex.y = *y;
+            vertex.s = *s;
+            vertex.t = *t;
+
+            vertex.r = *intensity;
+            vertex.g = *intensity;
+            vertex.b = *intensity;
             vertex.a = 1.f;
 
             buf.vertices.push_back(vertex);
@@ -88,12 +88,12 @@ Buffer generatePaulBourkeMesh(const std::filesystem::path& path, const vec2& pos
     }
 
     // generate indices
-    for (int c = 0; c < (meshSize->x - 1); c++) {
-        for (int r = 0; r < (meshSize->y - 1); r++) {
-            const int i0 = r * meshSize->x + c;
-            const int i1 = r * meshSize->x + (c + 1);
-            const int i2 = (r + 1) * meshSize->x + (c + 1);
-            const int i3 = (r + 1) * meshSize->x + c;
+    for (int c = 0; c < (meshSize.x - 1); c++) {
+        for (int r = 0; r < (meshSize.y - 1); r++) {
+            const int i0 = r * meshSize.x + c;
+            const int i1 = r * meshSize.x + (c + 1);
+            const int i2 = (r + 1) * meshSize.x + (c + 1);
+            const int i3 = (r + 1) * meshSize.x + c;
 
             // triangle 1
             buf.indices.push_back(i0);
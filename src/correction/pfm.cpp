@@ -11,11 +11,53 @@
 #include <sgct/error.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
+#include <sgct/correction/tokenizer.h>
 #include <glm/glm.hpp>
-#include <scn/scan.h>
-#include <fstream>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+namespace {
+    // Returns the line starting at \p pos and moves \p pos past the line terminator
+    std::string_view nextLine(std::string_view text, size_t& pos) {
+        if (pos >= text.size()) {
+            return std::string_view();
+        }
+        size_t end = text.find('\n', pos);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        std::string_view line = text.substr(pos, end - pos);
+        pos = end + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    // Splits the interleaved RGB float values into the x (red) and y (green) corrections
+    // and discards the blue channel. The loop is written so that the compiler can
+    // vectorize it and the byte swap is resolved at compile time
+    template <bool SwapBytes>
+    void deinterleave(const std::byte* data, size_t n, float* x, float* y) {
+        for (size_t i = 0; i < n; i++) {
+            uint32_t r = 0;
+            uint32_t g = 0;
+            std::memcpy(&r, data + i * 3 * sizeof(float), sizeof(uint32_t));
+            std::memcpy(&g, data + (i * 3 + 1) * sizeof(float), sizeof(uint32_t));
+            if constexpr (SwapBytes) {
+                r = (r >> 24) | ((r >> 8) & 0xff00) | ((r << 8) & 0xff0000) | (r << 24);
+                g = (g >> 24) | ((g >> 8) & 0xff00) | ((g << 8) & 0xff0000) | (g << 24);
+            }
+            x[i] = std::bit_cast<float>(r);
+            y[i] = std::bit_cast<float>(g);
+        }
+    }
+} // namespace
 
 namespace sgct::correction {
 
@@ -28,68 +70,88 @@ Buffer generatePerEyeMeshFromPFMImage(const std::filesystem::path& path, const v
 
     Log::Info(std::format("Reading 3D/stereo mesh data (in PFM image) from '{}'", path));
 
-    std::ifstream meshFile(path, std::ifstream::binary);
-    if (!meshFile.good()) {
+    const MappedFile meshFile = MappedFile(path);
+    if (!meshFile.isOpen()) {
         throw Error(
             Error::Component::Pfm,
             2050,
             std::format("Failed to open '{}'", path)
         );
     }
+    const std::string_view text = std::string_view(
+        reinterpret_cast<const char*>(meshFile.data()),
+        meshFile.size()
+    );
 
     // Read the first three lines
-    std::string fileFormatHeader;
-    std::string dims;
-    std::string endiannessIndicator;
-    std::getline(meshFile, fileFormatHeader, '\n');
-    std::getline(meshFile, dims, '\n');
-    std::getline(meshFile, endiannessIndicator, '\n');
-
-    auto result = scn::scan<unsigned int, unsigned int>(dims, "{} {}");
-    if (!result) {
+    size_t dataOffset = 0;
+    const std::string_view fileFormatHeader = nextLine(text, dataOffset);
+    const std::string_view dims = nextLine(text, dataOffset);
+    const std::string_view endiannessIndicator = nextLine(text, dataOffset);
+
+    Tokenizer dimsTokenizer = Tokenizer(dims);
+    dimsTokenizer.nextLine();
+    const std::optional<unsigned int> cols = dimsTokenizer.nextUnsignedInt();
+    const std::optional<unsigned int> rows = dimsTokenizer.nextUnsignedInt();
+    if (!cols || !rows || *cols == 0 || *rows == 0) {
         throw Error(
             Error::Component::Pfm, 2052,
             std::format("Invalid header syntax in file '{}'", path)
         );
     }
-    auto [nCols, nRows] = result->values();
-    auto result2 = scn::scan<float>(endiannessIndicator, "{}");
-    if (!result2) {
+    unsigned int nCols = *cols;
+    const unsigned int nRows = *rows;
+    const std::optional<float> scale = toFloat(endiannessIndicator);
+    if (!scale) {
         throw Error(
             Error::Component::Pfm, 2052,
             std::format("Invalid endianness value in file '{}'", path)
         );
     }
-    if (fileFormatHeader[0] != 'P' || fileFormatHeader[1] != 'F') {
+    if (fileFormatHeader.size() < 2 || fileFormatHeader[0] != 'P' ||
+        fileFormatHeader[1] != 'F')
+    {
         throw Error(
             Error::Component::Pfm, 2053,
             std::format("Incorrect file type in file '{}'", path)
         );
     }
 
-    const int numCorrectionValues = nCols * nRows;
-    std::vector<float> xcorrections;
-    xcorrections.resize(numCorrectionValues);
-    std::vector<float> ycorrections;
-    ycorrections.resize(numCorrectionValues);
-
-    for (int i = 0; i < numCorrectionValues; i++) {
-        meshFile.read(reinterpret_cast<char*>(xcorrections.data() + i), sizeof(float));
-        meshFile.read(reinterpret_cast<char*>(ycorrections.data() + i), sizeof(float));
-        float dumpValue = 0.f;
-        meshFile.read(reinterpret_cast<char*>(&dumpValue), sizeof(float));
-
-        if (!meshFile.good()) {
-            throw Error(
-                Error::Component::Pfm, 2054,
-                std::format("Error reading correction values in file '{}'", path)
-            );
-        }
+    const size_t numCorrectionValues = static_cast<size_t>(nCols) * nRows;
+    if (dataOffset > meshFile.size() ||
+        meshFile.size() - dataOffset < numCorrectionValues * 3 * sizeof(float))
+    {
+        throw Error(
+            Error::Component::Pfm, 2054,
+            std::format("Error reading correction values in file '{}'", path)
+        );
+    }
+
+    // A negative scale denotes little-endian values, a positive scale big-endian values
+    const bool isLittleEndian = *scale < 0.f;
+    const bool swapBytes = isLittleEndian != (std::endian::native == std::endian::little);
+    std::vector<float> xcorrections = std::vector<float>(numCorrectionValues);
+    std::vector<float> ycorrections = std::vector<float>(numCorrectionValues);
+    const std::byte* data = meshFile.data() + dataOffset;
+    if (swapBytes) {
+        deinterleave<true>(
+            data, numCorrectionValues, xcorrections.data(), ycorrections.data()
+        );
+    }
+    else {
+        deinterleave<false>(
+            data, numCorrectionValues, xcorrections.data(), ycorrections.data()
+        );
     }
 
     const unsigned int nEyes = textureRenderMode ? 1 : 2;
     nCols /= nEyes;
 
+    // Each eye has one vertex per column and row, and two indices per vertex in all but
+    // the last row of the triangle strip
+    buf.vertices.reserve(static_cast<size_t>(nEyes) * nCols * nRows);
+    buf.indices.reserve(static_cast<size_t>(nEyes) * 2 * nCols * (nRows - 1));
+
     // Images are stored with X 0-1 (left to right), but Y 1 to 0 (top-bottom)
 
     // We assume we loaded side-by-side images if uses 2 eyes, i.e. different warp per eye
@@ -8,18 +8,16 @@
 
 #include <sgct/correction/scalable.h>
 
-#include <sgct/baseviewport.h>
-#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
-#include <sgct/user.h>
+#include <sgct/correction/tokenizer.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <fstream>
+#include <optional>
 
 namespace {
     struct Data {
@@ -92,36 +90,55 @@ namespace {
         bool applyBlackLevel = false;
         bool applyColor = false;
     };
+
+    float floatValue(std::string_view key, std::string_view value,
+                     const std::filesystem::path& path)
+    {
+        const std::optional<float> v = sgct::correction::toFloat(value);
+        if (!v) {
+            throw sgct::Error(
+                sgct::Error::Component::Scalable, 2063,
+                std::format("Illegal value '{}' for key {} in '{}'", value, key, path)
+            );
+        }
+        return *v;
+    }
+
+    int intValue(std::string_view key, std::string_view value,
+                 const std::filesystem::path& path)
+    {
+        const std::optional<int> v = sgct::correction::toInt(value);
+        if (!v) {
+            throw sgct::Error(
+                sgct::Error::Component::Scalable, 2063,
+                std::format("Illegal value '{}' for key {} in '{}'", value, key, path)
+            );
+        }
+        return *v;
+    }
 } // namespace
 
 namespace sgct::correction {
 
-Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& parent) {
+Buffer generateScalableMesh(const std::filesystem::path& path, const vec2& pos,
+                            const vec2& size)
+{
     ZoneScoped;
 
     Log::Info(std::format("Reading scalable mesh data from '{}'", path));
 
-    std::ifstream file(path);
-    if (!file.good()) {
+    const TextFile file = TextFile(path);
+    if (!file.isOpen()) {
         throw Error(
             Error::Component::Scalable, 2060, std::format("Failed to open '{}'", path)
         );
     }
 
     Data data;
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty()) {
-            continue;
-        }
-        else if (line.back() == '\r') {
-            line.pop_back();
-        }
-
-        const std::string_view v = line;
-        const size_t separator = v.find(' ');
-        std::string_view first = v.substr(0, separator);
-        std::string_view rest = v.substr(separator + 1);
+    Tokenizer tokenizer = Tokenizer(file.text());
+    while (tokenizer.nextLine()) {
+        const std::string_view first = tokenizer.nextToken();
+        const std::string_view rest = tokenizer.rest();
 
         if (first == "OPENMESH") {
             if (rest != "Version 1.1") {
@@ -132,11 +149,11 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "VERTICES") {
-            data.nVertices = std::stoi(std::string(rest));
+            data.nVertices = intValue(first, rest, path);
             data.vertices.reserve(data.nVertices);
         }
         else if (first == "FACES") {
-            data.nFaces = std::stoi(std::string(rest));
+            data.nFaces = intValue(first, rest, path);
             data.faces.reserve(data.nFaces);
         }
         else if (first == "MAPPING") {
@@ -164,62 +181,62 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "ORTHO_LEFT") {
-            data.ortho.left = std::stof(std::string(rest));
+            data.ortho.left = floatValue(first, rest, path);
         }
         else if (first == "ORTHO_RIGHT") {
-            data.ortho.right = std::stof(std::string(rest));
+            data.ortho.right = floatValue(first, rest, path);
         }
         else if (first == "ORTHO_TOP") {
-            data.ortho.top = std::stof(std::string(rest));
+            data.ortho.top = floatValue(first, rest, path);
         }
         else if (first == "ORTHO_BOTTOM") {
-            data.ortho.bottom = std::stof(std::string(rest));
+            data.ortho.bottom = floatValue(first, rest, path);
         }
         else if (first == "PERSPECTIVE_XOFFSET") {
-            data.perspective.offset.x = std::stof(std::string(rest));
+            data.perspective.offset.x = floatValue(first, rest, path);
             data.perspective.hasOffset = true;
         }
         else if (first == "PERSPECTIVE_YOFFSET") {
-            data.perspective.offset.y = std::stof(std::string(rest));
+            data.perspective.offset.y = floatValue(first, rest, path);
             data.perspective.hasOffset = true;
         }
         else if (first == "PERSPECTIVE_ZOFFSET") {
-            data.perspective.offset.z = std::stof(std::string(rest));
+            data.perspective.offset.z = floatValue(first, rest, path);
             data.perspective.hasOffset = true;
         }
         else if (first == "PERSPECTIVE_ROLL") {
-            data.perspective.direction.roll = std::stof(std::string(rest));
+            data.perspective.direction.roll = floatValue(first, rest, path);
         }
         else if (first == "PERSPECTIVE_PITCH") {
-            data.perspective.direction.pitch = std::stof(std::string(rest));
+            data.perspective.direction.pitch = floatValue(first, rest, path);
         }
         else if (first == "PERSPECTIVE_YAW") {
-            data.perspective.direction.yaw = std::stof(std::string(rest));
+            data.perspective.direction.yaw = floatValue(first, rest, path);
         }
         else if (first == "PERSPECTIVE_LEFT") {
-            data.perspective.fov.left = std::stof(std::string(rest));
+            data.perspective.fov.left = floatValue(first, rest, path);
             data.perspective.hasFov = true;
         }
         else if (first == "PERSPECTIVE_RIGHT") {
-            data.perspective.fov.right = std::stof(std::string(rest));
+            data.perspective.fov.right = floatValue(first, rest, path);
             data.perspective.hasFov = true;
         }
         else if (first == "PERSPECTIVE_TOP") {
-            data.perspective.fov.top = std::stof(std::string(rest));
+            data.perspective.fov.top = floatValue(first, rest, path);
             data.perspective.hasFov = true;
         }
         else if (first == "PERSPECTIVE_BOTTOM") {
-            data.perspective.fov.bottom = std::stof(std::string(rest));
+            data.perspective.fov.bottom = floatValue(first, rest, path);
             data.perspective.hasFov = true;
         }
         else if (first == "NATIVEXRES") {
-            data.resolution.x = std::stoi(std::string(rest));
+            data.resolution.x = intValue(first, rest, path);
         }
         else if (first == "NATIVEYRES") {
-            data.resolution.y = std::stoi(std::string(rest));
+            data.resolution.y = intValue(first, rest, path);
         }
         else if (first == "SUBVERSION") {
-            const int version = std::stoi(std::string(rest));
+            const int version = intValue(first, rest, path);
             if (version != 5) {
                 Log::Warning(std::format(
                     "Found subversion {} in mesh '{}' but only version 5 is tested",
@@ -228,7 +245,7 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "GAMMA") {
-            const float gamma = std::stof(std::string(rest));
+            const float gamma = floatValue(first, rest, path);
             if (gamma != data.gamma) {
                 data.gamma = gamma;
                 Log::Warning(std::format(
@@ -238,10 +255,10 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "DO_NO_WARP") {
-            data.doNotWarp = std::stoi(std::string(rest)) != 0;
+            data.doNotWarp = intValue(first, rest, path) != 0;
         }
         else if (first == "USE_SPHERE_SAMPLE_COORDINATE_SYSTEM") {
-            const bool useSphereSampling = std::stoi(std::string(rest)) != 0;
+            const bool useSphereSampling = intValue(first, rest, path) != 0;
             if (useSphereSampling) {
                 Log::Warning(std::format(
                     "Found request to use Sphere Sample Coordinate System in mesh {} "
@@ -250,7 +267,7 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "FRUSTUM_EULER_ANGLES") {
-            data.frustumEulerAngles.useAngles = std::stoi(std::string(rest)) != 0;
+            data.frustumEulerAngles.useAngles = intValue(first, rest, path) != 0;
             if (data.frustumEulerAngles.useAngles) {
                 Log::Warning(std::format(
                     "Enabled frustum euler angles in mesh '{}' but we do not know how "
@@ -259,19 +276,19 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "FRUSTUM_EULER_YAW") {
-            data.frustumEulerAngles.yaw = std::stof(std::string(rest));
+            data.frustumEulerAngles.yaw = floatValue(first, rest, path);
         }
         else if (first == "FRUSTUM_EULER_PITCH") {
-            data.frustumEulerAngles.pitch = std::stof(std::string(rest));
+            data.frustumEulerAngles.pitch = floatValue(first, rest, path);
         }
         else if (first == "FRUSTUM_EULER_ROLL") {
-            data.frustumEulerAngles.roll = std::stof(std::string(rest));
+            data.frustumEulerAngles.roll = floatValue(first, rest, path);
         }
         else if (first == "LABEL") {
             data.label = std::string(rest);
         }
         else if (first == "APPLY_MASK") {
-            data.applyMask = std::stoi(std::string(rest));
+            data.applyMask = intValue(first, rest, path);
             if (data.applyMask) {
                 Log::Warning(std::format(
                     "Mesh '{}' requested to apply a mask. Currently this is handled "
@@ -281,7 +298,7 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "APPLY_BLACK_LEVEL") {
-            data.applyBlackLevel = std::stoi(std::string(rest));
+            data.applyBlackLevel = intValue(first, rest, path);
             if (data.applyBlackLevel) {
                 Log::Warning(std::format(
                     "Mesh '{}' requested to apply a blacklevel image. Currently this is "
@@ -291,7 +308,7 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             }
         }
         else if (first == "APPLY_COLOR") {
-            data.applyColor = std::stoi(std::string(rest));
+            data.applyColor = intValue(first, rest, path);
             if (data.applyBlackLevel) {
                 Log::Warning(std::format(
                     "Mesh '{}' requested to apply an overlay image. Currently this is "
@@ -302,58 +319,31 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
         }
         else if (first == "[") {
             // Face
-            size_t sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
-                throw Error(
-                    Error::Component::Scalable, 2035,
-                    std::format(
-                        "Illegal formatting of face in file '{}' in line {}",
-                        path, line
-                    )
-                );
-            }
-            const std::string_view f1 = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
+            const std::optional<int> f1 = tokenizer.nextInt();
+            const std::optional<int> f2 = tokenizer.nextInt();
+            const std::optional<int> f3 = tokenizer.nextInt();
+            if (!f1 || !f2 || !f3) {
                 throw Error(
                     Error::Component::Scalable, 2035,
                     std::format(
                         "Illegal formatting of face in file '{}' in line {}",
-                        path, line
+                        path, tokenizer.line()
                     )
                 );
             }
-            const std::string_view f2 = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
 
-            sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
-                throw Error(
-                    Error::Component::Scalable, 2035,
-                    std::format(
-                        "Illegal formatting of face in file '{}' in line {}",
-                        path, line
-                    )
-                );
-            }
-            const std::string_view f3 = rest.substr(0, sep);
-
-            Data::Face f;
-            f.f1 = static_cast<unsigned int>(std::stoi(std::string(f1)));
-            f.f2 = static_cast<unsigned int>(std::stoi(std::string(f2)));
-            f.f3 = static_cast<unsigned int>(std::stoi(std::string(f3)));
-            data.faces.push_back(f);
+            data.faces.push_back({
+                .f1 = static_cast<unsigned int>(*f1),
+                .f2 = static_cast<unsigned int>(*f2),
+                .f3 = static_cast<unsigned int>(*f3)
+            });
         }
         else {
-            // Nothing matched previously, so it has to be a vertex or an unknown key now
-            try {
-                // We try to convert the first value into a float.  If it succeeds, we
-                // have reached the vertices.  Otherwise we have found an unknown key
-                [[maybe_unused]] const float dummy = std::stof(std::string(first));
-            }
-            catch (const std::invalid_argument&) {
+            // Nothing matched previously, so it has to be a vertex or an unknown key now.
+            // If the first value is a number, we have reached the vertices. Otherwise we
+            // have found an unknown key
+            const std::optional<float> x = toFloat(first);
+            if (!x) {
                 Log::Warning(std::format(
                     "Unknown key {} found in scalable mesh '{}'. Please report usage of "
                     "this key, preferably with an example, to the SGCT developers",
@@ -362,71 +352,31 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
                 continue;
             }
 
-
-            const std::string_view x = first;
-
-            size_t sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
-                throw Error(
-                    Error::Component::Scalable, 2036,
-                    std::format(
-                        "Illegal formatting of vertex in file '{}' in line {}",
-                        path, line
-                    )
-                );
-            }
-            const std::string_view y = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
-                throw Error(
-                    Error::Component::Scalable, 2036,
-                    std::format(
-                        "Illegal formatting of vertex in file '{}' in line {}",
-                        path, line
-                    )
-                );
-            }
-            const std::string_view intensity = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
-                throw Error(
-                    Error::Component::Scalable, 2036,
-                    std::format(
-                        "Illegal formatting of vertex in file '{}' in line {}",
-                        path, line
-                    )
-                );
-            }
-            const std::string_view s = rest.substr(0, sep);
-            rest = rest.substr(sep + 1);
-
-            sep = rest.find(' ');
-            if (sep == std::string_view::npos) {
+            const std::optional<float> y = tokenizer.nextFloat();
+            const std::optional<int> intensity = tokenizer.nextInt();
+            const std::optional<float> s = tokenizer.nextFloat();
+            const std::optional<float> t = tokenizer.nextFloat();
+            if (!y || !intensity || !s || !t) {
                 throw Error(
                     Error::Component::Scalable, 2036,
                     std::format(
                         "Illegal formatting of vertex in file '{}' in line {}",
-                        path, line
+                        path, tokenizer.line()
                     )
                 );
             }
-            const std::string_view t = rest.substr(0, sep);
 
-            Data::Vertex vertex;
-            vertex.x = std::stof(std::string(x));
-            vertex.y = std::stof(std::string(y));
-            vertex.intensity = std::stoi(std::string(intensity));
-            vertex.s = std::stof(std::string(s));
-            vertex.t = std::stof(std::string(t));
-            data.vertices.push_back(vertex);
+            data.vertices.push_back({
+                .x = *x,
+                .y = *y,
+                .intensity = *intensity,
+                .s = *s,
+                .t = *t
+            });
         }
     }
 
-
+    Buffer buf;
     if (data.perspective.hasFov) {
         // pitch, yaw, roll.  degrees -> radians
         // if we don't have a direction, all these values will be 0 anyway
@@ -436,23 +386,20 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
             glm::radians(data.perspective.direction.roll)
         ));
 
-        parent.setViewPlaneCoordsUsingFOVs(
-            data.perspective.fov.top,
-            data.perspective.fov.bottom,
-            data.perspective.fov.left,
-            data.perspective.fov.right,
-            quat(q.x, q.y, q.z, q.w)
-        );
-        Engine::instance().updateFrustums();
+        buf.viewPlane = Buffer::ViewPlane{
+            .up = data.perspective.fov.top,
+            .down = data.perspective.fov.bottom,
+            .left = data.perspective.fov.left,
+            .right = data.perspective.fov.right,
+            .orientation = quat(q.x, q.y, q.z, q.w)
+        };
     }
     if (data.perspective.hasOffset) {
-        parent.projectionPlane().offset(
-            vec3{
-                data.perspective.offset.x,
-                data.perspective.offset.y,
-                data.perspective.offset.z
-            }
-        );
+        buf.projectionOffset = vec3{
+            data.perspective.offset.x,
+            data.perspective.offset.y,
+            data.perspective.offset.z
+        };
     }
     if (data.nVertices != static_cast<int>(data.vertices.size()) ||
         data.nFaces != static_cast<int>(data.faces.size()))
@@ -463,15 +410,14 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
         );
     }
 
-    Buffer buf;
     buf.geometryType = GL_TRIANGLES;
     buf.vertices.reserve(data.vertices.size());
     for (const Data::Vertex& vertex : data.vertices) {
         Buffer::Vertex v;
         const float x =
-            (vertex.x / data.resolution.x) * parent.size().x + parent.position().x;
+            (vertex.x / data.resolution.x) * size.x + pos.x;
         const float y =
-            (vertex.y / data.resolution.y) * parent.size().y + parent.position().y;
+            (vertex.y / data.resolution.y) * size.y + pos.y;
 
         // Normalize vertices between 0 and 1
         const float x2 = (x - data.ortho.left) / (data.ortho.right - data.ortho.left);
@@ -485,10 +431,10 @@ Buffer generateScalableMesh(const std::filesystem::path& path, BaseViewport& par
         v.g = vertex.intensity / 255.f;
         v.b = vertex.intensity / 255.f;
         v.a = 1.f;
-        //v.s = (1.f - vertex.s) * parent.size().x + parent.position().x;
-        v.s = (1.f - vertex.t) * parent.size().x + parent.position().x;
-        //v.t = (1.f - vertex.t) * parent.size().x + parent.position().x;
-        v.t = (1.f - vertex.s) * parent.size().x + parent.position().x;
+        //v.s = (1.f - vertex.s) * size.x + pos.x;
+        v.s = (1.f - vertex.t) * size.x + pos.x;
+        //v.t = (1.f - vertex.t) * size.x + pos.x;
+        v.t = (1.f - vertex.s) * size.x + pos.x;
 
         buf.vertices.push_back(v);
     }
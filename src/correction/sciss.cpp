@@ -8,14 +8,11 @@
 
 #include <sgct/correction/sciss.h>
 
-#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
-#include <sgct/viewport.h>
-#include <sgct/user.h>
 #include <glm/glm.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/euler_angles.hpp>
@@ -54,7 +51,9 @@ namespace {
 
 namespace sgct::correction {
 
-Buffer generateScissMesh(const std::filesystem::path& path, BaseViewport& parent) {
+Buffer generateScissMesh(const std::filesystem::path& path, const vec2& pos,
+                         const vec2& size)
+{
     ZoneScoped;
 
     Buffer buf;
@@ -127,21 +126,21 @@ Buffer generateScissMesh(const std::filesystem::path& path, BaseViewport& parent
     ));
 
     // read number of vertices
-    unsigned int size[2];
-    file.read(reinterpret_cast<char*>(size), 2 * sizeof(unsigned int));
+    unsigned int dims[2];
+    file.read(reinterpret_cast<char*>(dims), 2 * sizeof(unsigned int));
     if (!file.good()) {
         throw Error(2075, std::format("Error parsing file '{}'", path));
     }
 
     unsigned int nVertices = 0;
     if (fileVersion == 2) {
-        nVertices = size[1];
+        nVertices = dims[1];
         Log::Debug(std::format("Number of vertices: {}", nVertices));
     }
     else {
-        nVertices = size[0] * size[1];
+        nVertices = dims[0] * dims[1];
         Log::Debug(std::format(
-            "Number of vertices: {} ({}x{})", nVertices, size[0], size[1]
+            "Number of vertices: {} ({}x{})", nVertices, dims[0], dims[1]
         ));
     }
     // read vertices
@@ -174,16 +173,14 @@ Buffer generateScissMesh(const std::filesystem::path& path, BaseViewport& parent
         }
     }
 
-    parent.user().setPos(vec3{ viewData.x, viewData.y, viewData.z });
-    parent.setViewPlaneCoordsUsingFOVs(
-        viewData.fovUp,
-        viewData.fovDown,
-        viewData.fovLeft,
-        viewData.fovRight,
-        quat{ viewData.qx, viewData.qy, viewData.qz, viewData.qw }
-    );
-
-    Engine::instance().updateFrustums();
+    buf.userPosition = vec3{ viewData.x, viewData.y, viewData.z };
+    buf.viewPlane = Buffer::ViewPlane{
+        .up = viewData.fovUp,
+        .down = viewData.fovDown,
+        .left = viewData.fovLeft,
+        .right = viewData.fovRight,
+        .orientation = quat{ viewData.qx, viewData.qy, viewData.qz, viewData.qw }
+    };
 
     buf.vertices.resize(nVertices);
     for (unsigned int i = 0; i < nVertices; i++) {
@@ -193,16 +190,13 @@ Buffer generateScissMesh(const std::filesystem::path& path, BaseViewport& parent
         scissVertex.tx = glm::clamp(scissVertex.tx, 0.f, 1.f);
         scissVertex.ty = glm::clamp(scissVertex.ty, 0.f, 1.f);
 
-        const vec2& s = parent.size();
-        const vec2& p = parent.position();
-
         // convert to [-1, 1]
         Buffer::Vertex& vertex = buf.vertices[i];
-        vertex.x = 2.f * (scissVertex.x * s.x + p.x) - 1.f;
-        vertex.y = 2.f * ((1.f - scissVertex.y) * s.y + p.y) - 1.f;
+        vertex.x = 2.f * (scissVertex.x * size.x + pos.x) - 1.f;
+        vertex.y = 2.f * ((1.f - scissVertex.y) * size.y + pos.y) - 1.f;
 
-        vertex.s = scissVertex.tx * parent.size().x + parent.position().x;
-        vertex.t = scissVertex.ty * parent.size().y + parent.position().y;
+        vertex.s = scissVertex.tx * size.x + pos.x;
+        vertex.t = scissVertex.ty * size.y + pos.y;
 
         vertex.r = 1.f;
         vertex.g = 1.f;
@@ -210,7 +204,7 @@ Buffer generateScissMesh(const std::filesystem::path& path, BaseViewport& parent
         vertex.a = 1.f;
     }
 
-    if (fileVersion == '2' && size[0] == 4) {
+    if (fileVersion == '2' && dims[0] == 4) {
         buf.geometryType = GL_TRIANGLES;
     }
     else {
@@ -0,0 +1,597 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/simplify.h>
+
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace {
+    using sgct::correction::Buffer;
+    using Triangle = std::array<uint32_t, 3>;
+
+    // The triangles of a grid cell are identified by the corner of the cell that they do
+    // not use, where the corners are numbered 0 = (i, j), 1 = (i + 1, j), 2 = (i, j + 1),
+    // and 3 = (i + 1, j + 1). Each cell stores a bit for each of its four triangles
+    bool isFull(uint8_t cell) {
+        return (cell & 0b0110) == 0b0110 || (cell & 0b1001) == 0b1001;
+    }
+
+    struct Grid {
+        // The number of vertices in each row and column of the grid
+        uint32_t nCols = 0;
+        uint32_t nRows = 0;
+        // One entry for each of the (nCols - 1) * (nRows - 1) cells
+        std::vector<uint8_t> cells;
+        // Whether the original triangles are counter-clockwise in grid coordinates
+        bool isCounterClockwise = true;
+
+        // Summed area tables of the number of full cells and of the cells that contain
+        // at least one triangle with (nCols * nRows) entries
+        std::vector<uint32_t> fullCells;
+        std::vector<uint32_t> usedCells;
+
+        uint32_t index(uint32_t i, uint32_t j) const {
+            return j * nCols + i;
+        }
+    };
+
+    // A rectangle of w * h cells in the quadtree, starting at cell (i, j)
+    struct Cell {
+        uint32_t i = 0;
+        uint32_t j = 0;
+        uint32_t w = 0;
+        uint32_t h = 0;
+    };
+
+    // The triangles of a cell in the quadtree. If the triangles form a fan around the
+    // center of the cell, the position of each vertex on the boundary of the cell is
+    // stored, starting at (i, j) and going around the cell counter-clockwise in grid
+    // coordinates, so that the triangle containing a grid vertex can be found quickly
+    struct Triangulation {
+        std::vector<Triangle> triangles;
+        std::vector<uint32_t> fan;
+    };
+
+    // Calls fn for each triangle in the buffer until fn returns false
+    template <typename Fn>
+    bool forEachTriangle(const Buffer& buffer, Fn fn) {
+        const std::vector<unsigned int>& idx = buffer.indices;
+        if (buffer.geometryType == GL_TRIANGLES) {
+            for (size_t i = 0; i + 2 < idx.size(); i += 3) {
+                if (!fn(idx[i], idx[i + 1], idx[i + 2])) {
+                    return false;
+                }
+            }
+        }
+        else {
+            for (size_t i = 0; i + 2 < idx.size(); i++) {
+                if (!fn(idx[i], idx[i + 1], idx[i + 2])) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    int64_t orientation(const Grid& grid, uint32_t a, uint32_t b, uint32_t c) {
+        const int64_t ax = a % grid.nCols;
+        const int64_t ay = a / grid.nCols;
+        const int64_t bx = b % grid.nCols;
+        const int64_t by = b / grid.nCols;
+        const int64_t cx = c % grid.nCols;
+        const int64_t cy = c / grid.nCols;
+        return (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+    }
+
+    std::vector<uint32_t> summedAreaTable(const Grid& grid, bool (*predicate)(uint8_t)) {
+        // The table has one more row and column than there are cells
+        const uint32_t w = grid.nCols - 1;
+        const uint32_t h = grid.nRows - 1;
+        std::vector<uint32_t> res = std::vector<uint32_t>(grid.nCols * grid.nRows, 0);
+        for (uint32_t j = 0; j < h; j++) {
+            uint32_t row = 0;
+            for (uint32_t i = 0; i < w; i++) {
+                row += predicate(grid.cells[j * w + i]) ? 1 : 0;
+                res[grid.index(i + 1, j + 1)] = res[grid.index(i + 1, j)] + row;
+            }
+        }
+        return res;
+    }
+
+    uint32_t count(const Grid& grid, const std::vector<uint32_t>& table, const Cell& c) {
+        const uint32_t i1 = c.i + c.w;
+        const uint32_t j1 = c.j + c.h;
+        return table[grid.index(i1, j1)] - table[grid.index(c.i, j1)] -
+               table[grid.index(i1, c.j)] + table[grid.index(c.i, c.j)];
+    }
+
+    std::optional<Grid> tryGrid(const Buffer& buffer, uint32_t nCols) {
+        const size_t nVertices = buffer.vertices.size();
+        if (nCols < 2 || nVertices % nCols != 0 || nVertices / nCols < 2) {
+            return std::nullopt;
+        }
+
+        Grid grid;
+        grid.nCols = nCols;
+        grid.nRows = static_cast<uint32_t>(nVertices / nCols);
+        grid.cells.resize(static_cast<size_t>(nCols - 1) * (grid.nRows - 1), 0);
+        bool hasOrientation = false;
+
+        const bool isGrid = forEachTriangle(
+            buffer,
+            [&](uint32_t a, uint32_t b, uint32_t c) {
+                if (a >= nVertices || b >= nVertices || c >= nVertices) {
+                    return false;
+                }
+                const std::array<uint32_t, 3> is = { a % nCols, b % nCols, c % nCols };
+                const std::array<uint32_t, 3> js = { a / nCols, b / nCols, c / nCols };
+                const auto [minI, maxI] = std::minmax({ is[0], is[1], is[2] });
+                const auto [minJ, maxJ] = std::minmax({ js[0], js[1], js[2] });
+                if (a == b || b == c || a == c || minI == maxI || minJ == maxJ) {
+                    // Degenerate triangles, for example to connect rows of a strip
+                    return true;
+                }
+                if (maxI - minI > 1 || maxJ - minJ > 1) {
+                    return false;
+                }
+
+                int missing = 0 + 1 + 2 + 3;
+                for (int k = 0; k < 3; k++) {
+                    missing -= static_cast<int>((is[k] - minI) + 2 * (js[k] - minJ));
+                }
+                grid.cells[static_cast<size_t>(minJ) * (nCols - 1) + minI] |=
+                    1 << missing;
+
+                if (!hasOrientation) {
+                    grid.isCounterClockwise = orientation(grid, a, b, c) > 0;
+                    hasOrientation = true;
+                }
+                return true;
+            }
+        );
+        if (!isGrid || !hasOrientation) {
+            return std::nullopt;
+        }
+
+        grid.fullCells = summedAreaTable(grid, isFull);
+        grid.usedCells = summedAreaTable(grid, [](uint8_t cell) { return cell != 0; });
+        return grid;
+    }
+
+    std::optional<Grid> detectGrid(const Buffer& buffer) {
+        // In a grid with n columns, the indices of a triangle in a cell are at most n + 1
+        // apart, so the first triangle gives two candidates for the number of columns
+        uint32_t distance = 0;
+        forEachTriangle(
+            buffer,
+            [&distance](uint32_t a, uint32_t b, uint32_t c) {
+                if (a == b || b == c || a == c) {
+                    return true;
+                }
+                distance = std::max({ a, b, c }) - std::min({ a, b, c });
+                return false;
+            }
+        );
+
+        for (uint32_t nCols : { distance, distance - 1 }) {
+            if (distance > 0) {
+                std::optional<Grid> grid = tryGrid(buffer, nCols);
+                if (grid) {
+                    return grid;
+                }
+            }
+        }
+        return std::nullopt;
+    }
+
+    class Simplifier {
+    public:
+        Simplifier(const Buffer& buffer, const Grid& grid, float maxTexCoordError,
+                   float maxColorError)
+            : _buffer(buffer)
+            , _grid(grid)
+            , _maxTexCoordError(maxTexCoordError)
+            , _maxColorError(maxColorError)
+        {}
+
+        // Subdivides the cell until the triangulation of each leaf without considering
+        // its neighbors is within the error bounds
+        void build(const Cell& cell, std::vector<Cell>& leaves) const {
+            if (count(_grid, _grid.usedCells, cell) == 0) {
+                return;
+            }
+            const bool isLeaf = (cell.w == 1 && cell.h == 1) ||
+                (count(_grid, _grid.fullCells, cell) == cell.w * cell.h &&
+                 isWithinBounds(cell, cornerTriangulation(cell)));
+            if (isLeaf) {
+                leaves.push_back(cell);
+            }
+            else {
+                for (const Cell& child : split(cell)) {
+                    build(child, leaves);
+                }
+            }
+        }
+
+        // Triangulates all leaves, taking the vertices of the neighbors on the edges of
+        // each leaf into account. Leaves that are no longer within the error bounds are
+        // split, which might change the triangulation of their neighbors, until all
+        // leaves are within the bounds
+        std::vector<Triangle> triangulate(std::vector<Cell> leaves) const {
+            const std::vector<uint8_t> boundary = boundaryVertices();
+            std::vector<uint8_t> used;
+            std::vector<Triangle> res;
+            while (true) {
+                used = boundary;
+                for (const Cell& c : leaves) {
+                    used[_grid.index(c.i, c.j)] = 1;
+                    used[_grid.index(c.i + c.w, c.j)] = 1;
+                    used[_grid.index(c.i, c.j + c.h)] = 1;
+                    used[_grid.index(c.i + c.w, c.j + c.h)] = 1;
+                }
+
+                res.clear();
+                std::vector<Cell> next;
+                next.reserve(leaves.size());
+                bool hasSplit = false;
+                for (const Cell& c : leaves) {
+                    const Triangulation t = triangulate(c, used);
+                    const bool isOriginal = c.w == 1 && c.h == 1;
+                    if (isOriginal || isWithinBounds(c, t)) {
+                        res.insert(res.end(), t.triangles.begin(), t.triangles.end());
+                        next.push_back(c);
+                    }
+                    else {
+                        for (const Cell& child : split(c)) {
+                            if (count(_grid, _grid.usedCells, child) > 0) {
+                                next.push_back(child);
+                            }
+                        }
+                        hasSplit = true;
+                    }
+                }
+
+                if (!hasSplit) {
+                    return res;
+                }
+                leaves = std::move(next);
+            }
+        }
+
+    private:
+        // The vertices on the outline of the mesh and of holes in the mesh are always
+        // kept so that the simplified mesh covers exactly the same area
+        std::vector<uint8_t> boundaryVertices() const {
+            const uint32_t w = _grid.nCols - 1;
+            const uint32_t h = _grid.nRows - 1;
+            const auto isCellFull = [&](int64_t i, int64_t j) {
+                return i >= 0 && j >= 0 && i < w && j < h &&
+                    isFull(_grid.cells[j * w + i]);
+            };
+
+            std::vector<uint8_t> res = std::vector<uint8_t>(_buffer.vertices.size(), 0);
+            for (uint32_t j = 0; j < _grid.nRows; j++) {
+                for (uint32_t i = 0; i < _grid.nCols; i++) {
+                    const bool isInterior =
+                        isCellFull(i - 1, j - 1) && isCellFull(i, j - 1) &&
+                        isCellFull(i - 1, j) && isCellFull(i, j);
+                    res[_grid.index(i, j)] = isInterior ? 0 : 1;
+                }
+            }
+            return res;
+        }
+
+        static std::vector<Cell> split(const Cell& c) {
+            const uint32_t w0 = c.w > 1 ? c.w / 2 : c.w;
+            const uint32_t h0 = c.h > 1 ? c.h / 2 : c.h;
+            std::vector<Cell> res;
+            res.push_back({ c.i, c.j, w0, h0 });
+            if (w0 < c.w) {
+                res.push_back({ c.i + w0, c.j, c.w - w0, h0 });
+            }
+            if (h0 < c.h) {
+                res.push_back({ c.i, c.j + h0, w0, c.h - h0 });
+            }
+            if (w0 < c.w && h0 < c.h) {
+                res.push_back({ c.i + w0, c.j + h0, c.w - w0, c.h - h0 });
+            }
+            return res;
+        }
+
+        Triangle oriented(uint32_t a, uint32_t b, uint32_t c) const {
+            const bool isCounterClockwise = orientation(_grid, a, b, c) > 0;
+            if (isCounterClockwise == _grid.isCounterClockwise) {
+                return { a, b, c };
+            }
+            else {
+                return { a, c, b };
+            }
+        }
+
+        // The triangulation of a cell that only uses its corners and its center
+        Triangulation cornerTriangulation(const Cell& c) const {
+            const uint32_t c00 = _grid.index(c.i, c.j);
+            const uint32_t c10 = _grid.index(c.i + c.w, c.j);
+            const uint32_t c01 = _grid.index(c.i, c.j + c.h);
+            const uint32_t c11 = _grid.index(c.i + c.w, c.j + c.h);
+            Triangulation res;
+            if (c.w >= 2 && c.h >= 2) {
+                const uint32_t m = _grid.index(c.i + c.w / 2, c.j + c.h / 2);
+                res.triangles = {
+                    oriented(m, c00, c10), oriented(m, c10, c11),
+                    oriented(m, c11, c01), oriented(m, c01, c00)
+                };
+                res.fan = { 0, c.w, c.w + c.h, 2 * c.w + c.h };
+            }
+            else {
+                res.triangles = { oriented(c00, c10, c11), oriented(c00, c11, c01) };
+            }
+            return res;
+        }
+
+        Triangulation triangulate(const Cell& c, const std::vector<uint8_t>& used) const {
+            Triangulation triangulation;
+            std::vector<Triangle>& res = triangulation.triangles;
+            if (c.w == 1 && c.h == 1) {
+                // Keep the original triangles of the cell
+                const uint8_t cell = _grid.cells[c.j * (_grid.nCols - 1) + c.i];
+                const std::array<uint32_t, 4> corners = {
+                    _grid.index(c.i, c.j), _grid.index(c.i + 1, c.j),
+                    _grid.index(c.i, c.j + 1), _grid.index(c.i + 1, c.j + 1)
+                };
+                for (int missing = 0; missing < 4; missing++) {
+                    if (cell & (1 << missing)) {
+                        std::array<uint32_t, 3> t;
+                        std::copy_if(
+                            corners.begin(), corners.end(),
+                            t.begin(),
+                            [&](uint32_t v) { return v != corners[missing]; }
+                        );
+                        res.push_back(oriented(t[0], t[1], t[2]));
+                    }
+                }
+            }
+            else if (c.w >= 2 && c.h >= 2) {
+                // Fan around the center through all used vertices on the boundary
+                std::vector<uint32_t> boundary;
+                const auto add = [&](uint32_t i, uint32_t j, uint32_t position) {
+                    const uint32_t v = _grid.index(i, j);
+                    if (used[v]) {
+                        boundary.push_back(v);
+                        triangulation.fan.push_back(position);
+                    }
+                };
+                for (uint32_t k = 0; k < c.w; k++) {
+                    add(c.i + k, c.j, k);
+                }
+                for (uint32_t k = 0; k < c.h; k++) {
+                    add(c.i + c.w, c.j + k, c.w + k);
+                }
+                for (uint32_t k = 0; k < c.w; k++) {
+                    add(c.i + c.w - k, c.j + c.h, c.w + c.h + k);
+                }
+                for (uint32_t k = 0; k < c.h; k++) {
+                    add(c.i, c.j + c.h - k, 2 * c.w + c.h + k);
+                }
+
+                const uint32_t m = _grid.index(c.i + c.w / 2, c.j + c.h / 2);
+                for (size_t k = 0; k < boundary.size(); k++) {
+                    const uint32_t next = boundary[(k + 1) % boundary.size()];
+                    res.push_back(oriented(m, boundary[k], next));
+                }
+            }
+            else {
+                // A row or column of cells, which is triangulated by zipping the vertices
+                // of the two long edges together
+                const bool isColumn = c.w == 1;
+                const uint32_t length = isColumn ? c.h : c.w;
+                const auto vertex = [&](uint32_t side, uint32_t k) {
+                    return isColumn ?
+                        _grid.index(c.i + side, c.j + k) :
+                        _grid.index(c.i + k, c.j + side);
+                };
+                std::array<std::vector<uint32_t>, 2> steps;
+                for (uint32_t side = 0; side < 2; side++) {
+                    for (uint32_t k = 0; k <= length; k++) {
+                        if (used[vertex(side, k)]) {
+                            steps[side].push_back(k);
+                        }
+                    }
+                }
+
+                size_t a = 0;
+                size_t b = 0;
+                while (a + 1 < steps[0].size() || b + 1 < steps[1].size()) {
+                    const bool advanceA = b + 1 == steps[1].size() ||
+                        (a + 1 < steps[0].size() && steps[0][a + 1] <= steps[1][b + 1]);
+                    const uint32_t va = vertex(0, steps[0][a]);
+                    const uint32_t vb = vertex(1, steps[1][b]);
+                    if (advanceA) {
+                        a++;
+                        res.push_back(oriented(va, vb, vertex(0, steps[0][a])));
+                    }
+                    else {
+                        b++;
+                        res.push_back(oriented(va, vb, vertex(1, steps[1][b])));
+                    }
+                }
+            }
+            return triangulation;
+        }
+
+        // Returns the index of the fan triangle that contains the grid vertex (i, j) by
+        // intersecting the ray from the center of the cell through the vertex with the
+        // boundary of the cell
+        static size_t fanTriangle(const Cell& c, std::span<const uint32_t> fan,
+                                  uint32_t i, uint32_t j)
+        {
+            const double cx = static_cast<double>(c.w / 2);
+            const double cy = static_cast<double>(c.h / 2);
+            const double dx = static_cast<double>(i - c.i) - cx;
+            const double dy = static_cast<double>(j - c.j) - cy;
+            if (dx == 0.0 && dy == 0.0) {
+                // The center is part of all triangles
+                return 0;
+            }
+
+            constexpr double Inf = std::numeric_limits<double>::infinity();
+            const double tx = dx > 0.0 ? (c.w - cx) / dx : (dx < 0.0 ? -cx / dx : Inf);
+            const double ty = dy > 0.0 ? (c.h - cy) / dy : (dy < 0.0 ? -cy / dy : Inf);
+            double position = 0.0;
+            if (tx < ty) {
+                const double y = cy + tx * dy;
+                position = dx > 0.0 ? c.w + y : 2.0 * c.w + c.h + (c.h - y);
+            }
+            else {
+                const double x = cx + ty * dx;
+                position = dy < 0.0 ? x : c.w + c.h + (c.w - x);
+            }
+
+            const auto it = std::upper_bound(fan.begin(), fan.end(), position);
+            return it == fan.begin() ? 0 : static_cast<size_t>(it - fan.begin()) - 1;
+        }
+
+        // Checks whether the triangles reproduce all original vertices inside the cell
+        bool isWithinBounds(const Cell& c, const Triangulation& triangulation) const {
+            const std::vector<Buffer::Vertex>& vs = _buffer.vertices;
+            for (uint32_t j = c.j; j <= c.j + c.h; j++) {
+                for (uint32_t i = c.i; i <= c.i + c.w; i++) {
+                    const Buffer::Vertex& p = vs[_grid.index(i, j)];
+
+                    // For fans only the triangle that contains the vertex in grid
+                    // coordinates is considered, otherwise all triangles of the cell
+                    std::span<const Triangle> triangles = triangulation.triangles;
+                    if (!triangulation.fan.empty()) {
+                        const size_t k = fanTriangle(c, triangulation.fan, i, j);
+                        triangles = triangles.subspan(k, 1);
+                    }
+
+                    // Find the triangle that contains the vertex or that is closest to
+                    // containing it if the vertex lies outside of all triangles
+                    float best = -std::numeric_limits<float>::max();
+                    std::array<float, 3> bary = {};
+                    const Triangle* tri = nullptr;
+                    for (const Triangle& t : triangles) {
+                        const Buffer::Vertex& v0 = vs[t[0]];
+                        const Buffer::Vertex& v1 = vs[t[1]];
+                        const Buffer::Vertex& v2 = vs[t[2]];
+                        const float det =
+                            (v1.y - v2.y) * (v0.x - v2.x) + (v2.x - v1.x) * (v0.y - v2.y);
+                        if (std::abs(det) < std::numeric_limits<float>::min()) {
+                            continue;
+                        }
+                        const float px = p.x - v2.x;
+                        const float py = p.y - v2.y;
+                        const float l0 = ((v1.y - v2.y) * px + (v2.x - v1.x) * py) / det;
+                        const float l1 = ((v2.y - v0.y) * px + (v0.x - v2.x) * py) / det;
+                        const float l2 = 1.f - l0 - l1;
+                        const float m = std::min({ l0, l1, l2 });
+                        if (m > best) {
+                            best = m;
+                            bary = { l0, l1, l2 };
+                            tri = &t;
+                        }
+                        if (m >= 0.f) {
+                            break;
+                        }
+                    }
+                    if (!tri) {
+                        return false;
+                    }
+
+                    const auto interpolate = [&](float Buffer::Vertex::* member) {
+                        return bary[0] * vs[(*tri)[0]].*member +
+                               bary[1] * vs[(*tri)[1]].*member +
+                               bary[2] * vs[(*tri)[2]].*member;
+                    };
+                    const float ds = interpolate(&Buffer::Vertex::s) - p.s;
+                    const float dt = interpolate(&Buffer::Vertex::t) - p.t;
+                    if (std::sqrt(ds * ds + dt * dt) > _maxTexCoordError) {
+                        return false;
+                    }
+                    for (float Buffer::Vertex::* member : { &Buffer::Vertex::r,
+                        &Buffer::Vertex::g, &Buffer::Vertex::b, &Buffer::Vertex::a })
+                    {
+                        if (std::abs(interpolate(member) - p.*member) > _maxColorError) {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        const Buffer& _buffer;
+        const Grid& _grid;
+        const float _maxTexCoordError;
+        const float _maxColorError;
+    };
+} // namespace
+
+namespace sgct::correction {
+
+std::optional<Buffer> simplifyMesh(const Buffer& buffer, float maxTexCoordError,
+                                   float maxColorError)
+{
+    ZoneScoped;
+
+    if (buffer.geometryType != GL_TRIANGLES && buffer.geometryType != GL_TRIANGLE_STRIP) {
+        return std::nullopt;
+    }
+    const std::optional<Grid> grid = detectGrid(buffer);
+    if (!grid) {
+        return std::nullopt;
+    }
+
+    const Simplifier simplifier = Simplifier(
+        buffer,
+        *grid,
+        maxTexCoordError,
+        maxColorError
+    );
+    std::vector<Cell> leaves;
+    simplifier.build(Cell{ 0, 0, grid->nCols - 1, grid->nRows - 1 }, leaves);
+    const std::vector<Triangle> triangles = simplifier.triangulate(std::move(leaves));
+
+    // Only keep the vertices that are still used, in the same order as in the original
+    constexpr uint32_t Unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap = std::vector<uint32_t>(buffer.vertices.size(), Unused);
+    for (const Triangle& t : triangles) {
+        for (uint32_t v : t) {
+            remap[v] = 0;
+        }
+    }
+
+    Buffer res;
+    res.geometryType = GL_TRIANGLES;
+    res.viewPlane = buffer.viewPlane;
+    res.projectionOffset = buffer.projectionOffset;
+    res.userPosition = buffer.userPosition;
+    for (size_t i = 0; i < remap.size(); i++) {
+        if (remap[i] != Unused) {
+            remap[i] = static_cast<uint32_t>(res.vertices.size());
+            res.vertices.push_back(buffer.vertices[i]);
+        }
+    }
+    res.indices.reserve(triangles.size() * 3);
+    for (const Triangle& t : triangles) {
+        res.indices.push_back(remap[t[0]]);
+        res.indices.push_back(remap[t[1]]);
+        res.indices.push_back(remap[t[2]]);
+    }
+    return res;
+}
+
+} // namespace sgct::correction
@@ -8,34 +8,42 @@
 
 #include <sgct/correction/skyskan.h>
 
-#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
-#include <sgct/viewport.h>
-#include <sgct/user.h>
+#include <sgct/correction/tokenizer.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
-#include <scn/scan.h>
-#include <fstream>
 #include <optional>
 
 #define Error(code, msg) sgct::Error(sgct::Error::Component::SkySkan, code, msg)
 
+namespace {
+    // Returns the value of a line with the format `<key><value>`
+    std::optional<float> keyValue(std::string_view line, std::string_view key) {
+        if (!line.starts_with(key)) {
+            return std::nullopt;
+        }
+        return sgct::correction::toFloat(line.substr(key.size()));
+    }
+} // namespace
+
 namespace sgct::correction {
 
-Buffer generateSkySkanMesh(const std::filesystem::path& path, BaseViewport& parent) {
+Buffer generateSkySkanMesh(const std::filesystem::path& path, const vec2& pos,
+                           const vec2& size)
+{
     ZoneScoped;
 
     Buffer buf;
 
     Log::Info(std::format("Reading SkySkan mesh data from '{}'", path));
 
-    std::ifstream meshFile(path);
-    if (!meshFile.good()) {
+    const TextFile file = TextFile(path);
+    if (!file.isOpen()) {
         throw Error(2090, std::format("Failed to open file '{}'", path));
     }
 
@@ -51,71 +59,72 @@ Buffer generateSkySkanMesh(const std::filesystem::path& path, BaseViewport& pare
     unsigned int sizeY = 0;
     unsigned int counter = 0;
 
-    std::string line;
-    while (std::getline(meshFile, line)) {
-        if (auto r = scn::scan<float>(line, "Dome Azimuth={}");  r) {
-            azimuth = r->value();
-            break;
+    Tokenizer tokenizer = Tokenizer(file.text());
+    while (tokenizer.nextLine()) {
+        const std::string_view line = tokenizer.line();
+        if (std::optional<float> v = keyValue(line, "Dome Azimuth="); v) {
+            azimuth = v;
         }
-        if (auto r = scn::scan<float>(line, "Dome Elevation={}");  r) {
-            elevation = r->value();
-            break;
+        else if (std::optional<float> v = keyValue(line, "Dome Elevation="); v) {
+            elevation = v;
         }
-        if (auto r = scn::scan<float>(line, "Horizontal FOV={}");  r) {
-            hFov = r->value();
-            break;
+        else if (std::optional<float> v = keyValue(line, "Horizontal FOV="); v) {
+            hFov = v;
         }
-        if (auto r = scn::scan<float>(line, "Vertical FOV={}");  r) {
-            vFov = r->value();
-            break;
+        else if (std::optional<float> v = keyValue(line, "Vertical FOV="); v) {
+            vFov = v;
         }
-        if (auto r = scn::scan<float>(line, "Horizontal Tweak={}");  r) {
-            fovTweaks.x = r->value();
-            break;
+        else if (std::optional<float> v = keyValue(line, "Horizontal Tweak="); v) {
+            fovTweaks.x = *v;
         }
-        if (auto r = scn::scan<float>(line, "Vertical Tweak={}");  r) {
-            fovTweaks.y = r->value();
-            break;
+        else if (std::optional<float> v = keyValue(line, "Vertical Tweak="); v) {
+            fovTweaks.y = *v;
         }
-        if (auto r = scn::scan<float>(line, "U Tweak={}");  r) {
-            uvTweaks.x = r->value();
-            break;
+        else if (std::optional<float> v = keyValue(line, "U Tweak="); v) {
+            uvTweaks.x = *v;
         }
-        if (auto r = scn::scan<float>(line, "V Tweak={}");  r) {
-            uvTweaks.y = r->value();
-            break;
+        else if (std::optional<float> v = keyValue(line, "V Tweak="); v) {
+            uvTweaks.y = *v;
         }
-        if (auto r = scn::scan<unsigned int, unsigned int>(line, "{} {}");
-            r && !areDimsSet)
-        {
-            areDimsSet = true;
-            std::tie(sizeX, sizeY) = r->values();
-            buf.vertices.resize(static_cast<size_t>(sizeX) * static_cast<size_t>(sizeY));
-            break;
+        else if (!areDimsSet) {
+            const std::optional<unsigned int> x = tokenizer.nextUnsignedInt();
+            const std::optional<unsigned int> y = tokenizer.nextUnsignedInt();
+            if (x && y) {
+                areDimsSet = true;
+                sizeX = *x;
+                sizeY = *y;
+                buf.vertices.resize(
+                    static_cast<size_t>(sizeX) * static_cast<size_t>(sizeY)
+                );
+            }
         }
-        if (auto r = scn::scan<float, float, float, float>(line, "{} {} {} {}");
-            r && areDimsSet)
-        {
-            auto [x, y, u, v] = r->values();
+        else if (counter < buf.vertices.size()) {
+            const std::optional<float> x = tokenizer.nextFloat();
+            const std::optional<float> y = tokenizer.nextFloat();
+            std::optional<float> u = tokenizer.nextFloat();
+            std::optional<float> v = tokenizer.nextFloat();
+            if (!x || !y || !u || !v) {
+                continue;
+            }
+
             if (uvTweaks.x > -1.f) {
-                u *= uvTweaks.x;
+                *u *= uvTweaks.x;
             }
 
             if (uvTweaks.y > -1.f) {
-                v *= uvTweaks.y;
+                *v *= uvTweaks.y;
             }
 
-            buf.vertices[counter].x = x;
-            buf.vertices[counter].y = y;
-            buf.vertices[counter].s = u;
-            buf.vertices[counter].t = 1.f - v;
+            buf.vertices[counter].x = *x;
+            buf.vertices[counter].y = *y;
+            buf.vertices[counter].s = *u;
+            buf.vertices[counter].t = 1.f - *v;
 
             buf.vertices[counter].r = 1.f;
             buf.vertices[counter].g = 1.f;
             buf.vertices[counter].b = 1.f;
             buf.vertices[counter].a = 1.f;
             counter++;
-            break;
         }
     }
 
@@ -147,17 +156,16 @@ Buffer generateSkySkanMesh(const std::filesystem::path& path, BaseViewport& pare
     rotQuat = glm::rotate(rotQuat, glm::radians(-*azimuth), glm::vec3(0.f, 1.f, 0.f));
     rotQuat = glm::rotate(rotQuat, glm::radians(*elevation), glm::vec3(1.f, 0.f, 0.f));
 
-    parent.user().setPos(vec3{ 0.f, 0.f, 0.f });
+    buf.userPosition = vec3{ 0.f, 0.f, 0.f };
     const float vHalf = *vFov / 2.f;
     const float hHalf = *hFov / 2.f;
-    parent.setViewPlaneCoordsUsingFOVs(
-        vHalf,
-        -vHalf,
-        -hHalf,
-        hHalf,
-        quat(rotQuat.x, rotQuat.y, rotQuat.z, rotQuat.w)
-    );
-    Engine::instance().updateFrustums();
+    buf.viewPlane = Buffer::ViewPlane{
+        .up = vHalf,
+        .down = -vHalf,
+        .left = -hHalf,
+        .right = hHalf,
+        .orientation = quat(rotQuat.x, rotQuat.y, rotQuat.z, rotQuat.w)
+    };
 
     for (unsigned int c = 0; c < (sizeX - 1); c++) {
         for (unsigned int r = 0; r < (sizeY - 1); r++) {
@@ -189,15 +197,12 @@ Buffer generateSkySkanMesh(const std::filesystem::path& path, BaseViewport& pare
     }
 
     for (Buffer::Vertex& vertex : buf.vertices) {
-        const vec2& s = parent.size();
-        const vec2& p = parent.position();
-
         // convert to [-1, 1]
-        vertex.x = 2.f * (vertex.x * s.x + p.x) - 1.f;
-        vertex.y = 2.f * ((1.f - vertex.y) * s.y + p.y) - 1.f;
+        vertex.x = 2.f * (vertex.x * size.x + pos.x) - 1.f;
+        vertex.y = 2.f * ((1.f - vertex.y) * size.y + pos.y) - 1.f;
 
-        vertex.s = vertex.s * s.x + p.x;
-        vertex.t = vertex.t * s.y + p.y;
+        vertex.s = vertex.s * size.x + pos.x;
+        vertex.t = vertex.t * size.y + pos.y;
     }
 
     buf.geometryType = GL_TRIANGLES;
@@ -0,0 +1,156 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/correction/tokenizer.h>
+
+#include <algorithm>
+#include <charconv>
+
+namespace {
+    constexpr std::string_view Whitespace = " \t\r\n\f\v";
+
+    constexpr bool isWhitespace(char c) {
+        return c == ' ' || (c >= '\t' && c <= '\r');
+    }
+
+    std::string_view trim(std::string_view str) {
+        const size_t begin = str.find_first_not_of(Whitespace);
+        if (begin == std::string_view::npos) {
+            return std::string_view();
+        }
+        const size_t end = str.find_last_not_of(Whitespace);
+        return str.substr(begin, end - begin + 1);
+    }
+
+    template <typename T>
+    std::optional<T> convert(std::string_view str) {
+        const char* first = str.data();
+        const char* last = str.data() + str.size();
+        while (first != last && isWhitespace(*first)) {
+            first++;
+        }
+        if (first == last) {
+            return std::nullopt;
+        }
+        // std::from_chars does not accept an explicit positive sign
+        if (*first == '+' && last - first > 1 && first[1] != '-') {
+            first++;
+        }
+
+        T value = T(0);
+        const std::from_chars_result res = std::from_chars(first, last, value);
+        if (res.ec != std::errc() || res.ptr == first) {
+            return std::nullopt;
+        }
+        return value;
+    }
+} // namespace
+
+namespace sgct::correction {
+
+std::optional<float> toFloat(std::string_view str) {
+    return convert<float>(str);
+}
+
+std::optional<int> toInt(std::string_view str) {
+    return convert<int>(str);
+}
+
+std::optional<unsigned int> toUnsignedInt(std::string_view str) {
+    return convert<unsigned int>(str);
+}
+
+Tokenizer::Tokenizer(std::string_view text, std::string_view separators)
+    : _text(text)
+    , _separators(separators)
+{}
+
+bool Tokenizer::nextLine() {
+    while (_textPos < _text.size()) {
+        size_t end = _text.find('\n', _textPos);
+        if (end == std::string_view::npos) {
+            end = _text.size();
+        }
+        _line = _text.substr(_textPos, end - _textPos);
+        _textPos = end + 1;
+        _linePos = 0;
+
+        if (!_line.empty() && _line.back() == '\r') {
+            _line.remove_suffix(1);
+        }
+        if (_line.find_first_not_of(Whitespace) != std::string_view::npos) {
+            return true;
+        }
+    }
+    _line = std::string_view();
+    _linePos = 0;
+    return false;
+}
+
+std::string_view Tokenizer::line() const {
+    return _line;
+}
+
+std::string_view Tokenizer::rest() const {
+    return trim(_line.substr(std::min(_linePos, _line.size())));
+}
+
+std::string_view Tokenizer::nextToken() {
+    const auto isSeparator = [this](char c) {
+        // Most files only use spaces as separators, so check for those first before
+        // searching through the list of separators
+        return c == ' ' || c == '\t' || _separators.find(c) != std::string_view::npos;
+    };
+
+    // Skip all separators and whitespace in front of the token
+    while (_linePos < _line.size() &&
+           (isSeparator(_line[_linePos]) || isWhitespace(_line[_linePos])))
+    {
+        _linePos++;
+    }
+    if (_linePos >= _line.size()) {
+        return std::string_view();
+    }
+
+    size_t end = _linePos + 1;
+    while (end < _line.size() && !isSeparator(_line[end])) {
+        end++;
+    }
+    std::string_view token = _line.substr(_linePos, end - _linePos);
+    // Consume the separator that terminated the token
+    _linePos = std::min(end + 1, _line.size());
+    // The front of the token is not whitespace, so only the back has to be trimmed
+    while (isWhitespace(token.back())) {
+        token.remove_suffix(1);
+    }
+    return token;
+}
+
+std::optional<float> Tokenizer::nextFloat() {
+    return toFloat(nextToken());
+}
+
+std::optional<int> Tokenizer::nextInt() {
+    return toInt(nextToken());
+}
+
+std::optional<unsigned int> Tokenizer::nextUnsignedInt() {
+    return toUnsignedInt(nextToken());
+}
+
+TextFile::TextFile(const std::filesystem::path& path) : _file(path) {}
+
+bool TextFile::isOpen() const {
+    return _file.isOpen();
+}
+
+std::string_view TextFile::text() const {
+    return std::string_view(reinterpret_cast<const char*>(_file.data()), _file.size());
+}
+
+} // namespace sgct::correction
@@ -8,22 +8,28 @@
 
 #include <sgct/correctionmesh.h>
 
+#include <sgct/engine.h>
 #include <sgct/error.h>
 #include <sgct/format.h>
+#include <sgct/internalshaders.h>
 #include <sgct/log.h>
 #include <sgct/math.h>
 #include <sgct/opengl.h>
 #include <sgct/profiling.h>
 #include <sgct/settings.h>
+#include <sgct/user.h>
 #include <sgct/viewport.h>
 #include <sgct/window.h>
 #include <sgct/correction/domeprojection.h>
+#include <sgct/correction/meshcache.h>
 #include <sgct/correction/obj.h>
+#include <sgct/correction/optimize.h>
 #include <sgct/correction/paulbourke.h>
 #include <sgct/correction/pfm.h>
 #include <sgct/correction/scalable.h>
 #include <sgct/correction/sciss.h>
 #include <sgct/correction/simcad.h>
+#include <sgct/correction/simplify.h>
 #include <sgct/correction/skyskan.h>
 #include <sgct/projection/fisheye.h>
 #include <algorithm>
@@ -158,25 +164,228 @@ void exportMesh(GLenum type, const std::filesystem::path& path,
     Log::Info(std::format("Mesh '{}' exported successfully", path));
 }
 
+correction::Buffer parseMesh(const std::filesystem::path& path,
+                             const CorrectionMesh::ViewportSetup& parent,
+                             bool textureRenderMode)
+{
+    using namespace correction;
+    const vec2& parentPos = parent.position;
+    const vec2& parentSize = parent.size;
+
+    if (path.extension() == ".sgc") {
+        return generateScissMesh(path, parentPos, parentSize);
+    }
+    else if (path.extension() == ".ol") {
+        return generateScalableMesh(path, parentPos, parentSize);
+    }
+    else if (path.extension() == ".skyskan") {
+        return generateSkySkanMesh(path, parentPos, parentSize);
+    }
+    else if (path.extension() == ".txt") {
+        return generateSkySkanMesh(path, parentPos, parentSize);
+    }
+    else if (path.extension() == ".csv") {
+        return generateDomeProjectionMesh(path, parentPos, parentSize);
+    }
+    else if (path.extension() == ".data") {
+        return generatePaulBourkeMesh(path, parentPos, parentSize, parent.aspectRatio);
+    }
+    else if (path.extension() == ".obj") {
+        return generateOBJMesh(path);
+    }
+    else if (path.extension() == ".pfm") {
+        return generatePerEyeMeshFromPFMImage(
+            path,
+            parentPos,
+            parentSize,
+            textureRenderMode
+        );
+    }
+    else if (path.extension() == ".simcad") {
+        return generateSimCADMesh(path, parentPos, parentSize);
+    }
+    else {
+        throw Error(2002, "Could not determine format for warping mesh");
+    }
+}
+
+// The stereo modes that combine both eyes in a shader, which can't be used together with
+// a baked warp as that uses its own shader
+bool hasStereoShader(Window::StereoMode sm) {
+    return sm > Window::StereoMode::Active && sm < Window::StereoMode::SideBySide;
+}
+
+// Applies the parts of the viewport setup that are defined by some mesh formats
+void applyViewSetup(BaseViewport& parent,
+                    const std::optional<correction::Buffer::ViewPlane>& viewPlane,
+                    const std::optional<vec3>& projectionOffset,
+                    const std::optional<vec3>& userPosition)
+{
+    if (userPosition) {
+        parent.user().setPos(*userPosition);
+    }
+    if (viewPlane) {
+        parent.setViewPlaneCoordsUsingFOVs(
+            viewPlane->up,
+            viewPlane->down,
+            viewPlane->left,
+            viewPlane->right,
+            viewPlane->orientation
+        );
+        Engine::instance().updateFrustums();
+    }
+    if (projectionOffset) {
+        parent.projectionPlane().offset(*projectionOffset);
+    }
+}
+
 } // namespace
 
 CorrectionMesh::CorrectionMeshGeometry::~CorrectionMeshGeometry() {
+    release();
+}
+
+void CorrectionMesh::CorrectionMeshGeometry::release() {
     // Yes, glDeleteVertexArrays and glDeleteBuffers work when passing 0, but this check
     // is a standin for whether they were created in the first place. This would only fail
     // if there is no OpenGL context, which would cause these functions to fail, too.
     if (vao) {
         glDeleteVertexArrays(1, &vao);
+        vao = 0;
     }
     if (vbo) {
         glDeleteBuffers(1, &vbo);
+        vbo = 0;
     }
     if (ibo) {
         glDeleteBuffers(1, &ibo);
+        ibo = 0;
+    }
+    nVertices = 0;
+    nIndices = 0;
+}
+
+CorrectionMesh::BakedWarpTextures::~BakedWarpTextures() {
+    release();
+}
+
+void CorrectionMesh::BakedWarpTextures::release() {
+    if (lookup) {
+        glDeleteTextures(1, &lookup);
+        lookup = 0;
+    }
+    if (blend) {
+        glDeleteTextures(1, &blend);
+        blend = 0;
     }
 }
 
+CorrectionMesh::ViewportSetup CorrectionMesh::viewportSetup(const BaseViewport& parent) {
+    return ViewportSetup{
+        parent.position(),
+        parent.size(),
+        parent.window().aspectRatio()
+    };
+}
+
+CorrectionMesh::MeshData CorrectionMesh::readMesh(const std::filesystem::path& path,
+                                                  const BaseViewport& parent,
+                                                  bool textureRenderMode)
+{
+    return readMesh(path, viewportSetup(parent), textureRenderMode);
+}
+
+CorrectionMesh::MeshData CorrectionMesh::readMesh(const std::filesystem::path& path,
+                                                  const ViewportSetup& parent,
+                                                  bool textureRenderMode)
+{
+    ZoneScoped;
+
+    using namespace correction;
+
+    MeshData mesh;
+    mesh.path = path;
+    if (path.empty()) {
+        return mesh;
+    }
+
+    const float simplificationError =
+        Settings::instance().warpingMeshSimplificationError();
+    const bool optimize = Settings::instance().optimizeWarpingMeshes();
+
+    // The cache is only used for existing files so that the loaders report missing files
+    std::string cacheKey;
+    std::filesystem::path cachePath;
+    if (Settings::instance().useWarpingMeshCache() && std::filesystem::exists(path)) {
+        ZoneScopedN("Open cached mesh");
+        cacheKey = meshCacheKey(
+            path,
+            parent.position,
+            parent.size,
+            parent.aspectRatio,
+            textureRenderMode,
+            simplificationError,
+            optimize
+        );
+        cachePath = meshCachePath(path, cacheKey);
+        mesh.cached = CachedMesh::open(cachePath, cacheKey);
+    }
+
+    if (mesh.cached) {
+        Log::Debug(std::format("CorrectionMesh: Using cached mesh '{}'", cachePath));
+        return mesh;
+    }
+
+    mesh.buffer = parseMesh(path, parent, textureRenderMode);
+    if (simplificationError > 0.f) {
+        ZoneScopedN("Simplify mesh");
+        std::optional<Buffer> simplified = simplifyMesh(mesh.buffer, simplificationError);
+        if (simplified) {
+            Log::Debug(std::format(
+                "CorrectionMesh: Simplified '{}' from {} to {} vertices", path,
+                mesh.buffer.vertices.size(), simplified->vertices.size()
+            ));
+            mesh.buffer = std::move(*simplified);
+        }
+        else {
+            Log::Debug(std::format(
+                "CorrectionMesh: Not simplifying '{}' as it is not a regular grid", path
+            ));
+        }
+    }
+    if (optimize) {
+        ZoneScopedN("Optimize mesh");
+        const float before = averageCacheMissRatio(mesh.buffer);
+        const size_t nVertices = mesh.buffer.vertices.size();
+        optimizeVertexCache(mesh.buffer);
+        Log::Debug(std::format(
+            "CorrectionMesh: Optimized '{}' from ACMR {:.3f} to {:.3f}, removed {} "
+            "unused vertices", path, before, averageCacheMissRatio(mesh.buffer),
+            nVertices - mesh.buffer.vertices.size()
+        ));
+    }
+    if (!cacheKey.empty()) {
+        try {
+            writeCachedMesh(cachePath, cacheKey, mesh.buffer);
+        }
+        catch (const std::exception& e) {
+            // A read-only mesh folder should not prevent the mesh from being used
+            Log::Warning(std::format(
+                "CorrectionMesh: Failed to cache mesh '{}': {}", path, e.what()
+            ));
+        }
+    }
+    return mesh;
+}
+
 void CorrectionMesh::loadMesh(const std::filesystem::path& path, BaseViewport& parent,
                               bool needsMaskGeometry, bool textureRenderMode)
+{
+    loadMesh(readMesh(path, parent, textureRenderMode), parent, needsMaskGeometry);
+}
+
+void CorrectionMesh::loadMesh(MeshData mesh, BaseViewport& parent, bool needsMaskGeometry,
+                              bool canBake)
 {
     ZoneScoped;
 
@@ -201,34 +410,54 @@ void CorrectionMesh::loadMesh(const std::filesystem::path& path, BaseViewport& p
     }
 
     // fallback if no mesh is provided
-    if (path.empty()) {
+    if (mesh.path.empty()) {
         const Buffer buf = setupSimpleMesh(parentPos, parentSize);
         createMesh(_warpGeometry, buf);
         return;
     }
 
-    Buffer buf;
-
-    // find a suitable format
-    if (path.extension() == ".sgc") {
-        buf = generateScissMesh(path, parent);
-    }
-    else if (path.extension() == ".ol") {
-        buf = generateScalableMesh(path, parent);
+    const bool bake = canBake && Settings::instance().useWarpingLookupTexture() &&
+        !hasStereoShader(parent.window().stereoMode());
+    if (mesh.cached && bake) {
+        mesh.buffer = mesh.cached->toBuffer();
+        mesh.cached = std::nullopt;
     }
-    else if (path.extension() == ".skyskan") {
-        buf = generateSkySkanMesh(path, parent);
-    }
-    else if (path.extension() == ".txt") {
-        buf = generateSkySkanMesh(path, parent);
+
+    const bool compact = Settings::instance().useCompactWarpingMeshVertices();
+    if (mesh.cached) {
+        applyViewSetup(
+            parent,
+            mesh.cached->viewPlane(),
+            mesh.cached->projectionOffset(),
+            mesh.cached->userPosition()
+        );
+        createMesh(
+            _warpGeometry,
+            mesh.cached->vertices(),
+            mesh.cached->indices(),
+            mesh.cached->geometryType(),
+            compact
+        );
     }
-    else if (path.extension() == ".csv") {
-        buf = generateDomeProjectionMesh(path, parentPos, parentSize);
+    else {
+        const Buffer& buf = mesh.buffer;
+        applyViewSetup(parent, buf.viewPlane, buf.projectionOffset, buf.userPosition);
+        if (bake) {
+            _bakedMesh = buf;
+            bakeMesh(parent.window().backBufferResolution());
+        }
+        else {
+            createMesh(
+                _warpGeometry,
+                buf.vertices,
+                buf.indices,
+                buf.geometryType,
+                compact
+            );
+        }
     }
-    else if (path.extension() == ".data") {
-        const float aspectRatio = parent.window().aspectRatio();
-        buf = generatePaulBourkeMesh(path, parentPos, parentSize, aspectRatio);
 
+    if (mesh.path.extension() == ".data") {
         // force regeneration of dome render quad
         if (Viewport* vp = dynamic_cast<Viewport*>(&parent); vp) {
             auto fishPrj = dynamic_cast<FisheyeProjection*>(vp->nonLinearProjection());
@@ -238,36 +467,20 @@ void CorrectionMesh::loadMesh(const std::filesystem::path& path, BaseViewport& p
             }
         }
     }
-    else if (path.extension() == ".obj") {
-        buf = generateOBJMesh(path);
-    }
-    else if (path.extension() == ".pfm") {
-        buf = generatePerEyeMeshFromPFMImage(
-            path,
-            parentPos,
-            parentSize,
-            textureRenderMode
-        );
-    }
-    else if (path.extension() == ".simcad") {
-        buf = generateSimCADMesh(path, parentPos, parentSize);
-    }
-    else {
-        throw Error(2002, "Could not determine format for warping mesh");
-    }
-
-    createMesh(_warpGeometry, buf);
 
     Log::Debug(std::format(
         "CorrectionMesh read successfully. Vertices={}, Indices={}",
-        buf.vertices.size(), buf.indices.size()
+        _warpGeometry.nVertices, _warpGeometry.nIndices
     ));
 
     if (Settings::instance().exportWarpingMeshes()) {
-        std::filesystem::path p = path;
+        if (mesh.cached) {
+            mesh.buffer = mesh.cached->toBuffer();
+        }
+        std::filesystem::path p = mesh.path;
         p.replace_filename(std::format("{}_export", p.filename()));
         p.replace_extension(".obj");
-        exportMesh(_warpGeometry.type, p, buf);
+        exportMesh(mesh.buffer.geometryType, p, mesh.buffer);
     }
 }
 
@@ -280,6 +493,11 @@ void CorrectionMesh::renderQuadMesh() const {
 }
 
 void CorrectionMesh::renderWarpMesh() const {
+    if (_bakedTextures.lookup) {
+        renderBakedWarp();
+        return;
+    }
+
     TracyGpuZone("Render Warp mesh")
 
     glBindVertexArray(_warpGeometry.vao);
@@ -297,45 +515,200 @@ void CorrectionMesh::renderMaskMesh() const {
 
 void CorrectionMesh::createMesh(CorrectionMeshGeometry& geom,
                                 const correction::Buffer& buffer)
+{
+    createMesh(geom, buffer.vertices, buffer.indices, buffer.geometryType);
+}
+
+void CorrectionMesh::createMesh(CorrectionMeshGeometry& geom,
+                                std::span<const correction::Buffer::Vertex> vertices,
+                                std::span<const unsigned int> indices,
+                                unsigned int geometryType, bool useCompactVertices)
 {
     ZoneScoped;
     TracyGpuZone("createMesh");
 
+    // The mesh is created again if its file is reloaded
+    geom.release();
+
     glGenVertexArrays(1, &geom.vao);
     glBindVertexArray(geom.vao);
 
     glGenBuffers(1, &geom.vbo);
     glBindBuffer(GL_ARRAY_BUFFER, geom.vbo);
-    constexpr int s = sizeof(correction::Buffer::Vertex);
-    glBufferData(
-        GL_ARRAY_BUFFER,
-        buffer.vertices.size() * s,
-        buffer.vertices.data(),
-        GL_STATIC_DRAW
-    );
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, nullptr);
+    std::optional<std::vector<correction::CompactVertex>> compact;
+    if (useCompactVertices) {
+        compact = correction::compactVertices(vertices);
+        if (!compact) {
+            Log::Debug(
+                "CorrectionMesh: Using full vertex format as the texture coordinates or "
+                "colors are outside the range [0, 1]"
+            );
+        }
+    }
 
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(8));
+    if (compact) {
+        constexpr int s = sizeof(correction::CompactVertex);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            compact->size() * s,
+            compact->data(),
+            GL_STATIC_DRAW
+        );
 
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(16));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, nullptr);
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(
+            1, 2, GL_UNSIGNED_SHORT, GL_TRUE, s, reinterpret_cast<void*>(8)
+        );
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(
+            2, 4, GL_UNSIGNED_BYTE, GL_TRUE, s, reinterpret_cast<void*>(12)
+        );
+    }
+    else {
+        constexpr int s = sizeof(correction::Buffer::Vertex);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            vertices.size() * s,
+            vertices.data(),
+            GL_STATIC_DRAW
+        );
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, s, nullptr);
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(8));
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, s, reinterpret_cast<void*>(16));
+    }
 
     glGenBuffers(1, &geom.ibo);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, geom.ibo);
     glBufferData(
         GL_ELEMENT_ARRAY_BUFFER,
-        buffer.indices.size() * sizeof(unsigned int),
-        buffer.indices.data(),
+        indices.size() * sizeof(unsigned int),
+        indices.data(),
         GL_STATIC_DRAW
     );
     glBindVertexArray(0);
 
-    geom.nVertices = static_cast<int>(buffer.vertices.size());
-    geom.nIndices = static_cast<int>(buffer.indices.size());
-    geom.type = buffer.geometryType;
+    geom.nVertices = static_cast<int>(vertices.size());
+    geom.nIndices = static_cast<int>(indices.size());
+    geom.type = geometryType;
+}
+
+void CorrectionMesh::updateBakedWarp(ivec2 resolution) {
+    if (_bakedMesh.vertices.empty() ||
+        (resolution.x == _bakedResolution.x && resolution.y == _bakedResolution.y))
+    {
+        return;
+    }
+    bakeMesh(resolution);
+}
+
+void CorrectionMesh::bakeMesh(ivec2 resolution) {
+    ZoneScoped;
+
+    const correction::BakedWarp baked = correction::bakeWarp(_bakedMesh, resolution);
+    Log::Debug(std::format(
+        "CorrectionMesh: Baked mesh into {}x{} lookup texture for {}x{} pixels",
+        baked.size.x, baked.size.y, resolution.x, resolution.y
+    ));
+    createBakedWarp(baked);
+    _bakedResolution = resolution;
+}
+
+void CorrectionMesh::createBakedWarp(const correction::BakedWarp& baked) {
+    ZoneScoped;
+
+    _bakedTextures.release();
+    if (baked.size.x == 0 || baked.size.y == 0) {
+        // The mesh does not cover any pixel, so there is nothing to render
+        return;
+    }
+
+    // The quad covering the baked area, where the texture coordinates address the
+    // lookup and blend textures
+    const vec2& ll = baked.lowerLeft;
+    const vec2& ur = baked.upperRight;
+    correction::Buffer quad;
+    quad.geometryType = GL_TRIANGLE_STRIP;
+    quad.indices = { 0, 3, 1, 2 };
+    quad.vertices = {
+        { ll.x, ll.y, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f },
+        { ur.x, ll.y, 1.f, 0.f, 1.f, 1.f, 1.f, 1.f },
+        { ur.x, ur.y, 1.f, 1.f, 1.f, 1.f, 1.f, 1.f },
+        { ll.x, ur.y, 0.f, 1.f, 1.f, 1.f, 1.f, 1.f }
+    };
+    createMesh(_bakedGeometry, quad);
+
+    // Each texel corresponds to exactly one pixel, so there is no filtering
+    const auto createTexture = [&baked](GLenum internalFormat, GLenum format,
+                                        const void* data)
+    {
+        unsigned int id = 0;
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_2D, id);
+        glTexImage2D(
+            GL_TEXTURE_2D, 0, internalFormat, baked.size.x, baked.size.y, 0,
+            format, GL_FLOAT, data
+        );
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        return id;
+    };
+    _bakedTextures.lookup = createTexture(GL_RGB32F, GL_RGB, baked.lookup.data());
+    _bakedTextures.blend = createTexture(GL_RGBA16F, GL_RGBA, baked.blend.data());
+
+    if (_bakedShader.id() != 0) {
+        // The shader does not depend on the mesh and only needs to be created once
+        return;
+    }
+    _bakedShader = ShaderProgram("BakedWarpShader");
+    _bakedShader.addShaderSource(shaders::BaseVert, GL_VERTEX_SHADER);
+    _bakedShader.addShaderSource(shaders::BakedWarpFrag, GL_FRAGMENT_SHADER);
+    _bakedShader.createAndLinkProgram();
+    _bakedShader.bind();
+    glUniform1i(glGetUniformLocation(_bakedShader.id(), "tex"), 0);
+    glUniform1i(glGetUniformLocation(_bakedShader.id(), "lookup"), 1);
+    glUniform1i(glGetUniformLocation(_bakedShader.id(), "blend"), 2);
+    ShaderProgram::unbind();
+}
+
+void CorrectionMesh::renderBakedWarp() const {
+    TracyGpuZone("Render baked warp")
+
+    // The caller has bound its own shader program for the meshes of the other viewports,
+    // which has to be restored afterwards
+    GLint program = 0;
+    glGetIntegerv(GL_CURRENT_PROGRAM, &program);
+
+    _bakedShader.bind();
+    glActiveTexture(GL_TEXTURE1);
+    glBindTexture(GL_TEXTURE_2D, _bakedTextures.lookup);
+    glActiveTexture(GL_TEXTURE2);
+    glBindTexture(GL_TEXTURE_2D, _bakedTextures.blend);
+    glActiveTexture(GL_TEXTURE0);
+
+    glBindVertexArray(_bakedGeometry.vao);
+    glDrawElements(
+        _bakedGeometry.type,
+        _bakedGeometry.nIndices,
+        GL_UNSIGNED_INT,
+        nullptr
+    );
+    glBindVertexArray(0);
+
+    glUseProgram(program);
 }
 
 } // namespace sgct
@@ -7,9 +7,12 @@
  ****************************************************************************************/
 
 #include <sgct/engine.h>
+#include <sgct/bundle.h>
 #include <sgct/clustermanager.h>
 #include <sgct/commandline.h>
+#include <sgct/configsnapshot.h>
 #include <sgct/error.h>
+#include <sgct/filewatcher.h>
 #include <sgct/font.h>
 #include <sgct/fontmanager.h>
 #include <sgct/format.h>
@@ -31,7 +34,9 @@
 #include <sgct/user.h>
 #include <sgct/version.h>
 #include <sgct/projection/nonlinearprojection.h>
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <iostream>
 #include <numeric>
 #include <cmath>
@@ -69,6 +74,9 @@ namespace {
     std::function<void(double, double, Window*)> gMouseScrollCallback = nullptr;
     std::function<void(std::vector<std::string_view>)> gDropCallback = nullptr;
 
+    // Serves the configuration bundle to the clients for as long as the engine exists
+    std::unique_ptr<BundleServer> gBundleServer;
+
     // For feedback: breaks a frame lock wait condition every time interval
     // (FrameLockTimeout) in order to print waiting message.
     void updateFrameLockLoop(void*) {
@@ -94,7 +102,14 @@ namespace {
         if (buffer == BufferMode::BackBufferBlack) {
             const bool doubleBuffered = window.isDoubleBuffered();
             // Set buffer
-            if (window.stereoMode() != Window::StereoMode::Active) {
+            if (Settings::instance().useHeadlessRendering()) {
+                window.bindHeadlessFramebuffer(
+                    frustum == Frustum::Mode::StereoRightEye ?
+                        Window::Eye::Right :
+                        Window::Eye::MonoOrLeft
+                );
+            }
+            else if (window.stereoMode() != Window::StereoMode::Active) {
                 glDrawBuffer(doubleBuffered ? GL_BACK : GL_FRONT);
                 glReadBuffer(doubleBuffered ? GL_BACK : GL_FRONT);
             }
@@ -119,34 +134,30 @@ namespace {
         }
     }
 
+    OffScreenBuffer::Target renderingTarget(Window& win, Window::TextureIndex ti) {
+        OffScreenBuffer::Target target;
+        target.color = win.frameBufferTexture(ti);
+        if (Settings::instance().useDepthTexture()) {
+            target.depth = win.frameBufferTexture(Window::TextureIndex::Depth);
+        }
+        if (Settings::instance().useNormalTexture()) {
+            target.normals = win.frameBufferTexture(Window::TextureIndex::Normals);
+        }
+        if (Settings::instance().usePositionTexture()) {
+            target.positions = win.frameBufferTexture(Window::TextureIndex::Positions);
+        }
+        return target;
+    }
+
     void prepareBuffer(Window& win, Window::TextureIndex ti) {
         ZoneScoped;
 
         OffScreenBuffer* fbo = win.fbo();
-        fbo->bind();
         if (fbo->isMultiSampled()) {
-            return;
+            fbo->bind();
         }
-
-        // update attachments
-        fbo->attachColorTexture(win.frameBufferTexture(ti), GL_COLOR_ATTACHMENT0);
-
-        if (Settings::instance().useDepthTexture()) {
-            fbo->attachDepthTexture(win.frameBufferTexture(Window::TextureIndex::Depth));
-        }
-
-        if (Settings::instance().useNormalTexture()) {
-            fbo->attachColorTexture(
-                win.frameBufferTexture(Window::TextureIndex::Normals),
-                GL_COLOR_ATTACHMENT1
-            );
-        }
-
-        if (Settings::instance().usePositionTexture()) {
-            fbo->attachColorTexture(
-                win.frameBufferTexture(Window::TextureIndex::Positions),
-                GL_COLOR_ATTACHMENT2
-            );
+        else {
+            fbo->bindTarget(renderingTarget(win, ti));
         }
     }
 
@@ -160,29 +171,7 @@ namespace {
         }
 
         // bind separate read and draw buffers to prepare blit operation
-        fbo->bindBlit();
-
-        // update attachments
-        fbo->attachColorTexture(win.frameBufferTexture(ti), GL_COLOR_ATTACHMENT0);
-
-        if (Settings::instance().useDepthTexture()) {
-            fbo->attachDepthTexture(win.frameBufferTexture(Window::TextureIndex::Depth));
-        }
-
-        if (Settings::instance().useNormalTexture()) {
-            fbo->attachColorTexture(
-                win.frameBufferTexture(Window::TextureIndex::Normals),
-                GL_COLOR_ATTACHMENT1
-            );
-        }
-
-        if (Settings::instance().usePositionTexture()) {
-            fbo->attachColorTexture(
-                win.frameBufferTexture(Window::TextureIndex::Positions),
-                GL_COLOR_ATTACHMENT2
-            );
-        }
-
+        fbo->bindTarget(renderingTarget(win, ti));
         fbo->blit();
     }
 } // namespace
@@ -245,15 +234,16 @@ void Engine::destroy() {
 
     delete _instance;
     _instance = nullptr;
+    gBundleServer = nullptr;
 }
 
-config::Cluster loadCluster(std::optional<std::filesystem::path> path) {
+config::Cluster loadCluster(std::optional<std::filesystem::path> path, bool useSnapshot) {
     ZoneScoped;
 
     if (path) {
         assert(std::filesystem::exists(*path) && std::filesystem::is_regular_file(*path));
         try {
-            return readConfig(*path);
+            return useSnapshot ? readConfigWithSnapshot(*path) : readConfig(*path);
         }
         catch (const std::runtime_error& e) {
             std::cout << e.what() << '\n';
@@ -306,6 +296,47 @@ config::Cluster loadCluster(std::optional<std::filesystem::path> path) {
     }
 }
 
+config::Cluster loadCluster(const Configuration& configuration) {
+    ZoneScoped;
+
+    try {
+        if (configuration.bundleMasterAddress && configuration.bundleMasterPort) {
+            const std::filesystem::path cache =
+                configuration.bundleCacheFolder ?
+                std::filesystem::path(*configuration.bundleCacheFolder) :
+                std::filesystem::temp_directory_path() / "sgct-bundles";
+            return fetchBundle(
+                *configuration.bundleMasterAddress,
+                *configuration.bundleMasterPort,
+                cache
+            );
+        }
+
+        std::optional<std::filesystem::path> path;
+        if (configuration.configFilename) {
+            path = *configuration.configFilename;
+        }
+        config::Cluster cluster = loadCluster(
+            path,
+            configuration.useConfigSnapshot.value_or(false)
+        );
+        if (cluster.success && configuration.bundleServerPort) {
+            gBundleServer = std::make_unique<BundleServer>(
+                createBundle(cluster),
+                *configuration.bundleServerPort
+            );
+        }
+        return cluster;
+    }
+    catch (const std::exception& e) {
+        // The applications only check whether the cluster was loaded successfully
+        Log::Error(std::format("Failed to load the cluster: {}", e.what()));
+        config::Cluster cluster;
+        cluster.success = false;
+        return cluster;
+    }
+}
+
 double time() {
     return glfwGetTime();
 }
@@ -360,6 +391,46 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
     if (config.exportCorrectionMeshes) {
         Settings::instance().setExportWarpingMeshes(*config.exportCorrectionMeshes);
     }
+    if (config.useCorrectionMeshCache) {
+        Settings::instance().setUseWarpingMeshCache(*config.useCorrectionMeshCache);
+    }
+    if (config.correctionMeshSimplificationError) {
+        Settings::instance().setWarpingMeshSimplificationError(
+            *config.correctionMeshSimplificationError
+        );
+    }
+    if (config.bakeCorrectionMeshes) {
+        Settings::instance().setUseWarpingLookupTexture(*config.bakeCorrectionMeshes);
+    }
+    if (config.optimizeCorrectionMeshes) {
+        Settings::instance().setOptimizeWarpingMeshes(*config.optimizeCorrectionMeshes);
+    }
+    if (config.compactCorrectionMeshes) {
+        Settings::instance().setUseCompactWarpingMeshVertices(
+            *config.compactCorrectionMeshes
+        );
+    }
+    if (config.hotReload) {
+        Settings::instance().setHotReload(*config.hotReload);
+    }
+    if (config.eventDrivenTracking) {
+        Settings::instance().setUseEventDrivenTracking(*config.eventDrivenTracking);
+    }
+    if (config.trackingRecordPath) {
+        Settings::instance().setTrackingRecordPath(*config.trackingRecordPath);
+    }
+    if (config.trackingReplayPath) {
+#ifndef SGCT_HAS_VRPN
+        throw Err(3007, "Replaying a tracking log requires SGCT to be built with VRPN");
+#endif // SGCT_HAS_VRPN
+        Settings::instance().setTrackingReplay(
+            *config.trackingReplayPath,
+            config.trackingReplaySpeed.value_or(Settings::TrackingReplaySpeed::Original)
+        );
+    }
+    if (config.headless) {
+        Settings::instance().setUseHeadlessRendering(*config.headless);
+    }
     if (config.useOpenGLDebugContext) {
         _createDebugContext = *config.useOpenGLDebugContext;
     }
@@ -389,6 +460,29 @@ Engine::Engine(config::Cluster cluster, Callbacks callbacks, const Configuration
         glfwSetErrorCallback([](int error, const char* desc) {
             throw Err(3010, std::format("GLFW error ({}): {}", error, desc));
         });
+        if (Settings::instance().useHeadlessRendering()) {
+            // The null platform does not need a display server and the contexts are
+            // created with EGL in the window creation. The platform hint was added in
+            // GLFW 3.4, which is checked for the headers and for the loaded library
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+            int major = 0;
+            int minor = 0;
+            glfwGetVersion(&major, &minor, nullptr);
+            if (major < 3 || (major == 3 && minor < 4)) {
+                throw Err(3008, std::format(
+                    "Headless rendering requires GLFW 3.4 or newer, but {}.{} is used",
+                    major, minor
+                ));
+            }
+            Log::Info("Rendering headless without a display server");
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else // ^^^^ GLFW >= 3.4 // GLFW < 3.4 vvvv
+            throw Err(3008, std::format(
+                "Headless rendering requires GLFW 3.4 or newer, but SGCT was built with "
+                "GLFW {}.{}", GLFW_VERSION_MAJOR, GLFW_VERSION_MINOR
+            ));
+#endif // GLFW >= 3.4
+        }
         const int res = glfwInit();
         if (res == GLFW_FALSE) {
             throw Err(3000, "Failed to initialize GLFW");
@@ -464,6 +558,10 @@ void Engine::initialize() {
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
         glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
+        if (Settings::instance().useHeadlessRendering()) {
+            // Window hints persist, so this applies to all windows that are created
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        }
         glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
         GLFWwindow* offscreen = glfwCreateWindow(128, 128, "", nullptr, nullptr);
         glfwMakeContextCurrent(offscreen);
@@ -487,6 +585,13 @@ void Engine::initialize() {
     const std::vector<std::unique_ptr<Window>>& wins = thisNode.windows();
     std::for_each(wins.cbegin(), wins.cend(), std::mem_fn(&Window::updateResolutions));
 
+    // Parse the correction meshes of all viewports in parallel while the rest of the
+    // OpenGL state is initialized. The meshes are uploaded in initContextSpecificOGL
+    for (const std::unique_ptr<Window>& win : wins) {
+        const std::vector<std::unique_ptr<Viewport>>& vps = win->viewports();
+        std::for_each(vps.cbegin(), vps.cend(), std::mem_fn(&Viewport::beginLoadData));
+    }
+
     // if a single node, skip syncing
     if (ClusterManager::instance().numberOfNodes() == 1) {
         ClusterManager::instance().setUseIgnoreSync(true);
@@ -656,6 +761,18 @@ void Engine::initialize() {
 
     updateFrustums();
 
+    if (Settings::instance().hotReload() != Settings::HotReload::Disabled) {
+        std::vector<std::filesystem::path> files;
+        for (const std::unique_ptr<Window>& win : wins) {
+            for (const std::unique_ptr<Viewport>& vp : win->viewports()) {
+                std::vector<std::filesystem::path> f = vp->dataFiles();
+                files.insert(files.end(), f.begin(), f.end());
+            }
+        }
+        Log::Info(std::format("Watching {} files for changes", files.size()));
+        _fileWatcher = std::make_unique<FileWatcher>(std::move(files));
+    }
+
 #ifdef SGCT_HAS_TEXT
 #ifdef WIN32
     constexpr std::string_view FontName = "verdanab.ttf";
@@ -827,8 +944,10 @@ void Engine::initWindows(int majorVersion, int minorVersion) {
     }
 
     // clear directly otherwise junk will be displayed on some OSs (OS X Yosemite)
-    glClearColor(0.f, 0.f, 0.f, 0.f);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    if (!Settings::instance().useHeadlessRendering()) {
+        glClearColor(0.f, 0.f, 0.f, 0.f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
 
     if (RunFrameLockCheckThread) {
         if (ClusterManager::instance().numberOfNodes() > 1) {
@@ -941,6 +1060,65 @@ void Engine::frameLockPostStage() {
     addValue(_statistics.syncTimes, glfwGetTime() - t0);
 }
 
+void Engine::updateHotReload() {
+    ZoneScoped;
+
+    const std::vector<std::unique_ptr<Window>>& windows =
+        ClusterManager::instance().thisNode().windows();
+
+    if (_fileWatcher) {
+        const std::vector<std::filesystem::path> changed = _fileWatcher->changedFiles();
+        if (!changed.empty()) {
+            for (const std::unique_ptr<Window>& win : windows) {
+                for (const std::unique_ptr<Viewport>& vp : win->viewports()) {
+                    vp->beginReloadData(changed);
+                }
+            }
+            if (isMaster() &&
+                Settings::instance().hotReload() == Settings::HotReload::Cluster)
+            {
+                SharedData& data = SharedData::instance();
+                data.setReloadCounter(data.reloadCounter() + 1);
+            }
+        }
+    }
+
+    // The master increments the counter whenever one of its files changes, in which case
+    // all clients reload all of their files. Files that did not change are reloaded from
+    // the texture and mesh caches
+    const uint32_t counter = SharedData::instance().reloadCounter();
+    if (!isMaster() && counter != _reloadCounter) {
+        _reloadCounter = counter;
+        Log::Info("Reloading files as requested by the master");
+        for (const std::unique_ptr<Window>& win : windows) {
+            for (const std::unique_ptr<Viewport>& vp : win->viewports()) {
+                vp->beginReloadData(vp->dataFiles());
+            }
+        }
+    }
+
+    // The meshes are not shared between the contexts, so they have to be replaced with
+    // the context of their window
+    bool hasChangedContext = false;
+    for (const std::unique_ptr<Window>& win : windows) {
+        const std::vector<std::unique_ptr<Viewport>>& vps = win->viewports();
+        const bool isReloading = std::any_of(
+            vps.cbegin(),
+            vps.cend(),
+            std::mem_fn(&Viewport::isReloadingData)
+        );
+        if (!isReloading) {
+            continue;
+        }
+        win->makeOpenGLContextCurrent();
+        hasChangedContext = true;
+        std::for_each(vps.cbegin(), vps.cend(), std::mem_fn(&Viewport::finishReloadData));
+    }
+    if (hasChangedContext) {
+        Window::makeSharedContextCurrent();
+    }
+}
+
 void Engine::exec() {
     Window::makeSharedContextCurrent();
 
@@ -956,7 +1134,10 @@ void Engine::exec() {
     {
 #ifdef SGCT_HAS_VRPN
         if (isMaster()) {
-            TrackingManager::instance().updateTrackingDevices();
+            // The frame is expected to be shown about one average frame time from now
+            TrackingManager::instance().updateTrackingDevices(
+                time() + _statistics.avgDt()
+            );
         }
 #endif
 
@@ -985,6 +1166,9 @@ void Engine::exec() {
         std::for_each(windows.cbegin(), windows.cend(), std::mem_fn(&Window::update));
         Window::makeSharedContextCurrent();
 
+        TextureManager::instance().processUploads();
+        updateHotReload();
+
         if (_postSyncPreDrawFn) {
             ZoneScopedN("[SGCT] PostSyncPreDraw");
             _postSyncPreDrawFn();
@@ -1080,7 +1264,7 @@ void Engine::exec() {
             }
         }
 
-        // Render to screen
+        // Render to screen, or to the offscreen framebuffers of headless windows
         for (const std::unique_ptr<Window>& window : windows) {
             if (window->isVisible()) {
                 renderFBOTexture(*window);
@@ -1196,10 +1380,7 @@ void Engine::renderFBOTexture(Window& window) {
         Frustum::Mode::StereoLeftEye :
         Frustum::Mode::MonoEye;
 
-    const ivec2 size = ivec2{
-        static_cast<int>(std::ceil(window.scale().x * window.resolution().x)),
-        static_cast<int>(std::ceil(window.scale().y * window.resolution().y))
-    };
+    const ivec2 size = window.backBufferResolution();
 
     glViewport(0, 0, size.x, size.y);
     setAndClearBuffer(window, BufferMode::BackBufferBlack, frustum);
@@ -1252,8 +1433,11 @@ void Engine::renderFBOTexture(Window& window) {
             _fboQuad.bind();
         }
 
-        glDrawBuffer(window.isDoubleBuffered() ? GL_BACK : GL_FRONT);
-        glReadBuffer(window.isDoubleBuffered() ? GL_BACK : GL_FRONT);
+        // The headless framebuffer is still bound with its only color attachment
+        if (!Settings::instance().useHeadlessRendering()) {
+            glDrawBuffer(window.isDoubleBuffered() ? GL_BACK : GL_FRONT);
+            glReadBuffer(window.isDoubleBuffered() ? GL_BACK : GL_FRONT);
+        }
         glActiveTexture(GL_TEXTURE0);
         glEnable(GL_BLEND);
 
@@ -1285,6 +1469,9 @@ void Engine::renderFBOTexture(Window& window) {
 
     ShaderProgram::unbind();
     glDisable(GL_BLEND);
+    if (Settings::instance().useHeadlessRendering()) {
+        OffScreenBuffer::unbind();
+    }
 }
 
 void Engine::renderViewports(Window& window, Frustum::Mode frustum,
@@ -1463,12 +1650,9 @@ void Engine::renderFXAA(Window& window, Window::TextureIndex targetIndex) {
 
     assert(_fxaa.has_value());
 
-    glDrawBuffer(GL_COLOR_ATTACHMENT0);
     // bind target FBO
-    window.fbo()->attachColorTexture(
-        window.frameBufferTexture(targetIndex),
-        GL_COLOR_ATTACHMENT0
-    );
+    window.fbo()->bindTarget(renderingTarget(window, targetIndex));
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
 
     const ivec2 framebufferSize = window.framebufferResolution();
     glViewport(0, 0, framebufferSize.x, framebufferSize.y);
@@ -1506,21 +1690,24 @@ void Engine::waitForAllWindowsInSwapGroupToOpen() {
     ClusterManager& cm = ClusterManager::instance();
     Node& thisNode = cm.thisNode();
 
-    // clear the buffers initially
-    for (const std::unique_ptr<Window>& window : thisNode.windows()) {
-        ZoneScopedN("Clear Windows");
-        window->makeOpenGLContextCurrent();
-        glDrawBuffer(window->isDoubleBuffered() ? GL_BACK : GL_FRONT);
-        glClearColor(0.f, 0.f, 0.f, 0.f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    // clear the buffers initially, unless the windows are headless and have no buffers
+    const bool hasScreen = !Settings::instance().useHeadlessRendering();
+    if (hasScreen) {
+        for (const std::unique_ptr<Window>& window : thisNode.windows()) {
+            ZoneScopedN("Clear Windows");
+            window->makeOpenGLContextCurrent();
+            glDrawBuffer(window->isDoubleBuffered() ? GL_BACK : GL_FRONT);
+            glClearColor(0.f, 0.f, 0.f, 0.f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        if (window->isDoubleBuffered()) {
-            ZoneScopedN("glfwSwapBuffers");
-            glfwSwapBuffers(window->windowHandle());
-        }
-        else {
-            ZoneScopedN("glFinish");
-            glFinish();
+            if (window->isDoubleBuffered()) {
+                ZoneScopedN("glfwSwapBuffers");
+                glfwSwapBuffers(window->windowHandle());
+            }
+            else {
+                ZoneScopedN("glFinish");
+                glFinish();
+            }
         }
     }
 
@@ -1551,13 +1738,15 @@ void Engine::waitForAllWindowsInSwapGroupToOpen() {
 
     while (!NetworkManager::instance().areAllNodesConnected()) {
         // Swap front and back rendering buffers
-        for (const std::unique_ptr<Window>& window : thisNode.windows()) {
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-            if (window->isDoubleBuffered()) {
-                glfwSwapBuffers(window->windowHandle());
-            }
-            else {
-                glFinish();
+        if (hasScreen) {
+            for (const std::unique_ptr<Window>& window : thisNode.windows()) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                if (window->isDoubleBuffered()) {
+                    glfwSwapBuffers(window->windowHandle());
+                }
+                else {
+                    glFinish();
+                }
             }
         }
         {
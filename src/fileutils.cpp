@@ -0,0 +1,43 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/fileutils.h>
+
+#include <sgct/format.h>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <thread>
+
+namespace sgct {
+
+uint64_t fnv1a(std::string_view data, uint64_t h) {
+    for (char c : data) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+std::filesystem::path temporaryPath(const std::filesystem::path& path) {
+    // The random device is not guaranteed to be nondeterministic on every platform, so
+    // the seed additionally depends on the time and the thread
+    thread_local std::mt19937_64 generator = std::mt19937_64(
+        (static_cast<uint64_t>(std::random_device()()) << 32) ^
+        static_cast<uint64_t>(
+            std::chrono::high_resolution_clock::now().time_since_epoch().count()
+        ) ^
+        std::hash<std::thread::id>()(std::this_thread::get_id())
+    );
+
+    std::filesystem::path res = path;
+    res += std::format(".{:016x}.tmp", generator());
+    return res;
+}
+
+} // namespace sgct
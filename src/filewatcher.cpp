@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/filewatcher.h>
+
+#include <sgct/format.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <utility>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif // __linux__
+
+namespace {
+    // The time after which the background thread checks whether it should terminate or,
+    // without inotify, polls the modification times again
+    constexpr std::chrono::milliseconds PollInterval = std::chrono::milliseconds(100);
+} // namespace
+
+namespace sgct {
+
+FileWatcher::FileWatcher(std::vector<std::filesystem::path> files)
+    : _files(std::move(files))
+{
+    ZoneScoped;
+
+    for (const std::filesystem::path& file : _files) {
+        _absoluteFiles.push_back(std::filesystem::absolute(file).lexically_normal());
+    }
+
+#ifdef __linux__
+    _inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotify == -1) {
+        Log::Warning("Failed to initialize inotify. Polling files for changes instead");
+    }
+    for (const std::filesystem::path& file : _absoluteFiles) {
+        if (_inotify == -1) {
+            break;
+        }
+
+        // Watching the folders instead of the files also catches files that are replaced
+        // by renaming another file over them, which would remove a watch on the file
+        const std::filesystem::path folder = file.parent_path();
+        const int wd = inotify_add_watch(
+            _inotify,
+            folder.string().c_str(),
+            IN_CLOSE_WRITE | IN_MOVED_TO
+        );
+        if (wd == -1) {
+            Log::Warning(std::format("Failed to watch folder '{}'", folder));
+            continue;
+        }
+        _folders[wd] = folder;
+    }
+#endif // __linux__
+
+    if (_inotify == -1) {
+        for (const std::filesystem::path& file : _absoluteFiles) {
+            std::error_code ec;
+            _times.push_back(std::filesystem::last_write_time(file, ec));
+        }
+    }
+
+    _thread = std::thread(&FileWatcher::watch, this);
+}
+
+FileWatcher::~FileWatcher() {
+    _shouldTerminate = true;
+    _thread.join();
+#ifdef __linux__
+    if (_inotify != -1) {
+        close(_inotify);
+    }
+#endif // __linux__
+}
+
+std::vector<std::filesystem::path> FileWatcher::changedFiles() {
+    const std::unique_lock lock(_mutex);
+    return std::exchange(_changed, {});
+}
+
+void FileWatcher::addChange(const std::filesystem::path& path) {
+    for (size_t i = 0; i < _absoluteFiles.size(); i++) {
+        if (_absoluteFiles[i] != path) {
+            continue;
+        }
+
+        const std::unique_lock lock(_mutex);
+        if (std::find(_changed.begin(), _changed.end(), _files[i]) == _changed.end()) {
+            Log::Debug(std::format("File '{}' changed", _files[i]));
+            _changed.push_back(_files[i]);
+        }
+    }
+}
+
+void FileWatcher::watch() {
+#ifdef __linux__
+    if (_inotify != -1) {
+        alignas(inotify_event) std::array<char, 4096> buffer;
+        while (!_shouldTerminate) {
+            pollfd fd = { .fd = _inotify, .events = POLLIN, .revents = 0 };
+            if (poll(&fd, 1, static_cast<int>(PollInterval.count())) <= 0) {
+                continue;
+            }
+
+            const ssize_t length = read(_inotify, buffer.data(), buffer.size());
+            ssize_t i = 0;
+            while (i < length) {
+                const inotify_event* event =
+                    reinterpret_cast<const inotify_event*>(buffer.data() + i);
+                auto it = _folders.find(event->wd);
+                if (event->len > 0 && it != _folders.end()) {
+                    addChange(it->second / event->name);
+                }
+                i += sizeof(inotify_event) + event->len;
+            }
+        }
+        return;
+    }
+#endif // __linux__
+
+    // Fallback that compares the modification times of the files
+    while (!_shouldTerminate) {
+        std::this_thread::sleep_for(PollInterval);
+        for (size_t i = 0; i < _absoluteFiles.size(); i++) {
+            // Files that are missing while they are replaced are checked in the next poll
+            std::error_code ec;
+            const auto t = std::filesystem::last_write_time(_absoluteFiles[i], ec);
+            if (!ec && t != _times[i]) {
+                _times[i] = t;
+                addChange(_absoluteFiles[i]);
+            }
+        }
+    }
+}
+
+} // namespace sgct
@@ -12,11 +12,34 @@
 #include <sgct/error.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
 #include <png.h>
 #include <zlib.h>
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <string>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SGCT_IMAGE_SSE2
+#endif
+#if defined(__AVX2__) || defined(__SSSE3__)
+#define SGCT_IMAGE_SSE2
+#define SGCT_IMAGE_SSSE3
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define SGCT_IMAGE_NEON
+#endif
 
 #ifdef WIN32
 #include <CodeAnalysis/warnings.h>
@@ -38,7 +61,6 @@
 #pragma GCC diagnostic ignored "-Wzero-as-null-pointer-constant"
 #endif // __clang__
 
-#define STBI_NO_SIMD
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
@@ -82,6 +104,160 @@ namespace {
         }
         return sgct::Image::FormatType::Unknown;
     }
+
+    // The byte permutation that is applied to every pixel. perm[i] is the index of the
+    // byte in the source pixel that ends up in byte i of the destination pixel
+    struct PixelPermutation {
+        std::array<uint8_t, 8> perm = {};
+        int bytesPerPixel = 0;
+        bool isIdentity = true;
+    };
+
+    PixelPermutation createPermutation(int channels, int bpc,
+                                       sgct::Image::Conversion conversion)
+    {
+        PixelPermutation res;
+        res.bytesPerPixel = channels * bpc;
+        for (int c = 0; c < channels; c++) {
+            int srcChannel = c;
+            if (conversion.swapRedBlue && channels >= 3 && (c == 0 || c == 2)) {
+                srcChannel = 2 - c;
+            }
+            for (int b = 0; b < bpc; b++) {
+                const int srcByte = (conversion.swapBytes && bpc == 2) ? bpc - 1 - b : b;
+                res.perm[c * bpc + b] = static_cast<uint8_t>(srcChannel * bpc + srcByte);
+            }
+        }
+        for (int i = 0; i < res.bytesPerPixel; i++) {
+            res.isIdentity &= (res.perm[i] == i);
+        }
+        return res;
+    }
+
+    // Converts a row of 'nBytes' bytes. Returns the number of bytes that were handled,
+    // the remaining bytes have to be converted by the scalar version
+    size_t permuteRowSimd([[maybe_unused]] const uint8_t* src,
+                          [[maybe_unused]] uint8_t* dst,
+                          [[maybe_unused]] size_t nBytes,
+                          [[maybe_unused]] const PixelPermutation& p)
+    {
+        size_t i = 0;
+#if defined(SGCT_IMAGE_SSSE3) || defined(SGCT_IMAGE_NEON)
+        // Pack as many whole pixels into a 16 byte register as possible. The bytes
+        // after the last whole pixel are passed through unchanged and are overwritten
+        // with their converted values in the next iteration
+        const int pixelsPerChunk = 16 / p.bytesPerPixel;
+        const size_t chunk = static_cast<size_t>(pixelsPerChunk * p.bytesPerPixel);
+        alignas(16) std::array<uint8_t, 16> mask;
+        for (int j = 0; j < 16; j++) {
+            const int pixel = j / p.bytesPerPixel;
+            mask[j] = static_cast<uint8_t>(
+                pixel < pixelsPerChunk ?
+                pixel * p.bytesPerPixel + p.perm[j % p.bytesPerPixel] :
+                j
+            );
+        }
+#endif // SGCT_IMAGE_SSSE3 || SGCT_IMAGE_NEON
+
+#if defined(SGCT_IMAGE_SSSE3)
+        const __m128i m = _mm_load_si128(reinterpret_cast<const __m128i*>(mask.data()));
+#if defined(__AVX2__)
+        if (chunk == 16) {
+            // The AVX2 shuffle operates on two independent 128 bit lanes, so we can only
+            // use it directly if the pixels evenly divide the lanes
+            const __m256i m2 = _mm256_broadcastsi128_si256(m);
+            for (; i + 32 <= nBytes; i += 32) {
+                const __m256i v = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(src + i)
+                );
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(dst + i),
+                    _mm256_shuffle_epi8(v, m2)
+                );
+            }
+        }
+#endif // __AVX2__
+        for (; i + 16 <= nBytes; i += chunk) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_shuffle_epi8(v, m));
+        }
+#elif defined(SGCT_IMAGE_NEON)
+        const uint8x16_t m = vld1q_u8(mask.data());
+        for (; i + 16 <= nBytes; i += chunk) {
+            vst1q_u8(dst + i, vqtbl1q_u8(vld1q_u8(src + i), m));
+        }
+#elif defined(SGCT_IMAGE_SSE2)
+        // Without a byte shuffle instruction, we can only handle the cases that can be
+        // expressed as shifts and masks: red/blue swap for 8 bit RGBA and byte swap for
+        // 16 bit channels that don't change the channel order. The number of converted
+        // bytes has to be a multiple of the pixel size for the scalar remainder
+        constexpr std::array<uint8_t, 8> SwapRB4 = { 2, 1, 0, 3 };
+        constexpr std::array<uint8_t, 8> Swap16 = { 1, 0, 3, 2, 5, 4, 7, 6 };
+        const bool isSwapRB4 = p.bytesPerPixel == 4 &&
+            std::equal(p.perm.begin(), p.perm.begin() + 4, SwapRB4.begin());
+        const bool isSwap16 = (16 % p.bytesPerPixel) == 0 && p.bytesPerPixel >= 2 &&
+            std::equal(p.perm.begin(), p.perm.begin() + p.bytesPerPixel, Swap16.begin());
+
+        if (isSwapRB4) {
+            const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+            const __m128i low = _mm_set1_epi32(0x000000FF);
+            for (; i + 16 <= nBytes; i += 16) {
+                const __m128i v = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(src + i)
+                );
+                const __m128i r = _mm_or_si128(
+                    _mm_and_si128(v, keep),
+                    _mm_or_si128(
+                        _mm_and_si128(_mm_srli_epi32(v, 16), low),
+                        _mm_slli_epi32(_mm_and_si128(v, low), 16)
+                    )
+                );
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+            }
+        }
+        else if (isSwap16) {
+            for (; i + 16 <= nBytes; i += 16) {
+                const __m128i v = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(src + i)
+                );
+                const __m128i r = _mm_or_si128(
+                    _mm_slli_epi16(v, 8),
+                    _mm_srli_epi16(v, 8)
+                );
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), r);
+            }
+        }
+#endif
+        return i;
+    }
+
+    void permuteRowScalar(const uint8_t* src, uint8_t* dst, size_t nBytes,
+                          const PixelPermutation& p)
+    {
+        const size_t bpp = static_cast<size_t>(p.bytesPerPixel);
+        std::array<uint8_t, 8> pixel;
+        for (size_t i = 0; i + bpp <= nBytes; i += bpp) {
+            // Copy the source pixel first as 'src' and 'dst' might be the same buffer
+            std::memcpy(pixel.data(), src + i, bpp);
+            for (size_t j = 0; j < bpp; j++) {
+                dst[i + j] = pixel[p.perm[j]];
+            }
+        }
+    }
+
+    void convertRow(const uint8_t* src, uint8_t* dst, size_t nBytes,
+                    const PixelPermutation& p, bool useSimd)
+    {
+        if (p.isIdentity) {
+            if (src != dst) {
+                std::memcpy(dst, src, nBytes);
+            }
+            return;
+        }
+
+        const size_t done = useSimd ? permuteRowSimd(src, dst, nBytes, p) : 0;
+        permuteRowScalar(src + done, dst + done, nBytes - done, p);
+    }
 } // namespace
 
 namespace sgct {
@@ -97,23 +273,38 @@ void Image::load(const std::filesystem::path& filename) {
         throw Err(9000, "Cannot load empty filepath");
     }
 
-    stbi_set_flip_vertically_on_load(1);
-    std::string name = filename.string();
-    _data = stbi_load(name.c_str(), &_size.x, &_size.y, &_nChannels, 0);
-    if (_data == nullptr) {
+    const MappedFile file = MappedFile(filename);
+    if (!file.isOpen()) {
         throw Err(
             9001, std::format("Could not open file '{}' for loading image", filename)
         );
     }
+
+    // We leave stb's vertical flip disabled and flip the image ourselves as part of the
+    // channel swizzle to save one pass over the image data. As we never change stb's
+    // global flip state, it is also safe to load images on multiple threads at once
+    _data = stbi_load_from_memory(
+        reinterpret_cast<const stbi_uc*>(file.data()),
+        static_cast<int>(file.size()),
+        &_size.x,
+        &_size.y,
+        &_nChannels,
+        0
+    );
+    if (_data == nullptr) {
+        throw Err(
+            9013,
+            std::format("Could not decode file '{}': {}", filename, stbi_failure_reason())
+        );
+    }
     _bytesPerChannel = 1;
     _dataSize = _size.x * _size.y * _nChannels * _bytesPerChannel;
 
-    // Convert BGR to RGB
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
-        }
-    }
+    // Convert RGB to BGR and flip the image into OpenGL's bottom-to-top row order
+    Conversion conversion;
+    conversion.swapRedBlue = true;
+    conversion.flipVertically = true;
+    convertPixels(_data, _data, _size, _nChannels, _bytesPerChannel, conversion);
 }
 
 void Image::save(const std::filesystem::path& filename) {
@@ -132,16 +323,32 @@ void Image::save(const std::filesystem::path& filename) {
         return;
     }
 
-    if (_nChannels >= 3) {
-        for (size_t i = 0; i < _dataSize; i += _nChannels) {
-            std::swap(_data[i], _data[i + 2]);
-        }
-    }
+    // Swap BGR to RGB and flip the rows into a separate buffer so that the image data
+    // stays untouched and stb does not need to do an additional pass for the flip
+    std::vector<unsigned char> buffer(_dataSize);
+    Conversion conversion;
+    conversion.swapRedBlue = true;
+    conversion.flipVertically = true;
+    convertPixels(
+        _data,
+        buffer.data(),
+        _size,
+        _nChannels,
+        _bytesPerChannel,
+        conversion
+    );
 
-    stbi_flip_vertically_on_write(1);
+    stbi_flip_vertically_on_write(0);
     if (type == FormatType::JPEG) {
         std::string f = filename.string();
-        const int r = stbi_write_jpg(f.c_str(), _size.x, _size.y, _nChannels, _data, 100);
+        const int r = stbi_write_jpg(
+            f.c_str(),
+            _size.x,
+            _size.y,
+            _nChannels,
+            buffer.data(),
+            100
+        );
         if (r == 0) {
             throw Err(9004, std::format("Could not save file '{}' as JPG", filename));
         }
@@ -149,7 +356,13 @@ void Image::save(const std::filesystem::path& filename) {
     }
     if (type == FormatType::TGA) {
         std::string f = filename.string();
-        const int r = stbi_write_tga(f.c_str(), _size.x, _size.y, _nChannels, _data);
+        const int r = stbi_write_tga(
+            f.c_str(),
+            _size.x,
+            _size.y,
+            _nChannels,
+            buffer.data()
+        );
         if (r == 0) {
             throw Err(9005, std::format("Could not save file '{}' as TGA", filename));
 
@@ -171,6 +384,20 @@ void Image::savePNG(const std::filesystem::path& filename, int compressionLevel)
 
     const double t0 = time();
 
+    // 16 bit images are converted into the byte order and the channel order of the PNG in
+    // a single pass over a separate buffer instead of by libPNG one row at a time. The
+    // buffer is created before libPNG can jump out of this function
+    std::vector<unsigned char> buffer;
+    unsigned char* data = _data;
+    if (_bytesPerChannel == 2) {
+        buffer.resize(_dataSize);
+        Conversion conversion;
+        conversion.swapRedBlue = true;
+        conversion.swapBytes = true;
+        convertPixels(_data, buffer.data(), _size, _nChannels, 2, conversion);
+        data = buffer.data();
+    }
+
     std::string f = filename.string();
     FILE* fp = fopen(f.c_str(), "wb");
     if (fp == nullptr) {
@@ -232,20 +459,17 @@ void Image::savePNG(const std::filesystem::path& filename, int compressionLevel)
         PNG_FILTER_TYPE_BASE
     );
 
-    if (colorType == PNG_COLOR_TYPE_RGB || colorType == PNG_COLOR_TYPE_RGB_ALPHA) {
+    const bool isRGB =
+        colorType == PNG_COLOR_TYPE_RGB || colorType == PNG_COLOR_TYPE_RGB_ALPHA;
+    if (isRGB && _bytesPerChannel == 1) {
         png_set_bgr(png_ptr);
     }
     png_write_info(png_ptr, info_ptr);
 
-    // swap big-endian to little endian
-    if (_bytesPerChannel == 2) {
-        png_set_swap(png_ptr);
-    }
-
     std::vector<png_bytep> rowPtrs(_size.y);
     for (int y = 0; y < _size.y; y++) {
         const size_t idx = static_cast<size_t>(_size.y) - 1 - static_cast<size_t>(y);
-        rowPtrs[idx] = &_data[y * _size.x * _nChannels * _bytesPerChannel];
+        rowPtrs[idx] = &data[y * _size.x * _nChannels * _bytesPerChannel];
     }
     png_write_image(png_ptr, rowPtrs.data());
     rowPtrs.clear();
@@ -290,6 +514,55 @@ void Image::setBytesPerChannel(int bpc) {
     _bytesPerChannel = bpc;
 }
 
+void Image::convertPixels(const unsigned char* src, unsigned char* dst, ivec2 size,
+                          int channels, int bytesPerChannel, Conversion conversion,
+                          bool useSimd)
+{
+    if (channels < 1 || channels > 4) {
+        throw std::logic_error("Number of channels must be between 1 and 4");
+    }
+    if (bytesPerChannel != 1 && bytesPerChannel != 2) {
+        throw std::logic_error("Only 8 and 16 bit channels are supported");
+    }
+
+    const PixelPermutation p = createPermutation(channels, bytesPerChannel, conversion);
+    const size_t stride = static_cast<size_t>(size.x) * p.bytesPerPixel;
+    const size_t height = static_cast<size_t>(size.y);
+
+    if (!conversion.flipVertically) {
+        if (src == dst && p.isIdentity) {
+            return;
+        }
+        for (size_t y = 0; y < height; y++) {
+            convertRow(src + y * stride, dst + y * stride, stride, p, useSimd);
+        }
+        return;
+    }
+
+    if (src != dst) {
+        for (size_t y = 0; y < height; y++) {
+            const size_t dstY = height - 1 - y;
+            convertRow(src + y * stride, dst + dstY * stride, stride, p, useSimd);
+        }
+        return;
+    }
+
+    // In-place flip: convert the top row into a temporary buffer, convert the bottom row
+    // into the top row, and then move the temporary row into the bottom row
+    std::vector<unsigned char> tmp(stride);
+    for (size_t y = 0; y < height / 2; y++) {
+        unsigned char* top = dst + y * stride;
+        unsigned char* bottom = dst + (height - 1 - y) * stride;
+        convertRow(top, tmp.data(), stride, p, useSimd);
+        convertRow(bottom, top, stride, p, useSimd);
+        std::memcpy(bottom, tmp.data(), stride);
+    }
+    if (height % 2 == 1) {
+        unsigned char* middle = dst + (height / 2) * stride;
+        convertRow(middle, middle, stride, p, useSimd);
+    }
+}
+
 void Image::allocateOrResizeData() {
     const double t0 = time();
 
@@ -303,13 +576,15 @@ void Image::allocateOrResizeData() {
 
     if (_data && _dataSize != dataSize) {
         // re-allocate if needed
-        delete[] _data;
+        stbi_image_free(_data);
         _data = nullptr;
         _dataSize = 0;
     }
 
     if (!_data) {
-        _data = new unsigned char[dataSize];
+        // The data has to be allocated with malloc as it might also come from stb, which
+        // means that the destructor releases it through stbi_image_free
+        _data = static_cast<unsigned char*>(std::malloc(dataSize));
         _dataSize = dataSize;
 
         Log::Debug(std::format(
@@ -0,0 +1,157 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/mappedfile.h>
+
+#ifdef WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define VC_EXTRALEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <utility>
+
+namespace sgct {
+
+MappedFile::MappedFile(const std::filesystem::path& path) {
+#ifdef WIN32
+    HANDLE file = CreateFileW(
+        path.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        nullptr
+    );
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    _fileHandle = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        close();
+        return;
+    }
+    _size = static_cast<size_t>(size.QuadPart);
+    if (_size == 0) {
+        _isOpen = true;
+        return;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        close();
+        return;
+    }
+    _mappingHandle = mapping;
+
+    void* ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (ptr == nullptr) {
+        close();
+        return;
+    }
+    _data = reinterpret_cast<const std::byte*>(ptr);
+    _isOpen = true;
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        ::close(fd);
+        return;
+    }
+    _size = static_cast<size_t>(st.st_size);
+    if (_size == 0) {
+        ::close(fd);
+        _isOpen = true;
+        return;
+    }
+
+    void* ptr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file, so the descriptor can be closed
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+        _size = 0;
+        return;
+    }
+    // All of our users read the file front to back
+    madvise(ptr, _size, MADV_SEQUENTIAL);
+    _data = reinterpret_cast<const std::byte*>(ptr);
+    _isOpen = true;
+#endif // WIN32
+}
+
+MappedFile::MappedFile(MappedFile&& rhs) noexcept {
+    *this = std::move(rhs);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& rhs) noexcept {
+    if (this != &rhs) {
+        close();
+        _isOpen = std::exchange(rhs._isOpen, false);
+        _data = std::exchange(rhs._data, nullptr);
+        _size = std::exchange(rhs._size, 0);
+#ifdef WIN32
+        _fileHandle = std::exchange(rhs._fileHandle, nullptr);
+        _mappingHandle = std::exchange(rhs._mappingHandle, nullptr);
+#endif // WIN32
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+#ifdef WIN32
+    if (_data) {
+        UnmapViewOfFile(_data);
+    }
+    if (_mappingHandle) {
+        CloseHandle(_mappingHandle);
+    }
+    if (_fileHandle) {
+        CloseHandle(_fileHandle);
+    }
+    _mappingHandle = nullptr;
+    _fileHandle = nullptr;
+#else // ^^^^ WIN32 // !WIN32 vvvv
+    if (_data) {
+        munmap(const_cast<std::byte*>(_data), _size);
+    }
+#endif // WIN32
+    _data = nullptr;
+    _size = 0;
+    _isOpen = false;
+}
+
+bool MappedFile::isOpen() const {
+    return _isOpen;
+}
+
+const std::byte* MappedFile::data() const {
+    return _data;
+}
+
+size_t MappedFile::size() const {
+    return _size;
+}
+
+} // namespace sgct
@@ -45,6 +45,7 @@ namespace {
 namespace sgct {
 
 OffScreenBuffer::~OffScreenBuffer() {
+    deleteTargets();
     glDeleteFramebuffers(1, &_frameBuffer);
     glDeleteRenderbuffers(1, &_depthBuffer);
     glDeleteFramebuffers(1, &_multiSampledFrameBuffer);
@@ -203,6 +204,9 @@ void OffScreenBuffer::resizeFBO(int width, int height, int samples) {
     _size = ivec2{ width, height };
     _isMultiSampled = samples > 1;
 
+    // The framebuffers of the targets refer to the depth buffer and textures of the old
+    // size, so they are recreated when they are bound the next time
+    deleteTargets();
     glDeleteFramebuffers(1, &_frameBuffer);
     glDeleteRenderbuffers(1, &_depthBuffer);
     glDeleteFramebuffers(1, &_multiSampledFrameBuffer);
@@ -250,6 +254,91 @@ void OffScreenBuffer::bindBlit() const {
     setDrawBuffers();
 }
 
+unsigned int OffScreenBuffer::targetFramebuffer(const Target& target) {
+    auto it = std::find_if(
+        _targets.begin(),
+        _targets.end(),
+        [&target](const TargetFramebuffer& t) { return t.target == target; }
+    );
+    if (it == _targets.end()) {
+        TargetFramebuffer t;
+        t.target = target;
+        glGenFramebuffers(1, &t.frameBuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, t.frameBuffer);
+        glFramebufferTexture2D(
+            GL_FRAMEBUFFER,
+            GL_COLOR_ATTACHMENT0,
+            GL_TEXTURE_2D,
+            target.color,
+            0
+        );
+        if (target.depth != 0) {
+            glFramebufferTexture2D(
+                GL_FRAMEBUFFER,
+                GL_DEPTH_ATTACHMENT,
+                GL_TEXTURE_2D,
+                target.depth,
+                0
+            );
+        }
+        else if (!_isMultiSampled) {
+            // A multisampled buffer is rendered with its own depth buffer
+            glFramebufferRenderbuffer(
+                GL_FRAMEBUFFER,
+                GL_DEPTH_ATTACHMENT,
+                GL_RENDERBUFFER,
+                _depthBuffer
+            );
+        }
+        if (target.normals != 0) {
+            glFramebufferTexture2D(
+                GL_FRAMEBUFFER,
+                GL_COLOR_ATTACHMENT1,
+                GL_TEXTURE_2D,
+                target.normals,
+                0
+            );
+        }
+        if (target.positions != 0) {
+            glFramebufferTexture2D(
+                GL_FRAMEBUFFER,
+                GL_COLOR_ATTACHMENT2,
+                GL_TEXTURE_2D,
+                target.positions,
+                0
+            );
+        }
+        Log::Debug(std::format(
+            "Created FBO id={} for color texture id={}", t.frameBuffer, target.color
+        ));
+        _targets.push_back(t);
+        it = _targets.end() - 1;
+    }
+    return it->frameBuffer;
+}
+
+void OffScreenBuffer::bindTarget(const Target& target) {
+    const unsigned int frameBuffer = targetFramebuffer(target);
+
+    if (_isMultiSampled) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, _multiSampledFrameBuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, frameBuffer);
+    }
+    else {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
+    }
+    setDrawBuffers();
+}
+
+void OffScreenBuffer::deleteTargets() {
+    for (const TargetFramebuffer& t : _targets) {
+        glDeleteFramebuffers(1, &t.frameBuffer);
+    }
+    _targets.clear();
+}
+
 void OffScreenBuffer::unbind() {
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
 }
@@ -306,6 +395,35 @@ void OffScreenBuffer::blit() const {
     }
 }
 
+void OffScreenBuffer::blitToCubeMapFace(unsigned int texId, unsigned int face,
+                                        ivec4 source, ivec4 destination) const
+{
+    // The face is attached temporarily next to the source texture
+    glFramebufferTexture2D(
+        GL_FRAMEBUFFER,
+        GL_COLOR_ATTACHMENT1,
+        GL_TEXTURE_CUBE_MAP_POSITIVE_X + face,
+        texId,
+        0
+    );
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glDrawBuffer(GL_COLOR_ATTACHMENT1);
+    glBlitFramebuffer(
+        source.x, source.y, source.x + source.z, source.y + source.w,
+        destination.x, destination.y,
+        destination.x + destination.z, destination.y + destination.w,
+        GL_COLOR_BUFFER_BIT, GL_LINEAR
+    );
+    glFramebufferTexture2D(
+        GL_FRAMEBUFFER,
+        GL_COLOR_ATTACHMENT1,
+        GL_TEXTURE_CUBE_MAP_POSITIVE_X + face,
+        0,
+        0
+    );
+    setDrawBuffers();
+}
+
 bool OffScreenBuffer::isMultiSampled() const {
     return _isMultiSampled;
 }
@@ -340,4 +458,8 @@ void OffScreenBuffer::attachCubeMapDepthTexture(unsigned int texId, unsigned int
     );
 }
 
+void OffScreenBuffer::attachLayeredTexture(unsigned int texId, GLenum attachment) {
+    glFramebufferTexture(GL_FRAMEBUFFER, attachment, texId, 0);
+}
+
 } // namespace sgct
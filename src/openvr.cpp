@@ -189,7 +189,10 @@ void copyWindowToHMD(Window* win) {
     const int renderHeight = dim.y;
 
     // HMD Left Eye
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, win->fbo()->getBufferID());
+    // The eye texture is only attached to the framebuffer of its rendering target
+    OffScreenBuffer::Target source;
+    source.color = win->frameBufferTexture(Window::TextureIndex::LeftEye);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, win->fbo()->targetFramebuffer(source));
     glBindFramebuffer(GL_DRAW_FRAMEBUFFER, leftEyeFBODesc.fboID);
 
     glBlitFramebuffer(
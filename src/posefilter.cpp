@@ -0,0 +1,179 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/posefilter.h>
+
+#include <sgct/profiling.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+    constexpr float DefaultSmoothing = 0.5f;
+
+    // Rotations smaller than this are treated as no rotation at all to avoid dividing by
+    // the sine of a vanishing angle
+    constexpr float MinAngle = 1e-6f;
+
+    glm::vec3 toGlm(const sgct::vec3& v) {
+        return glm::make_vec3(&v.x);
+    }
+
+    glm::quat toGlm(const sgct::quat& q) {
+        return glm::make_quat(&q.x);
+    }
+
+    sgct::vec3 fromGlm(const glm::vec3& v) {
+        return sgct::vec3(v.x, v.y, v.z);
+    }
+
+    sgct::quat fromGlm(const glm::quat& q) {
+        return sgct::quat(q.x, q.y, q.z, q.w);
+    }
+
+    // Converts the rotation into its axis scaled by its angle in radians, taking the
+    // shorter of the two ways around
+    glm::vec3 rotationVector(glm::quat q) {
+        if (q.w < 0.f) {
+            q = -q;
+        }
+        const float angle = 2.f * std::acos(std::clamp(q.w, -1.f, 1.f));
+        if (angle < MinAngle) {
+            return glm::vec3(0.f);
+        }
+        const glm::vec3 axis = glm::vec3(q.x, q.y, q.z) / std::sin(angle / 2.f);
+        return axis * angle;
+    }
+
+    // The inverse of rotationVector
+    glm::quat fromRotationVector(const glm::vec3& v) {
+        const float angle = std::sqrt(glm::dot(v, v));
+        if (angle < MinAngle) {
+            return glm::quat(1.f, 0.f, 0.f, 0.f);
+        }
+        const glm::vec3 axis = v / angle * std::sin(angle / 2.f);
+        return glm::quat(std::cos(angle / 2.f), axis.x, axis.y, axis.z);
+    }
+
+    // Interpolates between the rotations \p a and \p b like slerp, but also extrapolates
+    // beyond \p b for factors larger than 1
+    glm::quat extrapolate(const glm::quat& a, const glm::quat& b, float f) {
+        const glm::vec3 delta = rotationVector(glm::conjugate(a) * b);
+        return glm::normalize(a * fromRotationVector(delta * f));
+    }
+} // namespace
+
+namespace sgct {
+
+PoseFilter::PoseFilter(const config::Tracker::Prediction& prediction)
+    : _method(prediction.method)
+    , _smoothing(prediction.smoothing.value_or(DefaultSmoothing))
+{}
+
+void PoseFilter::addSample(double time, const Pose& pose) {
+    ZoneScoped;
+
+    if (_nSamples == 0) {
+        _time = time;
+        _latest = pose;
+        _smoothed = pose;
+        _smoothedTwice = pose;
+        _nSamples = 1;
+        return;
+    }
+
+    const double dt = time - _time;
+    if (dt <= 0.0) {
+        return;
+    }
+
+    // The first difference initializes the smoothed values as there is nothing to smooth
+    const float a = _nSamples == 1 ? 1.f : _smoothing;
+
+    const glm::vec3 prevPos = toGlm(_latest.position);
+    const glm::quat prevRot = toGlm(_latest.rotation);
+    const glm::vec3 pos = toGlm(pose.position);
+    const glm::quat rot = toGlm(pose.rotation);
+
+    // Constant velocity: the angular velocity is expressed in the frame of the device so
+    // that it can be applied on the right of the latest rotation
+    const float t = static_cast<float>(dt);
+    const glm::vec3 velocity = (pos - prevPos) / t;
+    const glm::vec3 angularVelocity = rotationVector(glm::conjugate(prevRot) * rot) / t;
+    _velocity = fromGlm(glm::mix(toGlm(_velocity), velocity, a));
+    _angularVelocity = fromGlm(glm::mix(toGlm(_angularVelocity), angularVelocity, a));
+
+    // Double exponential smoothing
+    const glm::vec3 s = glm::mix(toGlm(_smoothed.position), pos, _smoothing);
+    const glm::vec3 s2 = glm::mix(toGlm(_smoothedTwice.position), s, _smoothing);
+    const glm::quat r = glm::slerp(toGlm(_smoothed.rotation), rot, _smoothing);
+    const glm::quat r2 = glm::slerp(toGlm(_smoothedTwice.rotation), r, _smoothing);
+    _smoothed = { fromGlm(s), fromGlm(r) };
+    _smoothedTwice = { fromGlm(s2), fromGlm(r2) };
+    _interval = _nSamples == 1 ? dt : _interval + _smoothing * (dt - _interval);
+
+    _time = time;
+    _latest = pose;
+    _nSamples++;
+}
+
+std::optional<PoseFilter::Pose> PoseFilter::predict(double time) const {
+    ZoneScoped;
+
+    if (_nSamples == 0) {
+        return std::nullopt;
+    }
+    if (_nSamples == 1) {
+        return _latest;
+    }
+
+    const float dt = static_cast<float>(time - _time);
+    switch (_method) {
+        case config::Tracker::Prediction::Method::ConstantVelocity:
+        {
+            const glm::vec3 p = toGlm(_latest.position) + toGlm(_velocity) * dt;
+            const glm::quat q = glm::normalize(
+                toGlm(_latest.rotation) *
+                fromRotationVector(toGlm(_angularVelocity) * dt)
+            );
+            return Pose{ fromGlm(p), fromGlm(q) };
+        }
+        case config::Tracker::Prediction::Method::DoubleExponential:
+        {
+            // Without smoothing, the smoothed values are the latest sample and carry no
+            // information about the trend
+            if (_smoothing >= 1.f) {
+                return _latest;
+            }
+
+            // The prediction is expressed in the number of samples ahead of the latest
+            const float tau = static_cast<float>((time - _time) / _interval);
+            const float k = _smoothing * tau / (1.f - _smoothing);
+
+            const glm::vec3 s = toGlm(_smoothed.position);
+            const glm::vec3 s2 = toGlm(_smoothedTwice.position);
+            const glm::vec3 p = (2.f + k) * s - (1.f + k) * s2;
+            const glm::quat q = extrapolate(
+                toGlm(_smoothedTwice.rotation),
+                toGlm(_smoothed.rotation),
+                2.f + k
+            );
+            return Pose{ fromGlm(p), fromGlm(q) };
+        }
+        default: throw std::logic_error("Unhandled case label");
+    }
+}
+
+std::optional<double> PoseFilter::latestTime() const {
+    return _nSamples > 0 ? std::optional<double>(_time) : std::nullopt;
+}
+
+} // namespace sgct
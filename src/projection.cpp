@@ -9,81 +9,203 @@
 #include <sgct/projection.h>
 
 #include <sgct/projection/projectionplane.h>
-#ifdef WIN32
-#pragma warning(push)
-#pragma warning(disable : 4127)
-#endif // WIN32
-#include <glm/gtc/type_ptr.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-
-#ifdef WIN32
-#pragma warning(pop)
-#endif // WIN32
-
-#include <cstring>
+#include <sgct/profiling.h>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace {
+    // The number of projections that are calculated together. A cube map has at most six
+    // faces, so all faces of a non-linear projection fit into one batch
+    constexpr size_t BatchSize = 8;
+
+    // The values of up to BatchSize planes with one array per value
+    struct Batch {
+        // The rotation of the plane as column-major 3x3 matrix
+        std::array<std::array<float, BatchSize>, 9> rotation;
+        std::array<float, BatchSize> lowerLeftX;
+        std::array<float, BatchSize> lowerLeftY;
+        std::array<float, BatchSize> lowerLeftZ;
+        std::array<float, BatchSize> upperRightX;
+        std::array<float, BatchSize> upperRightY;
+
+        // Results
+        std::array<float, BatchSize> left;
+        std::array<float, BatchSize> right;
+        std::array<float, BatchSize> bottom;
+        std::array<float, BatchSize> top;
+        std::array<std::array<float, BatchSize>, 16> view;
+        std::array<std::array<float, BatchSize>, 16> projection;
+        std::array<std::array<float, BatchSize>, 16> viewProjection;
+    };
+
+    bool operator==(const sgct::vec3& a, const sgct::vec3& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    // Calculates the same matrices as the combination of the inverted DCM of the plane,
+    // glm::translate, and glm::frustum, but for all planes of the batch at once. Each
+    // loop only works on arrays indexed by the plane, which the compiler can vectorize
+    void calculate(Batch& b, size_t n, sgct::vec3 base, sgct::vec3 offset,
+                   float nearClip, float farClip)
+    {
+        const auto& r = b.rotation;
+        const sgct::vec3 p = sgct::vec3{
+            base.x + offset.x,
+            base.y + offset.y,
+            base.z + offset.z
+        };
+
+        // The parts of the projection matrix that are the same for all planes
+        const float p22 = -(farClip + nearClip) / (farClip - nearClip);
+        const float p32 = -(2.f * farClip * nearClip) / (farClip - nearClip);
+
+        for (size_t i = 0; i < n; i++) {
+            // eye position in the coordinate system of the plane
+            const float eyeX = r[0][i] * base.x + r[3][i] * base.y + r[6][i] * base.z;
+            const float eyeY = r[1][i] * base.x + r[4][i] * base.y + r[7][i] * base.z;
+            const float eyeZ = r[2][i] * base.x + r[5][i] * base.y + r[8][i] * base.z;
+
+            // nearFactor = near clipping plane / focus plane dist
+            const float nearF = std::fabs(nearClip / (b.lowerLeftZ[i] - eyeZ));
+            const float left = (b.lowerLeftX[i] - eyeX) * nearF;
+            const float right = (b.upperRightX[i] - eyeX) * nearF;
+            const float bottom = (b.lowerLeftY[i] - eyeY) * nearF;
+            const float top = (b.upperRightY[i] - eyeY) * nearF;
+            b.left[i] = left;
+            b.right[i] = right;
+            b.bottom[i] = bottom;
+            b.top[i] = top;
+
+            // view = rotation * translate(-p)
+            for (int j = 0; j < 3; j++) {
+                b.view[0 * 4 + j][i] = r[0 * 3 + j][i];
+                b.view[1 * 4 + j][i] = r[1 * 3 + j][i];
+                b.view[2 * 4 + j][i] = r[2 * 3 + j][i];
+                b.view[3 * 4 + j][i] = -(
+                    r[0 * 3 + j][i] * p.x + r[1 * 3 + j][i] * p.y + r[2 * 3 + j][i] * p.z
+                );
+            }
+            b.view[3][i] = 0.f;
+            b.view[7][i] = 0.f;
+            b.view[11][i] = 0.f;
+            b.view[15][i] = 1.f;
+
+            // projection = glm::frustum(left, right, bottom, top, near, far)
+            const float p00 = (2.f * nearClip) / (right - left);
+            const float p11 = (2.f * nearClip) / (top - bottom);
+            const float p20 = (right + left) / (right - left);
+            const float p21 = (top + bottom) / (top - bottom);
+            for (int j = 0; j < 16; j++) {
+                b.projection[j][i] = 0.f;
+            }
+            b.projection[0][i] = p00;
+            b.projection[5][i] = p11;
+            b.projection[8][i] = p20;
+            b.projection[9][i] = p21;
+            b.projection[10][i] = p22;
+            b.projection[11][i] = -1.f;
+            b.projection[14][i] = p32;
+
+            // viewProjection = projection * view, using that most of the projection is 0
+            for (int c = 0; c < 4; c++) {
+                const float v0 = b.view[c * 4 + 0][i];
+                const float v1 = b.view[c * 4 + 1][i];
+                const float v2 = b.view[c * 4 + 2][i];
+                const float v3 = b.view[c * 4 + 3][i];
+                b.viewProjection[c * 4 + 0][i] = p00 * v0 + p20 * v2;
+                b.viewProjection[c * 4 + 1][i] = p11 * v1 + p21 * v2;
+                b.viewProjection[c * 4 + 2][i] = p22 * v2 + p32 * v3;
+                b.viewProjection[c * 4 + 3][i] = -v2;
+            }
+        }
+    }
+} // namespace
 
 namespace sgct {
 
 void Projection::calculateProjection(vec3 base, const ProjectionPlane& proj,
                                      float nearClip, float farClip, vec3 offset)
 {
-    const glm::vec3 b = glm::make_vec3(&base.x);
-    const glm::vec3 o = glm::make_vec3(&offset.x);
-
-    const glm::vec3 lowerLeft = glm::make_vec3(&proj.coordinateLowerLeft().x);
-    const glm::vec3 upperLeft = glm::make_vec3(&proj.coordinateUpperLeft().x);
-    const glm::vec3 upperRight = glm::make_vec3(&proj.coordinateUpperRight().x);
-
-    // calculate viewplane's internal coordinate system bases
-    const glm::vec3 planeX = glm::normalize(upperRight - upperLeft);
-    const glm::vec3 planeY = glm::normalize(upperLeft - lowerLeft);
-    const glm::vec3 planeZ = glm::normalize(glm::cross(planeX, planeY));
-
-    // calculate plane rotation using Direction Cosine Matrix (DCM)
-    glm::mat3 dcm;
-    dcm[0][0] = glm::dot(planeX, glm::vec3(1.f, 0.f, 0.f));
-    dcm[0][1] = glm::dot(planeX, glm::vec3(0.f, 1.f, 0.f));
-    dcm[0][2] = glm::dot(planeX, glm::vec3(0.f, 0.f, 1.f));
-
-    dcm[1][0] = glm::dot(planeY, glm::vec3(1.f, 0.f, 0.f));
-    dcm[1][1] = glm::dot(planeY, glm::vec3(0.f, 1.f, 0.f));
-    dcm[1][2] = glm::dot(planeY, glm::vec3(0.f, 0.f, 1.f));
-
-    dcm[2][0] = glm::dot(planeZ, glm::vec3(1.f, 0.f, 0.f));
-    dcm[2][1] = glm::dot(planeZ, glm::vec3(0.f, 1.f, 0.f));
-    dcm[2][2] = glm::dot(planeZ, glm::vec3(0.f, 0.f, 1.f));
-
-    // invert & transform
-    const glm::mat3 invDcm = glm::inverse(dcm);
-    const glm::vec3 viewPlaneLowerLeft = invDcm * lowerLeft;
-    const glm::vec3 viewPlaneUpperRight = invDcm * upperRight;
-    const glm::vec3 eyePos = invDcm * b;
-
-    // nearFactor = near clipping plane / focus plane dist
-    const float nearF = std::fabs(nearClip / (viewPlaneLowerLeft.z - eyePos.z));
-
-    _frustum.left = (viewPlaneLowerLeft.x - eyePos.x) * nearF;
-    _frustum.right = (viewPlaneUpperRight.x - eyePos.x) * nearF;
-    _frustum.bottom = (viewPlaneLowerLeft.y - eyePos.y) * nearF;
-    _frustum.top = (viewPlaneUpperRight.y - eyePos.y) * nearF;
-    _frustum.nearPlane = nearClip;
-    _frustum.farPlane = farClip;
-
-    glm::mat4 complete = glm::mat4(invDcm) * glm::translate(glm::mat4(1.f), -(b + o));
-    std::memcpy(&_viewMatrix, glm::value_ptr(complete), sizeof(sgct::mat4));
-
-    // calc frustum matrix
-    glm::mat4 frustum = glm::frustum(
-        _frustum.left,
-        _frustum.right,
-        _frustum.bottom,
-        _frustum.top,
-        _frustum.nearPlane,
-        _frustum.farPlane
+    Projection* projection = this;
+    const ProjectionPlane* plane = &proj;
+    calculateProjections(
+        std::span(&projection, 1),
+        std::span(&plane, 1),
+        base,
+        nearClip,
+        farClip,
+        offset
     );
-    std::memcpy(&_projectionMatrix, glm::value_ptr(frustum), sizeof(sgct::mat4));
+}
 
-    _viewProjectionMatrix = _projectionMatrix * _viewMatrix;
+void Projection::calculateProjections(std::span<Projection* const> projections,
+                                      std::span<const ProjectionPlane* const> planes,
+                                      vec3 base, float nearClip, float farClip,
+                                      vec3 offset)
+{
+    ZoneScoped;
+
+    assert(projections.size() == planes.size());
+
+    Batch batch;
+    std::array<Projection*, BatchSize> batchProjections;
+    size_t n = 0;
+
+    auto flush = [&]() {
+        calculate(batch, n, base, offset, nearClip, farClip);
+        for (size_t i = 0; i < n; i++) {
+            Projection& p = *batchProjections[i];
+            p._frustum.left = batch.left[i];
+            p._frustum.right = batch.right[i];
+            p._frustum.bottom = batch.bottom[i];
+            p._frustum.top = batch.top[i];
+            p._frustum.nearPlane = nearClip;
+            p._frustum.farPlane = farClip;
+            for (int j = 0; j < 16; j++) {
+                p._viewMatrix.values[j] = batch.view[j][i];
+                p._projectionMatrix.values[j] = batch.projection[j][i];
+                p._viewProjectionMatrix.values[j] = batch.viewProjection[j][i];
+            }
+        }
+        n = 0;
+    };
+
+    for (size_t i = 0; i < projections.size(); i++) {
+        Projection& p = *projections[i];
+        const ProjectionPlane& plane = *planes[i];
+
+        // Nothing has to be done if neither the eye nor the plane have moved
+        const Inputs& in = p._inputs;
+        if (in.plane == &plane && in.planeVersion == plane.version() &&
+            in.base == base && in.offset == offset &&
+            in.nearClip == nearClip && in.farClip == farClip)
+        {
+            continue;
+        }
+        p._inputs = { &plane, plane.version(), base, offset, nearClip, farClip };
+
+        const float* rotation = plane.rotation().values;
+        for (int j = 0; j < 3; j++) {
+            batch.rotation[0 * 3 + j][n] = rotation[0 * 4 + j];
+            batch.rotation[1 * 3 + j][n] = rotation[1 * 4 + j];
+            batch.rotation[2 * 3 + j][n] = rotation[2 * 4 + j];
+        }
+        batch.lowerLeftX[n] = plane.rotatedLowerLeft().x;
+        batch.lowerLeftY[n] = plane.rotatedLowerLeft().y;
+        batch.lowerLeftZ[n] = plane.rotatedLowerLeft().z;
+        batch.upperRightX[n] = plane.rotatedUpperRight().x;
+        batch.upperRightY[n] = plane.rotatedUpperRight().y;
+        batchProjections[n] = &p;
+        n++;
+
+        if (n == BatchSize) {
+            flush();
+        }
+    }
+    if (n > 0) {
+        flush();
+    }
 }
 
 const mat4& Projection::viewProjectionMatrix() const {
@@ -0,0 +1,249 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/projection/cubemapcoverage.h>
+
+#include <sgct/profiling.h>
+#include <sgct/correction/bake.h>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace sgct {
+
+CubemapCoordinate cubemapCoordinate(vec3 direction) {
+    const float ax = std::abs(direction.x);
+    const float ay = std::abs(direction.y);
+    const float az = std::abs(direction.z);
+
+    // Table 8.19 of the OpenGL 4.6 specification
+    int face = 0;
+    float sc = 0.f;
+    float tc = 0.f;
+    float ma = 0.f;
+    if (ax >= ay && ax >= az) {
+        face = direction.x >= 0.f ? 0 : 1;
+        sc = direction.x >= 0.f ? -direction.z : direction.z;
+        tc = -direction.y;
+        ma = ax;
+    }
+    else if (ay >= az) {
+        face = direction.y >= 0.f ? 2 : 3;
+        sc = direction.x;
+        tc = direction.y >= 0.f ? direction.z : -direction.z;
+        ma = ay;
+    }
+    else {
+        face = direction.z >= 0.f ? 4 : 5;
+        sc = direction.z >= 0.f ? direction.x : -direction.x;
+        tc = -direction.y;
+        ma = az;
+    }
+
+    if (ma == 0.f) {
+        return CubemapCoordinate{ 0, vec2{ 0.5f, 0.5f } };
+    }
+    return CubemapCoordinate{
+        face,
+        vec2{ (sc / ma + 1.f) / 2.f, (tc / ma + 1.f) / 2.f }
+    };
+}
+
+CubemapCoverage cubemapCoverage(std::span<const vec3> directions, ivec2 resolution,
+                                float spacing)
+{
+    ZoneScoped;
+
+    // An angle covers resolution/2 pixels per radian in the center of a face and about
+    // twice as many towards the edges and corners, which is rounded up generously
+    const int maxRes = std::max(resolution.x, resolution.y);
+    const int margin = static_cast<int>(std::ceil(spacing * 1.5f * maxRes)) + 2;
+
+    std::array<vec2, 6> min;
+    std::array<vec2, 6> max;
+    std::array<bool, 6> isCovered = { false, false, false, false, false, false };
+    for (const vec3& dir : directions) {
+        const CubemapCoordinate c = cubemapCoordinate(dir);
+        if (!isCovered[c.face]) {
+            isCovered[c.face] = true;
+            min[c.face] = c.uv;
+            max[c.face] = c.uv;
+            continue;
+        }
+        min[c.face].x = std::min(min[c.face].x, c.uv.x);
+        min[c.face].y = std::min(min[c.face].y, c.uv.y);
+        max[c.face].x = std::max(max[c.face].x, c.uv.x);
+        max[c.face].y = std::max(max[c.face].y, c.uv.y);
+    }
+
+    CubemapCoverage res;
+    for (size_t i = 0; i < res.faces.size(); i++) {
+        if (!isCovered[i]) {
+            continue;
+        }
+        const int x0 = std::max(
+            static_cast<int>(std::floor(min[i].x * resolution.x)) - margin,
+            0
+        );
+        const int y0 = std::max(
+            static_cast<int>(std::floor(min[i].y * resolution.y)) - margin,
+            0
+        );
+        const int x1 = std::min(
+            static_cast<int>(std::ceil(max[i].x * resolution.x)) + margin,
+            resolution.x
+        );
+        const int y1 = std::min(
+            static_cast<int>(std::ceil(max[i].y * resolution.y)) + margin,
+            resolution.y
+        );
+        res.faces[i].isCovered = true;
+        res.faces[i].rect = ivec4{ x0, y0, x1 - x0, y1 - y0 };
+    }
+    return res;
+}
+
+std::array<int, 6> cubemapFaceResolutions(std::span<const vec3> directions,
+                                          float pixelsPerDirection)
+{
+    ZoneScoped;
+
+    constexpr int NBins = 32;
+    // The percentile of the bins of a face whose number of samples decides its resolution
+    constexpr size_t Percentile = 90;
+    std::vector<int> bins = std::vector<int>(6 * NBins * NBins, 0);
+    for (const vec3& dir : directions) {
+        const CubemapCoordinate c = cubemapCoordinate(dir);
+        const int x = std::clamp(static_cast<int>(c.uv.x * NBins), 0, NBins - 1);
+        const int y = std::clamp(static_cast<int>(c.uv.y * NBins), 0, NBins - 1);
+        bins[(c.face * NBins + y) * NBins + x]++;
+    }
+
+    std::array<int, 6> res = { 0, 0, 0, 0, 0, 0 };
+    std::vector<int> counts;
+    for (int face = 0; face < 6; face++) {
+        const auto begin = bins.begin() + face * NBins * NBins;
+        counts.clear();
+        std::copy_if(
+            begin,
+            begin + NBins * NBins,
+            std::back_inserter(counts),
+            [](int count) { return count > 0; }
+        );
+        if (counts.empty()) {
+            continue;
+        }
+
+        // The bins with the most samples are not used, as projections can concentrate
+        // their samples in a small area, such as the point opposite to the center of a
+        // 360 degree fisheye, which would otherwise decide the resolution of the face
+        const size_t n = counts.size() * Percentile / 100;
+        std::nth_element(counts.begin(), counts.begin() + n, counts.end());
+        const int count = counts[n];
+
+        // A bin of a face with the resolution r contains (r / NBins)^2 pixels, which
+        // should be as many as there are output pixels that sample it
+        const float pixels = static_cast<float>(count) * pixelsPerDirection;
+        const float r = std::sqrt(pixels) * NBins;
+        // Rounded up to a multiple of 16 pixels
+        res[face] = std::max((static_cast<int>(std::ceil(r / 16.f))) * 16, 16);
+    }
+    return res;
+}
+
+std::array<int, 6> limitToPixelBudget(std::array<int, 6> resolutions,
+                                      const CubemapCoverage& coverage,
+                                      ivec2 coverageResolution, int64_t budget)
+{
+    const double coverageArea =
+        static_cast<double>(coverageResolution.x) * coverageResolution.y;
+
+    double pixels = 0.0;
+    for (size_t i = 0; i < resolutions.size(); i++) {
+        const CubemapCoverage::Face& face = coverage.faces[i];
+        if (!face.isCovered) {
+            continue;
+        }
+        const double fraction = static_cast<double>(face.rect.z) * face.rect.w /
+            coverageArea;
+        pixels += fraction * resolutions[i] * resolutions[i];
+    }
+    if (pixels <= static_cast<double>(budget)) {
+        return resolutions;
+    }
+
+    const double scale = std::sqrt(static_cast<double>(budget) / pixels);
+    for (int& r : resolutions) {
+        if (r > 0) {
+            // Rounded down so that the budget is not exceeded
+            r = std::max(static_cast<int>(r * scale) / 16 * 16, 16);
+        }
+    }
+    return resolutions;
+}
+
+std::optional<vec3> fisheyeDirection(vec2 tc, float halfFov, vec3 offset,
+                                     bool isFourFaceCube)
+{
+    const float s = 2.f * (tc.x - 0.5f);
+    const float t = 2.f * (tc.y - 0.5f);
+    const float r2 = s * s + t * t;
+    if (r2 > 1.f) {
+        return std::nullopt;
+    }
+
+    const float phi = std::sqrt(r2) * halfFov;
+    const float theta = std::atan2(s, t);
+    const float x = std::sin(phi) * std::sin(theta) - offset.x;
+    const float y = -std::sin(phi) * std::cos(theta) - offset.y;
+    const float z = std::cos(phi) - offset.z;
+
+    constexpr float Angle = 0.7071067812f;
+    if (isFourFaceCube) {
+        return vec3(Angle * x + Angle * z, y, -Angle * x + Angle * z);
+    }
+    else {
+        return vec3(Angle * x - Angle * y, Angle * x + Angle * y, z);
+    }
+}
+
+vec3 cylindricalDirection(vec2 uv, float rotation, float heightOffset) {
+    const float angle = glm::two_pi<float>() * uv.x;
+    return vec3(
+        std::cos(-angle + rotation),
+        std::sin(-angle + rotation),
+        uv.y + heightOffset
+    );
+}
+
+std::vector<vec2> sampledPositions(const correction::Buffer& mesh, ivec2 resolution,
+                                   vec2 position, vec2 size)
+{
+    ZoneScoped;
+
+    const correction::BakedWarp warp = correction::bakeWarp(mesh, resolution);
+
+    std::vector<vec2> res;
+    res.reserve(warp.lookup.size());
+    for (size_t i = 0; i < warp.lookup.size(); i++) {
+        const vec3& uv = warp.lookup[i];
+        const vec4& b = warp.blend[i];
+        if (uv.z == 0.f || (b.x == 0.f && b.y == 0.f && b.z == 0.f && b.w == 0.f)) {
+            // Not covered by the mesh or blended to black, so the cube map is not shown
+            continue;
+        }
+        res.push_back(vec2{
+            (uv.x - position.x) / size.x,
+            (uv.y - position.y) / size.y
+        });
+    }
+    return res;
+}
+
+} // namespace sgct
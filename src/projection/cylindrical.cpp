@@ -18,6 +18,7 @@
 #include <sgct/settings.h>
 #include <sgct/window.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -113,7 +114,7 @@ void CylindricalProjection::renderCubemap(Window& window, Frustum::Mode frustumM
     renderCubeFaces(window, frustumMode);
 }
 
-void CylindricalProjection::update(vec2) {
+void CylindricalProjection::update(vec2 size) {
     glBindVertexArray(_vao);
     glBindBuffer(GL_ARRAY_BUFFER, _vbo);
 
@@ -125,6 +126,9 @@ void CylindricalProjection::update(vec2) {
     };
     glBufferData(GL_ARRAY_BUFFER, v.size() * sizeof(float), v.data(), GL_STATIC_DRAW);
     glBindVertexArray(0);
+
+    _viewportResolution = size;
+    updateCubemapCoverage();
 }
 
 void CylindricalProjection::initVBO() {
@@ -304,6 +308,26 @@ void CylindricalProjection::initShaders() {
     ShaderProgram::unbind();
 }
 
+std::optional<NonLinearProjection::CubemapSamples> CylindricalProjection::cubemapSamples(
+                                                          std::span<const vec2> positions,
+                                                          float spacing) const
+{
+    ZoneScoped;
+
+    // The quad covers the whole viewport, so the positions are the texture coordinates
+    const float rotation = glm::radians(_rotation);
+    std::vector<vec3> directions;
+    directions.reserve(positions.size());
+    for (const vec2& p : positions) {
+        directions.push_back(cylindricalDirection(p, rotation, _heightOffset));
+    }
+
+    // Horizontally the positions cover the full circle, vertically they change the height
+    // linearly, which changes the angle by less than the distance
+    const float angle = glm::two_pi<float>() * spacing;
+    return CubemapSamples{ std::move(directions), angle };
+}
+
 void CylindricalProjection::setRotation(float rotation) {
     _rotation = rotation;
 }
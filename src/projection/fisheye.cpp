@@ -21,6 +21,8 @@
 
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace {
     struct Vertex {
@@ -77,6 +79,11 @@ void FisheyeProjection::update(vec2 size) {
     };
     glBufferData(GL_ARRAY_BUFFER, v.size() * sizeof(Vertex), v.data(), GL_STATIC_DRAW);
     glBindVertexArray(0);
+
+    _quadSize = vec2{ x, y };
+    _viewportResolution = size;
+    _coverageParameters = coverageParameters();
+    updateCubemapCoverage();
 }
 
 void FisheyeProjection::render(const Window& window, const BaseViewport& viewport,
@@ -157,9 +164,22 @@ void FisheyeProjection::renderCubemap(Window& window, Frustum::Mode frustumMode)
             break;
     }
 
+    // The offsets and the eye separation can change without the projection being updated
+    const std::array<float, 4> parameters = coverageParameters();
+    if (parameters != _coverageParameters) {
+        _coverageParameters = parameters;
+        updateCubemapCoverage();
+    }
+
+    // Without depth textures, there is no depth correction that has to be done per face
+    if (_useLayeredRendering) {
+        renderCubeFacesLayered(window, frustumMode);
+        return;
+    }
+
     auto render = [this](const Window& win, BaseViewport& vp, int idx, Frustum::Mode mode)
     {
-        if (!vp.isEnabled()) {
+        if (!vp.isEnabled() || !isFaceCovered(idx)) {
             return;
         }
 
@@ -555,6 +575,64 @@ void FisheyeProjection::initViewports() {
     }
 }
 
+std::optional<NonLinearProjection::CubemapSamples> FisheyeProjection::cubemapSamples(
+                                                          std::span<const vec2> positions,
+                                                          float spacing) const
+{
+    ZoneScoped;
+
+    // The cube map is shared by both eyes, so it has to contain the samples of both
+    const std::array<float, 4> p = coverageParameters();
+    std::vector<vec3> offsets = { vec3{ p[0], p[1], p[2] } };
+    if (p[3] > 0.f) {
+        const float eyeOffset = p[3] / _diameter;
+        offsets.push_back(vec3{ p[0] - eyeOffset, p[1], p[2] });
+        offsets.push_back(vec3{ p[0] + eyeOffset, p[1], p[2] });
+    }
+
+    const float halfFov = glm::radians(_fov / 2.f);
+    const bool isFourFaceCube = _method == FisheyeMethod::FourFaceCube;
+    const vec2 tcSize = vec2{
+        1.f - _cropLeft - _cropRight,
+        1.f - _cropBottom - _cropTop
+    };
+
+    std::vector<vec3> directions;
+    directions.reserve(positions.size() * offsets.size());
+    for (const vec2& p : positions) {
+        // The position on the quad that is created in the update function
+        const float qx = (2.f * p.x - 1.f + _quadSize.x) / (2.f * _quadSize.x);
+        const float qy = (2.f * p.y - 1.f + _quadSize.y) / (2.f * _quadSize.y);
+        if (qx < 0.f || qx > 1.f || qy < 0.f || qy > 1.f) {
+            continue;
+        }
+
+        const vec2 tc = vec2{ _cropLeft + qx * tcSize.x, _cropBottom + qy * tcSize.y };
+        for (const vec3& offset : offsets) {
+            const std::optional<vec3> dir =
+                fisheyeDirection(tc, halfFov, offset, isFourFaceCube);
+            if (dir) {
+                directions.push_back(*dir);
+            }
+        }
+    }
+
+    // The angle from the center grows by the field of view per unit of the texture
+    // coordinates, and an offset moves the center of projection closer to the sphere
+    float maxOffset = 0.f;
+    for (const vec3& o : offsets) {
+        maxOffset = std::max(maxOffset, std::sqrt(o.x * o.x + o.y * o.y + o.z * o.z));
+    }
+    const float tcSpacing =
+        spacing * std::max(tcSize.x / _quadSize.x, tcSize.y / _quadSize.y);
+    const float angle = 2.f * halfFov * tcSpacing / std::max(1.f - maxOffset, 0.1f);
+    return CubemapSamples{
+        std::move(directions),
+        angle,
+        static_cast<int>(offsets.size())
+    };
+}
+
 void FisheyeProjection::initShaders() {
     if (_isStereo || _preferedMonoFrustumMode != Frustum::Mode::MonoEye) {
         // if any frustum mode other than Mono (or stereo)
@@ -724,4 +802,18 @@ void FisheyeProjection::initShaders() {
     }
 }
 
+std::array<float, 4> FisheyeProjection::coverageParameters() const {
+    // The offset of a stereo projection is replaced by the offsets of the eyes before
+    // each cube map is rendered, so only its base offset is relevant
+    if (_isStereo || _preferedMonoFrustumMode != Frustum::Mode::MonoEye) {
+        return {
+            _baseOffset.x,
+            _baseOffset.y,
+            _baseOffset.z,
+            Engine::defaultUser().eyeSeparation()
+        };
+    }
+    return { _totalOffset.x, _totalOffset.y, _totalOffset.z, 0.f };
+}
+
 } // namespace sgct
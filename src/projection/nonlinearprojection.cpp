@@ -21,6 +21,18 @@
 #include <array>
 #include <cmath>
 
+namespace {
+    // Scales the rectangle \p r given as x, y, width, and height and rounds the corners
+    // to the nearest pixel
+    sgct::ivec4 scaledRect(sgct::ivec4 r, float scale) {
+        const int x0 = static_cast<int>(std::floor(r.x * scale + 0.5f));
+        const int y0 = static_cast<int>(std::floor(r.y * scale + 0.5f));
+        const int x1 = static_cast<int>(std::floor((r.x + r.z) * scale + 0.5f));
+        const int y1 = static_cast<int>(std::floor((r.y + r.w) * scale + 0.5f));
+        return sgct::ivec4{ x0, y0, x1 - x0, y1 - y0 };
+    }
+} // namespace
+
 namespace sgct {
 
 NonLinearProjection::NonLinearProjection(const Window* parent)
@@ -47,6 +59,7 @@ NonLinearProjection::~NonLinearProjection() {
     glDeleteTextures(1, &_textures.cubeFaceTop);
     glDeleteTextures(1, &_textures.cubeFaceFront);
     glDeleteTextures(1, &_textures.cubeFaceBack);
+    glDeleteTextures(1, &_textures.scaledFace);
 }
 
 void NonLinearProjection::initialize(unsigned int internalFormat, unsigned int format,
@@ -58,6 +71,31 @@ void NonLinearProjection::initialize(unsigned int internalFormat, unsigned int f
     _samples = samples;
 
     initViewports();
+
+    _useLayeredRendering = Settings::instance().useLayeredCubemapRendering();
+    if (_useLayeredRendering) {
+        const std::array<const BaseViewport*, 6> faces = {
+            &_subViewports.right, &_subViewports.left, &_subViewports.bottom,
+            &_subViewports.top, &_subViewports.front, &_subViewports.back
+        };
+        const std::optional<std::string_view> reason = layeredRenderingFallback(
+            _samples,
+            Settings::instance().useDepthTexture(),
+            faces
+        );
+        if (reason) {
+            Log::Info(std::format("Rendering cube map faces separately as {}", *reason));
+            _useLayeredRendering = false;
+        }
+    }
+
+    // Faces are scaled up by copying them into the cube map, which is only done for a
+    // single color attachment that is rendered directly
+    const Settings& s = Settings::instance();
+    _useScaledFaces = s.cubemapResolution() != Settings::CubemapResolution::Fixed &&
+        _samples == 1 && !_useLayeredRendering && !s.useDepthTexture() &&
+        !s.useNormalTexture() && !s.usePositionTexture();
+
     initTextures();
     initFBO();
     initVBO();
@@ -69,24 +107,24 @@ void NonLinearProjection::updateFrustums(Frustum::Mode mode, float nearClip,
 {
     ZoneScoped;
 
-    if (_subViewports.right.isEnabled()) {
-        _subViewports.right.calculateNonLinearFrustum(mode, nearClip, farClip);
-    }
-    if (_subViewports.left.isEnabled()) {
-        _subViewports.left.calculateNonLinearFrustum(mode, nearClip, farClip);
-    }
-    if (_subViewports.bottom.isEnabled()) {
-        _subViewports.bottom.calculateNonLinearFrustum(mode, nearClip, farClip);
-    }
-    if (_subViewports.top.isEnabled()) {
-        _subViewports.top.calculateNonLinearFrustum(mode, nearClip, farClip);
-    }
-    if (_subViewports.front.isEnabled()) {
-        _subViewports.front.calculateNonLinearFrustum(mode, nearClip, farClip);
-    }
-    if (_subViewports.back.isEnabled()) {
-        _subViewports.back.calculateNonLinearFrustum(mode, nearClip, farClip);
+    // All faces are seen from the same eye, so their projections are calculated together
+    std::array<BaseViewport*, 6> viewports;
+    size_t n = 0;
+    for (BaseViewport* vp : { &_subViewports.right, &_subViewports.left,
+                              &_subViewports.bottom, &_subViewports.top,
+                              &_subViewports.front, &_subViewports.back })
+    {
+        if (vp->isEnabled()) {
+            viewports[n] = vp;
+            n++;
+        }
     }
+    BaseViewport::calculateNonLinearFrustums(
+        std::span(viewports.data(), n),
+        mode,
+        nearClip,
+        farClip
+    );
 }
 
 void NonLinearProjection::setCubemapResolution(int resolution) {
@@ -119,6 +157,12 @@ void NonLinearProjection::setUser(User* user) {
     _subViewports.back.setUser(user);
 }
 
+void NonLinearProjection::setCubemapSamples(std::vector<vec2> positions, float spacing) {
+    _coverageSamples = std::move(positions);
+    _coverageSpacing = spacing;
+    updateCubemapCoverage();
+}
+
 ivec2 NonLinearProjection::cubemapResolution() const {
     return _cubemapResolution;
 }
@@ -167,6 +211,21 @@ void NonLinearProjection::initTextures() {
         }
     }
 
+    if (_useLayeredRendering) {
+        // The depth buffer has to be layered as well, so the renderbuffer of the
+        // framebuffer cannot be used
+        generateCubeMap(
+            _textures.cubeMapDepth,
+            GL_DEPTH_COMPONENT32,
+            GL_DEPTH_COMPONENT,
+            GL_FLOAT
+        );
+        Log::Debug(std::format(
+            "{}x{} layered depth cube map texture (id: {}) generated",
+            _cubemapResolution.x, _cubemapResolution.y, _textures.cubeMapDepth
+        ));
+    }
+
     if (Settings::instance().useNormalTexture()) {
         generateCubeMap(
             _textures.cubeMapNormals,
@@ -192,6 +251,14 @@ void NonLinearProjection::initTextures() {
             _cubemapResolution.x, _cubemapResolution.y, _textures.cubeMapPositions
         ));
     }
+
+    if (_useScaledFaces) {
+        generateMap(_textures.scaledFace, _texInternalFormat, _texFormat, _texType);
+        Log::Debug(std::format(
+            "{}x{} scaled face texture (id: {}) generated",
+            _cubemapResolution.x, _cubemapResolution.y, _textures.scaledFace
+        ));
+    }
 }
 
 void NonLinearProjection::initFBO() {
@@ -200,7 +267,159 @@ void NonLinearProjection::initFBO() {
     _cubeMapFbo->createFBO(_cubemapResolution.x, _cubemapResolution.y, _samples);
 }
 
-void NonLinearProjection::setupViewport(BaseViewport& vp) {
+std::optional<NonLinearProjection::CubemapSamples> NonLinearProjection::cubemapSamples(
+                                                                   std::span<const vec2>,
+                                                                   float) const
+{
+    return std::nullopt;
+}
+
+void NonLinearProjection::updateCubemapCoverage() {
+    ZoneScoped;
+
+    std::optional<CubemapSamples> samples;
+    float pixelsPerPosition = 1.f;
+    if (_coverageSamples.empty()) {
+        // Without a correction mesh, every pixel of the viewport is visible
+        constexpr int GridSize = 512;
+        std::vector<vec2> grid;
+        grid.reserve(GridSize * GridSize);
+        for (int y = 0; y < GridSize; y++) {
+            for (int x = 0; x < GridSize; x++) {
+                grid.emplace_back(
+                    (static_cast<float>(x) + 0.5f) / GridSize,
+                    (static_cast<float>(y) + 0.5f) / GridSize
+                );
+            }
+        }
+        samples = cubemapSamples(grid, 1.f / GridSize);
+        pixelsPerPosition = _viewportResolution.x * _viewportResolution.y /
+            (GridSize * GridSize);
+    }
+    else {
+        // The positions of a correction mesh are sampled once for each pixel
+        samples = cubemapSamples(_coverageSamples, _coverageSpacing);
+    }
+
+    if (!samples) {
+        _coverage = std::nullopt;
+        return;
+    }
+
+    if (Settings::instance().cubemapResolution() != Settings::CubemapResolution::Fixed &&
+        _viewportResolution.x > 0.f && _viewportResolution.y > 0.f)
+    {
+        updateFaceResolutions(
+            *samples,
+            pixelsPerPosition / static_cast<float>(samples->directionsPerPosition)
+        );
+    }
+    _coverage = cubemapCoverage(
+        samples->directions,
+        _cubemapResolution,
+        samples->spacing
+    );
+
+    const std::array<const BaseViewport*, 6> faces = {
+        &_subViewports.right, &_subViewports.left, &_subViewports.bottom,
+        &_subViewports.top, &_subViewports.front, &_subViewports.back
+    };
+    double total = 0.0;
+    double used = 0.0;
+    int nFaces = 0;
+    for (size_t i = 0; i < faces.size(); i++) {
+        if (!faces[i]->isEnabled()) {
+            continue;
+        }
+        total += static_cast<double>(_cubemapResolution.x) * _cubemapResolution.y;
+        const CubemapCoverage::Face& face = _coverage->faces[i];
+        if (face.isCovered) {
+            // Faces that are scaled up are rendered with fewer pixels
+            const double r = static_cast<double>(_faceResolutions[i]);
+            const double scale = r > 0.0 ? std::min(r / _cubemapResolution.x, 1.0) : 1.0;
+            used += static_cast<double>(face.rect.z) * face.rect.w * scale * scale;
+            nFaces++;
+        }
+    }
+    if (total > 0.0) {
+        Log::Debug(std::format(
+            "Rendering {} cube map faces with {:.1f}% of the pixels",
+            nFaces, 100.0 * used / total
+        ));
+    }
+}
+
+void NonLinearProjection::updateFaceResolutions(const CubemapSamples& samples,
+                                                float pixelsPerDirection)
+{
+    ZoneScoped;
+
+    const std::array<const BaseViewport*, 6> faces = {
+        &_subViewports.right, &_subViewports.left, &_subViewports.bottom,
+        &_subViewports.top, &_subViewports.front, &_subViewports.back
+    };
+
+    std::array<int, 6> res =
+        cubemapFaceResolutions(samples.directions, pixelsPerDirection);
+    for (size_t i = 0; i < faces.size(); i++) {
+        if (!faces[i]->isEnabled()) {
+            res[i] = 0;
+        }
+    }
+    int resolution = *std::max_element(res.cbegin(), res.cend());
+    if (resolution == 0) {
+        return;
+    }
+
+    if (Settings::instance().cubemapResolution() ==
+        Settings::CubemapResolution::PixelBudget)
+    {
+        const CubemapCoverage coverage = cubemapCoverage(
+            samples.directions,
+            ivec2(resolution, resolution),
+            samples.spacing
+        );
+        res = limitToPixelBudget(
+            res,
+            coverage,
+            ivec2(resolution, resolution),
+            Settings::instance().cubemapPixelBudget()
+        );
+        resolution = *std::max_element(res.cbegin(), res.cend());
+    }
+
+    if (resolution != _cubemapResolution.x || resolution != _cubemapResolution.y) {
+        setCubemapResolution(resolution);
+        if (_cubeMapFbo) {
+            // The projection is already initialized, so the textures have to be recreated
+            initTextures();
+            initFBO();
+            initShaders();
+        }
+    }
+
+    // The resolution might have been limited by the largest supported texture size
+    for (int& r : res) {
+        r = std::min(r, _cubemapResolution.x);
+    }
+    Log::Info(std::format(
+        "Cube map resolution {} with face resolutions {}, {}, {}, {}, {}, {}",
+        _cubemapResolution.x, res[0], res[1], res[2], res[3], res[4], res[5]
+    ));
+
+    if (_useScaledFaces) {
+        _faceResolutions = res;
+    }
+    else {
+        _faceResolutions = { 0, 0, 0, 0, 0, 0 };
+    }
+}
+
+bool NonLinearProjection::isFaceCovered(int face) const {
+    return !_coverage.has_value() || _coverage->faces[face].isCovered;
+}
+
+void NonLinearProjection::setupViewport(const BaseViewport& vp) {
     _vpCoords = ivec4{
         static_cast<int>(std::floor(vp.position().x * _cubemapResolution.x + 0.5f)),
         static_cast<int>(std::floor(vp.position().y * _cubemapResolution.y + 0.5f)),
@@ -401,12 +620,20 @@ void NonLinearProjection::blitCubeFace(int face) {
 void NonLinearProjection::renderCubeFace(const Window& win, BaseViewport& vp, int idx,
                                          Frustum::Mode mode)
 {
-    if (!vp.isEnabled()) {
+    if (!vp.isEnabled() || !isFaceCovered(idx)) {
         return;
     }
 
+    // A face that needs fewer pixels than the cube map is rendered into the lower left
+    // corner of a separate texture and then scaled up into the cube map
+    const int faceResolution = std::min(_faceResolutions[idx], _cubemapResolution.x);
+    const bool isScaled = faceResolution > 0 && faceResolution < _cubemapResolution.x;
+
     _cubeMapFbo->bind();
-    if (!_cubeMapFbo->isMultiSampled()) {
+    if (isScaled) {
+        _cubeMapFbo->attachColorTexture(_textures.scaledFace, GL_COLOR_ATTACHMENT0);
+    }
+    else if (!_cubeMapFbo->isMultiSampled()) {
         attachTextures(idx);
     }
 
@@ -419,7 +646,7 @@ void NonLinearProjection::renderCubeFace(const Window& win, BaseViewport& vp, in
         vp.projection(mode).projectionMatrix(),
         vp.projection(mode).viewProjectionMatrix() *
             ClusterManager::instance().sceneTransform(),
-        _cubemapResolution
+        isScaled ? ivec2(faceResolution, faceResolution) : _cubemapResolution
     );
     glLineWidth(1.f);
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -428,14 +655,42 @@ void NonLinearProjection::renderCubeFace(const Window& win, BaseViewport& vp, in
 
     glEnable(GL_SCISSOR_TEST);
     setupViewport(vp);
+    ivec4 scissor = _vpCoords;
+    if (_coverage) {
+        // Only the part of the face that is sampled later is cleared and rendered
+        const ivec4 r = _coverage->faces[idx].rect;
+        const int x0 = std::max(_vpCoords.x, r.x);
+        const int y0 = std::max(_vpCoords.y, r.y);
+        const int x1 = std::min(_vpCoords.x + _vpCoords.z, r.x + r.z);
+        const int y1 = std::min(_vpCoords.y + _vpCoords.w, r.y + r.w);
+        scissor = ivec4{ x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0) };
+    }
+    ivec4 viewport = _vpCoords;
+    if (isScaled) {
+        const float scale = static_cast<float>(faceResolution) / _cubemapResolution.x;
+        viewport = scaledRect(_vpCoords, scale);
+        // The scissor rectangle grows by a pixel for the linear filtering of the copy
+        const ivec4 r = scaledRect(scissor, scale);
+        scissor = ivec4{ r.x - 1, r.y - 1, r.z + 2, r.w + 2 };
+        glViewport(viewport.x, viewport.y, viewport.z, viewport.w);
+    }
+    glScissor(scissor.x, scissor.y, scissor.z, scissor.w);
 
     glClearColor(0.f, 0.f, 0.f, 1.f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    glDisable(GL_SCISSOR_TEST);
+    if (!_coverage) {
+        glDisable(GL_SCISSOR_TEST);
+    }
     Engine::instance().drawFunction()(renderData);
+    glDisable(GL_SCISSOR_TEST);
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
+    if (isScaled) {
+        // The viewports map to each other in the same way as the rendering did
+        _cubeMapFbo->blitToCubeMapFace(_textures.cubeMapColor, idx, viewport, _vpCoords);
+    }
+
     // blit MSAA fbo to texture
     if (_cubeMapFbo->isMultiSampled()) {
         blitCubeFace(idx);
@@ -443,6 +698,11 @@ void NonLinearProjection::renderCubeFace(const Window& win, BaseViewport& vp, in
 }
 
 void NonLinearProjection::renderCubeFaces(Window& window, Frustum::Mode frustumMode) {
+    if (_useLayeredRendering) {
+        renderCubeFacesLayered(window, frustumMode);
+        return;
+    }
+
     renderCubeFace(window, _subViewports.right, 0, frustumMode);
     renderCubeFace(window, _subViewports.left, 1, frustumMode);
     renderCubeFace(window, _subViewports.bottom, 2, frustumMode);
@@ -451,4 +711,141 @@ void NonLinearProjection::renderCubeFaces(Window& window, Frustum::Mode frustumM
     renderCubeFace(window, _subViewports.back, 5, frustumMode);
 }
 
+void NonLinearProjection::renderCubeFacesLayered(const Window& window,
+                                                 Frustum::Mode frustumMode)
+{
+    ZoneScoped;
+
+    const std::array<const BaseViewport*, 6> faces = {
+        &_subViewports.right, &_subViewports.left, &_subViewports.bottom,
+        &_subViewports.top, &_subViewports.front, &_subViewports.back
+    };
+
+    std::array<bool, 6> isCovered;
+    for (size_t i = 0; i < isCovered.size(); i++) {
+        isCovered[i] = isFaceCovered(static_cast<int>(i));
+    }
+    const mat4& sceneTransform = ClusterManager::instance().sceneTransform();
+    const RenderData::CubemapLayers layers =
+        cubemapLayers(faces, isCovered, frustumMode, sceneTransform);
+
+    const BaseViewport* first = nullptr;
+    ivec4 bounds = ivec4{ _cubemapResolution.x, _cubemapResolution.y, 0, 0 };
+    for (size_t i = 0; i < faces.size(); i++) {
+        if (!layers.isEnabled[i]) {
+            continue;
+        }
+        if (_coverage) {
+            // The bounds of all sampled rectangles as x0, y0, x1, y1
+            const ivec4 r = _coverage->faces[i].rect;
+            bounds.x = std::min(bounds.x, r.x);
+            bounds.y = std::min(bounds.y, r.y);
+            bounds.z = std::max(bounds.z, r.x + r.z);
+            bounds.w = std::max(bounds.w, r.y + r.w);
+        }
+        if (!first) {
+            first = faces[i];
+        }
+    }
+    if (!first) {
+        return;
+    }
+
+    _cubeMapFbo->bind();
+    _cubeMapFbo->attachLayeredTexture(_textures.cubeMapColor, GL_COLOR_ATTACHMENT0);
+    _cubeMapFbo->attachLayeredTexture(_textures.cubeMapDepth, GL_DEPTH_ATTACHMENT);
+    if (Settings::instance().useNormalTexture()) {
+        _cubeMapFbo->attachLayeredTexture(_textures.cubeMapNormals, GL_COLOR_ATTACHMENT1);
+    }
+    if (Settings::instance().usePositionTexture()) {
+        _cubeMapFbo->attachLayeredTexture(
+            _textures.cubeMapPositions,
+            GL_COLOR_ATTACHMENT2
+        );
+    }
+
+    const Projection& proj = first->projection(frustumMode);
+    RenderData renderData(
+        window,
+        *first,
+        frustumMode,
+        sceneTransform,
+        proj.viewMatrix(),
+        proj.projectionMatrix(),
+        proj.viewProjectionMatrix() * sceneTransform,
+        _cubemapResolution
+    );
+    renderData.cubemapLayers = layers;
+
+    glLineWidth(1.f);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+
+    glDepthFunc(GL_LESS);
+
+    // All faces cover the whole cube map, so the viewport is the same for all layers and
+    // clearing the layered framebuffer clears all faces. The scissor rectangle is shared
+    // by all layers as well, so it has to contain the sampled parts of all faces
+    glEnable(GL_SCISSOR_TEST);
+    setupViewport(*first);
+    if (_coverage) {
+        glScissor(bounds.x, bounds.y, bounds.z - bounds.x, bounds.w - bounds.y);
+    }
+
+    glClearColor(0.f, 0.f, 0.f, 1.f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    if (!_coverage) {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    Engine::instance().drawFunction()(renderData);
+    glDisable(GL_SCISSOR_TEST);
+    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+}
+
+std::optional<std::string_view> NonLinearProjection::layeredRenderingFallback(
+                                                                             int samples,
+                                                                    bool useDepthTexture,
+                                           std::span<const BaseViewport* const, 6> faces)
+{
+    if (samples > 1) {
+        return "multisampling is enabled";
+    }
+    if (useDepthTexture) {
+        return "depth textures are enabled";
+    }
+    const bool isFullFace = std::all_of(
+        faces.begin(),
+        faces.end(),
+        [](const BaseViewport* vp) {
+            return !vp->isEnabled() ||
+                (vp->position().x == 0.f && vp->position().y == 0.f &&
+                 vp->size().x == 1.f && vp->size().y == 1.f);
+        }
+    );
+    if (!isFullFace) {
+        return "some faces are cropped";
+    }
+    return std::nullopt;
+}
+
+RenderData::CubemapLayers NonLinearProjection::cubemapLayers(
+                                           std::span<const BaseViewport* const, 6> faces,
+                                                    const std::array<bool, 6>& isCovered,
+                                                               Frustum::Mode frustumMode,
+                                                              const mat4& sceneTransform)
+{
+    RenderData::CubemapLayers layers;
+    for (size_t i = 0; i < faces.size(); i++) {
+        if (!faces[i]->isEnabled() || !isCovered[i]) {
+            continue;
+        }
+        const Projection& p = faces[i]->projection(frustumMode);
+        layers.viewMatrix[i] = p.viewMatrix();
+        layers.projectionMatrix[i] = p.projectionMatrix();
+        layers.modelViewProjectionMatrix[i] = p.viewProjectionMatrix() * sceneTransform;
+        layers.isEnabled[i] = true;
+    }
+    return layers;
+}
+
 } // namespace sgct
@@ -8,13 +8,27 @@
 
 #include <sgct/projection/projectionplane.h>
 
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <atomic>
+#include <cstring>
 #include <utility>
 
 // @TODO (abock, 2019-10-15) There seems to be an issue with the rendering of the
 // z coordinate of the place is 0 even if the user position is not a zero
 
+namespace {
+    // The versions are unique across all planes, so that a projection never mistakes a
+    // different plane for the one it was last calculated with
+    std::atomic<uint64_t> gVersion = 0;
+} // namespace
+
 namespace sgct {
 
+ProjectionPlane::ProjectionPlane() {
+    updateRotation();
+}
+
 void ProjectionPlane::offset(const vec3& p) {
     _lowerLeft.x += p.x;
     _lowerLeft.y += p.y;
@@ -27,12 +41,16 @@ void ProjectionPlane::offset(const vec3& p) {
     _upperRight.x += p.x;
     _upperRight.y += p.y;
     _upperRight.z += p.z;
+
+    updateRotation();
 }
 
 void ProjectionPlane::setCoordinates(vec3 lowerLeft, vec3 upperLeft, vec3 upperRight) {
     _lowerLeft = std::move(lowerLeft);
     _upperLeft = std::move(upperLeft);
     _upperRight = std::move(upperRight);
+
+    updateRotation();
 }
 
 const vec3& ProjectionPlane::coordinateLowerLeft() const {
@@ -47,4 +65,47 @@ const vec3& ProjectionPlane::coordinateUpperRight() const {
     return _upperRight;
 }
 
+const mat4& ProjectionPlane::rotation() const {
+    return _rotation;
+}
+
+const vec3& ProjectionPlane::rotatedLowerLeft() const {
+    return _rotatedLowerLeft;
+}
+
+const vec3& ProjectionPlane::rotatedUpperRight() const {
+    return _rotatedUpperRight;
+}
+
+uint64_t ProjectionPlane::version() const {
+    return _version;
+}
+
+void ProjectionPlane::updateRotation() {
+    const glm::vec3 lowerLeft = glm::make_vec3(&_lowerLeft.x);
+    const glm::vec3 upperLeft = glm::make_vec3(&_upperLeft.x);
+    const glm::vec3 upperRight = glm::make_vec3(&_upperRight.x);
+
+    // calculate viewplane's internal coordinate system bases
+    const glm::vec3 planeX = glm::normalize(upperRight - upperLeft);
+    const glm::vec3 planeY = glm::normalize(upperLeft - lowerLeft);
+    const glm::vec3 planeZ = glm::normalize(glm::cross(planeX, planeY));
+
+    // calculate plane rotation using Direction Cosine Matrix (DCM), whose columns are the
+    // dot products of the bases with the world axes, which are the bases themselves
+    const glm::mat3 dcm = glm::mat3(planeX, planeY, planeZ);
+
+    // invert & transform
+    const glm::mat3 invDcm = glm::inverse(dcm);
+    const glm::vec3 ll = invDcm * lowerLeft;
+    const glm::vec3 ur = invDcm * upperRight;
+    _rotatedLowerLeft = vec3{ ll.x, ll.y, ll.z };
+    _rotatedUpperRight = vec3{ ur.x, ur.y, ur.z };
+
+    const glm::mat4 rotation = glm::mat4(invDcm);
+    std::memcpy(&_rotation, glm::value_ptr(rotation), sizeof(mat4));
+
+    _version = ++gVersion;
+}
+
 } // namespace sgct
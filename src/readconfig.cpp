@@ -138,6 +138,14 @@ namespace {
         throw Err(6023, "Unregnozed interpolation");
     }
 
+    using PredictionMethod = sgct::config::Tracker::Prediction::Method;
+    PredictionMethod parsePredictionMethod(std::string_view method) {
+        if (method == "constantvelocity") { return PredictionMethod::ConstantVelocity; }
+        if (method == "doubleexponential") { return PredictionMethod::DoubleExponential; }
+
+        throw Err(6071, std::format("Unknown prediction method {}", method));
+    }
+
     sgct::config::SpoutOutputProjection::Mapping parseMapping(std::string_view mapping) {
         using namespace sgct::config;
         if (mapping == "fisheye") { return SpoutOutputProjection::Mapping::Fisheye; }
@@ -580,6 +588,36 @@ void to_json(nlohmann::json& j, const Device& d) {
     }
 }
 
+void from_json(const nlohmann::json& j, Tracker::Prediction& p) {
+    if (auto it = j.find("method");  it != j.end()) {
+        const std::string method = it->get<std::string>();
+        p.method = parsePredictionMethod(method);
+    }
+    parseValue(j, "latency", p.latency);
+    parseValue(j, "smoothing", p.smoothing);
+}
+
+void to_json(nlohmann::json& j, const Tracker::Prediction& p) {
+    j = nlohmann::json::object();
+
+    switch (p.method) {
+        case Tracker::Prediction::Method::ConstantVelocity:
+            j["method"] = "constantvelocity";
+            break;
+        case Tracker::Prediction::Method::DoubleExponential:
+            j["method"] = "doubleexponential";
+            break;
+    }
+
+    if (p.latency.has_value()) {
+        j["latency"] = *p.latency;
+    }
+
+    if (p.smoothing.has_value()) {
+        j["smoothing"] = *p.smoothing;
+    }
+}
+
 void from_json(const nlohmann::json& j, Tracker& t) {
     if (auto it = j.find("name");  it != j.end()) {
         it->get_to(t.name);
@@ -599,6 +637,7 @@ void from_json(const nlohmann::json& j, Tracker& t) {
     }
     parseValue(j, "scale", t.scale);
     parseValue(j, "matrix", t.transformation);
+    parseValue(j, "prediction", t.prediction);
 }
 
 void to_json(nlohmann::json& j, const Tracker& t) {
@@ -618,6 +657,10 @@ void to_json(nlohmann::json& j, const Tracker& t) {
     if (t.scale.has_value()) {
         j["scale"] = *t.scale;
     }
+
+    if (t.prediction.has_value()) {
+        j["prediction"] = *t.prediction;
+    }
 }
 
 void from_json(const nlohmann::json& j, PlanarProjection::FOV& f) {
@@ -113,6 +113,18 @@ void Settings::setUsePositionTexture(bool state) {
     _usePositionTexture = state;
 }
 
+void Settings::setUseLayeredCubemapRendering(bool state) {
+    _useLayeredCubemapRendering = state;
+}
+
+void Settings::setCubemapResolution(CubemapResolution policy) {
+    _cubemapResolution = policy;
+}
+
+void Settings::setCubemapPixelBudget(int64_t pixels) {
+    _cubemapPixelBudget = pixels;
+}
+
 void Settings::setBufferFloatPrecision(BufferFloatPrecision bfp) {
     _bufferFloatPrecision = bfp;
 }
@@ -126,6 +138,27 @@ void Settings::setNumberOfCaptureThreads(int count) {
     }
 }
 
+void Settings::setNumberOfTextureLoadThreads(int count) {
+    if (count <= 0) {
+        Log::Error("Only positive number of texture load threads allowed");
+    }
+    else {
+        _nTextureLoadThreads = count;
+    }
+}
+
+void Settings::setTextureUploadBudget(double milliseconds) {
+    _textureUploadBudget = std::max(milliseconds, 0.0);
+}
+
+void Settings::setTextureMemoryBudget(size_t bytes) {
+    _textureMemoryBudget = bytes;
+}
+
+void Settings::setTextureCachePath(std::filesystem::path path) {
+    _textureCachePath = std::move(path);
+}
+
 bool Settings::useDepthTexture() const {
     return _useDepthTexture;
 }
@@ -138,10 +171,38 @@ bool Settings::usePositionTexture() const {
     return _usePositionTexture;
 }
 
+bool Settings::useLayeredCubemapRendering() const {
+    return _useLayeredCubemapRendering;
+}
+
+Settings::CubemapResolution Settings::cubemapResolution() const {
+    return _cubemapResolution;
+}
+
+int64_t Settings::cubemapPixelBudget() const {
+    return _cubemapPixelBudget;
+}
+
 int Settings::numberCaptureThreads() const {
     return _nCaptureThreads;
 }
 
+int Settings::numberTextureLoadThreads() const {
+    return _nTextureLoadThreads;
+}
+
+double Settings::textureUploadBudget() const {
+    return _textureUploadBudget;
+}
+
+size_t Settings::textureMemoryBudget() const {
+    return _textureMemoryBudget;
+}
+
+const std::filesystem::path& Settings::textureCachePath() const {
+    return _textureCachePath;
+}
+
 Settings::DrawBufferType Settings::drawBufferType() const {
     if (_usePositionTexture) {
         if (_useNormalTexture) {
@@ -193,6 +254,47 @@ void Settings::setExportWarpingMeshes(bool state) {
     _exportWarpingMeshes = state;
 }
 
+void Settings::setUseWarpingMeshCache(bool state) {
+    _useWarpingMeshCache = state;
+}
+
+void Settings::setWarpingMeshSimplificationError(float error) {
+    _warpingMeshSimplificationError = std::max(error, 0.f);
+}
+
+void Settings::setUseWarpingLookupTexture(bool state) {
+    _useWarpingLookupTexture = state;
+}
+
+void Settings::setOptimizeWarpingMeshes(bool state) {
+    _optimizeWarpingMeshes = state;
+}
+
+void Settings::setUseCompactWarpingMeshVertices(bool state) {
+    _useCompactWarpingMeshVertices = state;
+}
+
+void Settings::setHotReload(HotReload hotReload) {
+    _hotReload = hotReload;
+}
+
+void Settings::setUseEventDrivenTracking(bool state) {
+    _useEventDrivenTracking = state;
+}
+
+void Settings::setTrackingRecordPath(std::filesystem::path path) {
+    _trackingRecordPath = std::move(path);
+}
+
+void Settings::setTrackingReplay(std::filesystem::path path, TrackingReplaySpeed speed) {
+    _trackingReplayPath = std::move(path);
+    _trackingReplaySpeed = speed;
+}
+
+void Settings::setUseHeadlessRendering(bool state) {
+    _useHeadlessRendering = state;
+}
+
 void Settings::setAddNodeNameToScreenshot(bool state) {
     _screenshot.addNodeName = state;
 }
@@ -205,6 +307,50 @@ bool Settings::exportWarpingMeshes() const {
     return _exportWarpingMeshes;
 }
 
+bool Settings::useWarpingMeshCache() const {
+    return _useWarpingMeshCache;
+}
+
+float Settings::warpingMeshSimplificationError() const {
+    return _warpingMeshSimplificationError;
+}
+
+bool Settings::useWarpingLookupTexture() const {
+    return _useWarpingLookupTexture;
+}
+
+bool Settings::optimizeWarpingMeshes() const {
+    return _optimizeWarpingMeshes;
+}
+
+bool Settings::useCompactWarpingMeshVertices() const {
+    return _useCompactWarpingMeshVertices;
+}
+
+Settings::HotReload Settings::hotReload() const {
+    return _hotReload;
+}
+
+bool Settings::useEventDrivenTracking() const {
+    return _useEventDrivenTracking;
+}
+
+const std::filesystem::path& Settings::trackingRecordPath() const {
+    return _trackingRecordPath;
+}
+
+const std::filesystem::path& Settings::trackingReplayPath() const {
+    return _trackingReplayPath;
+}
+
+Settings::TrackingReplaySpeed Settings::trackingReplaySpeed() const {
+    return _trackingReplaySpeed;
+}
+
+bool Settings::useHeadlessRendering() const {
+    return _useHeadlessRendering;
+}
+
 bool Settings::captureFromBackBuffer() const {
     return _captureBackBuffer;
 }
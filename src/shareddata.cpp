@@ -10,10 +10,20 @@
 
 #include <sgct/log.h>
 #include <sgct/profiling.h>
+#include <sgct/settings.h>
 #include <zlib.h>
 #include <cstring>
 #include <string>
 
+namespace {
+    // The wire format of the synchronization only changes if the master tells the
+    // clients to reload their files, which requires the same setting on all nodes
+    bool isSendingReloadCounter() {
+        return sgct::Settings::instance().hotReload() ==
+            sgct::Settings::HotReload::Cluster;
+    }
+} // namespace
+
 namespace sgct {
 
 SharedData* SharedData::_instance = nullptr;
@@ -69,6 +79,16 @@ void SharedData::decode(const char* receivedData, int receivedLength) {
         );
     }
 
+    // The reload counter precedes the application's data if it is sent at all
+    constexpr int CounterSize = static_cast<int>(sizeof(uint32_t));
+    if (isSendingReloadCounter() && receivedLength >= CounterSize) {
+        uint32_t counter = 0;
+        std::memcpy(&counter, receivedData, sizeof(uint32_t));
+        _reloadCounter = counter;
+        receivedData += sizeof(uint32_t);
+        receivedLength -= CounterSize;
+    }
+
     if (_decodeFn) {
         std::vector<std::byte> data;
         data.assign(
@@ -91,6 +111,9 @@ void SharedData::encode() {
             _headerSpace.cbegin(),
             _headerSpace.cbegin() + Network::HeaderSize
         );
+        if (isSendingReloadCounter()) {
+            serializeObject(_dataBlock, _reloadCounter.load());
+        }
     }
 
     if (_encodeFn) {
@@ -111,6 +134,14 @@ int SharedData::bufferSize() {
     return static_cast<int>(_dataBlock.capacity());
 }
 
+void SharedData::setReloadCounter(uint32_t counter) {
+    _reloadCounter = counter;
+}
+
+uint32_t SharedData::reloadCounter() const {
+    return _reloadCounter;
+}
+
 template <>
 void serializeObject(std::vector<std::byte>& buffer, std::string_view value) {
     uint32_t length = static_cast<uint32_t>(value.size());
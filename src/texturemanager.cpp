@@ -8,18 +8,65 @@
 
 #include <sgct/texturemanager.h>
 
+#include <sgct/compressedimage.h>
+#include <sgct/engine.h>
+#include <sgct/fileutils.h>
 #include <sgct/format.h>
 #include <sgct/image.h>
 #include <sgct/log.h>
+#include <sgct/mappedfile.h>
 #include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <sgct/settings.h>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
 
 namespace {
-    unsigned int uploadImage(const sgct::Image& img, bool interpolate, int mipmap,
-                             float anisotropicFilterSize)
+    void setTextureParameters(bool interpolate, int mipmap, float anisotropicFilterSize) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, std::max(mipmap - 1, 0));
+
+        if (mipmap > 1) {
+            glTexParameteri(
+                GL_TEXTURE_2D,
+                GL_TEXTURE_MIN_FILTER,
+                interpolate ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR
+            );
+            glTexParameteri(
+                GL_TEXTURE_2D,
+                GL_TEXTURE_MAG_FILTER,
+                interpolate ? GL_LINEAR : GL_NEAREST
+            );
+            glTexParameterf(
+                GL_TEXTURE_2D,
+                GL_TEXTURE_MAX_ANISOTROPY_EXT,
+                anisotropicFilterSize
+            );
+        }
+        else {
+            glTexParameteri(
+                GL_TEXTURE_2D,
+                GL_TEXTURE_MIN_FILTER,
+                interpolate ? GL_LINEAR : GL_NEAREST
+            );
+            glTexParameteri(
+                GL_TEXTURE_2D,
+                GL_TEXTURE_MAG_FILTER,
+                interpolate ? GL_LINEAR : GL_NEAREST
+            );
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    void specifyTexture(unsigned int tex, sgct::ivec2 size, int channels,
+                        const void* data, bool interpolate, int mipmap,
+                        float anisotropicFilterSize)
     {
-        unsigned int tex = 0;
-        glGenTextures(1, &tex);
         glBindTexture(GL_TEXTURE_2D, tex);
 
         const auto [type, internalFormat] = [](int c) -> std::pair<GLenum, GLenum> {
@@ -30,72 +77,282 @@ namespace {
                 case 4: return { GL_BGRA, GL_RGBA8 };
                 default: throw std::logic_error("Unhandled case label");
             }
-        }(img.channels());
+        }(channels);
 
         sgct::Log::Debug(std::format(
             "Creating texture. Size: {}x{}, {}-channels, Type: {:#04x}, Format: {:#04x}",
-            img.size().x, img.size().y, img.channels(), type, internalFormat
+            size.x, size.y, channels, type, internalFormat
         ));
 
         glPixelStorei(GL_PACK_ALIGNMENT, 1);
         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
+        // If a pixel unpack buffer is bound, 'data' is an offset into that buffer
         constexpr GLenum Format = GL_UNSIGNED_BYTE;
         glTexImage2D(
             GL_TEXTURE_2D,
             0,
             internalFormat,
-            img.size().x,
-            img.size().y,
+            size.x,
+            size.y,
             0,
             type,
             Format,
-            img.data()
+            data
         );
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipmap - 1);
-
         if (mipmap > 1) {
             glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        setTextureParameters(interpolate, mipmap, anisotropicFilterSize);
+    }
 
-            glTexParameteri(
-                GL_TEXTURE_2D,
-                GL_TEXTURE_MIN_FILTER,
-                interpolate ? GL_LINEAR_MIPMAP_LINEAR : GL_NEAREST_MIPMAP_LINEAR
-            );
-            glTexParameteri(
-                GL_TEXTURE_2D,
-                GL_TEXTURE_MAG_FILTER,
-                interpolate ? GL_LINEAR : GL_NEAREST
-            );
-            glTexParameterf(
+    unsigned int uploadImage(const sgct::Image& img, bool interpolate, int mipmap,
+                             float anisotropicFilterSize)
+    {
+        unsigned int tex = 0;
+        glGenTextures(1, &tex);
+        specifyTexture(
+            tex,
+            img.size(),
+            img.channels(),
+            img.data(),
+            interpolate,
+            mipmap,
+            anisotropicFilterSize
+        );
+        return tex;
+    }
+
+    bool isCompressedFile(const std::filesystem::path& path) {
+        std::string ext = path.extension().string();
+        std::transform(
+            ext.begin(),
+            ext.end(),
+            ext.begin(),
+            [](char c) { return static_cast<char>(::tolower(c)); }
+        );
+        return ext == ".dds" || ext == ".ktx2";
+    }
+
+    // Returns the number of mipmap levels of the compressed image that are uploaded
+    int nCompressedLevels(const sgct::CompressedImage& img, int mipmapLevels) {
+        const int nLevels = static_cast<int>(img.levels().size());
+        return std::clamp(mipmapLevels, 1, nLevels);
+    }
+
+    void specifyCompressedTexture(unsigned int tex, const sgct::CompressedImage& img,
+                                  bool interpolate, int mipmap,
+                                  float anisotropicFilterSize)
+    {
+        // The S3TC formats are part of an extension that is not in the core profile
+        constexpr GLenum CompressedRGBADXT1 = 0x83F1;
+        constexpr GLenum CompressedRGBADXT5 = 0x83F3;
+
+        glBindTexture(GL_TEXTURE_2D, tex);
+
+        const GLenum internalFormat = [](sgct::CompressedImage::Format f) {
+            switch (f) {
+                case sgct::CompressedImage::Format::BC1: return CompressedRGBADXT1;
+                case sgct::CompressedImage::Format::BC3: return CompressedRGBADXT5;
+                case sgct::CompressedImage::Format::BC7:
+                    return static_cast<GLenum>(GL_COMPRESSED_RGBA_BPTC_UNORM);
+                default: throw std::logic_error("Unhandled case label");
+            }
+        }(img.format());
+
+        const int nLevels = nCompressedLevels(img, mipmap);
+        sgct::Log::Debug(std::format(
+            "Creating compressed texture. Size: {}x{}, Levels: {}, Format: {:#04x}",
+            img.size().x, img.size().y, nLevels, internalFormat
+        ));
+
+        // The mipmaps are stored in the file, so they don't have to be generated
+        for (int i = 0; i < nLevels; i++) {
+            const sgct::CompressedImage::Level& level = img.levels()[i];
+            glCompressedTexImage2D(
                 GL_TEXTURE_2D,
-                GL_TEXTURE_MAX_ANISOTROPY_EXT,
-                anisotropicFilterSize
+                i,
+                internalFormat,
+                level.size.x,
+                level.size.y,
+                0,
+                static_cast<GLsizei>(level.data.size()),
+                level.data.data()
             );
         }
-        else {
-            glTexParameteri(
-                GL_TEXTURE_2D,
-                GL_TEXTURE_MIN_FILTER,
-                interpolate ? GL_LINEAR : GL_NEAREST
-            );
-            glTexParameteri(
-                GL_TEXTURE_2D,
-                GL_TEXTURE_MAG_FILTER,
-                interpolate ? GL_LINEAR : GL_NEAREST
-            );
+        setTextureParameters(interpolate, nLevels, anisotropicFilterSize);
+    }
+
+    size_t compressedMemory(const sgct::CompressedImage& img, int mipmapLevels) {
+        size_t res = 0;
+        for (int i = 0; i < nCompressedLevels(img, mipmapLevels); i++) {
+            res += img.levels()[i].data.size();
         }
+        return res;
+    }
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    size_t estimateMemory(sgct::ivec2 size, int channels, int mipmapLevels) {
+        // Drivers store three channel textures with four channels internally
+        const size_t bytesPerPixel = channels == 3 ? 4 : static_cast<size_t>(channels);
+        const size_t base = static_cast<size_t>(size.x) * size.y * bytesPerPixel;
+        // A full mipmap chain adds a third of the base level
+        return mipmapLevels > 1 ? base + base / 3 : base;
+    }
 
-        return tex;
+    // Identifies the contents of a file by its canonical path and its modification time
+    std::string fileKey(const std::filesystem::path& path) {
+        std::error_code ec;
+        std::filesystem::path p = std::filesystem::weakly_canonical(path, ec);
+        if (ec) {
+            p = path;
+        }
+        const auto time = std::filesystem::last_write_time(p, ec);
+        const long long t = ec ? 0 : time.time_since_epoch().count();
+        return std::format("{}|{}", p, t);
+    }
+
+    std::string cacheKey(const std::filesystem::path& path, bool interpolate,
+                         float anisotropicFilterSize, int mipmapLevels)
+    {
+        return std::format(
+            "{}|{}|{}|{}", fileKey(path), interpolate, anisotropicFilterSize, mipmapLevels
+        );
+    }
+
+    //
+    // The file format for decoded images consists of the CacheHeader, followed by the
+    // key of the source file that the image was decoded from (to guard against hash
+    // collisions and stale files), followed by the raw pixel data as stored in the Image
+    //
+    constexpr std::array<char, 4> CacheMagic = { 'S', 'G', 'T', 'X' };
+    constexpr uint32_t CacheVersion = 1;
+
+    struct CacheHeader {
+        std::array<char, 4> magic = CacheMagic;
+        uint32_t version = CacheVersion;
+        uint32_t keyLength = 0;
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t channels = 0;
+        int32_t bytesPerChannel = 0;
+    };
+
+    std::filesystem::path cacheFile(const std::filesystem::path& folder,
+                                    const std::string& key)
+    {
+        return folder / std::format("{:016x}.sgcttex", std::hash<std::string>()(key));
+    }
+
+    bool readCachedImage(const std::filesystem::path& file, const std::string& key,
+                         sgct::Image& img)
+    {
+        const sgct::MappedFile f = sgct::MappedFile(file);
+        if (!f.isOpen() || f.size() < sizeof(CacheHeader)) {
+            return false;
+        }
+
+        CacheHeader header;
+        std::memcpy(&header, f.data(), sizeof(CacheHeader));
+        if (header.magic != CacheMagic || header.version != CacheVersion ||
+            header.keyLength != key.size() || header.width <= 0 || header.height <= 0 ||
+            header.channels < 1 || header.channels > 4 || header.bytesPerChannel < 1)
+        {
+            return false;
+        }
+
+        const std::byte* keyData = f.data() + sizeof(CacheHeader);
+        const size_t nBytes = static_cast<size_t>(header.width) * header.height *
+            header.channels * header.bytesPerChannel;
+        if (f.size() != sizeof(CacheHeader) + key.size() + nBytes ||
+            std::memcmp(keyData, key.data(), key.size()) != 0)
+        {
+            return false;
+        }
+
+        img.setSize(sgct::ivec2(header.width, header.height));
+        img.setChannels(header.channels);
+        img.setBytesPerChannel(header.bytesPerChannel);
+        img.allocateOrResizeData();
+        std::memcpy(img.data(), keyData + key.size(), nBytes);
+        return true;
+    }
+
+    void writeCachedImage(const std::filesystem::path& file, const std::string& key,
+                          const sgct::Image& img)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(file.parent_path(), ec);
+
+        CacheHeader header;
+        header.keyLength = static_cast<uint32_t>(key.size());
+        header.width = img.size().x;
+        header.height = img.size().y;
+        header.channels = img.channels();
+        header.bytesPerChannel = img.bytesPerChannel();
+        const size_t nBytes = static_cast<size_t>(header.width) * header.height *
+            header.channels * header.bytesPerChannel;
+
+        // Write to a temporary file first so that a concurrent reader never sees a
+        // partially written file
+        const std::filesystem::path tmp = temporaryPath(file);
+        {
+            std::ofstream out = std::ofstream(tmp, std::ofstream::binary);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+            out.write(key.data(), key.size());
+            out.write(reinterpret_cast<const char*>(img.data()), nBytes);
+            if (!out.good()) {
+                sgct::Log::Warning(
+                    std::format("Could not write texture cache '{}'", tmp)
+                );
+                out.close();
+                std::filesystem::remove(tmp, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(tmp, file, ec);
+        if (ec) {
+            std::filesystem::remove(tmp, ec);
+        }
+    }
+
+    void loadImage(const std::filesystem::path& path,
+                   const std::filesystem::path& cacheFolder, sgct::Image& img)
+    {
+        if (cacheFolder.empty()) {
+            img.load(path);
+            return;
+        }
+
+        const std::string key = fileKey(path);
+        const std::filesystem::path file = cacheFile(cacheFolder, key);
+        if (readCachedImage(file, key, img)) {
+            sgct::Log::Debug(std::format("Loaded '{}' from texture cache", path));
+            return;
+        }
+
+        img.load(path);
+        writeCachedImage(file, key, img);
     }
 } // namespace
 
 namespace sgct {
 
+struct TextureManager::PendingTexture {
+    unsigned int id = 0;
+    std::filesystem::path path;
+    bool interpolate = true;
+    float anisotropicFilterSize = 1.f;
+    int mipmapLevels = 8;
+    std::filesystem::path cacheFolder;
+
+    std::promise<void> promise;
+
+    // Set by the decode thread, either one of the images or the error is valid
+    std::unique_ptr<Image> image;
+    std::unique_ptr<CompressedImage> compressed;
+    std::exception_ptr error;
+};
+
 TextureManager* TextureManager::_instance = nullptr;
 
 TextureManager& TextureManager::instance() {
@@ -111,28 +368,71 @@ void TextureManager::destroy() {
 }
 
 TextureManager::~TextureManager() {
-    glDeleteTextures(static_cast<GLsizei>(_textures.size()), _textures.data());
+    {
+        const std::unique_lock lock(_pendingMutex);
+        _isShuttingDown = true;
+    }
+    _decodeCondition.notify_all();
+    for (std::thread& thread : _decodeThreads) {
+        thread.join();
+    }
+
+    for (StagingBuffer& buffer : _stagingBuffers) {
+        if (buffer.fence) {
+            glDeleteSync(static_cast<GLsync>(buffer.fence));
+        }
+        glDeleteBuffers(1, &buffer.pbo);
+    }
+
+    for (const std::pair<const unsigned int, TextureInfo>& p : _textures) {
+        glDeleteTextures(1, &p.first);
+    }
 }
 
 unsigned int TextureManager::loadTexture(const std::filesystem::path& filename,
                                          bool interpolate, float anisotropicFilterSize,
                                          int mipmapLevels)
 {
+    std::string key =
+        cacheKey(filename, interpolate, anisotropicFilterSize, mipmapLevels);
+    if (const unsigned int cached = acquireCachedTexture(key); cached != 0) {
+        Log::Debug(std::format("Reusing texture for '{}' [id={}]", filename, cached));
+        return cached;
+    }
+
+    if (isCompressedFile(filename)) {
+        // Block-compressed files are uploaded as they are and bypass the texture cache on
+        // disk, but the texture is shared with later loads of the same file like others
+        CompressedImage img;
+        img.load(filename);
+        unsigned int t = 0;
+        glGenTextures(1, &t);
+        specifyCompressedTexture(
+            t,
+            img,
+            interpolate,
+            mipmapLevels,
+            anisotropicFilterSize
+        );
+        addTexture(t, std::move(key), compressedMemory(img, mipmapLevels));
+        evictTextures();
+        Log::Debug(std::format("Texture created from '{}' [id={}]", filename, t));
+        return t;
+    }
+
     // load image
     Image img;
-    img.load(filename);
+    loadImage(filename, Settings::instance().textureCachePath(), img);
 
     if (img.data() == nullptr) {
         // image data not valid
         return 0;
     }
 
-    unsigned int t = loadTexture(
-        img,
-        interpolate,
-        anisotropicFilterSize,
-        mipmapLevels
-    );
+    const GLuint t = uploadImage(img, interpolate, mipmapLevels, anisotropicFilterSize);
+    const size_t memory = estimateMemory(img.size(), img.channels(), mipmapLevels);
+    addTexture(t, std::move(key), memory);
+    evictTextures();
     Log::Debug(std::format("Texture created from '{}' [id={}]", filename, t));
     return t;
 }
@@ -141,18 +441,349 @@ unsigned int TextureManager::loadTexture(const Image& img, bool interpolate,
                                          float anisotropicFilterSize, int mipmapLevels)
 {
     const GLuint t = uploadImage(img, interpolate, mipmapLevels, anisotropicFilterSize);
-    _textures.push_back(t);
-
+    addTexture(t, "", estimateMemory(img.size(), img.channels(), mipmapLevels));
+    evictTextures();
     return t;
 }
 
-void TextureManager::removeTexture(unsigned int textureId) {
-    _textures.erase(
-        std::remove(_textures.begin(), _textures.end(), textureId),
-        _textures.end()
+TextureManager::AsyncTexture TextureManager::loadTextureAsync(std::filesystem::path path,
+                                                              bool interpolate,
+                                                              float anisotropicFilterSize,
+                                                              int mipmapLevels)
+{
+    ZoneScoped;
+
+    std::string key = cacheKey(path, interpolate, anisotropicFilterSize, mipmapLevels);
+    if (const unsigned int cached = acquireCachedTexture(key); cached != 0) {
+        AsyncTexture res;
+        res.id = cached;
+        res.loaded = _textures[cached].loaded;
+        if (!res.loaded.valid()) {
+            // The texture was loaded synchronously, so it is ready already
+            std::promise<void> promise;
+            promise.set_value();
+            res.loaded = promise.get_future().share();
+        }
+        return res;
+    }
+
+    // The placeholder is a single mid-gray texel that is replaced by the image once it
+    // has been decoded. Creating the texture here means that the caller can use the
+    // OpenGL name right away without having to care whether the upload has finished
+    constexpr std::array<unsigned char, 4> Placeholder = { 128, 128, 128, 255 };
+    unsigned int tex = 0;
+    glGenTextures(1, &tex);
+    specifyTexture(tex, ivec2(1, 1), 4, Placeholder.data(), interpolate, 1, 1.f);
+
+    auto pending = std::make_unique<PendingTexture>();
+    pending->id = tex;
+    pending->path = std::move(path);
+    pending->interpolate = interpolate;
+    pending->anisotropicFilterSize = anisotropicFilterSize;
+    pending->mipmapLevels = mipmapLevels;
+    pending->cacheFolder = Settings::instance().textureCachePath();
+
+    AsyncTexture res;
+    res.id = tex;
+    res.loaded = pending->promise.get_future().share();
+
+    const size_t memory = estimateMemory(ivec2(1, 1), 4, 1);
+    TextureInfo& info = addTexture(tex, std::move(key), memory);
+    info.isPending = true;
+    info.loaded = res.loaded;
+
+    {
+        const std::unique_lock lock(_pendingMutex);
+        if (_decodeThreads.empty()) {
+            const int nThreads = Settings::instance().numberTextureLoadThreads();
+            Log::Debug(std::format("Starting {} texture load threads", nThreads));
+            for (int i = 0; i < nThreads; i++) {
+                _decodeThreads.emplace_back(&TextureManager::decodeLoop, this);
+            }
+        }
+        _decodeQueue.push_back(std::move(pending));
+        _nPendingTextures++;
+    }
+    _decodeCondition.notify_one();
+
+    return res;
+}
+
+void TextureManager::decodeLoop() {
+    while (true) {
+        std::unique_ptr<PendingTexture> texture;
+        {
+            std::unique_lock lock(_pendingMutex);
+            _decodeCondition.wait(
+                lock,
+                [this]() { return _isShuttingDown || !_decodeQueue.empty(); }
+            );
+            if (_isShuttingDown) {
+                return;
+            }
+            texture = std::move(_decodeQueue.front());
+            _decodeQueue.pop_front();
+        }
+
+        try {
+            if (isCompressedFile(texture->path)) {
+                texture->compressed = std::make_unique<CompressedImage>();
+                texture->compressed->load(texture->path);
+            }
+            else {
+                texture->image = std::make_unique<Image>();
+                loadImage(texture->path, texture->cacheFolder, *texture->image);
+            }
+        }
+        catch (...) {
+            texture->image = nullptr;
+            texture->compressed = nullptr;
+            texture->error = std::current_exception();
+        }
+
+        const std::unique_lock lock(_pendingMutex);
+        _uploadQueue.push_back(std::move(texture));
+    }
+}
+
+void TextureManager::processUploads() {
+    ZoneScoped;
+
+    const double budget = Settings::instance().textureUploadBudget() / 1000.0;
+    const double t0 = time();
+    bool isFirst = true;
+    while (isFirst || time() - t0 < budget) {
+        std::unique_ptr<PendingTexture> texture;
+        {
+            const std::unique_lock lock(_pendingMutex);
+            if (_uploadQueue.empty()) {
+                return;
+            }
+            texture = std::move(_uploadQueue.front());
+            _uploadQueue.pop_front();
+        }
+        isFirst = false;
+
+        TextureInfo& info = _textures[texture->id];
+        if (info.refCount == 0) {
+            // The texture was removed while its image was being decoded
+            texture->promise.set_value();
+        }
+        else if (texture->error) {
+            Log::Error(std::format("Failed to load texture '{}'", texture->path));
+            texture->promise.set_exception(texture->error);
+
+            // Later loads of the same file should try again rather than receive the
+            // placeholder. Without a key, the placeholder is deleted once it is released
+            const auto cacheIt = _cache.find(info.key);
+            if (cacheIt != _cache.end() && cacheIt->second == texture->id) {
+                _cache.erase(cacheIt);
+            }
+            info.key.clear();
+        }
+        else if (texture->compressed) {
+            // Compressed images are small enough to be uploaded directly
+            const CompressedImage& img = *texture->compressed;
+            specifyCompressedTexture(
+                texture->id,
+                img,
+                texture->interpolate,
+                texture->mipmapLevels,
+                texture->anisotropicFilterSize
+            );
+            Log::Debug(std::format(
+                "Texture created from '{}' [id={}]", texture->path, texture->id
+            ));
+            _memoryUsage -= info.memory;
+            info.memory = compressedMemory(img, texture->mipmapLevels);
+            _memoryUsage += info.memory;
+            texture->promise.set_value();
+        }
+        else if (uploadPendingTexture(*texture)) {
+            Log::Debug(std::format(
+                "Texture created from '{}' [id={}]", texture->path, texture->id
+            ));
+            const Image& img = *texture->image;
+            _memoryUsage -= info.memory;
+            const int mipmaps = texture->mipmapLevels;
+            info.memory = estimateMemory(img.size(), img.channels(), mipmaps);
+            _memoryUsage += info.memory;
+            texture->promise.set_value();
+        }
+        else {
+            // All staging buffers are still in use by the GPU, so we try again next frame
+            const std::unique_lock lock(_pendingMutex);
+            _uploadQueue.push_front(std::move(texture));
+            return;
+        }
+
+        info.isPending = false;
+        evictTextures();
+
+        const std::unique_lock lock(_pendingMutex);
+        _nPendingTextures--;
+    }
+}
+
+bool TextureManager::uploadPendingTexture(PendingTexture& texture) {
+    ZoneScoped;
+
+    const Image& img = *texture.image;
+    const size_t nBytes = static_cast<size_t>(img.size().x) * img.size().y *
+        img.channels() * img.bytesPerChannel();
+
+    StagingBuffer& buffer = _stagingBuffers[_nextStagingBuffer];
+    if (buffer.fence) {
+        GLsync fence = static_cast<GLsync>(buffer.fence);
+        if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED) {
+            return false;
+        }
+        glDeleteSync(fence);
+        buffer.fence = nullptr;
+    }
+    if (buffer.pbo == 0) {
+        glGenBuffers(1, &buffer.pbo);
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer.pbo);
+    if (buffer.size < nBytes) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, nBytes, nullptr, GL_STREAM_DRAW);
+        buffer.size = nBytes;
+    }
+
+    // The fence guarantees that the GPU is done reading from this buffer, so we don't
+    // need the driver to synchronize the mapping for us
+    void* ptr = glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER,
+        0,
+        nBytes,
+        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT
     );
+    bool isMapped = false;
+    if (ptr) {
+        std::memcpy(ptr, img.data(), nBytes);
+        isMapped = glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE;
+    }
 
-    glDeleteTextures(1, &textureId);
+    if (!isMapped) {
+        // Fall back to uploading directly from the image if the mapping failed
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+    specifyTexture(
+        texture.id,
+        img.size(),
+        img.channels(),
+        isMapped ? nullptr : img.data(),
+        texture.interpolate,
+        texture.mipmapLevels,
+        texture.anisotropicFilterSize
+    );
+
+    if (isMapped) {
+        buffer.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        _nextStagingBuffer = (_nextStagingBuffer + 1) % _stagingBuffers.size();
+    }
+    return true;
+}
+
+int TextureManager::numberOfPendingTextures() const {
+    const std::unique_lock lock(_pendingMutex);
+    return _nPendingTextures;
+}
+
+void TextureManager::removeTexture(unsigned int textureId) {
+    const auto it = _textures.find(textureId);
+    if (it == _textures.end()) {
+        // Not created by the texture manager, so there is no reference to release
+        glDeleteTextures(1, &textureId);
+        return;
+    }
+
+    it->second.refCount = std::max(it->second.refCount - 1, 0);
+    it->second.lastUsed = ++_usageCounter;
+    evictTextures();
+}
+
+size_t TextureManager::memoryUsage() const {
+    return _memoryUsage;
+}
+
+size_t TextureManager::memoryUsage(unsigned int textureId) const {
+    const auto it = _textures.find(textureId);
+    return it != _textures.end() ? it->second.memory : 0;
+}
+
+unsigned int TextureManager::acquireCachedTexture(const std::string& key) {
+    const auto it = _cache.find(key);
+    if (it == _cache.end()) {
+        return 0;
+    }
+
+    TextureInfo& info = _textures[it->second];
+    info.refCount++;
+    info.lastUsed = ++_usageCounter;
+    return it->second;
+}
+
+TextureManager::TextureInfo& TextureManager::addTexture(unsigned int textureId,
+                                                        std::string key, size_t memory)
+{
+    if (!key.empty()) {
+        // If the file changed on disk, the key is different and the outdated texture
+        // is evicted eventually as nobody can acquire it anymore
+        _cache[key] = textureId;
+    }
+
+    TextureInfo& info = _textures[textureId];
+    info.key = std::move(key);
+    info.refCount = 1;
+    info.memory = memory;
+    info.lastUsed = ++_usageCounter;
+    _memoryUsage += memory;
+    return info;
+}
+
+void TextureManager::evictTextures() {
+    const size_t budget = Settings::instance().textureMemoryBudget();
+
+    while (true) {
+        // Find the least recently used texture that is no longer referenced. Textures
+        // that are not in the cache can never be requested again and are always removed
+        auto lru = _textures.end();
+        for (auto it = _textures.begin(); it != _textures.end(); it++) {
+            const TextureInfo& info = it->second;
+            if (info.refCount > 0 || info.isPending) {
+                continue;
+            }
+            if (info.key.empty()) {
+                lru = it;
+                break;
+            }
+            const bool isOlder = lru == _textures.end() ||
+                info.lastUsed < lru->second.lastUsed;
+            if (_memoryUsage > budget && isOlder) {
+                lru = it;
+            }
+        }
+
+        if (lru == _textures.end()) {
+            return;
+        }
+
+        Log::Debug(std::format(
+            "Deleting texture [id={}] ({} bytes)", lru->first, lru->second.memory
+        ));
+        glDeleteTextures(1, &lru->first);
+        _memoryUsage -= lru->second.memory;
+        if (!lru->second.key.empty()) {
+            const auto cacheIt = _cache.find(lru->second.key);
+            if (cacheIt != _cache.end() && cacheIt->second == lru->first) {
+                _cache.erase(cacheIt);
+            }
+        }
+        _textures.erase(lru);
+    }
 }
 
 } // namespace sgct
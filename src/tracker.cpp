@@ -11,11 +11,11 @@
 #include <sgct/engine.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
-#include <sgct/mutexes.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
+#include <cstring>
 
 namespace sgct {
 
@@ -55,14 +55,14 @@ TrackingDevice* Tracker::deviceBySensorId(int id) const {
 }
 
 void Tracker::setOrientation(quat q) {
-    const std::unique_lock lock(mutex::Tracking);
-
     // create inverse rotation matrix
     glm::mat4 orientation = glm::inverse(glm::mat4_cast(glm::make_quat(&q.x)));
     std::memcpy(&_orientation, glm::value_ptr(orientation), 16 * sizeof(float));
 
     glm::mat4 transMat = glm::translate(glm::mat4(1.f), glm::make_vec3(&_offset.x));
-    std::memcpy(&_transform, glm::value_ptr(transMat), 16 * sizeof(float));
+    mat4 transform;
+    std::memcpy(&transform, glm::value_ptr(transMat), 16 * sizeof(float));
+    _transform.store(transform);
 }
 
 void Tracker::setOrientation(float xRot, float yRot, float zRot) {
@@ -74,36 +74,41 @@ void Tracker::setOrientation(float xRot, float yRot, float zRot) {
 }
 
 void Tracker::setOffset(vec3 offset) {
-    const std::unique_lock lock(mutex::Tracking);
     _offset = std::move(offset);
     glm::mat4 trans =
         glm::translate(glm::mat4(1.f), glm::make_vec3(&_offset.x)) *
         glm::make_mat4(_orientation.values);
-    std::memcpy(&_transform, glm::value_ptr(trans), 16 * sizeof(float));
+    mat4 transform;
+    std::memcpy(&transform, glm::value_ptr(trans), 16 * sizeof(float));
+    _transform.store(transform);
 }
 
 void Tracker::setScale(double scaleVal) {
-    const std::unique_lock lock(mutex::Tracking);
     if (scaleVal > 0.0) {
         _scale = scaleVal;
     }
 }
 
 void Tracker::setTransform(mat4 mat) {
-    const std::unique_lock lock(mutex::Tracking);
-    _transform = std::move(mat);
+    _transform.store(mat);
 }
 
 mat4 Tracker::getTransform() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _transform;
+    return _transform.load();
 }
 
 double Tracker::scale() const {
-    const std::unique_lock lock(mutex::Tracking);
     return _scale;
 }
 
+void Tracker::setPrediction(std::optional<config::Tracker::Prediction> prediction) {
+    _prediction = std::move(prediction);
+}
+
+const std::optional<config::Tracker::Prediction>& Tracker::prediction() const {
+    return _prediction;
+}
+
 const std::string& Tracker::name() const {
     return _name;
 }
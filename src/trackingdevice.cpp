@@ -12,7 +12,6 @@
 #include <sgct/engine.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
-#include <sgct/mutexes.h>
 #include <sgct/tracker.h>
 #ifdef SGCT_HAS_VRPN
 #include <sgct/trackingmanager.h>
@@ -21,6 +20,8 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <algorithm>
+#include <cstring>
+#include <limits>
 
 namespace sgct {
 
@@ -32,7 +33,6 @@ TrackingDevice::TrackingDevice([[maybe_unused]] int parentIndex, std::string nam
 {}
 
 void TrackingDevice::setEnabled(bool state) {
-    const std::unique_lock lock(mutex::Tracking);
     _isEnabled = state;
 }
 
@@ -41,56 +41,51 @@ void TrackingDevice::setSensorId(int id) {
 }
 
 void TrackingDevice::setNumberOfButtons(int numOfButtons) {
-    _buttons.resize(numOfButtons, false);
-    _buttonsPrevious.resize(numOfButtons, false);
-    _buttonTime.resize(numOfButtons, 0.0);
-    _buttonTimePrevious.resize(numOfButtons, 0.0);
+    _buttons = std::make_unique<SeqLock<Button>[]>(numOfButtons);
     _nButtons = numOfButtons;
 }
 
 void TrackingDevice::setNumberOfAxes(int numOfAxes) {
-    _axes.resize(numOfAxes, 0.0);
-    _axesPrevious.resize(numOfAxes, 0.0);
+    _axes = std::make_unique<SeqLock<Axis>[]>(numOfAxes);
     _nAxes = numOfAxes;
 }
 
-void TrackingDevice::setSensorTransform(vec3 vec, quat rot) {
-#ifdef SGCT_HAS_VRPN
-    Tracker* parent = TrackingManager::instance().trackers()[_parentIndex].get();
-#else
-    Tracker* parent = nullptr;
-#endif
-
-    if (parent == nullptr) {
-        Log::Error(std::format("Error getting handle to tracker for device '{}'", _name));
+void TrackingDevice::setSensorTransform(vec3 vec, quat rot,
+                                        std::optional<double> sourceTime)
+{
+    const double t = time();
+
+    // Only the sampling thread writes the history, so the number of samples can be
+    // incremented after the entry was written
+    const uint64_t n = _nSamples.load(std::memory_order_relaxed);
+    HistoryEntry entry;
+    entry.sample.sensorPosition = vec;
+    entry.sample.sensorRotation = rot;
+    entry.sample.sourceTime = sourceTime.value_or(t);
+    entry.sample.receiveTime = t;
+    entry.index = n;
+    _history[n % HistorySize].store(entry);
+    _nSamples.store(n + 1, std::memory_order_release);
+
+    const std::optional<mat4> m = sensorToWorld(vec, rot);
+    if (!m) {
         return;
     }
 
-    const glm::mat4 parentTrans = glm::make_mat4(parent->getTransform().values);
-
-    // create matrixes
-    const glm::mat4 sensorTransMat = glm::translate(
-        glm::mat4(1.f),
-        glm::make_vec3(&vec.x)
-    );
-    const glm::mat4 sensorRotMat = glm::mat4_cast(glm::make_quat(&rot.x));
-
-    {
-        const std::unique_lock lock(mutex::Tracking);
-
+    _pose.update([&](Pose& pose) {
         // swap
-        _sensorRotationPrevious = std::move(_sensorRotation);
-        _sensorRotation = std::move(rot);
+        pose.sensorRotationPrevious = pose.sensorRotation;
+        pose.sensorRotation = rot;
 
-        _sensorPosPrevious = std::move(_sensorPos);
-        _sensorPos = std::move(vec);
+        pose.sensorPositionPrevious = pose.sensorPosition;
+        pose.sensorPosition = vec;
 
-        _worldTransformPrevious = std::move(_worldTransform);
-        const glm::mat4 m = parentTrans * sensorTransMat * sensorRotMat *
-                            glm::make_mat4(_deviceTransform.values);
-        std::memcpy(&_worldTransform, glm::value_ptr(m), 16 * sizeof(float));
-    }
-    setTrackerTimeStamp();
+        pose.worldTransformPrevious = pose.worldTransform;
+        pose.worldTransform = *m;
+
+        pose.timePrevious = pose.time;
+        pose.time = t;
+    });
 }
 
 void TrackingDevice::setButtonValue(bool val, int index) {
@@ -98,24 +93,29 @@ void TrackingDevice::setButtonValue(bool val, int index) {
         return;
     }
 
-    {
-        const std::unique_lock lock(mutex::Tracking);
+    const double t = time();
+    _buttons[index].update([val, t](Button& button) {
         // swap
-        _buttonsPrevious[index] = _buttons[index];
-        _buttons[index] = val;
-    }
-    setButtonTimeStamp(index);
+        button.valuePrevious = button.value;
+        button.value = val;
+        button.timePrevious = button.time;
+        button.time = t;
+    });
 }
 
 void TrackingDevice::setAnalogValue(const double* array, int size) {
-    {
-        const std::unique_lock lock(mutex::Tracking);
-        for (int i = 0; i < std::min(size, _nAxes); i++) {
-            _axesPrevious[i] = _axes[i];
-            _axes[i] = array[i];
-        }
+    for (int i = 0; i < std::min(size, _nAxes); i++) {
+        _axes[i].update([value = array[i]](Axis& axis) {
+            axis.valuePrevious = axis.value;
+            axis.value = value;
+        });
     }
-    setAnalogTimeStamp();
+
+    const double t = time();
+    _analogTime.update([t](TimeStamp& ts) {
+        ts.timePrevious = ts.time;
+        ts.time = t;
+    });
 }
 
 void TrackingDevice::setOrientation(float xRot, float yRot, float zRot) {
@@ -125,26 +125,102 @@ void TrackingDevice::setOrientation(float xRot, float yRot, float zRot) {
     rotQuat = glm::rotate(rotQuat, glm::radians(yRot), glm::vec3(0.f, 1.f, 0.f));
     rotQuat = glm::rotate(rotQuat, glm::radians(zRot), glm::vec3(0.f, 0.f, 1.f));
 
-    const std::unique_lock lock(mutex::Tracking);
     _orientation = sgct::quat(rotQuat.x, rotQuat.y, rotQuat.z, rotQuat.w);
     calculateTransform();
 }
 
 void TrackingDevice::setOrientation(quat q) {
-    const std::unique_lock lock(mutex::Tracking);
     _orientation = std::move(q);
     calculateTransform();
 }
 
 void TrackingDevice::setOffset(vec3 offset) {
-    const std::unique_lock lock(mutex::Tracking);
     _offset = std::move(offset);
     calculateTransform();
 }
 
 void TrackingDevice::setTransform(mat4 mat) {
-    const std::unique_lock lock(mutex::Tracking);
-    _deviceTransform = std::move(mat);
+    _deviceTransform.store(mat);
+}
+
+TrackingDevice::Pose TrackingDevice::pose() const {
+    return _pose.load();
+}
+
+std::vector<TrackingDevice::Sample> TrackingDevice::history() const {
+    const uint64_t n = _nSamples.load(std::memory_order_acquire);
+    const uint64_t nEntries = std::min<uint64_t>(n, HistorySize);
+
+    std::vector<Sample> res;
+    res.reserve(nEntries);
+    for (uint64_t i = n; i > n - nEntries; i--) {
+        const HistoryEntry entry = _history[(i - 1) % HistorySize].load();
+        if (entry.index != i - 1) {
+            // This and all older entries have been overwritten since we started reading
+            break;
+        }
+        res.push_back(entry.sample);
+    }
+    std::reverse(res.begin(), res.end());
+    return res;
+}
+
+std::optional<TrackingDevice::Sample> TrackingDevice::sampleAt(double time) const {
+    const std::vector<Sample> samples = history();
+    if (samples.empty()) {
+        return std::nullopt;
+    }
+
+    double offset = std::numeric_limits<double>::max();
+    for (const Sample& s : samples) {
+        offset = std::min(offset, s.receiveTime - s.sourceTime);
+    }
+    const double sourceTime = time - offset;
+
+    const auto it = std::find_if(
+        samples.cbegin(),
+        samples.cend(),
+        [sourceTime](const Sample& s) { return s.sourceTime >= sourceTime; }
+    );
+    if (it == samples.cbegin()) {
+        return samples.front();
+    }
+    if (it == samples.cend()) {
+        return samples.back();
+    }
+
+    const Sample& prev = *(it - 1);
+    const Sample& next = *it;
+    const double duration = next.sourceTime - prev.sourceTime;
+    const float f = duration > 0.0 ?
+        static_cast<float>((sourceTime - prev.sourceTime) / duration) :
+        1.f;
+
+    const glm::vec3 p = glm::mix(
+        glm::make_vec3(&prev.sensorPosition.x),
+        glm::make_vec3(&next.sensorPosition.x),
+        f
+    );
+    const glm::quat q = glm::slerp(
+        glm::make_quat(&prev.sensorRotation.x),
+        glm::make_quat(&next.sensorRotation.x),
+        f
+    );
+
+    Sample res;
+    res.sensorPosition = vec3(p.x, p.y, p.z);
+    res.sensorRotation = quat(q.x, q.y, q.z, q.w);
+    res.sourceTime = sourceTime;
+    res.receiveTime = prev.receiveTime + f * (next.receiveTime - prev.receiveTime);
+    return res;
+}
+
+std::optional<mat4> TrackingDevice::worldTransformAt(double time) const {
+    const std::optional<Sample> sample = sampleAt(time);
+    if (!sample) {
+        return std::nullopt;
+    }
+    return sensorToWorld(sample->sensorPosition, sample->sensorRotation);
 }
 
 const std::string& TrackingDevice::name() const {
@@ -164,106 +240,126 @@ void TrackingDevice::calculateTransform() {
         glm::mat4(1.f),
         glm::make_vec3(&_offset.x)) * glm::mat4_cast(glm::make_quat(&_orientation.x)
     );
-    std::memcpy(&_deviceTransform, glm::value_ptr(transMat), 16 * sizeof(float));
+    mat4 m;
+    std::memcpy(&m, glm::value_ptr(transMat), 16 * sizeof(float));
+    _deviceTransform.store(m);
+}
+
+std::optional<mat4> TrackingDevice::sensorToWorld(const vec3& position,
+                                                  const quat& rotation) const
+{
+#ifdef SGCT_HAS_VRPN
+    const std::vector<std::unique_ptr<Tracker>>& trackers =
+        TrackingManager::instance().trackers();
+    Tracker* parent = _parentIndex < static_cast<int>(trackers.size()) ?
+        trackers[_parentIndex].get() :
+        nullptr;
+#else
+    Tracker* parent = nullptr;
+#endif
+
+    if (parent == nullptr) {
+        Log::Error(std::format("Error getting handle to tracker for device '{}'", _name));
+        return std::nullopt;
+    }
+
+    const glm::mat4 parentTrans = glm::make_mat4(parent->getTransform().values);
+
+    // create matrixes
+    const glm::mat4 sensorTransMat = glm::translate(
+        glm::mat4(1.f),
+        glm::make_vec3(&position.x)
+    );
+    const glm::mat4 sensorRotMat = glm::mat4_cast(glm::make_quat(&rotation.x));
+    const glm::mat4 m = parentTrans * sensorTransMat * sensorRotMat *
+                        glm::make_mat4(_deviceTransform.load().values);
+
+    mat4 res;
+    std::memcpy(&res, glm::value_ptr(m), 16 * sizeof(float));
+    return res;
 }
 
 int TrackingDevice::sensorId() const {
-    const std::unique_lock lock(mutex::Tracking);
     return _sensorId;
 }
 
 bool TrackingDevice::button(int index) const {
-    const std::unique_lock lock(mutex::Tracking);
-    return index < _nButtons ? _buttons[index] : false;
+    return index < _nButtons ? _buttons[index].load().value : false;
 }
 
 bool TrackingDevice::buttonPrevious(int index) const {
-    const std::unique_lock lock(mutex::Tracking);
-    return index < _nButtons ? _buttonsPrevious[index] : false;
+    return index < _nButtons ? _buttons[index].load().valuePrevious : false;
 }
 
 double TrackingDevice::analog(int index) const {
-    const std::unique_lock lock(mutex::Tracking);
-    return index < _nAxes ? _axes[index] : 0.0;
+    return index < _nAxes ? _axes[index].load().value : 0.0;
 }
 
 double TrackingDevice::analogPrevious(int index) const {
-    const std::unique_lock lock(mutex::Tracking);
-    return index < _nAxes ? _axesPrevious[index] : 0.0;
+    return index < _nAxes ? _axes[index].load().valuePrevious : 0.0;
 }
 
 vec3 TrackingDevice::position() const {
-    const std::unique_lock lock(mutex::Tracking);
-    const glm::mat4 m = glm::make_mat4(_worldTransform.values);
+    const glm::mat4 m = glm::make_mat4(_pose.load().worldTransform.values);
     const glm::vec3 p = glm::vec3(m[3]);
     return sgct::vec3(p.x, p.y, p.z);
 }
 
 vec3 TrackingDevice::previousPosition() const {
-    const std::unique_lock lock(mutex::Tracking);
-    const glm::mat4 m = glm::make_mat4(_worldTransformPrevious.values);
+    const glm::mat4 m = glm::make_mat4(_pose.load().worldTransformPrevious.values);
     const glm::vec3 p = glm::vec3(m[3]);
     return sgct::vec3(p.x, p.y, p.z);
 }
 
 vec3 TrackingDevice::eulerAngles() const {
-    const std::unique_lock lock(mutex::Tracking);
-    const glm::vec3 v =
-        glm::eulerAngles(glm::quat_cast(glm::make_mat4(_worldTransform.values)));
+    const mat4 m = _pose.load().worldTransform;
+    const glm::vec3 v = glm::eulerAngles(glm::quat_cast(glm::make_mat4(m.values)));
     return sgct::vec3(v.x, v.y, v.z);
 }
 
 vec3 TrackingDevice::eulerAnglesPrevious() const {
-    const std::unique_lock lock(mutex::Tracking);
-    const glm::vec3 v =
-        glm::eulerAngles(glm::quat_cast(glm::make_mat4(_worldTransformPrevious.values)));
+    const mat4 m = _pose.load().worldTransformPrevious;
+    const glm::vec3 v = glm::eulerAngles(glm::quat_cast(glm::make_mat4(m.values)));
     return sgct::vec3(v.x, v.y, v.z);
 }
 
 quat TrackingDevice::rotation() const {
-    const std::unique_lock lock(mutex::Tracking);
-    const glm::quat q = glm::quat_cast(glm::make_mat4(_worldTransform.values));
+    const mat4 m = _pose.load().worldTransform;
+    const glm::quat q = glm::quat_cast(glm::make_mat4(m.values));
     return quat(q.x, q.y, q.z, q.w);
 }
 
 quat TrackingDevice::rotationPrevious() const {
-    const std::unique_lock lock(mutex::Tracking);
-    const glm::quat q = glm::quat_cast(glm::make_mat4(_worldTransformPrevious.values));
+    const mat4 m = _pose.load().worldTransformPrevious;
+    const glm::quat q = glm::quat_cast(glm::make_mat4(m.values));
     return quat(q.x, q.y, q.z, q.w);
 }
 
 mat4 TrackingDevice::worldTransform() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _worldTransform;
+    return _pose.load().worldTransform;
 }
 
 mat4 TrackingDevice::worldTransformPrevious() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _worldTransformPrevious;
+    return _pose.load().worldTransformPrevious;
 }
 
 quat TrackingDevice::sensorRotation() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _sensorRotation;
+    return _pose.load().sensorRotation;
 }
 
 quat TrackingDevice::sensorRotationPrevious() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _sensorRotationPrevious;
+    return _pose.load().sensorRotationPrevious;
 }
 
 vec3 TrackingDevice::sensorPosition() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _sensorPos;
+    return _pose.load().sensorPosition;
 }
 
 vec3 TrackingDevice::sensorPositionPrevious() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _sensorPosPrevious;
+    return _pose.load().sensorPositionPrevious;
 }
 
 bool TrackingDevice::isEnabled() const {
-    const std::unique_lock lock(mutex::Tracking);
     return _isEnabled;
 }
 
@@ -279,67 +375,46 @@ bool TrackingDevice::hasAnalogs() const {
     return _nAxes > 0;
 }
 
-void TrackingDevice::setTrackerTimeStamp() {
-    const std::unique_lock lock(mutex::Tracking);
-    _trackerTimePrevious = _trackerTime;
-    _trackerTime = time();
-}
-
-void TrackingDevice::setAnalogTimeStamp() {
-    const std::unique_lock lock(mutex::Tracking);
-    _analogTimePrevious = _analogTime;
-    _analogTime = time();
-}
-
-void TrackingDevice::setButtonTimeStamp(int index) {
-    const std::unique_lock lock(mutex::Tracking);
-    _buttonTimePrevious[index] = _buttonTime[index];
-    _buttonTime[index] = time();
-}
-
 double TrackingDevice::trackerTimeStamp() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _trackerTime;
+    return _pose.load().time;
 }
 
 double TrackingDevice::trackerTimeStampPrevious() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _trackerTimePrevious;
+    return _pose.load().timePrevious;
 }
 
 double TrackingDevice::analogTimeStamp() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _analogTime;
+    return _analogTime.load().time;
 }
 
 double TrackingDevice::analogTimeStampPrevious() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _analogTimePrevious;
+    return _analogTime.load().timePrevious;
 }
 
 double TrackingDevice::buttonTimeStamp(int index) const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _buttonTime[index];
+    return index < _nButtons ? _buttons[index].load().time : 0.0;
 }
 
 double TrackingDevice::buttonTimeStampPrevious(int index) const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _buttonTimePrevious[index];
+    return index < _nButtons ? _buttons[index].load().timePrevious : 0.0;
 }
 
 double TrackingDevice::trackerDeltaTime() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _trackerTime - _trackerTimePrevious;
+    const Pose p = _pose.load();
+    return p.time - p.timePrevious;
 }
 
 double TrackingDevice::analogDeltaTime() const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _analogTime - _analogTimePrevious;
+    const TimeStamp ts = _analogTime.load();
+    return ts.time - ts.timePrevious;
 }
 
 double TrackingDevice::buttonDeltaTime(int index) const {
-    const std::unique_lock lock(mutex::Tracking);
-    return _buttonTime[index] - _buttonTimePrevious[index];
+    if (index >= _nButtons) {
+        return 0.0;
+    }
+    const Button b = _buttons[index].load();
+    return b.time - b.timePrevious;
 }
 
 } // namespace sgct
@@ -0,0 +1,357 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/trackinglog.h>
+
+#include <sgct/engine.h>
+#include <sgct/error.h>
+#include <sgct/format.h>
+#include <sgct/log.h>
+#include <sgct/profiling.h>
+#include <sgct/tracker.h>
+#include <sgct/trackingdevice.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+
+#define Err(code, msg) sgct::Error(sgct::Error::Component::Tracking, code, msg)
+
+namespace {
+    // Increase this version whenever the layout of the log changes
+    constexpr uint32_t LogVersion = 1;
+    constexpr std::array<char, 4> LogMagic = { 'S', 'G', 'T', 'L' };
+
+    // Every event starts with its type, the index of the device, and the time. The sizes
+    // of the events are fixed, apart from the analog event whose values are preceded by
+    // their number
+    enum class EventType : uint8_t { Sensor = 0, Button = 1, Analog = 2 };
+
+    // Used to signal a truncated log while reading, which is never visible outside
+    struct Truncated {};
+
+    template <typename T>
+    void append(std::string& buffer, const T& value) {
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void append(std::string& buffer, std::string_view value) {
+        append(buffer, static_cast<uint32_t>(value.size()));
+        buffer.append(value);
+    }
+
+    class Reader {
+    public:
+        explicit Reader(std::string_view data) : _data(data) {}
+
+        bool isAtEnd() const { return _data.empty(); }
+
+        template <typename T>
+        T read() {
+            if (_data.size() < sizeof(T)) {
+                throw Truncated();
+            }
+            T value;
+            std::memcpy(&value, _data.data(), sizeof(T));
+            _data.remove_prefix(sizeof(T));
+            return value;
+        }
+
+        std::string readString() {
+            const uint32_t size = read<uint32_t>();
+            if (_data.size() < size) {
+                throw Truncated();
+            }
+            std::string value = std::string(_data.substr(0, size));
+            _data.remove_prefix(size);
+            return value;
+        }
+
+    private:
+        std::string_view _data;
+    };
+} // namespace
+
+namespace sgct {
+
+TrackingLog readTrackingLog(const std::filesystem::path& path) {
+    ZoneScoped;
+
+    std::ifstream file = std::ifstream(path, std::ios::in | std::ios::binary);
+    if (!file.good()) {
+        throw Err(4001, std::format("Could not open tracking log '{}'", path));
+    }
+    const std::string data = std::string(
+        std::istreambuf_iterator<char>(file),
+        std::istreambuf_iterator<char>()
+    );
+    Reader reader = Reader(data);
+
+    TrackingLog log;
+    try {
+        const std::array<char, 4> magic = reader.read<std::array<char, 4>>();
+        if (magic != LogMagic) {
+            throw Err(4002, std::format("Invalid tracking log '{}'", path));
+        }
+        const uint32_t version = reader.read<uint32_t>();
+        if (version != LogVersion) {
+            throw Err(
+                4003,
+                std::format("Unsupported version {} of tracking log '{}'", version, path)
+            );
+        }
+        const uint32_t nDevices = reader.read<uint32_t>();
+        for (uint32_t i = 0; i < nDevices; i++) {
+            TrackingLog::Device device;
+            device.tracker = reader.readString();
+            device.device = reader.readString();
+            log.devices.push_back(std::move(device));
+        }
+    }
+    catch (const Truncated&) {
+        throw Err(4002, std::format("Invalid tracking log '{}'", path));
+    }
+
+    while (!reader.isAtEnd()) {
+        try {
+            TrackingLog::Event event;
+            const EventType type = reader.read<EventType>();
+            event.device = reader.read<uint16_t>();
+            event.time = reader.read<double>();
+            if (event.device >= static_cast<int>(log.devices.size())) {
+                throw Err(4002, std::format("Damaged tracking log '{}'", path));
+            }
+
+            switch (type) {
+                case EventType::Sensor:
+                {
+                    TrackingLog::Sensor sensor;
+                    sensor.position = reader.read<vec3>();
+                    sensor.rotation = reader.read<quat>();
+                    sensor.sourceTime = reader.read<double>();
+                    event.data = sensor;
+                    break;
+                }
+                case EventType::Button:
+                {
+                    TrackingLog::Button button;
+                    button.index = reader.read<uint16_t>();
+                    button.value = reader.read<uint8_t>() != 0;
+                    event.data = button;
+                    break;
+                }
+                case EventType::Analog:
+                {
+                    TrackingLog::Analog analog;
+                    analog.values.resize(reader.read<uint16_t>());
+                    for (double& v : analog.values) {
+                        v = reader.read<double>();
+                    }
+                    event.data = std::move(analog);
+                    break;
+                }
+                default:
+                    throw Err(4002, std::format("Damaged tracking log '{}'", path));
+            }
+            log.events.push_back(std::move(event));
+        }
+        catch (const Truncated&) {
+            Log::Warning(std::format(
+                "Tracking log '{}' ends with an incomplete event, which is ignored", path
+            ));
+            break;
+        }
+    }
+
+    Log::Debug(std::format(
+        "Read {} events of {} devices from tracking log '{}'",
+        log.events.size(), log.devices.size(), path
+    ));
+    return log;
+}
+
+TrackingRecorder::TrackingRecorder(const std::filesystem::path& path,
+                                   const std::vector<std::unique_ptr<Tracker>>& trackers)
+    : _file(path, std::ios::out | std::ios::binary | std::ios::trunc)
+    , _startTime(time())
+{
+    if (!_file.good()) {
+        throw Err(
+            4000,
+            std::format("Could not open tracking log '{}' for writing", path)
+        );
+    }
+
+    std::vector<TrackingLog::Device> devices;
+    for (const std::unique_ptr<Tracker>& tracker : trackers) {
+        for (const std::unique_ptr<TrackingDevice>& device : tracker->devices()) {
+            _deviceIndices[device.get()] = static_cast<int>(devices.size());
+            devices.push_back({ tracker->name(), device->name() });
+        }
+    }
+
+    std::string header;
+    header.append(LogMagic.data(), LogMagic.size());
+    append(header, LogVersion);
+    append(header, static_cast<uint32_t>(devices.size()));
+    for (const TrackingLog::Device& device : devices) {
+        append(header, std::string_view(device.tracker));
+        append(header, std::string_view(device.device));
+    }
+    _file.write(header.data(), header.size());
+    _file.flush();
+
+    Log::Info(std::format(
+        "Recording {} tracking devices to '{}'", devices.size(), path
+    ));
+}
+
+void TrackingRecorder::recordSensor(const TrackingDevice& device, vec3 position,
+                                    quat rotation, double sourceTime)
+{
+    TrackingLog::Event event;
+    event.data = TrackingLog::Sensor{ position, rotation, sourceTime };
+    write(device, event);
+}
+
+void TrackingRecorder::recordButton(const TrackingDevice& device, int index, bool value) {
+    TrackingLog::Event event;
+    event.data = TrackingLog::Button{ index, value };
+    write(device, event);
+}
+
+void TrackingRecorder::recordAnalog(const TrackingDevice& device, const double* values,
+                                    int size)
+{
+    TrackingLog::Event event;
+    event.data = TrackingLog::Analog{ std::vector<double>(values, values + size) };
+    write(device, event);
+}
+
+void TrackingRecorder::write(const TrackingDevice& device,
+                             const TrackingLog::Event& event)
+{
+    ZoneScoped;
+
+    const auto it = _deviceIndices.find(&device);
+    if (it == _deviceIndices.end()) {
+        return;
+    }
+
+    const double t = time() - _startTime;
+    std::string buffer;
+    if (const TrackingLog::Sensor* s = std::get_if<TrackingLog::Sensor>(&event.data)) {
+        append(buffer, EventType::Sensor);
+        append(buffer, static_cast<uint16_t>(it->second));
+        append(buffer, t);
+        append(buffer, s->position);
+        append(buffer, s->rotation);
+        append(buffer, s->sourceTime);
+    }
+    else if (const TrackingLog::Button* b = std::get_if<TrackingLog::Button>(&event.data))
+    {
+        append(buffer, EventType::Button);
+        append(buffer, static_cast<uint16_t>(it->second));
+        append(buffer, t);
+        append(buffer, static_cast<uint16_t>(b->index));
+        append(buffer, static_cast<uint8_t>(b->value ? 1 : 0));
+    }
+    else if (const TrackingLog::Analog* a = std::get_if<TrackingLog::Analog>(&event.data))
+    {
+        const size_t n = std::min<size_t>(
+            a->values.size(),
+            std::numeric_limits<uint16_t>::max()
+        );
+        append(buffer, EventType::Analog);
+        append(buffer, static_cast<uint16_t>(it->second));
+        append(buffer, t);
+        append(buffer, static_cast<uint16_t>(n));
+        buffer.append(
+            reinterpret_cast<const char*>(a->values.data()),
+            n * sizeof(double)
+        );
+    }
+
+    // The events are written as a whole so that the events of different sampling threads
+    // are not interleaved
+    std::lock_guard lock(_mutex);
+    _file.write(buffer.data(), buffer.size());
+}
+
+TrackingPlayer::TrackingPlayer(TrackingLog log,
+                               const std::vector<std::unique_ptr<Tracker>>& trackers)
+    : _log(std::move(log))
+{
+    for (const TrackingLog::Device& d : _log.devices) {
+        const auto it = std::find_if(
+            trackers.cbegin(),
+            trackers.cend(),
+            [&d](const std::unique_ptr<Tracker>& t) { return t->name() == d.tracker; }
+        );
+        TrackingDevice* device =
+            it != trackers.cend() ? (*it)->device(d.device) : nullptr;
+        if (!device) {
+            Log::Warning(std::format(
+                "Skipping the recorded device {}@{} that does not exist",
+                d.device, d.tracker
+            ));
+        }
+        _devices.push_back(device);
+    }
+}
+
+void TrackingPlayer::advance(double time) {
+    ZoneScoped;
+
+    while (_next < _log.events.size() && _log.events[_next].time <= time) {
+        step();
+    }
+}
+
+void TrackingPlayer::step() {
+    if (_next >= _log.events.size()) {
+        return;
+    }
+
+    const TrackingLog::Event& event = _log.events[_next];
+    _next++;
+
+    TrackingDevice* device = _devices[event.device];
+    if (!device || !device->isEnabled()) {
+        return;
+    }
+
+    if (const TrackingLog::Sensor* s = std::get_if<TrackingLog::Sensor>(&event.data)) {
+        device->setSensorTransform(s->position, s->rotation, s->sourceTime);
+    }
+    else if (const TrackingLog::Button* b = std::get_if<TrackingLog::Button>(&event.data))
+    {
+        device->setButtonValue(b->value, b->index);
+    }
+    else if (const TrackingLog::Analog* a = std::get_if<TrackingLog::Analog>(&event.data))
+    {
+        device->setAnalogValue(a->values.data(), static_cast<int>(a->values.size()));
+    }
+}
+
+bool TrackingPlayer::isDone() const {
+    return _next >= _log.events.size();
+}
+
+double TrackingPlayer::nextEventTime() const {
+    return isDone() ? duration() : _log.events[_next].time;
+}
+
+double TrackingPlayer::duration() const {
+    return _log.events.empty() ? 0.0 : _log.events.back().time;
+}
+
+} // namespace sgct
@@ -11,11 +11,13 @@
 #include <sgct/config.h>
 #include <sgct/clustermanager.h>
 #include <sgct/engine.h>
+#include <sgct/error.h>
 #include <sgct/format.h>
 #include <sgct/log.h>
-#include <sgct/mutexes.h>
 #include <sgct/profiling.h>
+#include <sgct/settings.h>
 #include <sgct/trackingdevice.h>
+#include <sgct/trackinglog.h>
 #include <sgct/user.h>
 #ifdef __GNUC__
 #pragma GCC diagnostic push
@@ -33,6 +35,10 @@
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+#include <optional>
 
 namespace {
     struct VRPNPointer {
@@ -42,6 +48,25 @@ namespace {
     };
     std::vector<std::vector<VRPNPointer>> gTrackers;
 
+    // Only set while the updates of the devices are recorded. It is created before the
+    // sampling threads start and destroyed after they have finished
+    std::unique_ptr<sgct::TrackingRecorder> gRecorder;
+
+    // Only set while a tracking log is replayed. The events are applied from the render
+    // loop so that every frame sees the same state of the devices in every replay
+    std::unique_ptr<sgct::TrackingPlayer> gPlayer;
+    std::optional<double> gReplayStart;
+    uint64_t gReplayFrame = 0;
+
+    // The recording time by which every rendered frame advances the replay when the log
+    // is replayed as fast as possible
+    constexpr double ReplayFrameStep = 1.0 / 60.0;
+
+    // The VRPN servers are not connected to while a tracking log is replayed
+    bool isReplaying() {
+        return !sgct::Settings::instance().trackingReplayPath().empty();
+    }
+
     void VRPN_CALLBACK updateTracker(void* userdata, const vrpn_TRACKERCB t) {
         if (userdata == nullptr) {
             return;
@@ -50,7 +75,7 @@ namespace {
         sgct::Tracker* tracker = reinterpret_cast<sgct::Tracker*>(userdata);
         sgct::TrackingDevice* device = tracker->deviceBySensorId(t.sensor);
 
-        if (device == nullptr) {
+        if (device == nullptr || !device->isEnabled()) {
             return;
         }
 
@@ -65,24 +90,41 @@ namespace {
             static_cast<float>(t.quat[2]),
             static_cast<float>(t.quat[3])
         };
-        device->setSensorTransform(pos, rotation);
+        // The time at which the tracking system created the sample
+        const double sourceTime = static_cast<double>(t.msg_time.tv_sec) +
+            static_cast<double>(t.msg_time.tv_usec) / 1000000.0;
+        device->setSensorTransform(pos, rotation, sourceTime);
+        if (gRecorder) {
+            gRecorder->recordSensor(*device, pos, rotation, sourceTime);
+        }
     }
 
     void VRPN_CALLBACK updateButton(void* userdata, const vrpn_BUTTONCB b) {
         sgct::TrackingDevice* device = reinterpret_cast<sgct::TrackingDevice*>(userdata);
-        device->setButtonValue(b.state != 0, b.button);
+        if (device->isEnabled()) {
+            device->setButtonValue(b.state != 0, b.button);
+            if (gRecorder) {
+                gRecorder->recordButton(*device, b.button, b.state != 0);
+            }
+        }
     }
 
     void VRPN_CALLBACK updateAnalog(void* userdata, const vrpn_ANALOGCB a) {
         sgct::TrackingDevice* tdPtr = reinterpret_cast<sgct::TrackingDevice*>(userdata);
-        tdPtr->setAnalogValue(a.channel, static_cast<int>(a.num_channel));
+        if (tdPtr->isEnabled()) {
+            tdPtr->setAnalogValue(a.channel, static_cast<int>(a.num_channel));
+            if (gRecorder) {
+                const int n = static_cast<int>(a.num_channel);
+                gRecorder->recordAnalog(*tdPtr, a.channel, n);
+            }
+        }
     }
 
     void samplingLoop(void* arg) {
         sgct::TrackingManager* tm = reinterpret_cast<sgct::TrackingManager*>(arg);
 
         while (true) {
-            const double t = sgct::Engine::getTime();
+            const double t = sgct::time();
             for (size_t i = 0; i < tm->trackers().size(); ++i) {
                 sgct::Tracker* tracker = tm->trackers()[i].get();
                 if (tracker == nullptr) {
@@ -107,7 +149,7 @@ namespace {
             }
 
             const bool isRunning = tm->isRunning();
-            tm->setSamplingTime(sgct::Engine::getTime() - t);
+            tm->setSamplingTime(sgct::time() - t);
 
             // Sleep for 1ms so we don't eat the CPU
             vrpn_SleepMsecs(1);
@@ -117,6 +159,32 @@ namespace {
             }
         }
     }
+
+    // Waits for data on the sockets of the connection and dispatches it to the handlers
+    // of the remote devices that use the connection as soon as it arrives
+    void connectionLoop(sgct::TrackingManager* tm, vrpn_Connection* connection,
+                        std::vector<vrpn_BaseClass*> remotes)
+    {
+        while (tm->isRunning()) {
+            // Blocks in select on the sockets of the connection until data arrives or the
+            // timeout has passed, after which the termination is checked again
+            timeval timeout = { 0, 100000 };
+            connection->mainloop(&timeout);
+
+            // The remotes only dispatch the data that arrived in the meantime, but they
+            // are also responsible for the heartbeat with the server
+            const double t = sgct::time();
+            for (vrpn_BaseClass* remote : remotes) {
+                remote->mainloop();
+            }
+            tm->setSamplingTime(sgct::time() - t);
+
+            if (!connection->connected()) {
+                // The connection does not wait for the timeout while it is connecting
+                vrpn_SleepMsecs(10);
+            }
+        }
+    }
 } // namespace
 
 namespace sgct {
@@ -138,17 +206,16 @@ void TrackingManager::destroy() {
 TrackingManager::~TrackingManager() {
     Log::Info("Disconnecting VRPN");
 
-    {
-        std::unique_lock lock(mutex::Tracking);
-        _isRunning = false;
-    }
+    _isRunning = false;
 
-    // destroy thread
-    if (_samplingThread) {
-        _samplingThread->join();
-        _samplingThread = nullptr;
+    // destroy threads
+    for (std::thread& thread : _samplingThreads) {
+        thread.join();
     }
+    _samplingThreads.clear();
 
+    gRecorder = nullptr;
+    gPlayer = nullptr;
     _trackers.clear();
     gTrackers.clear();
     Log::Debug("Done");
@@ -191,10 +258,10 @@ void TrackingManager::applyTracker(const config::Tracker& tracker) {
     if (tracker.transformation) {
         _trackers.back()->setTransform(*tracker.transformation);
     }
+    _trackers.back()->setPrediction(tracker.prediction);
 }
 
 bool TrackingManager::isRunning() const {
-    std::unique_lock lock(mutex::Tracking);
     return _isRunning;
 }
 
@@ -226,21 +293,150 @@ void TrackingManager::startSampling() {
         return;
     }
 
-    _samplingThread = std::make_unique<std::thread>(samplingLoop, this);
+    if (_head && tr->prediction()) {
+        _headFilter = std::make_unique<PoseFilter>(*tr->prediction());
+        _headLatency = tr->prediction()->latency.value_or(0.f);
+        Log::Info(std::format(
+            "Predicting the pose of {}@{} {} s ahead of the next frame",
+            deviceName, trackerName, _headLatency
+        ));
+    }
+
+    const std::filesystem::path& replayPath = Settings::instance().trackingReplayPath();
+    if (!replayPath.empty()) {
+        try {
+            gPlayer = std::make_unique<TrackingPlayer>(
+                readTrackingLog(replayPath),
+                _trackers
+            );
+            gReplayStart = std::nullopt;
+            gReplayFrame = 0;
+            Log::Info(std::format(
+                "Replaying {} s of tracking from '{}'", gPlayer->duration(), replayPath
+            ));
+        }
+        catch (const Error& e) {
+            Log::Error(std::format("Failed to replay tracking log: {}", e.what()));
+        }
+        return;
+    }
+
+    const std::filesystem::path& recordPath = Settings::instance().trackingRecordPath();
+    if (!recordPath.empty()) {
+        try {
+            gRecorder = std::make_unique<TrackingRecorder>(recordPath, _trackers);
+        }
+        catch (const Error& e) {
+            Log::Error(std::format("Failed to record tracking: {}", e.what()));
+        }
+    }
+
+    if (!Settings::instance().useEventDrivenTracking()) {
+        _samplingThreads.emplace_back(samplingLoop, this);
+        return;
+    }
+
+    // Devices that are served by the same VRPN server share a connection, which is
+    // handled by a single thread
+    std::map<vrpn_Connection*, std::vector<vrpn_BaseClass*>> connections;
+    for (const std::vector<VRPNPointer>& tracker : gTrackers) {
+        for (const VRPNPointer& ptr : tracker) {
+            const std::array<vrpn_BaseClass*, 3> remotes = {
+                ptr.sensorDevice.get(), ptr.analogDevice.get(), ptr.buttonDevice.get()
+            };
+            for (vrpn_BaseClass* remote : remotes) {
+                if (remote && remote->connectionPtr()) {
+                    connections[remote->connectionPtr()].push_back(remote);
+                }
+            }
+        }
+    }
+    Log::Info(std::format(
+        "Sampling {} VRPN connections when data arrives", connections.size()
+    ));
+    for (auto& [connection, remotes] : connections) {
+        _samplingThreads.emplace_back(
+            connectionLoop,
+            this,
+            connection,
+            std::move(remotes)
+        );
+    }
 }
 
-void TrackingManager::updateTrackingDevices() {
+void TrackingManager::updateTrackingDevices(double swapTime) {
     ZoneScoped
 
+    if (gPlayer) {
+        const double t = time();
+        if (Settings::instance().trackingReplaySpeed() ==
+            Settings::TrackingReplaySpeed::AsFastAsPossible)
+        {
+            gReplayFrame++;
+            gPlayer->advance(static_cast<double>(gReplayFrame) * ReplayFrameStep);
+        }
+        else {
+            // The recording starts with the first rendered frame
+            if (!gReplayStart) {
+                gReplayStart = t;
+            }
+            gPlayer->advance(t - *gReplayStart);
+        }
+        _samplingTime = time() - t;
+
+        if (gPlayer->isDone()) {
+            Log::Info("Finished replaying the tracking log");
+            gPlayer = nullptr;
+        }
+    }
+
     for (const std::unique_ptr<Tracker>& tracker : _trackers) {
         for (const std::unique_ptr<TrackingDevice>& device : tracker->devices()) {
             if (device->isEnabled() && device.get() == _head && _headUser) {
-                _headUser->setTransform(device->worldTransform());
+                const std::optional<mat4> predicted =
+                    _headFilter ? predictHead(swapTime) : std::nullopt;
+                _headUser->setTransform(predicted.value_or(device->worldTransform()));
             }
         }
     }
 }
 
+std::optional<mat4> TrackingManager::predictHead(double swapTime) {
+    ZoneScoped
+
+    const std::vector<TrackingDevice::Sample> history = _head->history();
+    if (history.empty()) {
+        return std::nullopt;
+    }
+
+    // The filter works with the clock of the tracking system, which is converted to the
+    // local clock with the smallest difference between the two as the transmission delay
+    // is never negative
+    double offset = std::numeric_limits<double>::max();
+    for (const TrackingDevice::Sample& s : history) {
+        offset = std::min(offset, s.receiveTime - s.sourceTime);
+    }
+
+    const double latest = _headFilter->latestTime().value_or(
+        -std::numeric_limits<double>::max()
+    );
+    for (const TrackingDevice::Sample& s : history) {
+        if (s.sourceTime > latest) {
+            _headFilter->addSample(
+                s.sourceTime,
+                PoseFilter::Pose{ s.sensorPosition, s.sensorRotation }
+            );
+        }
+    }
+
+    const std::optional<PoseFilter::Pose> pose =
+        _headFilter->predict(swapTime + _headLatency - offset);
+    if (!pose) {
+        return std::nullopt;
+    }
+    return _head->sensorToWorld(pose->position, pose->rotation);
+}
+
 void TrackingManager::addTracker(std::string name) {
     if (!tracker(name)) {
         _trackers.push_back(std::make_unique<Tracker>(name));
@@ -270,7 +466,7 @@ void TrackingManager::addSensorToCurrentDevice(std::string address, int id) {
     if (device) {
         device->setSensorId(id);
 
-        if (retVal.second && ptr.sensorDevice == nullptr) {
+        if (retVal.second && ptr.sensorDevice == nullptr && !isReplaying()) {
             Log::Info(std::format("Connecting to sensor '{}'", address));
             ptr.sensorDevice = std::make_unique<vrpn_Tracker_Remote>(address.c_str());
             ptr.sensorDevice->register_change_handler(
@@ -293,12 +489,16 @@ void TrackingManager::addButtonsToCurrentDevice(std::string address, int nButton
     TrackingDevice* device = _trackers.back()->devices().back().get();
 
     if (ptr.buttonDevice == nullptr && device) {
+        device->setNumberOfButtons(nButtons);
+        if (isReplaying()) {
+            return;
+        }
+
         Log::Info(std::format(
             "Connecting to buttons '{}' on device {}", address, device->name()
         ));
         ptr.buttonDevice = std::make_unique<vrpn_Button_Remote>(address.c_str());
         ptr.buttonDevice->register_change_handler(device, updateButton);
-        device->setNumberOfButtons(nButtons);
     }
     else {
         Log::Error(std::format("Failed to connect to buttons '{}'", address));
@@ -314,13 +514,17 @@ void TrackingManager::addAnalogsToCurrentDevice(std::string address, int nAxes)
     TrackingDevice* device = _trackers.back()->devices().back().get();
 
     if (ptr.analogDevice == nullptr && device) {
+        device->setNumberOfAxes(nAxes);
+        if (isReplaying()) {
+            return;
+        }
+
         Log::Info(std::format(
             "Connecting to analog '{}' on device {}", address, device->name()
         ));
 
         ptr.analogDevice = std::make_unique<vrpn_Analog_Remote>(address.c_str());
         ptr.analogDevice->register_change_handler(device, updateAnalog);
-        device->setNumberOfAxes(nAxes);
     }
     else {
         Log::Error(std::format("Failed to connect to analogs '{}'", address));
@@ -351,12 +555,10 @@ void TrackingManager::setEnabled(bool state) {
 }
 
 void TrackingManager::setSamplingTime(double t) {
-    std::unique_lock lock(mutex::Tracking);
     _samplingTime = t;
 }
 
 double TrackingManager::samplingTime() const {
-    std::unique_lock lock(mutex::Tracking);
     return _samplingTime;
 }
 
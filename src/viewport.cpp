@@ -10,11 +10,14 @@
 
 #include <sgct/clustermanager.h>
 #include <sgct/config.h>
+#include <sgct/format.h>
 #include <sgct/log.h>
 #include <sgct/profiling.h>
 #include <sgct/readconfig.h>
 #include <sgct/screencapture.h>
 #include <sgct/texturemanager.h>
+#include <sgct/window.h>
+#include <sgct/projection/cubemapcoverage.h>
 #include <sgct/projection/cylindrical.h>
 #include <sgct/projection/equirectangular.h>
 #include <sgct/projection/fisheye.h>
@@ -24,6 +27,7 @@
 #include <sgct/projection/spoutflat.h>
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <optional>
 #include <variant>
 
@@ -31,6 +35,28 @@ namespace {
     // Helper structs for the visitor pattern of the std::variant on projections
     template <class... Ts> struct overloaded : Ts... { using Ts::operator()...; };
     template <class... Ts> overloaded(Ts...) -> overloaded<Ts...>;
+
+    // Tells the non-linear projection which parts of the viewport are visible through
+    // the correction mesh, so that it can skip the parts of the cube map it never samples
+    void setCubemapSamples(sgct::NonLinearProjection& projection,
+                           const sgct::CorrectionMesh::MeshData& mesh,
+                           const sgct::BaseViewport& viewport, sgct::ivec2 resolution)
+    {
+        ZoneScoped;
+
+        const sgct::correction::Buffer buffer =
+            mesh.cached ? mesh.cached->toBuffer() : mesh.buffer;
+        const sgct::vec2 pos = viewport.position();
+        const sgct::vec2 size = viewport.size();
+        const float spacing = std::max(
+            1.f / (resolution.x * size.x),
+            1.f / (resolution.y * size.y)
+        );
+        projection.setCubemapSamples(
+            sgct::sampledPositions(buffer, resolution, pos, size),
+            spacing
+        );
+    }
 } // namespace
 
 namespace sgct {
@@ -322,6 +348,21 @@ void Viewport::applySphericalMirrorProjection(const config::SphericalMirrorProje
     _nonLinearProjection = std::move(proj);
 }
 
+void Viewport::beginLoadData() {
+    ZoneScoped;
+
+    // The viewport is copied as it can change while the mesh is parsed
+    _meshDataSetup = CorrectionMesh::viewportSetup(*this);
+    _meshData = std::async(
+        std::launch::async,
+        [path = _meshFilename, setup = _meshDataSetup,
+         textureMode = _useTextureMappedProjection]()
+        {
+            return CorrectionMesh::readMesh(path, setup, textureMode);
+        }
+    );
+}
+
 void Viewport::loadData() {
     ZoneScoped;
 
@@ -338,12 +379,167 @@ void Viewport::loadData() {
         _blackLevelMaskTextureIndex = mgr.loadTexture(_blackLevelMaskFilename, true, 1);
     }
 
+    // Rethrows the exception if the mesh could not be parsed on the worker thread. The
+    // initialization callback runs while the mesh is parsed and might have moved or
+    // resized this viewport, in which case the mesh is parsed again for the new values
+    std::optional<CorrectionMesh::MeshData> mesh;
+    if (_meshData.valid()) {
+        mesh = _meshData.get();
+        if (_meshDataSetup != CorrectionMesh::viewportSetup(*this)) {
+            Log::Debug("Parsing the mesh again as the viewport changed while parsing it");
+            mesh = std::nullopt;
+        }
+    }
+    if (!mesh) {
+        mesh = CorrectionMesh::readMesh(
+            _meshFilename,
+            *this,
+            _useTextureMappedProjection
+        );
+    }
+    if (_nonLinearProjection && !_meshFilename.empty()) {
+        const ivec2 resolution = _parent->framebufferResolution();
+        setCubemapSamples(*_nonLinearProjection, *mesh, *this, resolution);
+    }
     _mesh.loadMesh(
-        _meshFilename,
+        std::move(*mesh),
         *this,
         (hasBlendMaskTexture() || hasBlackLevelMaskTexture()),
-        _useTextureMappedProjection
+        true
+    );
+}
+
+std::vector<std::filesystem::path> Viewport::dataFiles() const {
+    const std::array<const std::filesystem::path*, 4> files = {
+        &_meshFilename, &_overlayFilename, &_blendMaskFilename, &_blackLevelMaskFilename
+    };
+    std::vector<std::filesystem::path> res;
+    for (const std::filesystem::path* p : files) {
+        if (!p->empty()) {
+            res.push_back(*p);
+        }
+    }
+    return res;
+}
+
+void Viewport::beginReloadData(std::span<const std::filesystem::path> files) {
+    ZoneScoped;
+
+    auto isChanged = [files](const std::filesystem::path& path) {
+        return !path.empty() &&
+            std::find(files.begin(), files.end(), path) != files.end();
+    };
+
+    if (isChanged(_meshFilename)) {
+        if (_reload.mesh.valid()) {
+            // The mesh is read again once the current reload has finished
+            _reload.isMeshOutdated = true;
+        }
+        else {
+            _reload.mesh = std::async(
+                std::launch::async,
+                [path = _meshFilename, setup = CorrectionMesh::viewportSetup(*this),
+                 textureMode = _useTextureMappedProjection]()
+                {
+                    return CorrectionMesh::readMesh(path, setup, textureMode);
+                }
+            );
+        }
+    }
+
+    TextureManager& mgr = TextureManager::instance();
+    auto reloadTexture = [&](const std::filesystem::path& path,
+                             std::optional<TextureManager::AsyncTexture>& texture)
+    {
+        if (!isChanged(path)) {
+            return;
+        }
+        if (texture) {
+            // A newer version of the file replaces the one that is still loading
+            mgr.removeTexture(texture->id);
+        }
+        texture = mgr.loadTextureAsync(path, true, 1.f);
+    };
+    reloadTexture(_overlayFilename, _reload.overlay);
+    reloadTexture(_blendMaskFilename, _reload.blendMask);
+    reloadTexture(_blackLevelMaskFilename, _reload.blackLevelMask);
+}
+
+bool Viewport::finishReloadData() {
+    ZoneScoped;
+
+    bool hasReplaced = false;
+    const auto isReady = [](const auto& future) {
+        return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    };
+
+    if (_reload.mesh.valid() && isReady(_reload.mesh)) {
+        try {
+            CorrectionMesh::MeshData mesh = _reload.mesh.get();
+            if (_nonLinearProjection) {
+                setCubemapSamples(
+                    *_nonLinearProjection,
+                    mesh,
+                    *this,
+                    _parent->framebufferResolution()
+                );
+            }
+            _mesh.loadMesh(
+                std::move(mesh),
+                *this,
+                (hasBlendMaskTexture() || hasBlackLevelMaskTexture()),
+                true
+            );
+            Log::Info(std::format("Reloaded correction mesh '{}'", _meshFilename));
+            hasReplaced = true;
+        }
+        catch (const std::exception& e) {
+            Log::Error(std::format(
+                "Failed to reload correction mesh '{}': {}", _meshFilename, e.what()
+            ));
+        }
+        if (_reload.isMeshOutdated) {
+            _reload.isMeshOutdated = false;
+            beginReloadData(std::span<const std::filesystem::path>(&_meshFilename, 1));
+        }
+    }
+
+    TextureManager& mgr = TextureManager::instance();
+    auto replaceTexture = [&](const std::filesystem::path& path,
+                              std::optional<TextureManager::AsyncTexture>& texture,
+                              unsigned int& index)
+    {
+        if (!texture || !isReady(texture->loaded)) {
+            return;
+        }
+        try {
+            texture->loaded.get();
+            if (index != 0) {
+                mgr.removeTexture(index);
+            }
+            index = texture->id;
+            Log::Info(std::format("Reloaded texture '{}'", path));
+            hasReplaced = true;
+        }
+        catch (const std::exception& e) {
+            mgr.removeTexture(texture->id);
+            Log::Error(std::format("Failed to reload texture '{}': {}", path, e.what()));
+        }
+        texture = std::nullopt;
+    };
+    replaceTexture(_overlayFilename, _reload.overlay, _overlayTextureIndex);
+    replaceTexture(_blendMaskFilename, _reload.blendMask, _blendMaskTextureIndex);
+    replaceTexture(
+        _blackLevelMaskFilename,
+        _reload.blackLevelMask,
+        _blackLevelMaskTextureIndex
     );
+    return hasReplaced;
+}
+
+bool Viewport::isReloadingData() const {
+    return _reload.mesh.valid() || _reload.overlay || _reload.blendMask ||
+        _reload.blackLevelMask;
 }
 
 void Viewport::renderQuadMesh() const {
@@ -362,6 +558,10 @@ void Viewport::renderWarpMesh() const {
     }
 }
 
+void Viewport::updateBakedWarp(ivec2 resolution) {
+    _mesh.updateBakedWarp(resolution);
+}
+
 void Viewport::renderMaskMesh() const {
     ZoneScoped;
 
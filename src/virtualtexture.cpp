@@ -0,0 +1,837 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <sgct/virtualtexture.h>
+
+#include <sgct/engine.h>
+#include <sgct/error.h>
+#include <sgct/fileutils.h>
+#include <sgct/format.h>
+#include <sgct/image.h>
+#include <sgct/log.h>
+#include <sgct/opengl.h>
+#include <sgct/profiling.h>
+#include <sgct/settings.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+#define Err(code, msg) Error(Error::Component::Image, code, msg)
+
+namespace {
+    //
+    // The pyramid file consists of the PyramidHeader followed by the tiles of all levels,
+    // starting with the full resolution level. The tiles of each level are stored in
+    // row-major order starting with the bottom-left tile
+    //
+    constexpr std::array<char, 4> PyramidMagic = { 'S', 'G', 'V', 'T' };
+    constexpr uint32_t PyramidVersion = 1;
+
+    struct PyramidHeader {
+        std::array<char, 4> magic = PyramidMagic;
+        uint32_t version = PyramidVersion;
+        int32_t width = 0;
+        int32_t height = 0;
+        int32_t tileSize = 0;
+        int32_t border = 0;
+        int32_t nLevels = 0;
+    };
+
+    // The number of grid cells in each direction that are used to sample a view
+    constexpr int GridSize = 32;
+
+    std::vector<size_t> levelOffsets(const sgct::TileLayout& layout) {
+        std::vector<size_t> res;
+        size_t offset = 0;
+        for (int level = 0; level < layout.nLevels; level++) {
+            res.push_back(offset);
+            const sgct::ivec2 tiles = layout.tiles(level);
+            offset += static_cast<size_t>(tiles.x) * tiles.y;
+        }
+        // The last entry is the total number of tiles
+        res.push_back(offset);
+        return res;
+    }
+
+    uint32_t pageTableEntry(sgct::ivec2 slot, int level) {
+        return static_cast<uint32_t>(slot.x) | (static_cast<uint32_t>(slot.y) << 8) |
+            (static_cast<uint32_t>(level) << 16) | (255u << 24);
+    }
+
+    bool directionToUv(glm::vec3 dir, sgct::TextureMapping mapping, float fov,
+                       glm::vec2& uv)
+    {
+        switch (mapping) {
+            case sgct::TextureMapping::Fisheye:
+            {
+                // The inverse of the texture coordinates that are created by utils::Dome
+                const float theta = std::acos(std::clamp(dir.y, -1.f, 1.f));
+                const float fovRad = glm::radians(fov);
+                if (theta > fovRad / 2.f) {
+                    return false;
+                }
+                const float h = std::sqrt(dir.x * dir.x + dir.z * dir.z);
+                if (h < 1e-6f) {
+                    uv = glm::vec2(0.5f, 0.5f);
+                    return true;
+                }
+                const float r = theta / fovRad;
+                uv = glm::vec2(0.5f + r * dir.x / h, 0.5f + r * dir.z / h);
+                return true;
+            }
+            case sgct::TextureMapping::Equirectangular:
+            {
+                const float u = std::atan2(dir.x, -dir.z) / glm::two_pi<float>() + 0.5f;
+                const float v =
+                    std::asin(std::clamp(dir.y, -1.f, 1.f)) / glm::pi<float>() + 0.5f;
+                uv = glm::vec2(u, v);
+                return true;
+            }
+            default:
+                throw std::logic_error("Unhandled case label");
+        }
+    }
+} // namespace
+
+namespace sgct {
+
+TileLayout TileLayout::create(ivec2 size, int tileSize, int border) {
+    TileLayout res;
+    res.size = size;
+    res.tileSize = tileSize;
+    res.border = border;
+    res.nLevels = 1;
+    while (true) {
+        const ivec2 tiles = res.tiles(res.nLevels - 1);
+        if (tiles.x == 1 && tiles.y == 1) {
+            break;
+        }
+        res.nLevels++;
+    }
+    return res;
+}
+
+ivec2 TileLayout::levelSize(int level) const {
+    return ivec2(std::max(size.x >> level, 1), std::max(size.y >> level, 1));
+}
+
+ivec2 TileLayout::tiles(int level) const {
+    const ivec2 s = levelSize(level);
+    return ivec2((s.x + tileSize - 1) / tileSize, (s.y + tileSize - 1) / tileSize);
+}
+
+size_t TileLayout::tileBytes() const {
+    const size_t slotSize = static_cast<size_t>(tileSize + 2 * border);
+    return slotSize * slotSize * 4;
+}
+
+void TilePyramid::build(const Image& image, const std::filesystem::path& path,
+                        int tileSize)
+{
+    ZoneScoped;
+
+    if ((image.channels() != 3 && image.channels() != 4) ||
+        image.bytesPerChannel() != 1 || image.data() == nullptr)
+    {
+        throw Err(
+            9025,
+            "Cannot build tile pyramid: Only images with 3 or 4 channels of 8 bit are "
+            "supported"
+        );
+    }
+    if (tileSize <= 0) {
+        throw Err(9025, "Cannot build tile pyramid: Tile size must be positive");
+    }
+
+    const TileLayout layout = TileLayout::create(image.size(), tileSize);
+
+    // Convert into BGRA so that all tiles and levels share the same layout
+    ivec2 size = image.size();
+    const int nChannels = image.channels();
+    std::vector<uint8_t> level(static_cast<size_t>(size.x) * size.y * 4);
+    for (size_t i = 0; i < static_cast<size_t>(size.x) * size.y; i++) {
+        const unsigned char* src = image.data() + i * nChannels;
+        level[i * 4 + 0] = src[0];
+        level[i * 4 + 1] = src[1];
+        level[i * 4 + 2] = src[2];
+        level[i * 4 + 3] = nChannels == 4 ? src[3] : 255;
+    }
+
+    // Write to a temporary file first so that a reader never sees a partial pyramid
+    const std::filesystem::path tmp = temporaryPath(path);
+    {
+        std::ofstream file = std::ofstream(tmp, std::ofstream::binary);
+        PyramidHeader header;
+        header.width = layout.size.x;
+        header.height = layout.size.y;
+        header.tileSize = layout.tileSize;
+        header.border = layout.border;
+        header.nLevels = layout.nLevels;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(PyramidHeader));
+
+        const int slotSize = layout.tileSize + 2 * layout.border;
+        std::vector<uint8_t> tile(layout.tileBytes());
+        for (int l = 0; l < layout.nLevels; l++) {
+            const ivec2 tiles = layout.tiles(l);
+            for (int ty = 0; ty < tiles.y; ty++) {
+                for (int tx = 0; tx < tiles.x; tx++) {
+                    // Pixels outside of the level are clamped to its edge
+                    for (int y = 0; y < slotSize; y++) {
+                        const int sy = std::clamp(
+                            ty * layout.tileSize + y - layout.border,
+                            0,
+                            size.y - 1
+                        );
+                        for (int x = 0; x < slotSize; x++) {
+                            const int sx = std::clamp(
+                                tx * layout.tileSize + x - layout.border,
+                                0,
+                                size.x - 1
+                            );
+                            std::memcpy(
+                                &tile[(static_cast<size_t>(y) * slotSize + x) * 4],
+                                &level[(static_cast<size_t>(sy) * size.x + sx) * 4],
+                                4
+                            );
+                        }
+                    }
+                    file.write(reinterpret_cast<const char*>(tile.data()), tile.size());
+                }
+            }
+
+            if (l == layout.nLevels - 1) {
+                break;
+            }
+
+            // Box filter the next level
+            const ivec2 next = layout.levelSize(l + 1);
+            std::vector<uint8_t> down(static_cast<size_t>(next.x) * next.y * 4);
+            for (int y = 0; y < next.y; y++) {
+                const int y0 = std::min(y * 2, size.y - 1);
+                const int y1 = std::min(y * 2 + 1, size.y - 1);
+                for (int x = 0; x < next.x; x++) {
+                    const int x0 = std::min(x * 2, size.x - 1);
+                    const int x1 = std::min(x * 2 + 1, size.x - 1);
+                    for (int c = 0; c < 4; c++) {
+                        const int sum =
+                            level[(static_cast<size_t>(y0) * size.x + x0) * 4 + c] +
+                            level[(static_cast<size_t>(y0) * size.x + x1) * 4 + c] +
+                            level[(static_cast<size_t>(y1) * size.x + x0) * 4 + c] +
+                            level[(static_cast<size_t>(y1) * size.x + x1) * 4 + c];
+                        down[(static_cast<size_t>(y) * next.x + x) * 4 + c] =
+                            static_cast<uint8_t>((sum + 2) / 4);
+                    }
+                }
+            }
+            level = std::move(down);
+            size = next;
+        }
+
+        if (!file.good()) {
+            file.close();
+            std::error_code ec;
+            std::filesystem::remove(tmp, ec);
+            throw Err(9024, std::format("Could not write tile pyramid '{}'", path));
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmp, ec);
+        throw Err(9024, std::format("Could not write tile pyramid '{}'", path));
+    }
+}
+
+TilePyramid::TilePyramid(const std::filesystem::path& path)
+    : _file(path)
+{
+    if (!_file.isOpen()) {
+        throw Err(9022, std::format("Could not open tile pyramid '{}'", path));
+    }
+
+    PyramidHeader header;
+    if (_file.size() < sizeof(PyramidHeader)) {
+        throw Err(9023, std::format("Invalid tile pyramid '{}'", path));
+    }
+    std::memcpy(&header, _file.data(), sizeof(PyramidHeader));
+    if (header.magic != PyramidMagic || header.version != PyramidVersion ||
+        header.width <= 0 || header.height <= 0 || header.tileSize <= 0 ||
+        header.border < 0)
+    {
+        throw Err(9023, std::format("Invalid tile pyramid '{}'", path));
+    }
+
+    _layout = TileLayout::create(
+        ivec2(header.width, header.height),
+        header.tileSize,
+        header.border
+    );
+    _levelOffsets = levelOffsets(_layout);
+    const size_t expected =
+        sizeof(PyramidHeader) + _levelOffsets.back() * _layout.tileBytes();
+    if (_layout.nLevels != header.nLevels || _file.size() != expected) {
+        throw Err(9023, std::format("Invalid tile pyramid '{}'", path));
+    }
+}
+
+const TileLayout& TilePyramid::layout() const {
+    return _layout;
+}
+
+void TilePyramid::readTile(TileId tile, std::byte* buffer) const {
+    if (tile.level < 0 || tile.level >= _layout.nLevels) {
+        throw Err(9023, std::format("Invalid tile level {}", tile.level));
+    }
+    const ivec2 tiles = _layout.tiles(tile.level);
+    if (tile.x < 0 || tile.x >= tiles.x || tile.y < 0 || tile.y >= tiles.y) {
+        throw Err(9023, std::format("Invalid tile {}x{}", tile.x, tile.y));
+    }
+
+    const size_t index = _levelOffsets[tile.level] +
+        static_cast<size_t>(tile.y) * tiles.x + tile.x;
+    const size_t nBytes = _layout.tileBytes();
+    std::memcpy(buffer, _file.data() + sizeof(PyramidHeader) + index * nBytes, nBytes);
+}
+
+std::vector<TileId> selectVisibleTiles(const TileLayout& layout,
+                                       std::span<const mat4> viewProjections,
+                                       ivec2 resolution, TextureMapping mapping,
+                                       float fov)
+{
+    ZoneScoped;
+
+    constexpr int N = GridSize + 1;
+    const glm::vec2 pixelsPerCell = glm::vec2(
+        std::max(resolution.x, 1) / static_cast<float>(GridSize),
+        std::max(resolution.y, 1) / static_cast<float>(GridSize)
+    );
+    const glm::vec2 imageSize = glm::vec2(layout.size.x, layout.size.y);
+
+    std::set<TileId> res;
+    std::vector<glm::vec2> uvs(N * N);
+    std::vector<bool> isValid(N * N);
+    for (const mat4& viewProjection : viewProjections) {
+        const glm::mat4 inv = glm::inverse(glm::make_mat4(viewProjection.values));
+
+        // Unproject the grid points into view directions and map them into the texture
+        for (int j = 0; j < N; j++) {
+            for (int i = 0; i < N; i++) {
+                const float x = -1.f + 2.f * i / GridSize;
+                const float y = -1.f + 2.f * j / GridSize;
+                glm::vec4 near = inv * glm::vec4(x, y, -1.f, 1.f);
+                glm::vec4 far = inv * glm::vec4(x, y, 1.f, 1.f);
+                near /= near.w;
+                far /= far.w;
+                const glm::vec3 dir = glm::normalize(glm::vec3(far) - glm::vec3(near));
+                isValid[j * N + i] = directionToUv(dir, mapping, fov, uvs[j * N + i]);
+            }
+        }
+
+        for (int j = 0; j < GridSize; j++) {
+            for (int i = 0; i < GridSize; i++) {
+                const std::array<int, 4> corners = {
+                    j * N + i, j * N + i + 1, (j + 1) * N + i, (j + 1) * N + i + 1
+                };
+
+                std::array<glm::vec2, 4> c;
+                int nValid = 0;
+                for (int corner : corners) {
+                    if (isValid[corner]) {
+                        c[nValid] = uvs[corner];
+                        nValid++;
+                    }
+                }
+                if (nValid == 0) {
+                    continue;
+                }
+
+                if (mapping == TextureMapping::Equirectangular) {
+                    // Move cells that cross the seam of the panorama to the right side so
+                    // that their extent stays small. Tiles are wrapped around below
+                    bool crossesSeam = false;
+                    for (int k = 0; k < nValid; k++) {
+                        crossesSeam |= std::abs(c[k].x - c[0].x) > 0.5f;
+                    }
+                    if (crossesSeam) {
+                        for (int k = 0; k < nValid; k++) {
+                            c[k].x += c[k].x < 0.5f ? 1.f : 0.f;
+                        }
+                    }
+                }
+
+                glm::vec2 uvMin = c[0];
+                glm::vec2 uvMax = c[0];
+                for (int k = 1; k < nValid; k++) {
+                    uvMin = glm::min(uvMin, c[k]);
+                    uvMax = glm::max(uvMax, c[k]);
+                }
+
+                // Use the level at which one texel covers at most one pixel
+                const glm::vec2 texels = (uvMax - uvMin) * imageSize;
+                const float texelsPerPixel = std::max(
+                    texels.x / pixelsPerCell.x,
+                    texels.y / pixelsPerCell.y
+                );
+                const int level = texelsPerPixel <= 1.f ?
+                    0 :
+                    std::clamp(
+                        static_cast<int>(std::floor(std::log2(texelsPerPixel))),
+                        0,
+                        layout.nLevels - 1
+                    );
+
+                const ivec2 levelSize = layout.levelSize(level);
+                const ivec2 tiles = layout.tiles(level);
+                const int tileSize = layout.tileSize;
+                const int x0 =
+                    static_cast<int>(std::floor(uvMin.x * levelSize.x)) / tileSize;
+                const int x1 =
+                    static_cast<int>(std::floor(uvMax.x * levelSize.x)) / tileSize;
+                const int y0 = std::clamp(
+                    static_cast<int>(std::floor(uvMin.y * levelSize.y)) / tileSize,
+                    0,
+                    tiles.y - 1
+                );
+                const int y1 = std::clamp(
+                    static_cast<int>(std::floor(uvMax.y * levelSize.y)) / tileSize,
+                    0,
+                    tiles.y - 1
+                );
+                for (int ty = y0; ty <= y1; ty++) {
+                    for (int tx = x0; tx <= x1; tx++) {
+                        const int x = mapping == TextureMapping::Equirectangular ?
+                            ((tx % tiles.x) + tiles.x) % tiles.x :
+                            std::clamp(tx, 0, tiles.x - 1);
+                        res.insert({ level, x, ty });
+                    }
+                }
+            }
+        }
+    }
+
+    return std::vector<TileId>(res.begin(), res.end());
+}
+
+TileCache::TileCache(const std::filesystem::path& path, int atlasTiles, int nThreads)
+    : _pyramid(path)
+    , _atlasTiles(atlasTiles)
+{
+    // The page table stores the slots as 8 bit values
+    if (atlasTiles < 1 || atlasTiles > 255) {
+        throw Err(9026, std::format("Invalid number of atlas tiles {}", atlasTiles));
+    }
+
+    // Reverse order so that the first slots are used first
+    for (int y = atlasTiles - 1; y >= 0; y--) {
+        for (int x = atlasTiles - 1; x >= 0; x--) {
+            _freeSlots.emplace_back(x, y);
+        }
+    }
+
+    const TileLayout& layout = _pyramid.layout();
+    _pageTable.resize(layout.nLevels);
+    for (int level = 0; level < layout.nLevels; level++) {
+        const ivec2 tiles = layout.tiles(level);
+        _pageTable[level].resize(static_cast<size_t>(tiles.x) * tiles.y, 0);
+    }
+
+    for (int i = 0; i < std::max(nThreads, 1); i++) {
+        _threads.emplace_back(&TileCache::workerLoop, this);
+    }
+
+    // Start loading the coarsest level right away as it is the fallback for all tiles
+    request({});
+}
+
+TileCache::~TileCache() {
+    {
+        const std::unique_lock lock(_mutex);
+        _isShuttingDown = true;
+    }
+    _condition.notify_all();
+    for (std::thread& thread : _threads) {
+        thread.join();
+    }
+}
+
+void TileCache::request(std::span<const TileId> tiles) {
+    ZoneScoped;
+
+    _frame++;
+    const TileLayout& layout = _pyramid.layout();
+    const int coarsest = layout.nLevels - 1;
+
+    _needed.clear();
+    _needed.insert({ coarsest, 0, 0 });
+    for (TileId tile : tiles) {
+        if (tile.level < 0 || tile.level > coarsest) {
+            continue;
+        }
+        const ivec2 nTiles = layout.tiles(tile.level);
+        if (tile.x < 0 || tile.x >= nTiles.x || tile.y < 0 || tile.y >= nTiles.y) {
+            continue;
+        }
+
+        // Keep the ancestors resident so that there is always a close fallback
+        while (tile.level < coarsest && _needed.insert(tile).second) {
+            const ivec2 parentTiles = layout.tiles(tile.level + 1);
+            tile = TileId {
+                tile.level + 1,
+                std::min(tile.x / 2, parentTiles.x - 1),
+                std::min(tile.y / 2, parentTiles.y - 1)
+            };
+        }
+    }
+
+    std::vector<TileId> missing;
+    for (const TileId& tile : _needed) {
+        auto it = _resident.find(tile);
+        if (it != _resident.end()) {
+            it->second.lastUsed = _frame;
+        }
+        else {
+            missing.push_back(tile);
+        }
+    }
+    std::stable_sort(
+        missing.begin(),
+        missing.end(),
+        [](const TileId& a, const TileId& b) { return a.level > b.level; }
+    );
+
+    {
+        const std::unique_lock lock(_mutex);
+        // Tiles that are already being read or waiting to be collected stay in flight
+        for (const TileId& tile : _queue) {
+            _inFlight.erase(tile);
+        }
+        _queue.clear();
+        for (const TileId& tile : missing) {
+            if (_inFlight.insert(tile).second) {
+                _queue.push_back(tile);
+            }
+        }
+    }
+    _condition.notify_all();
+}
+
+std::vector<TileCache::LoadedTile> TileCache::collectLoadedTiles(int maxTiles) {
+    ZoneScoped;
+
+    std::vector<std::pair<TileId, std::vector<std::byte>>> loaded;
+    {
+        const std::unique_lock lock(_mutex);
+        const size_t n = std::min(_loaded.size(), static_cast<size_t>(maxTiles));
+        loaded.insert(
+            loaded.end(),
+            std::make_move_iterator(_loaded.begin()),
+            std::make_move_iterator(_loaded.begin() + n)
+        );
+        _loaded.erase(_loaded.begin(), _loaded.begin() + n);
+        for (const std::pair<TileId, std::vector<std::byte>>& p : loaded) {
+            _inFlight.erase(p.first);
+        }
+    }
+
+    const int coarsest = _pyramid.layout().nLevels - 1;
+    std::vector<LoadedTile> res;
+    for (std::pair<TileId, std::vector<std::byte>>& p : loaded) {
+        if (p.second.empty() || _resident.contains(p.first)) {
+            continue;
+        }
+
+        const bool isNeeded = _needed.contains(p.first);
+        ivec2 slot;
+        if (!_freeSlots.empty()) {
+            slot = _freeSlots.back();
+            _freeSlots.pop_back();
+        }
+        else if (isNeeded) {
+            // Evict the least recently used tile that is not needed in this frame
+            auto victim = _resident.end();
+            for (auto it = _resident.begin(); it != _resident.end(); it++) {
+                if (it->first.level == coarsest || it->second.lastUsed >= _frame) {
+                    continue;
+                }
+                if (victim == _resident.end() ||
+                    it->second.lastUsed < victim->second.lastUsed)
+                {
+                    victim = it;
+                }
+            }
+            if (victim == _resident.end()) {
+                // The atlas is too small for all of the visible tiles
+                continue;
+            }
+            slot = victim->second.slot;
+            _resident.erase(victim);
+        }
+        else {
+            continue;
+        }
+
+        _resident[p.first] = Resident{ slot, isNeeded ? _frame : 0 };
+        res.push_back({ p.first, slot, std::move(p.second) });
+    }
+
+    if (!res.empty()) {
+        updatePageTable();
+    }
+    return res;
+}
+
+int TileCache::numberOfPendingTiles() const {
+    const std::unique_lock lock(_mutex);
+    return static_cast<int>(_inFlight.size());
+}
+
+bool TileCache::isResident(TileId tile) const {
+    return _resident.contains(tile);
+}
+
+const TilePyramid& TileCache::pyramid() const {
+    return _pyramid;
+}
+
+int TileCache::atlasTiles() const {
+    return _atlasTiles;
+}
+
+const std::vector<uint32_t>& TileCache::pageTable(int level) const {
+    return _pageTable[level];
+}
+
+bool TileCache::isDirty() const {
+    return _isDirty;
+}
+
+void TileCache::clearDirty() {
+    _isDirty = false;
+}
+
+void TileCache::workerLoop() {
+    const size_t nBytes = _pyramid.layout().tileBytes();
+    while (true) {
+        TileId tile;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(
+                lock,
+                [this]() { return _isShuttingDown || !_queue.empty(); }
+            );
+            if (_isShuttingDown) {
+                return;
+            }
+            tile = _queue.front();
+            _queue.pop_front();
+        }
+
+        // Reading from the memory-mapped file causes the page faults on this thread
+        std::vector<std::byte> data(nBytes);
+        try {
+            _pyramid.readTile(tile, data.data());
+        }
+        catch (const std::exception& e) {
+            Log::Error(std::format("Could not read tile: {}", e.what()));
+            data.clear();
+        }
+
+        const std::unique_lock lock(_mutex);
+        _loaded.emplace_back(tile, std::move(data));
+    }
+}
+
+void TileCache::updatePageTable() {
+    const TileLayout& layout = _pyramid.layout();
+    // Resolve from the coarsest level down so that the parent entries are final
+    for (int level = layout.nLevels - 1; level >= 0; level--) {
+        const ivec2 tiles = layout.tiles(level);
+        const bool isCoarsest = level == layout.nLevels - 1;
+        const ivec2 parentTiles = isCoarsest ? ivec2(0, 0) : layout.tiles(level + 1);
+        for (int y = 0; y < tiles.y; y++) {
+            for (int x = 0; x < tiles.x; x++) {
+                const size_t i = static_cast<size_t>(y) * tiles.x + x;
+                uint32_t& entry = _pageTable[level][i];
+                auto it = _resident.find({ level, x, y });
+                if (it != _resident.end()) {
+                    entry = pageTableEntry(it->second.slot, level);
+                }
+                else if (isCoarsest) {
+                    entry = 0;
+                }
+                else {
+                    const int px = std::min(x / 2, parentTiles.x - 1);
+                    const int py = std::min(y / 2, parentTiles.y - 1);
+                    entry = _pageTable[level + 1][
+                        static_cast<size_t>(py) * parentTiles.x + px
+                    ];
+                }
+            }
+        }
+    }
+    _isDirty = true;
+}
+
+VirtualTexture::VirtualTexture(const std::filesystem::path& path, int atlasTiles)
+    : _cache(path, atlasTiles, Settings::instance().numberTextureLoadThreads())
+{
+    const TileLayout& layout = _cache.pyramid().layout();
+    const int atlasSize = atlasTiles * (layout.tileSize + 2 * layout.border);
+
+    GLint maxSize = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+    if (atlasSize > maxSize) {
+        throw Err(
+            9026,
+            std::format(
+                "Virtual texture atlas size {} exceeds the maximum texture size {}",
+                atlasSize, maxSize
+            )
+        );
+    }
+
+    glGenTextures(1, &_atlas);
+    glBindTexture(GL_TEXTURE_2D, _atlas);
+    glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, atlasSize, atlasSize);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    // The level sizes of the page table have to match the number of tiles of each level,
+    // which is guaranteed for all levels if the base level is a power of two
+    const ivec2 tiles = layout.tiles(0);
+    const int width = static_cast<int>(std::bit_ceil(static_cast<unsigned int>(tiles.x)));
+    const int height =
+        static_cast<int>(std::bit_ceil(static_cast<unsigned int>(tiles.y)));
+    glGenTextures(1, &_pageTable);
+    glBindTexture(GL_TEXTURE_2D, _pageTable);
+    glTexStorage2D(GL_TEXTURE_2D, layout.nLevels, GL_RGBA8, width, height);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, layout.nLevels - 1);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+VirtualTexture::~VirtualTexture() {
+    glDeleteTextures(1, &_atlas);
+    glDeleteTextures(1, &_pageTable);
+}
+
+void VirtualTexture::request(std::span<const TileId> tiles) {
+    _cache.request(tiles);
+}
+
+void VirtualTexture::update() {
+    ZoneScoped;
+
+    const TileLayout& layout = _cache.pyramid().layout();
+    const int slotSize = layout.tileSize + 2 * layout.border;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glBindTexture(GL_TEXTURE_2D, _atlas);
+    const double budget = Settings::instance().textureUploadBudget() / 1000.0;
+    const double t0 = time();
+    bool isFirst = true;
+    while (isFirst || time() - t0 < budget) {
+        // Collect only a few tiles at a time so that the budget is not overshot
+        std::vector<TileCache::LoadedTile> tiles = _cache.collectLoadedTiles(4);
+        if (tiles.empty()) {
+            break;
+        }
+        isFirst = false;
+        for (const TileCache::LoadedTile& tile : tiles) {
+            glTexSubImage2D(
+                GL_TEXTURE_2D,
+                0,
+                tile.slot.x * slotSize,
+                tile.slot.y * slotSize,
+                slotSize,
+                slotSize,
+                GL_BGRA,
+                GL_UNSIGNED_BYTE,
+                tile.data.data()
+            );
+        }
+    }
+
+    if (_cache.isDirty()) {
+        glBindTexture(GL_TEXTURE_2D, _pageTable);
+        for (int level = 0; level < layout.nLevels; level++) {
+            const ivec2 tiles = layout.tiles(level);
+            glTexSubImage2D(
+                GL_TEXTURE_2D,
+                level,
+                0,
+                0,
+                tiles.x,
+                tiles.y,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                _cache.pageTable(level).data()
+            );
+        }
+        _cache.clearDirty();
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void VirtualTexture::bind(unsigned int program, int atlasUnit, int pageTableUnit) const {
+    const TileLayout& layout = _cache.pyramid().layout();
+    const GLuint p = static_cast<GLuint>(program);
+
+    glActiveTexture(GL_TEXTURE0 + atlasUnit);
+    glBindTexture(GL_TEXTURE_2D, _atlas);
+    glActiveTexture(GL_TEXTURE0 + pageTableUnit);
+    glBindTexture(GL_TEXTURE_2D, _pageTable);
+
+    glUniform1i(glGetUniformLocation(p, "vt_atlas"), atlasUnit);
+    glUniform1i(glGetUniformLocation(p, "vt_pageTable"), pageTableUnit);
+    glUniform2f(
+        glGetUniformLocation(p, "vt_imageSize"),
+        static_cast<float>(layout.size.x),
+        static_cast<float>(layout.size.y)
+    );
+    glUniform1f(
+        glGetUniformLocation(p, "vt_tileSize"),
+        static_cast<float>(layout.tileSize)
+    );
+    glUniform1f(glGetUniformLocation(p, "vt_border"), static_cast<float>(layout.border));
+    glUniform1f(
+        glGetUniformLocation(p, "vt_atlasTiles"),
+        static_cast<float>(_cache.atlasTiles())
+    );
+    glUniform1f(
+        glGetUniformLocation(p, "vt_maxLevel"),
+        static_cast<float>(layout.nLevels - 1)
+    );
+}
+
+const TileLayout& VirtualTexture::layout() const {
+    return _cache.pyramid().layout();
+}
+
+const TileCache& VirtualTexture::cache() const {
+    return _cache;
+}
+
+} // namespace sgct
@@ -25,6 +25,7 @@
 #include <sgct/projection/nonlinearprojection.h>
 #include <glm/gtc/matrix_transform.hpp>
 #include <algorithm>
+#include <cmath>
 
 #ifdef WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -264,6 +265,16 @@ void Window::close() {
     // Current handle must be set at the end to properly destroy the window
     makeOpenGLContextCurrent();
 
+    glDeleteFramebuffers(1, &_headless.leftFramebuffer);
+    _headless.leftFramebuffer = 0;
+    glDeleteFramebuffers(1, &_headless.rightFramebuffer);
+    _headless.rightFramebuffer = 0;
+    glDeleteTextures(1, &_headless.leftEye);
+    _headless.leftEye = 0;
+    glDeleteTextures(1, &_headless.rightEye);
+    _headless.rightEye = 0;
+    _headless.resolution = ivec2{ 0, 0 };
+
     _viewports.clear();
 
     glfwSetWindowSizeCallback(_windowHandle, nullptr);
@@ -428,9 +439,14 @@ void Window::swapBuffers(bool takeScreenshot) {
 
     makeOpenGLContextCurrent();
 
+    // Headless windows have no default framebuffer that could be captured or swapped
+    const bool isHeadless = Settings::instance().useHeadlessRendering();
+
     if (takeScreenshot) {
         ZoneScopedN("Take Screenshot");
-        if (Settings::instance().captureFromBackBuffer() && _isDoubleBuffered) {
+        if (Settings::instance().captureFromBackBuffer() && _isDoubleBuffered &&
+            !isHeadless)
+        {
             if (_screenCaptureLeftOrMono) {
                 _screenCaptureLeftOrMono->saveScreenCapture(
                     0,
@@ -461,7 +477,7 @@ void Window::swapBuffers(bool takeScreenshot) {
     // swap
     _windowResOld = _windowRes;
 
-    if (_isDoubleBuffered) {
+    if (_isDoubleBuffered && !isHeadless) {
         ZoneScopedN("glfwSwapBuffers");
         glfwSwapBuffers(_windowHandle);
     }
@@ -497,6 +513,15 @@ void Window::updateResolutions() {
             "Resolution changed to {}x{} in window {}", _windowRes.x, _windowRes.y, _id
         ));
         _pendingWindowRes = std::nullopt;
+
+        // The baked correction meshes map the pixels of the back buffer
+        if (Settings::instance().useWarpingLookupTexture() && _windowHandle) {
+            makeOpenGLContextCurrent();
+            const ivec2 res = backBufferResolution();
+            for (const std::unique_ptr<Viewport>& vp : _viewports) {
+                vp->updateBakedWarp(res);
+            }
+        }
     }
 
     if (_pendingFramebufferRes.has_value()) {
@@ -865,7 +890,7 @@ void Window::openWindow(GLFWwindow* share, bool isLastWindow) {
 
     setWindowTitle(_name.empty() ? title.c_str() : _name.c_str());
 
-    {
+    if (!Settings::instance().useHeadlessRendering()) {
         // swap the buffers and update the window
         ZoneScopedN("glfwSwapBuffers");
         glfwSwapBuffers(_windowHandle);
@@ -1190,12 +1215,6 @@ void Window::resizeFBOs() {
     createTextures();
 
     _finalFBO->resizeFBO(_framebufferRes.x, _framebufferRes.y, _nAASamples);
-
-    if (!_finalFBO->isMultiSampled()) {
-        _finalFBO->bind();
-        _finalFBO->attachColorTexture(_frameBufferTextures.leftEye, GL_COLOR_ATTACHMENT0);
-        OffScreenBuffer::unbind();
-    }
 }
 
 void Window::destroyFBOs() {
@@ -1258,6 +1277,68 @@ ivec2 Window::resolution() const {
     return _windowRes;
 }
 
+ivec2 Window::backBufferResolution() const {
+    return ivec2{
+        static_cast<int>(std::ceil(_scale.x * _windowRes.x)),
+        static_cast<int>(std::ceil(_scale.y * _windowRes.y))
+    };
+}
+
+void Window::bindHeadlessFramebuffer(Eye eye) {
+    ZoneScoped;
+
+    // Framebuffers are not shared between contexts, so this cannot use the shared context
+    const ivec2 res = backBufferResolution();
+    if (res.x != _headless.resolution.x || res.y != _headless.resolution.y) {
+        _headless.resolution = res;
+
+        // The texture is only attached here, so binding the framebuffer is all that is
+        // left to do for every frame
+        auto createTarget = [this, res](unsigned int& framebuffer, unsigned int& id) {
+            if (framebuffer == 0) {
+                glGenFramebuffers(1, &framebuffer);
+            }
+            glDeleteTextures(1, &id);
+            glGenTextures(1, &id);
+            glBindTexture(GL_TEXTURE_2D, id);
+            glTexImage2D(
+                GL_TEXTURE_2D,
+                0,
+                _internalColorFormat,
+                res.x,
+                res.y,
+                0,
+                ColorFormat,
+                _colorDataType,
+                nullptr
+            );
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+            glFramebufferTexture2D(
+                GL_FRAMEBUFFER,
+                GL_COLOR_ATTACHMENT0,
+                GL_TEXTURE_2D,
+                id,
+                0
+            );
+        };
+        createTarget(_headless.leftFramebuffer, _headless.leftEye);
+        if (_stereoMode == StereoMode::Active) {
+            createTarget(_headless.rightFramebuffer, _headless.rightEye);
+        }
+    }
+
+    const bool isRight = eye == Eye::Right && _headless.rightFramebuffer != 0;
+    glBindFramebuffer(
+        GL_FRAMEBUFFER,
+        isRight ? _headless.rightFramebuffer : _headless.leftFramebuffer
+    );
+    glDrawBuffer(GL_COLOR_ATTACHMENT0);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+}
+
 ivec2 Window::framebufferResolution() const {
     return _framebufferRes;
 }
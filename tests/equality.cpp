@@ -127,13 +127,21 @@ bool operator==(const Device& lhs, const Device& rhs) {
         lhs.transformation == rhs.transformation;
 }
 
+bool operator==(const Tracker::Prediction& lhs, const Tracker::Prediction& rhs) {
+    return
+        lhs.method == rhs.method &&
+        lhs.latency == rhs.latency &&
+        lhs.smoothing == rhs.smoothing;
+}
+
 bool operator==(const Tracker& lhs, const Tracker& rhs) {
     return
         lhs.name == rhs.name &&
         lhs.devices == rhs.devices &&
         lhs.offset == rhs.offset &&
         lhs.scale == rhs.scale &&
-        lhs.transformation == rhs.transformation;
+        lhs.transformation == rhs.transformation &&
+        lhs.prediction == rhs.prediction;
 }
 
 bool operator==(const NoProjection&, const NoProjection&) {
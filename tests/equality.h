@@ -35,6 +35,7 @@ bool operator==(const Device::Sensors& lhs, const Device::Sensors& rhs);
 bool operator==(const Device::Buttons& lhs, const Device::Buttons& rhs);
 bool operator==(const Device::Axes& lhs, const Device::Axes& rhs);
 bool operator==(const Device& lhs, const Device& rhs);
+bool operator==(const Tracker::Prediction& lhs, const Tracker::Prediction& rhs);
 bool operator==(const Tracker& lhs, const Tracker& rhs);
 bool operator==(const NoProjection& lhs, const NoProjection& rhs);
 bool operator==(const PlanarProjection& lhs, const PlanarProjection& rhs);
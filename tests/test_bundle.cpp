@@ -0,0 +1,148 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "equality.h"
+#include <sgct/bundle.h>
+#include <sgct/error.h>
+#include <sgct/format.h>
+#include <sgct/readconfig.h>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    std::filesystem::path tempFolder(std::string_view name) {
+        std::filesystem::path folder = std::filesystem::temp_directory_path() / name;
+        std::filesystem::remove_all(folder);
+        std::filesystem::create_directories(folder);
+        return folder;
+    }
+
+    void writeFile(const std::filesystem::path& path, std::string_view contents) {
+        std::ofstream file = std::ofstream(path, std::ios::out | std::ios::binary);
+        file << contents;
+    }
+
+    std::string readFile(const std::filesystem::path& path) {
+        std::ifstream file = std::ifstream(path, std::ios::in | std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    // Loads a cluster with a correction mesh and a blend mask in the assets folder
+    sgct::config::Cluster createCluster(const std::filesystem::path& assets) {
+        sgct::config::Cluster cluster =
+            sgct::readConfig(std::string(BASE_PATH) + "/config/single.json");
+        sgct::config::Viewport& vp = cluster.nodes[0].windows[0].viewports[0];
+        vp.correctionMeshTexture = assets / "mesh.pfm";
+        vp.blendMaskTexture = assets / "mask.png";
+        writeFile(*vp.correctionMeshTexture, std::string(10000, 'm'));
+        writeFile(*vp.blendMaskTexture, "mask");
+        return cluster;
+    }
+} // namespace
+
+TEST_CASE("Bundle: Roundtrip", "[bundle]") {
+    const std::filesystem::path assets = tempFolder("sgct_test_bundle_assets");
+    const std::filesystem::path folder = tempFolder("sgct_test_bundle");
+
+    const sgct::config::Cluster cluster = createCluster(assets);
+    const std::vector<std::filesystem::path> files = sgct::bundleFiles(cluster);
+    REQUIRE(files.size() == 2);
+    CHECK(files[0] == assets / "mask.png");
+    CHECK(files[1] == assets / "mesh.pfm");
+
+    const std::vector<char> bundle = sgct::createBundle(cluster);
+    REQUIRE(sgct::bundleHash(bundle).has_value());
+    // The mesh compresses well
+    CHECK(bundle.size() < 2000);
+
+    sgct::config::Cluster res = sgct::extractBundle(bundle, folder);
+    sgct::config::Viewport& vp = res.nodes[0].windows[0].viewports[0];
+    REQUIRE(vp.correctionMeshTexture.has_value());
+    REQUIRE(vp.blendMaskTexture.has_value());
+    CHECK(vp.correctionMeshTexture->parent_path() == folder);
+    CHECK(vp.blendMaskTexture->parent_path() == folder);
+    CHECK(readFile(*vp.correctionMeshTexture) == std::string(10000, 'm'));
+    CHECK(readFile(*vp.blendMaskTexture) == "mask");
+
+    // Apart from the paths, the cluster is unchanged
+    vp.correctionMeshTexture = assets / "mesh.pfm";
+    vp.blendMaskTexture = assets / "mask.png";
+    CHECK(res == cluster);
+
+    std::filesystem::remove_all(assets);
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("Bundle: Invalid", "[bundle]") {
+    const std::filesystem::path assets = tempFolder("sgct_test_bundle_assets");
+    const std::filesystem::path folder = tempFolder("sgct_test_bundle");
+
+    const sgct::config::Cluster cluster = createCluster(assets);
+    const std::vector<char> bundle = sgct::createBundle(cluster);
+
+    // Damaged contents
+    std::vector<char> damaged = bundle;
+    damaged.back() ^= 0x55;
+    CHECK_THROWS_AS(sgct::extractBundle(damaged, folder), sgct::Error);
+
+    // Truncated bundle
+    damaged = bundle;
+    damaged.pop_back();
+    CHECK_THROWS_AS(sgct::extractBundle(damaged, folder), sgct::Error);
+
+    // Larger than allowed, which is checked before the contents are decompressed
+    CHECK_THROWS_AS(sgct::extractBundle(bundle, folder, 16), sgct::Error);
+
+    // Missing header
+    const std::vector<char> empty;
+    CHECK_FALSE(sgct::bundleHash(empty).has_value());
+    CHECK_THROWS_AS(sgct::extractBundle(empty, folder), sgct::Error);
+
+    // Missing file
+    std::filesystem::remove(assets / "mask.png");
+    CHECK_THROWS_AS(sgct::createBundle(cluster), sgct::Error);
+
+    std::filesystem::remove_all(assets);
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("Bundle: Transfer", "[bundle]") {
+    constexpr int Port = 28461;
+    const std::filesystem::path assets = tempFolder("sgct_test_bundle_assets");
+    const std::filesystem::path cache = tempFolder("sgct_test_bundle_cache");
+
+    const sgct::config::Cluster cluster = createCluster(assets);
+    const std::vector<char> bundle = sgct::createBundle(cluster);
+    const uint64_t hash = *sgct::bundleHash(bundle);
+    const std::filesystem::path cachePath =
+        cache / std::format("{:016x}", hash) / "bundle.sgctbundle";
+
+    sgct::BundleServer server = sgct::BundleServer(bundle, Port);
+
+    // The first request transfers the bundle and caches it
+    const sgct::config::Cluster first = sgct::fetchBundle("127.0.0.1", Port, cache);
+    REQUIRE(std::filesystem::exists(cachePath));
+    CHECK(std::filesystem::file_size(cachePath) == bundle.size());
+    const sgct::config::Viewport& vp = first.nodes[0].windows[0].viewports[0];
+    REQUIRE(vp.correctionMeshTexture.has_value());
+    CHECK(readFile(*vp.correctionMeshTexture) == std::string(10000, 'm'));
+
+    // The second request uses the cached bundle
+    const auto modified = std::filesystem::last_write_time(cachePath);
+    const sgct::config::Cluster second = sgct::fetchBundle("127.0.0.1", Port, cache);
+    CHECK(std::filesystem::last_write_time(cachePath) == modified);
+    CHECK(second == first);
+
+    std::filesystem::remove_all(assets);
+    std::filesystem::remove_all(cache);
+}
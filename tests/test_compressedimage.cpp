@@ -0,0 +1,282 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "equality.h"
+#include <sgct/compressedimage.h>
+#include <sgct/error.h>
+#include <sgct/image.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    // Creates a smooth gradient image with the provided number of channels
+    sgct::Image gradientImage(sgct::ivec2 size, int channels) {
+        sgct::Image img;
+        img.setSize(size);
+        img.setChannels(channels);
+        img.setBytesPerChannel(1);
+        img.allocateOrResizeData();
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++) {
+                unsigned char* p = img.data() + (y * size.x + x) * channels;
+                p[0] = static_cast<unsigned char>(x * 255 / std::max(size.x - 1, 1));
+                p[1] = static_cast<unsigned char>(y * 255 / std::max(size.y - 1, 1));
+                p[2] = static_cast<unsigned char>(128);
+                if (channels == 4) {
+                    p[3] = static_cast<unsigned char>((x + y) * 255 / (size.x + size.y));
+                }
+            }
+        }
+        return img;
+    }
+
+    double rootMeanSquareError(const sgct::Image& a, const sgct::Image& b, int channel) {
+        double sum = 0.0;
+        const size_t nPixels = static_cast<size_t>(a.size().x) * a.size().y;
+        for (size_t i = 0; i < nPixels; i++) {
+            const int va = a.data()[i * a.channels() + channel];
+            const int vb = b.data()[i * b.channels() + channel];
+            sum += (va - vb) * (va - vb);
+        }
+        return std::sqrt(sum / static_cast<double>(nPixels));
+    }
+} // namespace
+
+TEST_CASE("CompressedImage: Level Sizes", "[compressedimage]") {
+    using namespace sgct;
+
+    CHECK(CompressedImage::levelSize(CompressedImage::Format::BC1, ivec2(4, 4)) == 8);
+    CHECK(CompressedImage::levelSize(CompressedImage::Format::BC3, ivec2(4, 4)) == 16);
+    CHECK(CompressedImage::levelSize(CompressedImage::Format::BC1, ivec2(5, 1)) == 16);
+    CHECK(CompressedImage::levelSize(CompressedImage::Format::BC7, ivec2(1, 1)) == 16);
+    CHECK(CompressedImage::levelSize(CompressedImage::Format::BC3, ivec2(16, 8)) == 128);
+}
+
+TEST_CASE("CompressedImage: Encode Mipmaps", "[compressedimage]") {
+    using namespace sgct;
+
+    const Image img = gradientImage(ivec2(64, 16), 3);
+    const CompressedImage c = CompressedImage::encode(img, CompressedImage::Format::BC1);
+    REQUIRE(c.levels().size() == 7);
+    CHECK(c.levels()[0].size == ivec2(64, 16));
+    CHECK(c.levels()[4].size == ivec2(4, 1));
+    CHECK(c.levels()[6].size == ivec2(1, 1));
+    for (const CompressedImage::Level& level : c.levels()) {
+        CHECK(level.data.size() == CompressedImage::levelSize(c.format(), level.size));
+    }
+
+    const CompressedImage single =
+        CompressedImage::encode(img, CompressedImage::Format::BC1, false);
+    CHECK(single.levels().size() == 1);
+}
+
+TEST_CASE("CompressedImage: Encode Decode Error", "[compressedimage]") {
+    using namespace sgct;
+
+    const CompressedImage::Format format =
+        GENERATE(CompressedImage::Format::BC1, CompressedImage::Format::BC3);
+    const int channels = format == CompressedImage::Format::BC3 ? 4 : 3;
+    const Image img = gradientImage(ivec2(64, 64), channels);
+
+    const CompressedImage c = CompressedImage::encode(img, format, false);
+    Image decoded;
+    c.decode(decoded);
+    REQUIRE(decoded.size() == img.size());
+    REQUIRE(decoded.channels() == 4);
+
+    // A smooth gradient is the best case for the block compression, so the error of
+    // each channel has to be in the order of the 5-6 bit endpoint quantization
+    for (int channel = 0; channel < 3; channel++) {
+        CHECK(rootMeanSquareError(img, decoded, channel) < 6.0);
+    }
+    if (channels == 4) {
+        CHECK(rootMeanSquareError(img, decoded, 3) < 2.0);
+    }
+}
+
+TEST_CASE("CompressedImage: Encode Solid Color", "[compressedimage]") {
+    using namespace sgct;
+
+    Image img;
+    img.setSize(ivec2(6, 6));
+    img.setChannels(4);
+    img.setBytesPerChannel(1);
+    img.allocateOrResizeData();
+    for (int i = 0; i < 36; i++) {
+        // BGRA
+        img.data()[i * 4 + 0] = 0;
+        img.data()[i * 4 + 1] = 255;
+        img.data()[i * 4 + 2] = 255;
+        img.data()[i * 4 + 3] = 255;
+    }
+
+    const CompressedImage c = CompressedImage::encode(img, CompressedImage::Format::BC3);
+    Image decoded;
+    c.decode(decoded);
+    REQUIRE(decoded.size() == ivec2(6, 6));
+    for (int i = 0; i < 36; i++) {
+        CHECK(decoded.data()[i * 4 + 0] == 0);
+        CHECK(decoded.data()[i * 4 + 1] == 255);
+        CHECK(decoded.data()[i * 4 + 2] == 255);
+        CHECK(decoded.data()[i * 4 + 3] == 255);
+    }
+}
+
+TEST_CASE("CompressedImage: BC1 Transparency", "[compressedimage]") {
+    using namespace sgct;
+
+    Image img = gradientImage(ivec2(8, 8), 4);
+    for (int i = 0; i < 64; i++) {
+        img.data()[i * 4 + 3] = (i % 2 == 0) ? 0 : 255;
+    }
+
+    const CompressedImage c =
+        CompressedImage::encode(img, CompressedImage::Format::BC1, false);
+    Image decoded;
+    c.decode(decoded);
+    for (int i = 0; i < 64; i++) {
+        CHECK(decoded.data()[i * 4 + 3] == ((i % 2 == 0) ? 0 : 255));
+    }
+}
+
+TEST_CASE("CompressedImage: DDS Roundtrip", "[compressedimage]") {
+    using namespace sgct;
+
+    const CompressedImage::Format format =
+        GENERATE(CompressedImage::Format::BC1, CompressedImage::Format::BC3);
+    // Includes levels whose height is smaller than a block
+    const Image img = gradientImage(ivec2(32, 8), 4);
+    const CompressedImage c = CompressedImage::encode(img, format);
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "sgct-test-compressedimage.dds";
+    c.save(path);
+
+    CompressedImage loaded;
+    loaded.load(path);
+    std::filesystem::remove(path);
+
+    CHECK(loaded.format() == c.format());
+    CHECK(loaded.size() == c.size());
+    REQUIRE(loaded.levels().size() == c.levels().size());
+    for (size_t i = 0; i < c.levels().size(); i++) {
+        CHECK(loaded.levels()[i].size == c.levels()[i].size);
+        CHECK(loaded.levels()[i].data == c.levels()[i].data);
+    }
+}
+
+TEST_CASE("CompressedImage: Top Down", "[compressedimage]") {
+    using namespace sgct;
+
+    const Image img = gradientImage(ivec2(8, 8), 4);
+    const CompressedImage c =
+        CompressedImage::encode(img, CompressedImage::Format::BC3, false);
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "sgct-test-compressedimage-topdown.dds";
+    c.save(path);
+
+    // An 8x6 image has as many blocks as an 8x8 image, but the upper two rows of the
+    // lower blocks are unused, so the blocks cannot be reordered
+    {
+        std::fstream file = std::fstream(
+            path,
+            std::ios::in | std::ios::out | std::ios::binary
+        );
+        // The height follows the magic number, the size of the header, and the flags
+        const uint32_t height = 6;
+        file.seekp(12);
+        file.write(reinterpret_cast<const char*>(&height), sizeof(uint32_t));
+    }
+
+    CompressedImage loaded;
+    loaded.load(path);
+    CHECK(loaded.isTopDown());
+    REQUIRE(loaded.size() == ivec2(8, 6));
+
+    // The top six rows of the 8x8 image, which are still stored bottom to top
+    Image original;
+    c.decode(original);
+    Image decoded;
+    loaded.decode(decoded);
+    for (int y = 0; y < 6; y++) {
+        CHECK(std::memcmp(
+            decoded.data() + y * 8 * 4,
+            original.data() + (y + 2) * 8 * 4,
+            8 * 4
+        ) == 0);
+    }
+
+    // The data is saved top to bottom again
+    loaded.save(path);
+    CompressedImage reloaded;
+    reloaded.load(path);
+    CHECK(reloaded.levels()[0].data == loaded.levels()[0].data);
+    std::filesystem::remove(path);
+
+    // A 6 pixel high mipmap level cannot be saved top to bottom
+    const CompressedImage mipmapped = CompressedImage::encode(
+        gradientImage(ivec2(12, 12), 4),
+        CompressedImage::Format::BC1
+    );
+    CHECK_THROWS_AS(mipmapped.save(path), Error);
+}
+
+TEST_CASE("CompressedImage: KTX2 Level Out Of Bounds", "[compressedimage]") {
+    using namespace sgct;
+
+    // A 4x4 BC1 image with a single level whose offset wraps around when the length of
+    // the level is added to it
+    const std::array<uint8_t, 12> identifier = {
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A
+    };
+    const std::array<uint32_t, 13> header = { 133, 1, 4, 4, 0, 0, 1, 1, 0, 0, 0, 0, 0 };
+    const std::array<uint64_t, 2> supercompression = { 0, 0 };
+    const std::array<uint64_t, 3> level = { ~uint64_t(0) - 3, 8, 8 };
+    const std::array<char, 8> data = {};
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "sgct-test-compressedimage-bounds.ktx2";
+    {
+        std::ofstream file = std::ofstream(path, std::ios::out | std::ios::binary);
+        file.write(reinterpret_cast<const char*>(identifier.data()), sizeof(identifier));
+        file.write(reinterpret_cast<const char*>(header.data()), sizeof(header));
+        file.write(
+            reinterpret_cast<const char*>(supercompression.data()),
+            sizeof(supercompression)
+        );
+        file.write(reinterpret_cast<const char*>(level.data()), sizeof(level));
+        file.write(data.data(), data.size());
+    }
+
+    CompressedImage img;
+    CHECK_THROWS_AS(img.load(path), Error);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("CompressedImage: Encode Benchmark", "[.][compressedimage][benchmark]") {
+    using namespace sgct;
+
+    const Image img = gradientImage(ivec2(2048, 2048), 4);
+
+    BENCHMARK("BC1 2048x2048") {
+        return CompressedImage::encode(img, CompressedImage::Format::BC1).dataSize();
+    };
+
+    BENCHMARK("BC3 2048x2048") {
+        return CompressedImage::encode(img, CompressedImage::Format::BC3).dataSize();
+    };
+}
@@ -7274,6 +7274,54 @@ TEST_CASE("Tracker/Transformation", "[roundtrip]") {
     }
 }
 
+TEST_CASE("Tracker/Prediction", "[roundtrip]") {
+    using Method = sgct::config::Tracker::Prediction::Method;
+    {
+        sgct::config::Cluster input = {
+            .success = true
+        };
+        input.trackers.push_back({
+            .prediction = std::nullopt
+        });
+
+        const std::string str = sgct::serializeConfig(input);
+        const sgct::config::Cluster output = sgct::readJsonConfig(str);
+        REQUIRE(input == output);
+    }
+
+    {
+        sgct::config::Cluster input = {
+            .success = true
+        };
+        input.trackers.push_back({
+            .prediction = sgct::config::Tracker::Prediction{
+                .method = Method::ConstantVelocity
+            }
+        });
+
+        const std::string str = sgct::serializeConfig(input);
+        const sgct::config::Cluster output = sgct::readJsonConfig(str);
+        REQUIRE(input == output);
+    }
+
+    {
+        sgct::config::Cluster input = {
+            .success = true
+        };
+        input.trackers.push_back({
+            .prediction = sgct::config::Tracker::Prediction{
+                .method = Method::DoubleExponential,
+                .latency = 0.025f,
+                .smoothing = 0.4f
+            }
+        });
+
+        const std::string str = sgct::serializeConfig(input);
+        const sgct::config::Cluster output = sgct::readJsonConfig(str);
+        REQUIRE(input == output);
+    }
+}
+
 TEST_CASE("Settings", "[roundtrip]") {
     {
         sgct::config::Cluster input = {
@@ -0,0 +1,109 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "equality.h"
+#include <sgct/configsnapshot.h>
+#include <sgct/readconfig.h>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    std::filesystem::path tempFolder() {
+        std::filesystem::path folder =
+            std::filesystem::temp_directory_path() / "sgct_test_snapshot";
+        std::filesystem::remove_all(folder);
+        std::filesystem::create_directories(folder);
+        return folder;
+    }
+} // namespace
+
+TEST_CASE("Snapshot: Roundtrip", "[snapshot]") {
+    const std::filesystem::path folder = tempFolder();
+
+    // Every configuration that ships with SGCT has to survive the snapshot unchanged
+    const std::filesystem::path configs = std::filesystem::path(BASE_PATH) / "config";
+    size_t nConfigs = 0;
+    for (const std::filesystem::directory_entry& e :
+         std::filesystem::recursive_directory_iterator(configs))
+    {
+        if (e.path().extension() != ".json") {
+            continue;
+        }
+        CAPTURE(e.path().string());
+        const sgct::config::Cluster cluster = sgct::readConfig(e.path());
+        const std::filesystem::path snapshot = folder / "roundtrip.sgctsnapshot";
+        sgct::writeConfigSnapshot(snapshot, cluster, 42);
+
+        const std::optional<sgct::config::Cluster> res =
+            sgct::readConfigSnapshot(snapshot, 42);
+        REQUIRE(res.has_value());
+        CHECK(*res == cluster);
+        nConfigs++;
+    }
+    CHECK(nConfigs > 10);
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("Snapshot: Invalid", "[snapshot]") {
+    const std::filesystem::path folder = tempFolder();
+    const std::filesystem::path snapshot = folder / "invalid.sgctsnapshot";
+
+    const sgct::config::Cluster cluster =
+        sgct::readConfig(std::string(BASE_PATH) + "/config/multi_window.json");
+    sgct::writeConfigSnapshot(snapshot, cluster, 42);
+    CHECK(sgct::readConfigSnapshot(snapshot, 42).has_value());
+
+    // Different source
+    CHECK_FALSE(sgct::readConfigSnapshot(snapshot, 43).has_value());
+
+    // Missing file
+    CHECK_FALSE(sgct::readConfigSnapshot(folder / "missing", 42).has_value());
+
+    // Truncated file
+    const uintmax_t size = std::filesystem::file_size(snapshot);
+    std::filesystem::resize_file(snapshot, size - 5);
+    CHECK_FALSE(sgct::readConfigSnapshot(snapshot, 42).has_value());
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("Snapshot: Read Config", "[snapshot]") {
+    const std::filesystem::path folder = tempFolder();
+    const std::filesystem::path config = folder / "single.json";
+    std::filesystem::copy_file(std::string(BASE_PATH) + "/config/single.json", config);
+    const std::filesystem::path snapshot = sgct::configSnapshotPath(config);
+
+    // The first read creates the snapshot
+    const sgct::config::Cluster cluster = sgct::readConfigWithSnapshot(config);
+    CHECK(cluster.success);
+    REQUIRE(std::filesystem::exists(snapshot));
+    CHECK(sgct::readConfigWithSnapshot(config) == cluster);
+
+    // Changing the configuration invalidates the snapshot
+    {
+        std::ifstream in = std::ifstream(config);
+        std::string contents = std::string(
+            std::istreambuf_iterator<char>(in),
+            std::istreambuf_iterator<char>()
+        );
+        in.close();
+        const size_t pos = contents.find("localhost");
+        REQUIRE(pos != std::string::npos);
+        contents.replace(pos, std::string_view("localhost").size(), "127.0.0.1");
+        std::ofstream out = std::ofstream(config);
+        out << contents;
+    }
+    const sgct::config::Cluster changed = sgct::readConfigWithSnapshot(config);
+    CHECK(changed.masterAddress == "127.0.0.1");
+    CHECK(sgct::readConfigWithSnapshot(config) == changed);
+
+    std::filesystem::remove_all(folder);
+}
@@ -0,0 +1,213 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <sgct/correction/bake.h>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    using sgct::correction::Buffer;
+
+    constexpr unsigned int TriangleStrip = 0x0005; // = GL_TRIANGLE_STRIP
+
+    // A grid covering [-0.5, 0.5] in x and [-1, 0.5] in y, where the texture coordinates
+    // and the color are affine functions of the position, so that the baked values can be
+    // computed exactly
+    Buffer createGrid(unsigned int nCols, unsigned int nRows, bool strip) {
+        Buffer buf;
+        for (unsigned int r = 0; r < nRows; r++) {
+            for (unsigned int c = 0; c < nCols; c++) {
+                const float u = static_cast<float>(c) / static_cast<float>(nCols - 1);
+                const float v = static_cast<float>(r) / static_cast<float>(nRows - 1);
+                buf.vertices.push_back({
+                    .x = u - 0.5f,
+                    .y = 1.5f * v - 1.f,
+                    .s = u,
+                    .t = 0.5f * v + 0.25f,
+                    .r = 1.f - u,
+                    .g = v,
+                    .b = 1.f,
+                    .a = 1.f
+                });
+            }
+        }
+
+        if (strip) {
+            buf.geometryType = TriangleStrip;
+            for (unsigned int r = 0; r < nRows - 1; r++) {
+                for (unsigned int c = 0; c < nCols; c++) {
+                    buf.indices.push_back(c + r * nCols);
+                    buf.indices.push_back(c + (r + 1) * nCols);
+                }
+                // Degenerate triangles to restart the strip at the next row
+                buf.indices.push_back((r + 2) * nCols - 1);
+                buf.indices.push_back((r + 1) * nCols);
+            }
+        }
+        else {
+            for (unsigned int r = 0; r < nRows - 1; r++) {
+                for (unsigned int c = 0; c < nCols - 1; c++) {
+                    const unsigned int i = r * nCols + c;
+                    buf.indices.insert(
+                        buf.indices.end(),
+                        { i, i + 1, i + nCols + 1, i, i + nCols + 1, i + nCols }
+                    );
+                }
+            }
+        }
+        return buf;
+    }
+
+    // Checks that every texel of the baked warp has the value of the affine functions of
+    // createGrid at the center of the corresponding framebuffer pixel
+    void checkBaked(const sgct::correction::BakedWarp& baked, sgct::ivec2 res) {
+        using namespace sgct;
+
+        // Mesh covers pixels [res.x / 4, 3 * res.x / 4) and [0, 3 * res.y / 4)
+        REQUIRE(baked.size.x == res.x / 2);
+        REQUIRE(baked.size.y == 3 * res.y / 4);
+        CHECK(baked.lowerLeft.x == -0.5f);
+        CHECK(baked.lowerLeft.y == -1.f);
+        CHECK(baked.upperRight.x == 0.5f);
+        CHECK(baked.upperRight.y == 0.5f);
+        REQUIRE(baked.lookup.size() == static_cast<size_t>(baked.size.x * baked.size.y));
+        REQUIRE(baked.blend.size() == baked.lookup.size());
+
+        float maxError = 0.f;
+        for (int r = 0; r < baked.size.y; r++) {
+            for (int c = 0; c < baked.size.x; c++) {
+                const float x = 2.f * (res.x / 4 + c + 0.5f) / res.x - 1.f;
+                const float y = 2.f * (r + 0.5f) / res.y - 1.f;
+                const float u = x + 0.5f;
+                const float v = (y + 1.f) / 1.5f;
+
+                const size_t i = static_cast<size_t>(r) * baked.size.x + c;
+                const vec3 l = baked.lookup[i];
+                const vec4 b = baked.blend[i];
+                maxError = std::max({
+                    maxError,
+                    std::abs(l.x - u),
+                    std::abs(l.y - (0.5f * v + 0.25f)),
+                    std::abs(l.z - 1.f),
+                    std::abs(b.x - (1.f - u)),
+                    std::abs(b.y - v),
+                    std::abs(b.z - 1.f),
+                    std::abs(b.w - 1.f)
+                });
+            }
+        }
+        CAPTURE(maxError);
+        CHECK(maxError < 1e-5f);
+    }
+} // namespace
+
+TEST_CASE("Bake: Triangles", "[bake]") {
+    using namespace sgct::correction;
+
+    const sgct::ivec2 res = sgct::ivec2{ 128, 96 };
+    const Buffer grid = createGrid(9, 7, false);
+    const BakedWarp baked = bakeWarp(grid, res, 1);
+    checkBaked(baked, res);
+}
+
+TEST_CASE("Bake: Triangle Strip", "[bake]") {
+    using namespace sgct::correction;
+
+    const sgct::ivec2 res = sgct::ivec2{ 128, 96 };
+    const Buffer grid = createGrid(9, 7, true);
+    const BakedWarp baked = bakeWarp(grid, res, 1);
+    checkBaked(baked, res);
+}
+
+TEST_CASE("Bake: Coverage", "[bake]") {
+    using namespace sgct::correction;
+
+    // A single triangle covering the lower left half of the framebuffer
+    Buffer buf;
+    buf.vertices = {
+        { -1.f, -1.f, 0.f, 0.f, 1.f, 1.f, 1.f, 1.f },
+        {  1.f, -1.f, 1.f, 0.f, 1.f, 1.f, 1.f, 1.f },
+        { -1.f,  1.f, 0.f, 1.f, 1.f, 1.f, 1.f, 1.f }
+    };
+    buf.indices = { 0, 1, 2 };
+
+    const BakedWarp baked = bakeWarp(buf, sgct::ivec2{ 64, 64 }, 4);
+    REQUIRE(baked.size.x == 64);
+    REQUIRE(baked.size.y == 64);
+    for (int r = 0; r < baked.size.y; r++) {
+        for (int c = 0; c < baked.size.x; c++) {
+            const sgct::vec3 l = baked.lookup[r * baked.size.x + c];
+            const sgct::vec4 b = baked.blend[r * baked.size.x + c];
+            // Pixel centers with c + r == 63 lie exactly on the diagonal edge
+            if (c + r < 63) {
+                CHECK(l.z == 1.f);
+                CHECK(b.w == 1.f);
+            }
+            else if (c + r > 63) {
+                CHECK(l.z == 0.f);
+                CHECK(b.w == 0.f);
+            }
+        }
+    }
+
+    // A mesh that is blended to black still covers its pixels
+    for (Buffer::Vertex& v : buf.vertices) {
+        v.r = 0.f;
+        v.g = 0.f;
+        v.b = 0.f;
+        v.a = 0.f;
+    }
+    const BakedWarp black = bakeWarp(buf, sgct::ivec2{ 64, 64 });
+    REQUIRE(black.size.x == 64);
+    CHECK(black.lookup[0].z == 1.f);
+    CHECK(black.blend[0].w == 0.f);
+    CHECK(black.lookup[63 * 64 + 63].z == 0.f);
+
+    // Meshes outside of the framebuffer result in an empty bake
+    for (Buffer::Vertex& v : buf.vertices) {
+        v.x += 3.f;
+    }
+    const BakedWarp outside = bakeWarp(buf, sgct::ivec2{ 64, 64 });
+    CHECK(outside.size.x == 0);
+    CHECK(outside.size.y == 0);
+    CHECK(outside.lookup.empty());
+}
+
+TEST_CASE("Bake: Threads", "[bake]") {
+    using namespace sgct::correction;
+
+    const sgct::ivec2 res = sgct::ivec2{ 333, 211 };
+    const Buffer grid = createGrid(31, 17, false);
+    const BakedWarp single = bakeWarp(grid, res, 1);
+    const BakedWarp multi = bakeWarp(grid, res, 7);
+    REQUIRE(single.lookup.size() == multi.lookup.size());
+    bool isEqual = true;
+    for (size_t i = 0; i < single.lookup.size(); i++) {
+        isEqual &= single.lookup[i].x == multi.lookup[i].x;
+        isEqual &= single.lookup[i].y == multi.lookup[i].y;
+        isEqual &= single.lookup[i].z == multi.lookup[i].z;
+        isEqual &= single.blend[i].x == multi.blend[i].x;
+        isEqual &= single.blend[i].w == multi.blend[i].w;
+    }
+    CHECK(isEqual);
+}
+
+TEST_CASE("Bake: Benchmark", "[.][bake][benchmark]") {
+    using namespace sgct::correction;
+
+    // A 4K framebuffer with a mesh of the density exported by calibration software
+    const sgct::ivec2 res = sgct::ivec2{ 3840, 2160 };
+    const Buffer grid = createGrid(481, 271, true);
+
+    BENCHMARK("Bake 4K") {
+        return bakeWarp(grid, res).lookup.size();
+    };
+}
@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/correction/meshcache.h>
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+
+namespace {
+    sgct::correction::Buffer createBuffer() {
+        sgct::correction::Buffer buf;
+        for (int i = 0; i < 9; i++) {
+            const float f = static_cast<float>(i);
+            buf.vertices.push_back(
+                { f, -f, f / 8.f, 1.f - f / 8.f, 1.f, 0.5f, 0.25f, 1.f }
+            );
+        }
+        buf.indices = { 0, 1, 4, 0, 4, 3, 1, 2, 5, 1, 5, 4 };
+        return buf;
+    }
+
+    std::filesystem::path createSourceMesh() {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-meshcache.obj";
+        std::ofstream(path) << "v 0 0 0\n";
+        return path;
+    }
+} // namespace
+
+TEST_CASE("MeshCache: Roundtrip", "[meshcache]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    const std::filesystem::path source = createSourceMesh();
+    const std::string key =
+        meshCacheKey(source, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f }, 1.5f, false);
+    const std::filesystem::path path = meshCachePath(source, key);
+    CHECK(path.parent_path() == source.parent_path());
+
+    Buffer buf = createBuffer();
+    buf.viewPlane = Buffer::ViewPlane{
+        .up = 30.f,
+        .down = -20.f,
+        .left = -40.f,
+        .right = 45.f,
+        .orientation = quat(0.f, 0.5f, 0.f, 0.866f)
+    };
+    buf.userPosition = vec3{ 1.f, 2.f, 3.f };
+    writeCachedMesh(path, key, buf);
+
+    {
+        const std::optional<CachedMesh> cached = CachedMesh::open(path, key);
+        REQUIRE(cached.has_value());
+        CHECK(cached->geometryType() == buf.geometryType);
+        REQUIRE(cached->vertices().size() == buf.vertices.size());
+        for (size_t i = 0; i < buf.vertices.size(); i++) {
+            CHECK(cached->vertices()[i].x == buf.vertices[i].x);
+            CHECK(cached->vertices()[i].y == buf.vertices[i].y);
+            CHECK(cached->vertices()[i].s == buf.vertices[i].s);
+            CHECK(cached->vertices()[i].t == buf.vertices[i].t);
+            CHECK(cached->vertices()[i].b == buf.vertices[i].b);
+        }
+        CHECK(std::equal(
+            cached->indices().begin(), cached->indices().end(),
+            buf.indices.begin(), buf.indices.end()
+        ));
+
+        REQUIRE(cached->viewPlane().has_value());
+        CHECK(cached->viewPlane()->up == 30.f);
+        CHECK(cached->viewPlane()->right == 45.f);
+        CHECK(cached->viewPlane()->orientation.w == 0.866f);
+        CHECK_FALSE(cached->projectionOffset().has_value());
+        REQUIRE(cached->userPosition().has_value());
+        CHECK(cached->userPosition()->z == 3.f);
+
+        const Buffer copy = cached->toBuffer();
+        CHECK(copy.indices == buf.indices);
+        CHECK(copy.vertices.size() == buf.vertices.size());
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(source);
+}
+
+TEST_CASE("MeshCache: Stale Key", "[meshcache]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    const std::filesystem::path source = createSourceMesh();
+    const std::string key =
+        meshCacheKey(source, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f }, 1.5f, false);
+    const std::filesystem::path path = meshCachePath(source, key);
+    writeCachedMesh(path, key, createBuffer());
+
+    // A different viewport results in a different key and cache file
+    const std::string otherViewport =
+        meshCacheKey(source, vec2{ 0.5f, 0.f }, vec2{ 0.5f, 1.f }, 1.5f, false);
+    CHECK(otherViewport != key);
+    CHECK(meshCachePath(source, otherViewport) != path);
+    CHECK_FALSE(CachedMesh::open(path, otherViewport).has_value());
+
+    // Modifying the source mesh invalidates the cache, but uses the same cache file
+    std::filesystem::last_write_time(
+        source,
+        std::filesystem::last_write_time(source) + std::chrono::seconds(10)
+    );
+    const std::string modified =
+        meshCacheKey(source, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f }, 1.5f, false);
+    CHECK(modified != key);
+    CHECK(meshCachePath(source, modified) == path);
+    CHECK_FALSE(CachedMesh::open(path, modified).has_value());
+
+    // Missing and truncated files are ignored
+    CHECK_FALSE(CachedMesh::open(path.string() + ".missing", key).has_value());
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 4);
+    CHECK_FALSE(CachedMesh::open(path, key).has_value());
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(source);
+}
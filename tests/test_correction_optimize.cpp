@@ -0,0 +1,181 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/correction/optimize.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+namespace {
+    using sgct::correction::Buffer;
+
+    constexpr unsigned int Triangles = 0x0004; // = GL_TRIANGLES
+    constexpr unsigned int TriangleStrip = 0x0005; // = GL_TRIANGLE_STRIP
+
+    Buffer createGrid(unsigned int nCols, unsigned int nRows) {
+        Buffer buf;
+        for (unsigned int r = 0; r < nRows; r++) {
+            for (unsigned int c = 0; c < nCols; c++) {
+                const float u = static_cast<float>(c) / static_cast<float>(nCols - 1);
+                const float v = static_cast<float>(r) / static_cast<float>(nRows - 1);
+                buf.vertices.push_back({
+                    .x = 2.f * u - 1.f,
+                    .y = 2.f * v - 1.f,
+                    .s = u,
+                    .t = v,
+                    .r = 1.f - u,
+                    .g = v,
+                    .b = 1.f,
+                    .a = 1.f
+                });
+            }
+        }
+        return buf;
+    }
+
+    // Same order as the DomeProjection loader, which emits the cells column by column
+    void addColumnMajorTriangles(Buffer& buf, unsigned int nCols, unsigned int nRows) {
+        for (unsigned int c = 0; c < nCols - 1; c++) {
+            for (unsigned int r = 0; r < nRows - 1; r++) {
+                const unsigned int i = r * nCols + c;
+                buf.indices.insert(
+                    buf.indices.end(),
+                    { i, i + 1, i + nCols + 1, i, i + nCols + 1, i + nCols }
+                );
+            }
+        }
+    }
+
+    using Triangle = std::array<std::tuple<float, float>, 3>;
+
+    // Returns the positions of all triangles, rotated so that each triangle starts with
+    // its smallest vertex, which makes the result independent of the vertex order while
+    // keeping the winding of the triangles
+    std::vector<Triangle> triangles(const Buffer& buf) {
+        std::vector<Triangle> res;
+        const bool isStrip = buf.geometryType == TriangleStrip;
+        const size_t step = isStrip ? 1 : 3;
+        for (size_t i = 0; i + 2 < buf.indices.size(); i += step) {
+            std::array<unsigned int, 3> idx = {
+                buf.indices[i], buf.indices[i + 1], buf.indices[i + 2]
+            };
+            if (idx[0] == idx[1] || idx[0] == idx[2] || idx[1] == idx[2]) {
+                continue;
+            }
+            if (isStrip && i % 2 == 1) {
+                std::swap(idx[0], idx[1]);
+            }
+            Triangle t;
+            for (size_t j = 0; j < 3; j++) {
+                const Buffer::Vertex& v = buf.vertices[idx[j]];
+                t[j] = { v.x, v.y };
+            }
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            res.push_back(t);
+        }
+        std::sort(res.begin(), res.end());
+        return res;
+    }
+} // namespace
+
+TEST_CASE("Optimize: Column Major Grid", "[optimize]") {
+    using namespace sgct::correction;
+
+    constexpr unsigned int nCols = 120;
+    constexpr unsigned int nRows = 80;
+    Buffer grid = createGrid(nCols, nRows);
+    addColumnMajorTriangles(grid, nCols, nRows);
+    // Unreferenced vertex at the end
+    grid.vertices.push_back({ .x = 5.f, .y = 5.f });
+
+    const float before = averageCacheMissRatio(grid);
+    const std::vector<Triangle> expected = triangles(grid);
+
+    Buffer optimized = grid;
+    optimizeVertexCache(optimized);
+    const float after = averageCacheMissRatio(optimized);
+    CAPTURE(before, after);
+
+    CHECK(optimized.geometryType == Triangles);
+    CHECK(optimized.vertices.size() == nCols * nRows);
+    CHECK(optimized.indices.size() == grid.indices.size());
+    CHECK(triangles(optimized) == expected);
+    CHECK(before > 0.95f);
+    CHECK(after < 0.75f);
+
+    // Vertices are sorted by their first use
+    unsigned int next = 0;
+    for (unsigned int i : optimized.indices) {
+        REQUIRE(i <= next);
+        next = std::max(next, i + 1);
+    }
+}
+
+TEST_CASE("Optimize: Triangle Strip", "[optimize]") {
+    using namespace sgct::correction;
+
+    // Same triangle strip as created by the PFM loader
+    constexpr unsigned int nCols = 50;
+    constexpr unsigned int nRows = 40;
+    Buffer grid = createGrid(nCols, nRows);
+    grid.geometryType = TriangleStrip;
+    for (unsigned int r = 0; r < nRows - 1; r++) {
+        if ((r & 1) == 0) {
+            for (unsigned int c = 0; c < nCols; c++) {
+                grid.indices.push_back(c + r * nCols);
+                grid.indices.push_back(c + (r + 1) * nCols);
+            }
+        }
+        else {
+            for (unsigned int c = nCols - 1; c > 0; c--) {
+                grid.indices.push_back(c + (r + 1) * nCols);
+                grid.indices.push_back(c - 1 + r * nCols);
+            }
+        }
+    }
+
+    const float before = averageCacheMissRatio(grid);
+    const std::vector<Triangle> expected = triangles(grid);
+
+    optimizeVertexCache(grid);
+    const float after = averageCacheMissRatio(grid);
+    CAPTURE(before, after);
+
+    CHECK(grid.geometryType == Triangles);
+    CHECK(triangles(grid) == expected);
+    CHECK(after < before);
+}
+
+TEST_CASE("Optimize: Compact Vertices", "[optimize]") {
+    using namespace sgct::correction;
+
+    Buffer grid = createGrid(33, 17);
+    std::optional<std::vector<CompactVertex>> compact = compactVertices(grid.vertices);
+    REQUIRE(compact.has_value());
+    REQUIRE(compact->size() == grid.vertices.size());
+    for (size_t i = 0; i < grid.vertices.size(); i++) {
+        const Buffer::Vertex& v = grid.vertices[i];
+        const CompactVertex& c = (*compact)[i];
+        CHECK(c.x == v.x);
+        CHECK(c.y == v.y);
+        CHECK(std::abs(c.s / 65535.f - v.s) <= 0.501f / 65535.f);
+        CHECK(std::abs(c.t / 65535.f - v.t) <= 0.501f / 65535.f);
+        CHECK(std::abs(c.r / 255.f - v.r) <= 0.501f / 255.f);
+        CHECK(std::abs(c.g / 255.f - v.g) <= 0.501f / 255.f);
+        CHECK(c.b == 255);
+        CHECK(c.a == 255);
+    }
+
+    // Texture coordinates outside of [0, 1] can not be represented
+    grid.vertices[5].s = 1.5f;
+    CHECK_FALSE(compactVertices(grid.vertices).has_value());
+}
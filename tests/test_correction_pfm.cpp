@@ -0,0 +1,120 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <sgct/error.h>
+#include <sgct/correction/pfm.h>
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace {
+    // Interleaved RGB values where red and green store the corrections
+    std::vector<float> createCorrections(unsigned int nCols, unsigned int nRows) {
+        std::vector<float> res;
+        res.reserve(static_cast<size_t>(nCols) * nRows * 3);
+        for (unsigned int r = 0; r < nRows; r++) {
+            for (unsigned int c = 0; c < nCols; c++) {
+                res.push_back(static_cast<float>(c) / nCols + 0.01f);
+                res.push_back(static_cast<float>(r) / nRows - 0.02f);
+                res.push_back(0.f);
+            }
+        }
+        return res;
+    }
+
+    std::filesystem::path writePFM(const std::vector<float>& values, unsigned int nCols,
+                                   unsigned int nRows, bool littleEndian)
+    {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-pfm.pfm";
+        std::ofstream file = std::ofstream(path, std::ios::out | std::ios::binary);
+        file << "PF\n" << nCols << ' ' << nRows << '\n';
+        file << (littleEndian ? -1 : 1) << '\n';
+
+        const bool swap = littleEndian != (std::endian::native == std::endian::little);
+        for (float f : values) {
+            uint32_t v = std::bit_cast<uint32_t>(f);
+            if (swap) {
+                v = (v >> 24) | ((v >> 8) & 0xff00) | ((v << 8) & 0xff0000) | (v << 24);
+            }
+            file.write(reinterpret_cast<const char*>(&v), sizeof(uint32_t));
+        }
+        return path;
+    }
+} // namespace
+
+TEST_CASE("PFM: Endianness", "[pfm]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    constexpr unsigned int nCols = 7;
+    constexpr unsigned int nRows = 5;
+    const std::vector<float> values = createCorrections(nCols, nRows);
+    const vec2 pos = vec2{ 0.25f, 0.f };
+    const vec2 size = vec2{ 0.5f, 1.f };
+
+    const std::filesystem::path little = writePFM(values, nCols, nRows, true);
+    const Buffer l = generatePerEyeMeshFromPFMImage(little, pos, size, true);
+    std::filesystem::remove(little);
+
+    const std::filesystem::path big = writePFM(values, nCols, nRows, false);
+    const Buffer b = generatePerEyeMeshFromPFMImage(big, pos, size, true);
+    std::filesystem::remove(big);
+
+    REQUIRE(l.vertices.size() == nCols * nRows);
+    REQUIRE(b.vertices.size() == l.vertices.size());
+    CHECK(b.indices == l.indices);
+    // Two even and two odd rows in the triangle strip
+    CHECK(l.indices.size() == 2 * 2 * nCols + 2 * 2 * (nCols - 1));
+    for (size_t i = 0; i < l.vertices.size(); i++) {
+        // The corrections are stored in the texture coordinates in texture render mode
+        CHECK(l.vertices[i].s == values[i * 3] + pos.x);
+        CHECK(l.vertices[i].t == values[i * 3 + 1] + pos.y);
+        CHECK(b.vertices[i].s == l.vertices[i].s);
+        CHECK(b.vertices[i].t == l.vertices[i].t);
+        CHECK(b.vertices[i].x == l.vertices[i].x);
+        CHECK(b.vertices[i].y == l.vertices[i].y);
+    }
+}
+
+TEST_CASE("PFM: Truncated File", "[pfm]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    std::vector<float> values = createCorrections(4, 4);
+    values.pop_back();
+    const std::filesystem::path path = writePFM(values, 4, 4, true);
+    CHECK_THROWS_AS(
+        generatePerEyeMeshFromPFMImage(path, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f }),
+        Error
+    );
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("PFM: Loader Benchmark", "[.][pfm][benchmark]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    // A 4K warp map with side-by-side stereo
+    constexpr unsigned int nCols = 2 * 3840;
+    constexpr unsigned int nRows = 2160;
+    const std::vector<float> values = createCorrections(nCols, nRows);
+    const std::filesystem::path path = writePFM(values, nCols, nRows, true);
+
+    BENCHMARK("PFM 4K stereo") {
+        return generatePerEyeMeshFromPFMImage(
+            path, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f }
+        ).vertices.size();
+    };
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,201 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/correction/simplify.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <optional>
+
+namespace {
+    using sgct::correction::Buffer;
+
+    constexpr unsigned int TriangleStrip = 0x0005; // = GL_TRIANGLE_STRIP
+
+    // A dense grid with a smooth warp and a blend ramp at the right edge, similar to the
+    // meshes that are exported by projector calibration software
+    Buffer createGrid(unsigned int nCols, unsigned int nRows) {
+        Buffer buf;
+        for (unsigned int r = 0; r < nRows; r++) {
+            for (unsigned int c = 0; c < nCols; c++) {
+                const float u = static_cast<float>(c) / static_cast<float>(nCols - 1);
+                const float v = static_cast<float>(r) / static_cast<float>(nRows - 1);
+                const float blend = std::clamp((1.f - u) * 5.f, 0.f, 1.f);
+                buf.vertices.push_back({
+                    .x = 2.f * u - 1.f + 0.05f * std::sin(3.f * v),
+                    .y = 2.f * v - 1.f + 0.03f * u * u,
+                    .s = u + 0.02f * std::sin(3.f * v),
+                    .t = v + 0.04f * u * u,
+                    .r = blend,
+                    .g = blend,
+                    .b = blend,
+                    .a = 1.f
+                });
+            }
+        }
+        return buf;
+    }
+
+    void addTriangles(Buffer& buf, unsigned int nCols, unsigned int nRows,
+                      const std::function<bool(unsigned int, unsigned int)>& isHole)
+    {
+        for (unsigned int r = 0; r < nRows - 1; r++) {
+            for (unsigned int c = 0; c < nCols - 1; c++) {
+                if (isHole(c, r)) {
+                    continue;
+                }
+                const unsigned int i = r * nCols + c;
+                buf.indices.insert(
+                    buf.indices.end(),
+                    { i, i + 1, i + nCols + 1, i, i + nCols + 1, i + nCols }
+                );
+            }
+        }
+    }
+
+    // Same triangle strip as created by the PFM loader
+    void addTriangleStrip(Buffer& buf, unsigned int nCols, unsigned int nRows) {
+        buf.geometryType = TriangleStrip;
+        for (unsigned int r = 0; r < nRows - 1; r++) {
+            if ((r & 1) == 0) {
+                for (unsigned int c = 0; c < nCols; c++) {
+                    buf.indices.push_back(c + r * nCols);
+                    buf.indices.push_back(c + (r + 1) * nCols);
+                }
+            }
+            else {
+                for (unsigned int c = nCols - 1; c > 0; c--) {
+                    buf.indices.push_back(c + (r + 1) * nCols);
+                    buf.indices.push_back(c - 1 + r * nCols);
+                }
+            }
+        }
+    }
+
+    // Returns the simplified vertex interpolated at the position of p or std::nullopt if
+    // p is not covered by the simplified mesh
+    std::optional<Buffer::Vertex> sample(const Buffer& mesh, const Buffer::Vertex& p) {
+        for (size_t i = 0; i < mesh.indices.size(); i += 3) {
+            const Buffer::Vertex& v0 = mesh.vertices[mesh.indices[i]];
+            const Buffer::Vertex& v1 = mesh.vertices[mesh.indices[i + 1]];
+            const Buffer::Vertex& v2 = mesh.vertices[mesh.indices[i + 2]];
+            const float det =
+                (v1.y - v2.y) * (v0.x - v2.x) + (v2.x - v1.x) * (v0.y - v2.y);
+            if (det == 0.f) {
+                continue;
+            }
+            const float l0 =
+                ((v1.y - v2.y) * (p.x - v2.x) + (v2.x - v1.x) * (p.y - v2.y)) / det;
+            const float l1 =
+                ((v2.y - v0.y) * (p.x - v2.x) + (v0.x - v2.x) * (p.y - v2.y)) / det;
+            const float l2 = 1.f - l0 - l1;
+            if (l0 >= -1e-4f && l1 >= -1e-4f && l2 >= -1e-4f) {
+                return Buffer::Vertex{
+                    .x = p.x,
+                    .y = p.y,
+                    .s = l0 * v0.s + l1 * v1.s + l2 * v2.s,
+                    .t = l0 * v0.t + l1 * v1.t + l2 * v2.t,
+                    .r = l0 * v0.r + l1 * v1.r + l2 * v2.r,
+                    .g = l0 * v0.g + l1 * v1.g + l2 * v2.g,
+                    .b = l0 * v0.b + l1 * v1.b + l2 * v2.b,
+                    .a = l0 * v0.a + l1 * v1.a + l2 * v2.a
+                };
+            }
+        }
+        return std::nullopt;
+    }
+} // namespace
+
+TEST_CASE("Simplify: Warp Error", "[simplify]") {
+    using namespace sgct::correction;
+
+    constexpr unsigned int nCols = 129;
+    constexpr unsigned int nRows = 97;
+    constexpr float MaxError = 0.001f;
+    Buffer grid = createGrid(nCols, nRows);
+    addTriangles(grid, nCols, nRows, [](unsigned int, unsigned int) { return false; });
+
+    const std::optional<Buffer> simplified = simplifyMesh(grid, MaxError);
+    REQUIRE(simplified.has_value());
+    CHECK(simplified->geometryType == grid.geometryType);
+
+    float maxTexCoordError = 0.f;
+    float maxColorError = 0.f;
+    size_t nUncovered = 0;
+    for (const Buffer::Vertex& v : grid.vertices) {
+        const std::optional<Buffer::Vertex> s = sample(*simplified, v);
+        if (!s) {
+            nUncovered++;
+            continue;
+        }
+        maxTexCoordError = std::max(maxTexCoordError, std::hypot(s->s - v.s, s->t - v.t));
+        maxColorError = std::max(maxColorError, std::abs(s->r - v.r));
+    }
+
+    const float reduction =
+        static_cast<float>(grid.indices.size()) / simplified->indices.size();
+    CAPTURE(maxTexCoordError, maxColorError, reduction);
+    CHECK(nUncovered == 0);
+    CHECK(maxTexCoordError <= MaxError * 1.01f);
+    CHECK(maxColorError <= 1.01f / 255.f);
+    CHECK(reduction > 10.f);
+}
+
+TEST_CASE("Simplify: Holes", "[simplify]") {
+    using namespace sgct::correction;
+
+    constexpr unsigned int nCols = 65;
+    constexpr unsigned int nRows = 65;
+    const auto isHole = [](unsigned int c, unsigned int r) {
+        return c >= 20 && c < 37 && r >= 10 && r < 50;
+    };
+    Buffer grid = createGrid(nCols, nRows);
+    addTriangles(grid, nCols, nRows, isHole);
+
+    const std::optional<Buffer> simplified = simplifyMesh(grid, 0.01f);
+    REQUIRE(simplified.has_value());
+    CHECK(simplified->indices.size() < grid.indices.size());
+
+    // Vertices at the center of the hole are not covered by the simplified mesh, but all
+    // vertices outside of the hole are
+    for (unsigned int r = 0; r < nRows; r++) {
+        for (unsigned int c = 0; c < nCols; c++) {
+            const bool isInside = c > 20 && c < 37 && r > 10 && r < 50;
+            const Buffer::Vertex& v = grid.vertices[r * nCols + c];
+            CHECK(sample(*simplified, v).has_value() != isInside);
+        }
+    }
+}
+
+TEST_CASE("Simplify: Triangle Strip", "[simplify]") {
+    using namespace sgct::correction;
+
+    constexpr unsigned int nCols = 40;
+    constexpr unsigned int nRows = 30;
+    Buffer grid = createGrid(nCols, nRows);
+    addTriangleStrip(grid, nCols, nRows);
+
+    const std::optional<Buffer> simplified = simplifyMesh(grid, 0.001f);
+    REQUIRE(simplified.has_value());
+    CHECK(simplified->vertices.size() < grid.vertices.size());
+    for (const Buffer::Vertex& v : grid.vertices) {
+        const std::optional<Buffer::Vertex> s = sample(*simplified, v);
+        REQUIRE(s.has_value());
+        CHECK(std::hypot(s->s - v.s, s->t - v.t) <= 0.00101f);
+    }
+}
+
+TEST_CASE("Simplify: Irregular Mesh", "[simplify]") {
+    using namespace sgct::correction;
+
+    Buffer buf = createGrid(5, 5);
+    buf.indices = { 0, 1, 7, 7, 12, 24, 3, 18, 20 };
+    CHECK_FALSE(simplifyMesh(buf, 0.01f).has_value());
+}
@@ -0,0 +1,432 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/correction/domeprojection.h>
+#include <sgct/correction/obj.h>
+#include <sgct/correction/paulbourke.h>
+#include <sgct/correction/scalable.h>
+#include <sgct/correction/skyskan.h>
+#include <sgct/correction/tokenizer.h>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+    // The vertices of a regular grid with random positions and texture coordinates
+    struct GridVertex {
+        float x = 0.f;
+        float y = 0.f;
+        float s = 0.f;
+        float t = 0.f;
+        int intensity = 255;
+    };
+
+    std::vector<GridVertex> randomGrid(int nCols, int nRows, unsigned int seed) {
+        std::mt19937 gen = std::mt19937(seed);
+        std::uniform_real_distribution<float> dist =
+            std::uniform_real_distribution(0.f, 1.f);
+        std::uniform_int_distribution<int> intensity =
+            std::uniform_int_distribution(0, 255);
+
+        std::vector<GridVertex> res;
+        res.reserve(static_cast<size_t>(nCols) * nRows);
+        for (int i = 0; i < nCols * nRows; i++) {
+            res.push_back({ dist(gen), dist(gen), dist(gen), dist(gen), intensity(gen) });
+        }
+        return res;
+    }
+
+    // Writes the mesh with enough digits that every float survives the roundtrip, so the
+    // parsed values have to be bit-identical to the ones that were written
+    std::ofstream openMesh(const std::filesystem::path& path) {
+        std::ofstream file = std::ofstream(path, std::ios::binary);
+        file << std::setprecision(9);
+        return file;
+    }
+
+    std::filesystem::path writeOBJ(const std::vector<GridVertex>& grid, int nCols) {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-tokenizer.obj";
+        std::ofstream file = openMesh(path);
+        file << "# Test mesh\r\no grid\n\n";
+        for (const GridVertex& v : grid) {
+            file << "v " << v.x << ' ' << v.y << " 0\n";
+        }
+        for (const GridVertex& v : grid) {
+            file << "vt " << v.s << ' ' << v.t << '\n';
+        }
+        const int nRows = static_cast<int>(grid.size()) / nCols;
+        for (int r = 0; r < nRows - 1; r++) {
+            for (int c = 0; c < nCols - 1; c++) {
+                const int i0 = r * nCols + c + 1;
+                const int i1 = i0 + 1;
+                const int i2 = i0 + nCols;
+                file << "f " << i0 << '/' << i0 << ' ' << i1 << '/' << i1 << ' ' <<
+                    i2 << '/' << i2 << '\n';
+            }
+        }
+        return path;
+    }
+
+    std::filesystem::path writeScalable(const std::vector<GridVertex>& grid, int nCols) {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-tokenizer.ol";
+        const int nRows = static_cast<int>(grid.size()) / nCols;
+        std::ofstream file = openMesh(path);
+        file << "OPENMESH Version 1.1\r\n";
+        file << "VERTICES " << grid.size() << "\r\n";
+        file << "FACES " << (nCols - 1) * (nRows - 1) << "\r\n";
+        file << "NATIVEXRES 1920\r\nNATIVEYRES 1080\r\n";
+        file << "ORTHO_LEFT 0\r\nORTHO_RIGHT 1\r\nORTHO_TOP 1\r\nORTHO_BOTTOM 0\r\n";
+        file << "PERSPECTIVE_TOP 30.5\r\nPERSPECTIVE_BOTTOM -20\r\n";
+        for (const GridVertex& v : grid) {
+            file << v.x * 1920.f << ' ' << v.y * 1080.f << ' ' << v.intensity << ' ' <<
+                v.s << ' ' << v.t << " \r\n";
+        }
+        for (int r = 0; r < nRows - 1; r++) {
+            for (int c = 0; c < nCols - 1; c++) {
+                const int i0 = r * nCols + c;
+                file << "[ " << i0 << ' ' << i0 + 1 << ' ' << i0 + nCols << " ]\r\n";
+            }
+        }
+        return path;
+    }
+
+    std::filesystem::path writeDomeProjection(const std::vector<GridVertex>& grid,
+                                              int nCols)
+    {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-tokenizer.csv";
+        std::ofstream file = openMesh(path);
+        file << "x;y;u;v;column;row\n";
+        for (size_t i = 0; i < grid.size(); i++) {
+            const GridVertex& v = grid[i];
+            file << v.x << ';' << v.y << ';' << v.s << ';' << v.t << ';' << i % nCols <<
+                ';' << i / nCols << '\n';
+        }
+        return path;
+    }
+
+    std::filesystem::path writePaulBourke(const std::vector<GridVertex>& grid,
+                                          int nCols)
+    {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-tokenizer.data";
+        std::ofstream file = openMesh(path);
+        file << "2\n" << nCols << ' ' << grid.size() / nCols << '\n';
+        for (const GridVertex& v : grid) {
+            file << v.x << ' ' << v.y << ' ' << v.s << ' ' << v.t << ' ' <<
+                v.intensity / 255.f << '\n';
+        }
+        return path;
+    }
+
+    std::filesystem::path writeSkySkan(const std::vector<GridVertex>& grid, int nCols) {
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-tokenizer.skyskan";
+        std::ofstream file = openMesh(path);
+        file << "Dome Azimuth=15\nDome Elevation=30\n";
+        file << "Horizontal FOV=90\nVertical FOV=60\n";
+        file << nCols << ' ' << grid.size() / nCols << '\n';
+        for (const GridVertex& v : grid) {
+            file << v.x << ' ' << v.y << ' ' << v.s << ' ' << v.t << '\n';
+        }
+        return path;
+    }
+
+    // The conversion that was used by the loaders before they were ported to the
+    // Tokenizer. The Tokenizer must accept exactly the same numbers, except for subnormal
+    // numbers that std::stof rejects as out of range
+    std::optional<float> referenceFloat(const std::string& str) {
+        try {
+            return std::stof(str);
+        }
+        catch (const std::invalid_argument&) {
+            return std::nullopt;
+        }
+        catch (const std::out_of_range&) {
+            const float value = std::strtof(str.c_str(), nullptr);
+            if (std::fpclassify(value) == FP_SUBNORMAL) {
+                return value;
+            }
+            return std::nullopt;
+        }
+    }
+
+    std::optional<int> referenceInt(const std::string& str) {
+        try {
+            return std::stoi(str);
+        }
+        catch (const std::invalid_argument&) {
+            return std::nullopt;
+        }
+        catch (const std::out_of_range&) {
+            return std::nullopt;
+        }
+    }
+} // namespace
+
+TEST_CASE("Tokenizer: Lines and Tokens", "[tokenizer]") {
+    using namespace sgct::correction;
+
+    Tokenizer tokenizer = Tokenizer("first line\r\n\n  \t\r\n second\tline  \nlast");
+    REQUIRE(tokenizer.nextLine());
+    CHECK(tokenizer.line() == "first line");
+    CHECK(tokenizer.nextToken() == "first");
+    CHECK(tokenizer.rest() == "line");
+    CHECK(tokenizer.nextToken() == "line");
+    CHECK(tokenizer.nextToken().empty());
+
+    // Empty lines and lines with only whitespace are skipped
+    REQUIRE(tokenizer.nextLine());
+    CHECK(tokenizer.nextToken() == "second");
+    CHECK(tokenizer.nextToken() == "line");
+    CHECK(tokenizer.nextToken().empty());
+
+    // The last line does not need a line terminator
+    REQUIRE(tokenizer.nextLine());
+    CHECK(tokenizer.line() == "last");
+    CHECK_FALSE(tokenizer.nextLine());
+
+    Tokenizer csv = Tokenizer("0.5; 1 ;2;x\n", ";");
+    REQUIRE(csv.nextLine());
+    CHECK(csv.nextFloat() == 0.5f);
+    CHECK(csv.nextInt() == 1);
+    CHECK(csv.nextUnsignedInt() == 2u);
+    CHECK_FALSE(csv.nextFloat().has_value());
+    CHECK_FALSE(csv.nextFloat().has_value());
+
+    CHECK_FALSE(Tokenizer("").nextLine());
+}
+
+TEST_CASE("Tokenizer: Number Conversion", "[tokenizer]") {
+    using namespace sgct::correction;
+
+    CHECK(toFloat("1.5") == 1.5f);
+    CHECK(toFloat("  +2.25") == 2.25f);
+    CHECK(toFloat("-1e-3") == -1e-3f);
+    CHECK(toFloat("3/4") == 3.f);
+    CHECK_FALSE(toFloat("").has_value());
+    CHECK_FALSE(toFloat("+").has_value());
+    CHECK_FALSE(toFloat("+-1").has_value());
+    CHECK_FALSE(toFloat("abc").has_value());
+    CHECK_FALSE(toFloat("1e99").has_value());
+
+    CHECK(toInt("12/12/12") == 12);
+    CHECK(toInt("-7") == -7);
+    CHECK_FALSE(toInt("99999999999").has_value());
+    CHECK(toUnsignedInt("7") == 7u);
+    CHECK_FALSE(toUnsignedInt("-7").has_value());
+}
+
+TEST_CASE("Tokenizer: Fuzz Against Standard Library", "[tokenizer]") {
+    using namespace sgct::correction;
+
+    std::mt19937 gen = std::mt19937(1234);
+
+    // Random character soup that consists mostly of the characters of numbers
+    constexpr std::string_view Alphabet = "0123456789.e-+ /a";
+    std::uniform_int_distribution<size_t> character =
+        std::uniform_int_distribution<size_t>(0, Alphabet.size() - 1);
+    std::uniform_int_distribution<int> length = std::uniform_int_distribution(0, 12);
+    for (int i = 0; i < 20000; i++) {
+        std::string str;
+        const int len = length(gen);
+        for (int j = 0; j < len; j++) {
+            str += Alphabet[character(gen)];
+        }
+
+        const std::optional<float> f = toFloat(str);
+        const std::optional<float> refF = referenceFloat(str);
+        REQUIRE(f.has_value() == refF.has_value());
+        if (f) {
+            REQUIRE(*f == *refF);
+        }
+
+        const std::optional<int> n = toInt(str);
+        const std::optional<int> refN = referenceInt(str);
+        REQUIRE(n.has_value() == refN.has_value());
+        if (n) {
+            REQUIRE(*n == *refN);
+        }
+    }
+
+    // Random floats of all magnitudes in fixed and scientific notation
+    std::uniform_real_distribution<float> mantissa =
+        std::uniform_real_distribution(-1.f, 1.f);
+    std::uniform_int_distribution<int> exponent = std::uniform_int_distribution(-30, 30);
+    for (int i = 0; i < 20000; i++) {
+        const float value = std::ldexp(mantissa(gen), exponent(gen));
+        std::ostringstream stream;
+        if (i % 2 == 0) {
+            stream << std::setprecision(9) << value;
+        }
+        else {
+            stream << std::scientific << std::setprecision(i % 9) << value;
+        }
+        const std::string str = stream.str();
+
+        const std::optional<float> f = toFloat(str);
+        REQUIRE(f.has_value());
+        REQUIRE(*f == std::stof(str));
+    }
+}
+
+TEST_CASE("Tokenizer: OBJ Loader", "[tokenizer]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    constexpr int nCols = 7;
+    const std::vector<GridVertex> grid = randomGrid(nCols, 5, 1);
+    const std::filesystem::path path = writeOBJ(grid, nCols);
+    const Buffer buf = generateOBJMesh(path);
+    std::filesystem::remove(path);
+
+    REQUIRE(buf.vertices.size() == grid.size());
+    for (size_t i = 0; i < grid.size(); i++) {
+        CHECK(buf.vertices[i].x == grid[i].x);
+        CHECK(buf.vertices[i].y == grid[i].y);
+        CHECK(buf.vertices[i].s == grid[i].s);
+        CHECK(buf.vertices[i].t == grid[i].t);
+    }
+    REQUIRE(buf.indices.size() == 6 * 4 * 3);
+    CHECK(buf.indices[0] == 0);
+    CHECK(buf.indices[1] == 1);
+    CHECK(buf.indices[2] == nCols);
+}
+
+TEST_CASE("Tokenizer: Scalable Loader", "[tokenizer]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    constexpr int nCols = 6;
+    const std::vector<GridVertex> grid = randomGrid(nCols, 4, 2);
+    const std::filesystem::path path = writeScalable(grid, nCols);
+    const vec2 pos = vec2{ 0.25f, 0.f };
+    const vec2 size = vec2{ 0.5f, 1.f };
+    const Buffer buf = generateScalableMesh(path, pos, size);
+    std::filesystem::remove(path);
+
+    REQUIRE(buf.vertices.size() == grid.size());
+    for (size_t i = 0; i < grid.size(); i++) {
+        const float x = ((grid[i].x * 1920.f) / 1920.f) * size.x + pos.x;
+        const float y = ((grid[i].y * 1080.f) / 1080.f) * size.y + pos.y;
+        CHECK(std::abs(buf.vertices[i].x - (x * 2.f - 1.f)) < 1e-5f);
+        CHECK(std::abs(buf.vertices[i].y - (y * 2.f - 1.f)) < 1e-5f);
+        CHECK(buf.vertices[i].r == grid[i].intensity / 255.f);
+        CHECK(buf.vertices[i].s == (1.f - grid[i].t) * size.x + pos.x);
+        CHECK(buf.vertices[i].t == (1.f - grid[i].s) * size.x + pos.x);
+    }
+    CHECK(buf.indices.size() == 5 * 3 * 3);
+    REQUIRE(buf.viewPlane.has_value());
+    CHECK(buf.viewPlane->up == 30.5f);
+    CHECK(buf.viewPlane->down == -20.f);
+}
+
+TEST_CASE("Tokenizer: DomeProjection Loader", "[tokenizer]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    constexpr int nCols = 5;
+    const std::vector<GridVertex> grid = randomGrid(nCols, 5, 3);
+    const std::filesystem::path path = writeDomeProjection(grid, nCols);
+    const Buffer buf =
+        generateDomeProjectionMesh(path, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f });
+    std::filesystem::remove(path);
+
+    // The header line is skipped as it does not contain numbers
+    REQUIRE(buf.vertices.size() == grid.size());
+    for (size_t i = 0; i < grid.size(); i++) {
+        CHECK(buf.vertices[i].x == 2.f * grid[i].x - 1.f);
+        CHECK(buf.vertices[i].y == 2.f * (1.f - grid[i].y) - 1.f);
+        CHECK(buf.vertices[i].s == grid[i].s);
+        CHECK(buf.vertices[i].t == 1.f - grid[i].t);
+    }
+}
+
+TEST_CASE("Tokenizer: PaulBourke Loader", "[tokenizer]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    constexpr int nCols = 4;
+    const std::vector<GridVertex> grid = randomGrid(nCols, 3, 4);
+    const std::filesystem::path path = writePaulBourke(grid, nCols);
+    const Buffer buf =
+        generatePaulBourkeMesh(path, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f }, 1.f);
+    std::filesystem::remove(path);
+
+    REQUIRE(buf.vertices.size() == grid.size());
+    for (size_t i = 0; i < grid.size(); i++) {
+        CHECK(std::abs(buf.vertices[i].x - grid[i].x) < 1e-6f);
+        CHECK(std::abs(buf.vertices[i].y - grid[i].y) < 1e-6f);
+        CHECK(buf.vertices[i].s == grid[i].s);
+        CHECK(buf.vertices[i].r == grid[i].intensity / 255.f);
+    }
+    CHECK(buf.indices.size() == 3 * 2 * 6);
+}
+
+TEST_CASE("Tokenizer: SkySkan Loader", "[tokenizer]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    constexpr int nCols = 4;
+    const std::vector<GridVertex> grid = randomGrid(nCols, 4, 5);
+    const std::filesystem::path path = writeSkySkan(grid, nCols);
+    const Buffer buf = generateSkySkanMesh(path, vec2{ 0.f, 0.f }, vec2{ 1.f, 1.f });
+    std::filesystem::remove(path);
+
+    REQUIRE(buf.vertices.size() == grid.size());
+    for (size_t i = 0; i < grid.size(); i++) {
+        CHECK(buf.vertices[i].x == 2.f * grid[i].x - 1.f);
+        CHECK(buf.vertices[i].y == 2.f * (1.f - grid[i].y) - 1.f);
+        CHECK(buf.vertices[i].s == grid[i].s);
+        CHECK(buf.vertices[i].t == 1.f - grid[i].t);
+    }
+    REQUIRE(buf.viewPlane.has_value());
+    CHECK(buf.viewPlane->up == 30.f);
+    CHECK(buf.viewPlane->left == -45.f);
+}
+
+TEST_CASE("Tokenizer: Loader Benchmark", "[.][tokenizer][benchmark]") {
+    using namespace sgct;
+    using namespace sgct::correction;
+
+    // 4 million vertices per mesh
+    constexpr int nCols = 2000;
+    const std::vector<GridVertex> grid = randomGrid(nCols, 2000, 6);
+    const vec2 pos = vec2{ 0.f, 0.f };
+    const vec2 size = vec2{ 1.f, 1.f };
+
+    const std::filesystem::path obj = writeOBJ(grid, nCols);
+    BENCHMARK("OBJ 4M vertices") {
+        return generateOBJMesh(obj).vertices.size();
+    };
+    std::filesystem::remove(obj);
+
+    const std::filesystem::path ol = writeScalable(grid, nCols);
+    BENCHMARK("Scalable 4M vertices") {
+        return generateScalableMesh(ol, pos, size).vertices.size();
+    };
+    std::filesystem::remove(ol);
+
+    const std::filesystem::path csv = writeDomeProjection(grid, nCols);
+    BENCHMARK("DomeProjection 4M vertices") {
+        return generateDomeProjectionMesh(csv, pos, size).vertices.size();
+    };
+    std::filesystem::remove(csv);
+}
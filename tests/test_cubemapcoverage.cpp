@@ -0,0 +1,413 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/projection/cubemapcoverage.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr float Epsilon = 1e-5f;
+    constexpr sgct::ivec2 Resolution = sgct::ivec2{ 1024, 1024 };
+
+    struct Fisheye {
+        float fov;
+        // The part of the fisheye that is cropped on the left, right, bottom, and top,
+        // which is also used to simulate a projector that only shows part of the fisheye
+        std::array<float, 4> crop = { 0.f, 0.f, 0.f, 0.f };
+    };
+
+    float radians(float degrees) {
+        return degrees * 3.14159265f / 180.f;
+    }
+
+    // The area of each face that the fisheye projection renders when all of its cube map
+    // is used, which mirrors FisheyeProjection::initViewports. Disabled faces are empty
+    std::array<sgct::ivec4, 6> renderedAreas(const Fisheye& f) {
+        using sgct::ivec4;
+        const int w = Resolution.x;
+        const int h = Resolution.y;
+        const ivec4 full = ivec4{ 0, 0, w, h };
+        const ivec4 none = ivec4{ 0, 0, 0, 0 };
+        if (f.fov <= 180.f) {
+            return { full, none, full, full, full, none };
+        }
+
+        const float fiveFaceLimit = 2.f * std::acos(-1.f / std::sqrt(3.f));
+        if (radians(f.fov) > fiveFaceLimit) {
+            return { full, full, full, full, full, full };
+        }
+
+        // Every five face fisheye is larger than the limit for the top face
+        const float cosAngle = std::cos(radians(f.fov / 2.f));
+        const float offset =
+            std::sqrt((2.f * cosAngle * cosAngle) / (1.f - cosAngle * cosAngle));
+        const float cropLevel = (1.f - offset) / 2.f;
+        const int c = static_cast<int>(std::floor(cropLevel * w + 0.5f));
+        return {
+            ivec4{ 0, 0, w - c, h }, ivec4{ c, 0, w - c, h },
+            ivec4{ 0, c, w, h - c }, ivec4{ 0, 0, w, h - c },
+            full, none
+        };
+    }
+
+    // The directions that the fisheye samples on a grid of n x n texture coordinates
+    std::vector<sgct::vec3> fisheyeDirections(const Fisheye& f, int n) {
+        std::vector<sgct::vec3> res;
+        for (int y = 0; y < n; y++) {
+            for (int x = 0; x < n; x++) {
+                const float qx = (static_cast<float>(x) + 0.5f) / n;
+                const float qy = (static_cast<float>(y) + 0.5f) / n;
+                const sgct::vec2 tc = sgct::vec2(
+                    f.crop[0] + qx * (1.f - f.crop[0] - f.crop[1]),
+                    f.crop[2] + qy * (1.f - f.crop[2] - f.crop[3])
+                );
+                const std::optional<sgct::vec3> dir = sgct::fisheyeDirection(
+                    tc,
+                    radians(f.fov / 2.f),
+                    sgct::vec3(0.f, 0.f, 0.f),
+                    f.fov <= 180.f
+                );
+                if (dir) {
+                    res.push_back(*dir);
+                }
+            }
+        }
+        return res;
+    }
+
+    float fisheyeSpacing(const Fisheye& f, int n) {
+        const float tcSize =
+            std::max(1.f - f.crop[0] - f.crop[1], 1.f - f.crop[2] - f.crop[3]);
+        return radians(f.fov) * tcSize / n;
+    }
+
+    // Checks that the pixels that are read when sampling the directions with linear
+    // filtering are inside the rectangles of the coverage
+    bool containsAll(const sgct::CubemapCoverage& coverage,
+                     const std::vector<sgct::vec3>& directions)
+    {
+        for (const sgct::vec3& dir : directions) {
+            const sgct::CubemapCoordinate c = sgct::cubemapCoordinate(dir);
+            const sgct::CubemapCoverage::Face& face = coverage.faces[c.face];
+            if (!face.isCovered) {
+                return false;
+            }
+            const float px = c.uv.x * Resolution.x;
+            const float py = c.uv.y * Resolution.y;
+            const int x0 = std::max(static_cast<int>(std::floor(px - 0.5f)), 0);
+            const int y0 = std::max(static_cast<int>(std::floor(py - 0.5f)), 0);
+            const int x1 = std::min(x0 + 1, Resolution.x - 1);
+            const int y1 = std::min(y0 + 1, Resolution.y - 1);
+            if (x0 < face.rect.x || x1 >= face.rect.x + face.rect.z ||
+                y0 < face.rect.y || y1 >= face.rect.y + face.rect.w)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int64_t area(sgct::ivec4 r) {
+        return static_cast<int64_t>(r.z) * r.w;
+    }
+
+    // The ratio of the rendered pixels that are no longer rendered with the coverage
+    double savings(const sgct::CubemapCoverage& coverage,
+                   const std::array<sgct::ivec4, 6>& rendered)
+    {
+        int64_t before = 0;
+        int64_t after = 0;
+        for (size_t i = 0; i < coverage.faces.size(); i++) {
+            before += area(rendered[i]);
+            if (!coverage.faces[i].isCovered) {
+                continue;
+            }
+            const sgct::ivec4 a = rendered[i];
+            const sgct::ivec4 b = coverage.faces[i].rect;
+            const int x0 = std::max(a.x, b.x);
+            const int y0 = std::max(a.y, b.y);
+            const int x1 = std::min(a.x + a.z, b.x + b.z);
+            const int y1 = std::min(a.y + a.w, b.y + b.w);
+            after += static_cast<int64_t>(std::max(x1 - x0, 0)) * std::max(y1 - y0, 0);
+        }
+        return 1.0 - static_cast<double>(after) / static_cast<double>(before);
+    }
+} // namespace
+
+TEST_CASE("CubemapCoverage: Face Selection", "[cubemapcoverage]") {
+    using sgct::vec3;
+
+    const std::array<vec3, 6> axes = {
+        vec3(1.f, 0.f, 0.f), vec3(-1.f, 0.f, 0.f),
+        vec3(0.f, 1.f, 0.f), vec3(0.f, -1.f, 0.f),
+        vec3(0.f, 0.f, 1.f), vec3(0.f, 0.f, -1.f)
+    };
+    for (size_t i = 0; i < axes.size(); i++) {
+        const sgct::CubemapCoordinate c = sgct::cubemapCoordinate(axes[i]);
+        CHECK(c.face == static_cast<int>(i));
+        CHECK(std::abs(c.uv.x - 0.5f) < Epsilon);
+        CHECK(std::abs(c.uv.y - 0.5f) < Epsilon);
+    }
+
+    // Table 8.19 of the OpenGL 4.6 specification: sc = -rz, tc = -ry for +x
+    const sgct::CubemapCoordinate px = sgct::cubemapCoordinate(vec3(2.f, 1.f, -1.f));
+    CHECK(px.face == 0);
+    CHECK(std::abs(px.uv.x - 0.75f) < Epsilon);
+    CHECK(std::abs(px.uv.y - 0.25f) < Epsilon);
+
+    // sc = rx, tc = rz for +y
+    const sgct::CubemapCoordinate py = sgct::cubemapCoordinate(vec3(0.5f, 1.f, -0.5f));
+    CHECK(py.face == 2);
+    CHECK(std::abs(py.uv.x - 0.75f) < Epsilon);
+    CHECK(std::abs(py.uv.y - 0.25f) < Epsilon);
+
+    // sc = -rx, tc = -ry for -z
+    const sgct::CubemapCoordinate nz = sgct::cubemapCoordinate(vec3(0.5f, 0.5f, -1.f));
+    CHECK(nz.face == 5);
+    CHECK(std::abs(nz.uv.x - 0.25f) < Epsilon);
+    CHECK(std::abs(nz.uv.y - 0.25f) < Epsilon);
+}
+
+TEST_CASE("CubemapCoverage: Full Sphere", "[cubemapcoverage]") {
+    std::mt19937 random = std::mt19937(1337);
+    std::normal_distribution<float> dist = std::normal_distribution<float>(0.f, 1.f);
+
+    std::vector<sgct::vec3> directions;
+    for (int i = 0; i < 200000; i++) {
+        directions.emplace_back(dist(random), dist(random), dist(random));
+    }
+
+    const sgct::CubemapCoverage coverage =
+        sgct::cubemapCoverage(directions, Resolution, 0.01f);
+    for (const sgct::CubemapCoverage::Face& face : coverage.faces) {
+        CHECK(face.isCovered);
+        CHECK(face.rect.x == 0);
+        CHECK(face.rect.y == 0);
+        CHECK(face.rect.z == Resolution.x);
+        CHECK(face.rect.w == Resolution.y);
+    }
+
+    // No directions at all
+    const sgct::CubemapCoverage empty = sgct::cubemapCoverage({}, Resolution, 0.01f);
+    for (const sgct::CubemapCoverage::Face& face : empty.faces) {
+        CHECK_FALSE(face.isCovered);
+    }
+}
+
+TEST_CASE("CubemapCoverage: Fisheye Configurations", "[cubemapcoverage]") {
+    struct Configuration {
+        Fisheye fisheye;
+        // The smallest ratio of the pixels that are saved compared to rendering the
+        // enabled faces as far as they are cropped by the fisheye projection itself
+        double minSavings;
+    };
+
+    // The savings that were measured with a 1024 x 1024 cube map are in the comments. The
+    // full fisheyes already crop the side faces of five face cube maps exactly, so only
+    // fisheyes smaller than the cube map and partial fisheyes benefit
+    const std::array<Configuration, 9> configurations = {
+        // 0%
+        Configuration{ Fisheye{ 180.f }, 0.0 },
+        // 17.5%
+        Configuration{ Fisheye{ 165.f }, 0.17 },
+        // 0%
+        Configuration{ Fisheye{ 200.f }, 0.0 },
+        // 0%
+        Configuration{ Fisheye{ 240.f }, 0.0 },
+        // 0%
+        Configuration{ Fisheye{ 360.f }, 0.0 },
+        // 21.9%, single projector dome with the top 25% of the fisheye cropped
+        Configuration{ Fisheye{ 180.f, { 0.f, 0.f, 0.f, 0.25f } }, 0.21 },
+        // 74.5%, one of four projectors that each show a quarter of the fisheye
+        Configuration{ Fisheye{ 180.f, { 0.5f, 0.f, 0.5f, 0.f } }, 0.74 },
+        // 37.6%, one of two projectors that each show a half of the fisheye
+        Configuration{ Fisheye{ 220.f, { 0.5f, 0.f, 0.f, 0.f } }, 0.37 },
+        // 33.3%
+        Configuration{ Fisheye{ 360.f, { 0.f, 0.f, 0.5f, 0.f } }, 0.33 }
+    };
+
+    for (const Configuration& c : configurations) {
+        constexpr int GridSize = 256;
+        const sgct::CubemapCoverage coverage = sgct::cubemapCoverage(
+            fisheyeDirections(c.fisheye, GridSize),
+            Resolution,
+            fisheyeSpacing(c.fisheye, GridSize)
+        );
+
+        // The coverage is computed from fewer samples than there are pixels, but all
+        // directions that are sampled at a higher resolution have to be covered
+        CHECK(containsAll(coverage, fisheyeDirections(c.fisheye, 4 * GridSize)));
+
+        const std::array<sgct::ivec4, 6> rendered = renderedAreas(c.fisheye);
+        const double s = savings(coverage, rendered);
+        CHECK(s >= c.minSavings);
+
+        // Only enabled faces are ever sampled
+        for (size_t i = 0; i < coverage.faces.size(); i++) {
+            if (area(rendered[i]) == 0) {
+                CHECK_FALSE(coverage.faces[i].isCovered);
+            }
+        }
+    }
+}
+
+TEST_CASE("CubemapCoverage: Cylindrical", "[cubemapcoverage]") {
+    constexpr int GridSize = 512;
+    std::vector<sgct::vec3> directions;
+    for (int y = 0; y < GridSize; y++) {
+        for (int x = 0; x < GridSize; x++) {
+            const sgct::vec2 uv = sgct::vec2(
+                (static_cast<float>(x) + 0.5f) / GridSize,
+                (static_cast<float>(y) + 0.5f) / GridSize
+            );
+            directions.push_back(sgct::cylindricalDirection(uv, 0.f, 0.f));
+        }
+    }
+
+    const sgct::CubemapCoverage coverage = sgct::cubemapCoverage(
+        directions,
+        Resolution,
+        2.f * 3.14159265f / GridSize
+    );
+
+    // The cylinder only extends upwards from the horizon, so only the half of the side
+    // faces with a positive z is sampled, part of the +z face, and never the -z face
+    CHECK(coverage.faces[0].isCovered);
+    CHECK(coverage.faces[0].rect.z < Resolution.x * 0.55);
+    CHECK(coverage.faces[0].rect.w == Resolution.y);
+    CHECK(coverage.faces[2].isCovered);
+    CHECK(coverage.faces[2].rect.w < Resolution.y * 0.55);
+    CHECK(coverage.faces[4].isCovered);
+    CHECK_FALSE(coverage.faces[5].isCovered);
+    const sgct::ivec4 full = sgct::ivec4{ 0, 0, Resolution.x, Resolution.y };
+    const sgct::ivec4 none = sgct::ivec4{ 0, 0, 0, 0 };
+    const double s = savings(coverage, { full, full, full, full, full, none });
+    CHECK(s > 0.35);
+}
+
+TEST_CASE("CubemapCoverage: Sampled Positions", "[cubemapcoverage]") {
+    // A mesh that covers the left half of the framebuffer and shows the left half of the
+    // framebuffer texture without any distortion
+    using Vertex = sgct::correction::Buffer::Vertex;
+    sgct::correction::Buffer mesh;
+    mesh.vertices = {
+        Vertex{ .x = -1.f, .y = -1.f, .s = 0.f, .t = 0.f, .r = 1.f, .a = 1.f },
+        Vertex{ .x = -1.f, .y = 1.f, .s = 0.f, .t = 1.f, .r = 1.f, .a = 1.f },
+        Vertex{ .x = 0.f, .y = -1.f, .s = 0.5f, .t = 0.f, .r = 1.f, .a = 1.f },
+        Vertex{ .x = 0.f, .y = 1.f, .s = 0.5f, .t = 1.f, .r = 1.f, .a = 1.f }
+    };
+    mesh.indices = { 0, 2, 3, 0, 3, 1 };
+
+    // The viewport covers the left half of the framebuffer, too
+    const sgct::ivec2 res = sgct::ivec2{ 64, 32 };
+    const std::vector<sgct::vec2> positions = sgct::sampledPositions(
+        mesh,
+        res,
+        sgct::vec2(0.f, 0.f),
+        sgct::vec2(0.5f, 1.f)
+    );
+    REQUIRE(positions.size() == static_cast<size_t>(res.x / 2 * res.y));
+    for (const sgct::vec2& p : positions) {
+        CHECK(p.x > 0.f);
+        CHECK(p.x < 1.f);
+        CHECK(p.y > 0.f);
+        CHECK(p.y < 1.f);
+    }
+}
+
+TEST_CASE("CubemapCoverage: Face Resolutions", "[cubemapcoverage]") {
+    // A 180 degree fisheye on a 2048 x 2048 output shows 2048 / pi pixels per radian. In
+    // the center of a face, a cube map with a resolution r has r / 2 pixels per radian
+    constexpr int GridSize = 512;
+    const float expected = 2.f * 2048.f / 3.14159265f;
+    auto resolutions = [](const Fisheye& f, float outputSize) {
+        const float pixels = outputSize / GridSize;
+        return sgct::cubemapFaceResolutions(
+            fisheyeDirections(f, GridSize),
+            pixels * pixels
+        );
+    };
+
+    // The faces render at 1280, 0, 1392, 1392, 1280, 0 pixels, which are 8% fewer
+    // pixels than rendering the four faces at the largest resolution
+    const std::array<int, 6> res = resolutions(Fisheye{ 180.f }, 2048.f);
+    for (int i : { 0, 2, 3, 4 }) {
+        CHECK(res[i] >= 0.9f * expected);
+        CHECK(res[i] <= 1.2f * expected);
+        CHECK(res[i] % 16 == 0);
+    }
+    CHECK(res[1] == 0);
+    CHECK(res[5] == 0);
+
+    // The resolutions grow with the size of the output
+    const std::array<int, 6> large = resolutions(Fisheye{ 180.f }, 4096.f);
+    for (size_t i = 0; i < res.size(); i++) {
+        CHECK(std::abs(large[i] - 2 * res[i]) <= 32);
+    }
+
+    // The back face of a 360 degree fisheye is shown much denser than the other faces.
+    // The faces render at 800, 800, 800, 800, 608, 1728 pixels, which are 67% fewer
+    // pixels than rendering all six faces at the largest resolution
+    const std::array<int, 6> full = resolutions(Fisheye{ 360.f }, 2048.f);
+    for (int i = 0; i < 5; i++) {
+        CHECK(full[i] > 0);
+        CHECK(full[i] < full[5] / 2);
+    }
+}
+
+TEST_CASE("CubemapCoverage: Pixel Budget", "[cubemapcoverage]") {
+    using sgct::ivec4;
+    const std::array<int, 6> res = { 1024, 1024, 1024, 1024, 1024, 1024 };
+    sgct::CubemapCoverage coverage;
+    for (sgct::CubemapCoverage::Face& face : coverage.faces) {
+        face.isCovered = true;
+        face.rect = ivec4{ 0, 0, Resolution.x, Resolution.y };
+    }
+
+    // Resolutions that fit into the budget are not changed
+    CHECK(sgct::limitToPixelBudget(res, coverage, Resolution, 6 * 1024 * 1024) == res);
+
+    // A quarter of the budget halves the resolution of each face
+    const std::array<int, 6> quarter =
+        sgct::limitToPixelBudget(res, coverage, Resolution, 6 * 512 * 512);
+    for (int r : quarter) {
+        CHECK(r == 512);
+    }
+
+    // Only the covered part of the faces counts towards the budget
+    for (sgct::CubemapCoverage::Face& face : coverage.faces) {
+        face.rect = ivec4{ 0, 0, Resolution.x / 2, Resolution.y };
+    }
+    coverage.faces[5].isCovered = false;
+    CHECK(sgct::limitToPixelBudget(res, coverage, Resolution, 5 * 512 * 1024) == res);
+
+    const int64_t budget = 5 * 256 * 1024;
+    const std::array<int, 6> half =
+        sgct::limitToPixelBudget(res, coverage, Resolution, budget);
+    int64_t pixels = 0;
+    for (int i = 0; i < 5; i++) {
+        CHECK(half[i] % 16 == 0);
+        CHECK(half[i] >= 700);
+        pixels += static_cast<int64_t>(half[i]) * half[i] / 2;
+    }
+    CHECK(pixels <= budget);
+
+    // The smallest resolution is kept for faces that would otherwise vanish
+    const std::array<int, 6> tiny =
+        sgct::limitToPixelBudget(res, coverage, Resolution, 1);
+    for (int r : tiny) {
+        CHECK(r == 16);
+    }
+}
@@ -0,0 +1,36 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/fileutils.h>
+#include <filesystem>
+#include <set>
+
+TEST_CASE("FileUtils: FNV-1a", "[FileUtils]") {
+    CHECK(sgct::fnv1a("") == 0xcbf29ce484222325ull);
+    CHECK(sgct::fnv1a("a") == 0xaf63dc4c8601ec8cull);
+    CHECK(sgct::fnv1a("foobar") == 0x85944171f73967e8ull);
+
+    // Hashing the parts one after another is the same as hashing the whole string
+    CHECK(sgct::fnv1a("bar", sgct::fnv1a("foo")) == sgct::fnv1a("foobar"));
+}
+
+TEST_CASE("FileUtils: Temporary Path", "[FileUtils]") {
+    const std::filesystem::path path = std::filesystem::path("folder") / "file.bin";
+
+    std::set<std::filesystem::path> paths;
+    for (int i = 0; i < 100; i++) {
+        const std::filesystem::path tmp = sgct::temporaryPath(path);
+        CHECK(tmp.parent_path() == path.parent_path());
+        CHECK(tmp.filename().string().starts_with("file.bin."));
+        CHECK(tmp.extension() == ".tmp");
+        paths.insert(tmp);
+    }
+    CHECK(paths.size() == 100);
+}
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/filewatcher.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+namespace {
+    std::filesystem::path tempFolder() {
+        std::filesystem::path folder =
+            std::filesystem::temp_directory_path() / "sgct_test_filewatcher";
+        std::filesystem::remove_all(folder);
+        std::filesystem::create_directories(folder);
+        return folder;
+    }
+
+    void writeFile(const std::filesystem::path& path, std::string_view contents) {
+        std::ofstream file = std::ofstream(path, std::ios::out | std::ios::binary);
+        file << contents;
+    }
+
+    // Waits until the watcher reports a change or two seconds have passed
+    std::vector<std::filesystem::path> waitForChanges(sgct::FileWatcher& watcher) {
+        const auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+            std::vector<std::filesystem::path> changed = watcher.changedFiles();
+            if (!changed.empty()) {
+                return changed;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return {};
+    }
+} // namespace
+
+TEST_CASE("FileWatcher: Modify", "[filewatcher]") {
+    const std::filesystem::path folder = tempFolder();
+    const std::filesystem::path file = folder / "mesh.pfm";
+    writeFile(file, "old");
+
+    {
+        sgct::FileWatcher watcher = sgct::FileWatcher({ file });
+        CHECK(watcher.changedFiles().empty());
+
+        // The modification time might have a coarse resolution for the polling fallback
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writeFile(file, "new");
+        const std::vector<std::filesystem::path> changed = waitForChanges(watcher);
+        REQUIRE(changed.size() == 1);
+        CHECK(changed[0] == file);
+        CHECK(watcher.changedFiles().empty());
+    }
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("FileWatcher: Replace", "[filewatcher]") {
+    const std::filesystem::path folder = tempFolder();
+    const std::filesystem::path file = folder / "mask.png";
+    writeFile(file, "old");
+
+    {
+        sgct::FileWatcher watcher = sgct::FileWatcher({ file });
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        writeFile(folder / "mask.png.tmp", "new");
+        std::filesystem::rename(folder / "mask.png.tmp", file);
+        const std::vector<std::filesystem::path> changed = waitForChanges(watcher);
+        REQUIRE(changed.size() == 1);
+        CHECK(changed[0] == file);
+    }
+
+    std::filesystem::remove_all(folder);
+}
+
+TEST_CASE("FileWatcher: Unrelated", "[filewatcher]") {
+    const std::filesystem::path folder = tempFolder();
+    const std::filesystem::path file = folder / "mesh.pfm";
+    writeFile(file, "old");
+
+    {
+        sgct::FileWatcher watcher = sgct::FileWatcher({ file });
+
+        writeFile(folder / "other.pfm", "other");
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        CHECK(watcher.changedFiles().empty());
+    }
+
+    std::filesystem::remove_all(folder);
+}
@@ -0,0 +1,167 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include "equality.h"
+#include <sgct/image.h>
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace {
+    std::vector<unsigned char> randomPixels(size_t nBytes) {
+        std::mt19937 rng(1337);
+        std::uniform_int_distribution<int> dist(0, 255);
+        std::vector<unsigned char> res(nBytes);
+        for (unsigned char& v : res) {
+            v = static_cast<unsigned char>(dist(rng));
+        }
+        return res;
+    }
+} // namespace
+
+TEST_CASE("Image: Convert Pixels Swizzle", "[image]") {
+    using namespace sgct;
+
+    // Two RGBA pixels in one row
+    std::vector<unsigned char> data = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    Image::Conversion conversion;
+    conversion.swapRedBlue = true;
+    Image::convertPixels(data.data(), data.data(), ivec2(2, 1), 4, 1, conversion);
+    CHECK(data == std::vector<unsigned char>{ 3, 2, 1, 4, 7, 6, 5, 8 });
+}
+
+TEST_CASE("Image: Convert Pixels Flip", "[image]") {
+    using namespace sgct;
+
+    // Three rows of one RGB pixel each
+    const std::vector<unsigned char> src = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    std::vector<unsigned char> dst(src.size());
+    Image::Conversion conversion;
+    conversion.flipVertically = true;
+    Image::convertPixels(src.data(), dst.data(), ivec2(1, 3), 3, 1, conversion);
+    CHECK(dst == std::vector<unsigned char>{ 7, 8, 9, 4, 5, 6, 1, 2, 3 });
+}
+
+TEST_CASE("Image: Convert Pixels Byte Swap", "[image]") {
+    using namespace sgct;
+
+    // One 16 bit RGB pixel
+    std::vector<unsigned char> data = { 1, 2, 3, 4, 5, 6 };
+    Image::Conversion conversion;
+    conversion.swapRedBlue = true;
+    conversion.swapBytes = true;
+    Image::convertPixels(data.data(), data.data(), ivec2(1, 1), 3, 2, conversion);
+    CHECK(data == std::vector<unsigned char>{ 6, 5, 4, 3, 2, 1 });
+}
+
+TEST_CASE("Image: Save 16 Bit PNG", "[image]") {
+    using namespace sgct;
+
+    // Two rows of one little-endian BGR pixel each, where the high byte of every channel
+    // is unique so that the 8 bit image that is loaded back shows the channel order
+    Image img;
+    img.setSize(ivec2(1, 2));
+    img.setChannels(3);
+    img.setBytesPerChannel(2);
+    img.allocateOrResizeData();
+    const std::vector<unsigned char> pixels = {
+        0xff, 10, 0xff, 20, 0xff, 30,
+        0x00, 40, 0x00, 50, 0x00, 60
+    };
+    std::copy(pixels.begin(), pixels.end(), img.data());
+
+    const std::filesystem::path path =
+        std::filesystem::temp_directory_path() / "sgct-test-image-16bit.png";
+    img.save(path);
+    CHECK(std::vector<unsigned char>(img.data(), img.data() + pixels.size()) == pixels);
+
+    Image loaded;
+    loaded.load(path);
+    std::filesystem::remove(path);
+    REQUIRE(loaded.size() == ivec2(1, 2));
+    REQUIRE(loaded.channels() == 3);
+    REQUIRE(loaded.bytesPerChannel() == 1);
+    CHECK(
+        std::vector<unsigned char>(loaded.data(), loaded.data() + 6) ==
+        std::vector<unsigned char>{ 10, 20, 30, 40, 50, 60 }
+    );
+}
+
+TEST_CASE("Image: Convert Pixels SIMD matches scalar", "[image]") {
+    using namespace sgct;
+
+    const int channels = GENERATE(1, 2, 3, 4);
+    const int bpc = GENERATE(1, 2);
+    const int width = GENERATE(1, 5, 17, 63, 256);
+    const int height = GENERATE(1, 4, 7);
+    const int flags = GENERATE(range(0, 8));
+    const bool inPlace = GENERATE(false, true);
+
+    Image::Conversion conversion;
+    conversion.swapRedBlue = (flags & 1) != 0;
+    conversion.flipVertically = (flags & 2) != 0;
+    conversion.swapBytes = (flags & 4) != 0;
+
+    const size_t nBytes = static_cast<size_t>(width * height * channels * bpc);
+    const std::vector<unsigned char> src = randomPixels(nBytes);
+    const ivec2 size = ivec2(width, height);
+
+    std::vector<unsigned char> simd = src;
+    std::vector<unsigned char> scalar = src;
+    if (inPlace) {
+        Image::convertPixels(
+            simd.data(), simd.data(), size, channels, bpc, conversion, true
+        );
+        Image::convertPixels(
+            scalar.data(), scalar.data(), size, channels, bpc, conversion, false
+        );
+    }
+    else {
+        Image::convertPixels(
+            src.data(), simd.data(), size, channels, bpc, conversion, true
+        );
+        Image::convertPixels(
+            src.data(), scalar.data(), size, channels, bpc, conversion, false
+        );
+    }
+    CHECK(simd == scalar);
+}
+
+TEST_CASE("Image: Convert Pixels Benchmark", "[.][image][benchmark]") {
+    using namespace sgct;
+
+    constexpr ivec2 Size = ivec2(3840, 2160);
+    Image::Conversion conversion;
+    conversion.swapRedBlue = true;
+    conversion.flipVertically = true;
+
+    for (int channels : { 3, 4 }) {
+        const std::vector<unsigned char> src =
+            randomPixels(static_cast<size_t>(Size.x * Size.y * channels));
+        std::vector<unsigned char> dst(src.size());
+
+        BENCHMARK("Scalar " + std::to_string(channels) + " channels") {
+            Image::convertPixels(
+                src.data(), dst.data(), Size, channels, 1, conversion, false
+            );
+            return dst[0];
+        };
+
+        BENCHMARK("SIMD " + std::to_string(channels) + " channels") {
+            Image::convertPixels(
+                src.data(), dst.data(), Size, channels, 1, conversion, true
+            );
+            return dst[0];
+        };
+    }
+}
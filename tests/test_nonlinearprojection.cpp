@@ -0,0 +1,118 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include "equality.h"
+#include <sgct/baseviewport.h>
+#include <sgct/clustermanager.h>
+#include <sgct/config.h>
+#include <sgct/projection/nonlinearprojection.h>
+#include <array>
+#include <cmath>
+#include <memory>
+
+namespace {
+    // The viewports need the default user of the cluster manager
+    struct ClusterManagerScope {
+        ClusterManagerScope() {
+            sgct::ClusterManager::create(sgct::config::Cluster(), 0);
+        }
+        ~ClusterManagerScope() {
+            sgct::ClusterManager::destroy();
+        }
+    };
+
+    using Faces = std::array<std::unique_ptr<sgct::BaseViewport>, 6>;
+
+    // The six faces of a cube map in the order right, left, bottom, top, front, back.
+    // The faces only need different projections, so they are rotated around two axes
+    Faces createFaces() {
+        using namespace sgct;
+
+        const float s = std::sqrt(0.5f);
+        const std::array<quat, 6> rotations = {
+            quat(0.f, -s, 0.f, s), quat(0.f, s, 0.f, s), quat(s, 0.f, 0.f, s),
+            quat(-s, 0.f, 0.f, s), quat(0.f, 0.f, 0.f, 1.f), quat(0.f, 1.f, 0.f, 0.f)
+        };
+        Faces faces;
+        for (size_t i = 0; i < faces.size(); i++) {
+            faces[i] = std::make_unique<BaseViewport>(nullptr);
+            faces[i]->setViewPlaneCoordsUsingFOVs(45.f, -45.f, -45.f, 45.f, rotations[i]);
+            faces[i]->calculateFrustum(Frustum::Mode::MonoEye, 0.1f, 100.f);
+        }
+        return faces;
+    }
+
+    std::array<const sgct::BaseViewport*, 6> pointers(const Faces& f) {
+        return {
+            f[0].get(), f[1].get(), f[2].get(), f[3].get(), f[4].get(), f[5].get()
+        };
+    }
+} // namespace
+
+TEST_CASE("NonLinearProjection: Cubemap Layers", "[nonlinearprojection]") {
+    using namespace sgct;
+
+    const ClusterManagerScope scope;
+    Faces faces = createFaces();
+    faces[1]->setEnabled(false);
+    const std::array<bool, 6> isCovered = { true, true, true, false, true, true };
+
+    mat4 sceneTransform = mat4(1.f);
+    sceneTransform.values[12] = 1.f;
+    sceneTransform.values[13] = 2.f;
+    sceneTransform.values[14] = 3.f;
+
+    const RenderData::CubemapLayers layers = NonLinearProjection::cubemapLayers(
+        pointers(faces),
+        isCovered,
+        Frustum::Mode::MonoEye,
+        sceneTransform
+    );
+
+    // The disabled face and the face that is not covered are skipped
+    const std::array<bool, 6> isEnabled = { true, false, true, false, true, true };
+    CHECK(layers.isEnabled == isEnabled);
+    for (size_t i = 0; i < faces.size(); i++) {
+        if (!isEnabled[i]) {
+            continue;
+        }
+        const Projection& p = faces[i]->projection(Frustum::Mode::MonoEye);
+        CHECK(layers.viewMatrix[i] == p.viewMatrix());
+        CHECK(layers.projectionMatrix[i] == p.projectionMatrix());
+        const mat4 mvp = p.viewProjectionMatrix() * sceneTransform;
+        CHECK(layers.modelViewProjectionMatrix[i] == mvp);
+    }
+
+    // Each face has its own projection
+    CHECK_FALSE(layers.viewMatrix[0] == layers.viewMatrix[2]);
+    CHECK_FALSE(layers.viewMatrix[4] == layers.viewMatrix[5]);
+}
+
+TEST_CASE("NonLinearProjection: Layered Rendering Fallback", "[nonlinearprojection]") {
+    using namespace sgct;
+
+    const ClusterManagerScope scope;
+    Faces faces = createFaces();
+
+    CHECK_FALSE(NonLinearProjection::layeredRenderingFallback(1, false, pointers(faces)));
+
+    // Multisampled renderbuffers and the depth textures cannot be layered
+    CHECK(NonLinearProjection::layeredRenderingFallback(4, false, pointers(faces)));
+    CHECK(NonLinearProjection::layeredRenderingFallback(1, true, pointers(faces)));
+
+    // The faces have to cover the whole cube map, unless they are not rendered at all
+    faces[0]->setPos(vec2{ 0.25f, 0.f });
+    faces[0]->setSize(vec2{ 0.75f, 1.f });
+    CHECK(NonLinearProjection::layeredRenderingFallback(1, false, pointers(faces)));
+    faces[0]->setEnabled(false);
+    CHECK_FALSE(NonLinearProjection::layeredRenderingFallback(1, false, pointers(faces)));
+    faces[3]->setSize(vec2{ 1.f, 0.5f });
+    CHECK(NonLinearProjection::layeredRenderingFallback(1, false, pointers(faces)));
+}
@@ -0,0 +1,274 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/offscreenbuffer.h>
+#include <sgct/opengl.h>
+#include <sgct/settings.h>
+#include <array>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace {
+    struct Calls {
+        int createdFramebuffers = 0;
+        int deletedFramebuffers = 0;
+        int framebufferBindings = 0;
+        int attachments = 0;
+    };
+    Calls calls;
+    GLuint nextName = 1;
+
+    void APIENTRY genNames(GLsizei n, GLuint* names) {
+        for (GLsizei i = 0; i < n; i++) {
+            names[i] = nextName++;
+        }
+    }
+
+    void APIENTRY genFramebuffers(GLsizei n, GLuint* names) {
+        calls.createdFramebuffers += n;
+        genNames(n, names);
+    }
+
+    void APIENTRY deleteFramebuffers(GLsizei n, const GLuint* names) {
+        for (GLsizei i = 0; i < n; i++) {
+            // Deleting the name 0 is allowed and ignored by OpenGL
+            if (names[i] != 0) {
+                calls.deletedFramebuffers++;
+            }
+        }
+    }
+
+    void APIENTRY bindFramebuffer(GLenum, GLuint) {
+        calls.framebufferBindings++;
+    }
+
+    void APIENTRY framebufferTexture2D(GLenum, GLenum, GLenum, GLuint, GLint) {
+        calls.attachments++;
+    }
+
+    void APIENTRY framebufferRenderbuffer(GLenum, GLenum, GLenum, GLuint) {
+        calls.attachments++;
+    }
+
+    void APIENTRY getIntegerv(GLenum, GLint* data) {
+        *data = 8;
+    }
+
+    void APIENTRY deleteNames(GLsizei, const GLuint*) {}
+    void APIENTRY bindName(GLenum, GLuint) {}
+    void APIENTRY setEnum(GLenum) {}
+    void APIENTRY drawBuffers(GLsizei, const GLenum*) {}
+    void APIENTRY renderbufferStorage(GLenum, GLenum, GLsizei, GLsizei) {}
+    void APIENTRY renderbufferStorageMultisample(GLenum, GLsizei, GLenum, GLsizei,
+                                                 GLsizei) {}
+    void APIENTRY blitFramebuffer(GLint, GLint, GLint, GLint, GLint, GLint, GLint, GLint,
+                                  GLbitfield, GLenum) {}
+
+    // Replaces the OpenGL functions that the offscreen buffer calls with functions that
+    // count the calls, so that the tests run without an OpenGL context
+    class CountingGL {
+    public:
+        CountingGL() {
+            replace(glad_glGenFramebuffers, &genFramebuffers);
+            replace(glad_glDeleteFramebuffers, &deleteFramebuffers);
+            replace(glad_glBindFramebuffer, &bindFramebuffer);
+            replace(glad_glFramebufferTexture2D, &framebufferTexture2D);
+            replace(glad_glFramebufferRenderbuffer, &framebufferRenderbuffer);
+            replace(glad_glGetIntegerv, &getIntegerv);
+            replace(glad_glGenRenderbuffers, &genNames);
+            replace(glad_glDeleteRenderbuffers, &deleteNames);
+            replace(glad_glBindRenderbuffer, &bindName);
+            replace(glad_glBindTexture, &bindName);
+            replace(glad_glActiveTexture, &setEnum);
+            replace(glad_glReadBuffer, &setEnum);
+            replace(glad_glDrawBuffer, &setEnum);
+            replace(glad_glDrawBuffers, &drawBuffers);
+            replace(glad_glRenderbufferStorage, &renderbufferStorage);
+            replace(
+                glad_glRenderbufferStorageMultisample,
+                &renderbufferStorageMultisample
+            );
+            replace(glad_glBlitFramebuffer, &blitFramebuffer);
+
+            sgct::Settings::instance().setUseDepthTexture(true);
+            sgct::Settings::instance().setUseNormalTexture(true);
+        }
+
+        ~CountingGL() {
+            sgct::Settings::instance().setUseDepthTexture(false);
+            sgct::Settings::instance().setUseNormalTexture(false);
+            for (const std::function<void()>& restore : _restore) {
+                restore();
+            }
+        }
+
+    private:
+        template <typename T>
+        void replace(T& function, T replacement) {
+            _restore.push_back([&function, original = function]() {
+                function = original;
+            });
+            function = replacement;
+        }
+
+        std::vector<std::function<void()>> _restore;
+    };
+
+    // A stereo window with a shared depth and normal texture, as in renderViewports
+    constexpr std::array<sgct::OffScreenBuffer::Target, 2> Eyes = {
+        sgct::OffScreenBuffer::Target{ 1001, 1003, 1004, 0 },
+        sgct::OffScreenBuffer::Target{ 1002, 1003, 1004, 0 }
+    };
+
+    // How a frame was rendered before the framebuffers of the targets were kept, which
+    // attached all textures of an eye to the same framebuffer
+    void renderFrameByAttaching(sgct::OffScreenBuffer& fbo,
+                                std::span<const sgct::OffScreenBuffer::Target> eyes)
+    {
+        for (const sgct::OffScreenBuffer::Target& eye : eyes) {
+            fbo.bind();
+            if (fbo.isMultiSampled()) {
+                fbo.bindBlit();
+            }
+            fbo.attachColorTexture(eye.color, GL_COLOR_ATTACHMENT0);
+            fbo.attachDepthTexture(eye.depth);
+            fbo.attachColorTexture(eye.normals, GL_COLOR_ATTACHMENT1);
+            if (fbo.isMultiSampled()) {
+                fbo.blit();
+            }
+        }
+    }
+
+    void renderFrame(sgct::OffScreenBuffer& fbo,
+                     std::span<const sgct::OffScreenBuffer::Target> eyes)
+    {
+        for (const sgct::OffScreenBuffer::Target& eye : eyes) {
+            if (fbo.isMultiSampled()) {
+                fbo.bind();
+                fbo.bindTarget(eye);
+                fbo.blit();
+            }
+            else {
+                fbo.bindTarget(eye);
+            }
+        }
+    }
+} // namespace
+
+TEST_CASE("OffScreenBuffer: Attachments per Frame", "[offscreenbuffer]") {
+    CountingGL gl;
+    sgct::OffScreenBuffer fbo;
+    fbo.createFBO(1280, 720);
+
+    calls = Calls();
+    renderFrameByAttaching(fbo, Eyes);
+    CHECK(calls.attachments == 6);
+    CHECK(calls.framebufferBindings == 2);
+
+    // The framebuffers are created and their textures attached in the first frame only
+    calls = Calls();
+    renderFrame(fbo, Eyes);
+    CHECK(calls.createdFramebuffers == 2);
+    CHECK(calls.attachments == 6);
+
+    calls = Calls();
+    for (int i = 0; i < 10; i++) {
+        renderFrame(fbo, Eyes);
+    }
+    CHECK(calls.createdFramebuffers == 0);
+    CHECK(calls.attachments == 0);
+    CHECK(calls.framebufferBindings == 20);
+}
+
+TEST_CASE("OffScreenBuffer: Multisampled Attachments per Frame", "[offscreenbuffer]") {
+    CountingGL gl;
+    sgct::OffScreenBuffer fbo;
+    fbo.createFBO(1280, 720, 4);
+    REQUIRE(fbo.isMultiSampled());
+
+    calls = Calls();
+    renderFrameByAttaching(fbo, Eyes);
+    CHECK(calls.attachments == 6);
+    CHECK(calls.framebufferBindings == 6);
+
+    calls = Calls();
+    renderFrame(fbo, Eyes);
+    CHECK(calls.createdFramebuffers == 2);
+    CHECK(calls.attachments == 6);
+
+    calls = Calls();
+    for (int i = 0; i < 10; i++) {
+        renderFrame(fbo, Eyes);
+    }
+    CHECK(calls.createdFramebuffers == 0);
+    CHECK(calls.attachments == 0);
+    CHECK(calls.framebufferBindings == 60);
+}
+
+TEST_CASE("OffScreenBuffer: Depth Buffer", "[offscreenbuffer]") {
+    CountingGL gl;
+    sgct::OffScreenBuffer fbo;
+    fbo.createFBO(1280, 720);
+
+    // Without a depth texture the depth buffer of the offscreen buffer is attached
+    calls = Calls();
+    fbo.bindTarget(sgct::OffScreenBuffer::Target{ 1001, 0, 0, 0 });
+    CHECK(calls.attachments == 2);
+
+    calls = Calls();
+    fbo.bindTarget(sgct::OffScreenBuffer::Target{ 1001, 0, 0, 0 });
+    CHECK(calls.attachments == 0);
+}
+
+TEST_CASE("OffScreenBuffer: Resize", "[offscreenbuffer]") {
+    CountingGL gl;
+    sgct::OffScreenBuffer fbo;
+    fbo.createFBO(1280, 720);
+    renderFrame(fbo, Eyes);
+
+    // The window recreates its textures when it is resized, so the framebuffers of the
+    // targets have to be recreated as well. The third deleted framebuffer is the one of
+    // the buffer itself
+    calls = Calls();
+    fbo.resizeFBO(1920, 1080);
+    CHECK(calls.deletedFramebuffers == 3);
+
+    const std::array<sgct::OffScreenBuffer::Target, 2> resized = {
+        sgct::OffScreenBuffer::Target{ 2001, 2003, 2004, 0 },
+        sgct::OffScreenBuffer::Target{ 2002, 2003, 2004, 0 }
+    };
+    calls = Calls();
+    renderFrame(fbo, resized);
+    CHECK(calls.createdFramebuffers == 2);
+    CHECK(calls.attachments == 6);
+}
+
+TEST_CASE("OffScreenBuffer: Target Framebuffer", "[offscreenbuffer]") {
+    CountingGL gl;
+    sgct::OffScreenBuffer fbo;
+    fbo.createFBO(1280, 720);
+    renderFrame(fbo, Eyes);
+
+    // The framebuffers that are rendered into can be read from without creating them
+    // again, and the first read of a new target creates its framebuffer once
+    calls = Calls();
+    const unsigned int left = fbo.targetFramebuffer(Eyes[0]);
+    const unsigned int right = fbo.targetFramebuffer(Eyes[1]);
+    CHECK(left != 0);
+    CHECK(left != right);
+    CHECK(calls.createdFramebuffers == 0);
+
+    const sgct::OffScreenBuffer::Target color = { Eyes[0].color, 0, 0, 0 };
+    const unsigned int source = fbo.targetFramebuffer(color);
+    CHECK(source != left);
+    CHECK(fbo.targetFramebuffer(color) == source);
+    CHECK(calls.createdFramebuffers == 1);
+}
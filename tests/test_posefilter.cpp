@@ -0,0 +1,144 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/generators/catch_generators.hpp>
+
+#include <sgct/posefilter.h>
+#include <cmath>
+#include <random>
+
+namespace {
+    constexpr float Epsilon = 1e-3f;
+
+    // The tracking system samples at 120 Hz
+    constexpr double Interval = 1.0 / 120.0;
+
+    using Method = sgct::config::Tracker::Prediction::Method;
+
+    sgct::PoseFilter createFilter(Method method, float smoothing) {
+        sgct::config::Tracker::Prediction prediction;
+        prediction.method = method;
+        prediction.smoothing = smoothing;
+        return sgct::PoseFilter(prediction);
+    }
+
+    // Rotation around the y axis by the angle in radians
+    sgct::quat rotationY(float angle) {
+        return sgct::quat(0.f, std::sin(angle / 2.f), 0.f, std::cos(angle / 2.f));
+    }
+
+    float distance(const sgct::vec3& a, const sgct::vec3& b) {
+        const float x = a.x - b.x;
+        const float y = a.y - b.y;
+        const float z = a.z - b.z;
+        return std::sqrt(x * x + y * y + z * z);
+    }
+
+    // A head that sways from side to side by 20 cm twice per second, similar to the
+    // recorded traces of a user looking around
+    sgct::vec3 swayingHead(double t) {
+        const float x = 0.2f * static_cast<float>(std::sin(2.0 * 3.14159265 * 2.0 * t));
+        return sgct::vec3(x, 1.7f, 0.f);
+    }
+} // namespace
+
+TEST_CASE("PoseFilter: No Samples", "[posefilter]") {
+    const sgct::PoseFilter filter = createFilter(Method::DoubleExponential, 0.5f);
+    CHECK_FALSE(filter.latestTime().has_value());
+    CHECK_FALSE(filter.predict(1.0).has_value());
+}
+
+TEST_CASE("PoseFilter: Old Samples", "[posefilter]") {
+    sgct::PoseFilter filter = createFilter(Method::ConstantVelocity, 1.f);
+    filter.addSample(1.0, { sgct::vec3(0.f, 0.f, 0.f), rotationY(0.f) });
+    filter.addSample(2.0, { sgct::vec3(1.f, 0.f, 0.f), rotationY(0.f) });
+    filter.addSample(1.5, { sgct::vec3(5.f, 0.f, 0.f), rotationY(0.f) });
+    REQUIRE(filter.latestTime().has_value());
+    CHECK(*filter.latestTime() == 2.0);
+
+    const std::optional<sgct::PoseFilter::Pose> pose = filter.predict(3.0);
+    REQUIRE(pose.has_value());
+    CHECK(std::abs(pose->position.x - 2.f) < Epsilon);
+}
+
+TEST_CASE("PoseFilter: Linear Motion", "[posefilter]") {
+    const Method method = GENERATE(Method::ConstantVelocity, Method::DoubleExponential);
+    sgct::PoseFilter filter = createFilter(method, 0.5f);
+
+    // 1 m/s along x and 0.5 m/s along z
+    for (int i = 0; i < 240; i++) {
+        const double t = i * Interval;
+        const float x = static_cast<float>(t);
+        filter.addSample(t, { sgct::vec3(x, 1.7f, 0.5f * x), rotationY(0.f) });
+    }
+
+    // 50 ms after the last sample
+    const double t = 239 * Interval + 0.05;
+    const std::optional<sgct::PoseFilter::Pose> pose = filter.predict(t);
+    REQUIRE(pose.has_value());
+    const float x = static_cast<float>(t);
+    CHECK(distance(pose->position, sgct::vec3(x, 1.7f, 0.5f * x)) < Epsilon);
+}
+
+TEST_CASE("PoseFilter: Constant Rotation", "[posefilter]") {
+    const Method method = GENERATE(Method::ConstantVelocity, Method::DoubleExponential);
+    sgct::PoseFilter filter = createFilter(method, 0.5f);
+
+    // Turning the head by 90 degrees per second
+    constexpr double Speed = 3.14159265 / 2.0;
+    for (int i = 0; i < 240; i++) {
+        const double t = i * Interval;
+        const sgct::quat q = rotationY(static_cast<float>(Speed * t));
+        filter.addSample(t, { sgct::vec3(0.f, 1.7f, 0.f), q });
+    }
+
+    const double t = 239 * Interval + 0.05;
+    const std::optional<sgct::PoseFilter::Pose> pose = filter.predict(t);
+    REQUIRE(pose.has_value());
+    const sgct::quat expected = rotationY(static_cast<float>(Speed * t));
+    CHECK(std::abs(pose->rotation.x - expected.x) < Epsilon);
+    CHECK(std::abs(pose->rotation.y - expected.y) < Epsilon);
+    CHECK(std::abs(pose->rotation.z - expected.z) < Epsilon);
+    CHECK(std::abs(pose->rotation.w - expected.w) < Epsilon);
+}
+
+TEST_CASE("PoseFilter: Noisy Trace", "[posefilter]") {
+    // The trace is sampled with 1 mm of sensor noise and the pose is needed 30 ms after
+    // each sample, which is when the frame is shown. Using the latest sample lags behind
+    // the head, which the prediction has to improve on
+    const Method method = GENERATE(Method::ConstantVelocity, Method::DoubleExponential);
+    sgct::PoseFilter filter = createFilter(method, 0.5f);
+
+    std::mt19937 random = std::mt19937(1337);
+    std::normal_distribution<float> noise = std::normal_distribution<float>(0.f, 0.001f);
+
+    constexpr double Latency = 0.03;
+    double errorLatest = 0.0;
+    double errorPredicted = 0.0;
+    for (int i = 0; i < 600; i++) {
+        const double t = i * Interval;
+        sgct::vec3 p = swayingHead(t);
+        p.x += noise(random);
+        p.y += noise(random);
+        p.z += noise(random);
+        filter.addSample(t, { p, rotationY(0.f) });
+
+        // Skip the first second in which the filter settles
+        if (i < 120) {
+            continue;
+        }
+        const sgct::vec3 truth = swayingHead(t + Latency);
+        const std::optional<sgct::PoseFilter::Pose> pose = filter.predict(t + Latency);
+        REQUIRE(pose.has_value());
+        errorLatest += distance(p, truth);
+        errorPredicted += distance(pose->position, truth);
+    }
+
+    CHECK(errorPredicted < 0.75 * errorLatest);
+}
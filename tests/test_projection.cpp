@@ -0,0 +1,254 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+
+#include <sgct/projection.h>
+#include <sgct/projection/projectionplane.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace {
+    constexpr float Epsilon = 1e-4f;
+
+    struct Matrices {
+        glm::mat4 view;
+        glm::mat4 projection;
+        glm::mat4 viewProjection;
+    };
+
+    // The calculation as it was done before the values of the planes were cached
+    Matrices reference(glm::vec3 base, const sgct::ProjectionPlane& plane, float nearClip,
+                       float farClip, glm::vec3 offset)
+    {
+        const glm::vec3 lowerLeft = glm::make_vec3(&plane.coordinateLowerLeft().x);
+        const glm::vec3 upperLeft = glm::make_vec3(&plane.coordinateUpperLeft().x);
+        const glm::vec3 upperRight = glm::make_vec3(&plane.coordinateUpperRight().x);
+
+        const glm::vec3 planeX = glm::normalize(upperRight - upperLeft);
+        const glm::vec3 planeY = glm::normalize(upperLeft - lowerLeft);
+        const glm::vec3 planeZ = glm::normalize(glm::cross(planeX, planeY));
+
+        const glm::mat3 invDcm = glm::inverse(glm::mat3(planeX, planeY, planeZ));
+        const glm::vec3 ll = invDcm * lowerLeft;
+        const glm::vec3 ur = invDcm * upperRight;
+        const glm::vec3 eye = invDcm * base;
+
+        const float nearF = std::fabs(nearClip / (ll.z - eye.z));
+        Matrices res;
+        res.view = glm::mat4(invDcm) * glm::translate(glm::mat4(1.f), -(base + offset));
+        res.projection = glm::frustum(
+            (ll.x - eye.x) * nearF,
+            (ur.x - eye.x) * nearF,
+            (ll.y - eye.y) * nearF,
+            (ur.y - eye.y) * nearF,
+            nearClip,
+            farClip
+        );
+        res.viewProjection = res.projection * res.view;
+        return res;
+    }
+
+    Matrices reference(sgct::vec3 base, const sgct::ProjectionPlane& plane,
+                       float nearClip, float farClip)
+    {
+        const glm::vec3 b = glm::make_vec3(&base.x);
+        return reference(b, plane, nearClip, farClip, glm::vec3(0.f));
+    }
+
+    bool isEqual(const sgct::mat4& m, const glm::mat4& ref) {
+        const float* r = glm::value_ptr(ref);
+        for (int i = 0; i < 16; i++) {
+            // The values of the projection matrix grow with the distance of the far plane
+            const float scale = std::max(1.f, std::abs(r[i]));
+            if (std::abs(m.values[i] - r[i]) > Epsilon * scale) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool isEqual(const sgct::Projection& p, const Matrices& ref) {
+        return isEqual(p.viewMatrix(), ref.view) &&
+            isEqual(p.projectionMatrix(), ref.projection) &&
+            isEqual(p.viewProjectionMatrix(), ref.viewProjection);
+    }
+
+    // The six faces of a cube map around the origin at a distance of 1
+    std::array<sgct::ProjectionPlane, 6> cubeFaces() {
+        using sgct::vec3;
+        std::array<sgct::ProjectionPlane, 6> faces;
+        // right, left, bottom, top, front, back
+        faces[0].setCoordinates(vec3(1, -1, -1), vec3(1, 1, -1), vec3(1, 1, 1));
+        faces[1].setCoordinates(vec3(-1, -1, 1), vec3(-1, 1, 1), vec3(-1, 1, -1));
+        faces[2].setCoordinates(vec3(-1, -1, 1), vec3(-1, -1, -1), vec3(1, -1, -1));
+        faces[3].setCoordinates(vec3(-1, 1, -1), vec3(-1, 1, 1), vec3(1, 1, 1));
+        faces[4].setCoordinates(vec3(-1, -1, -1), vec3(-1, 1, -1), vec3(1, 1, -1));
+        faces[5].setCoordinates(vec3(1, -1, 1), vec3(1, 1, 1), vec3(-1, 1, 1));
+        return faces;
+    }
+} // namespace
+
+TEST_CASE("Projection: Random Planes", "[projection]") {
+    std::mt19937 random = std::mt19937(1337);
+    std::uniform_real_distribution<float> pos = std::uniform_real_distribution(-2.f, 2.f);
+    std::uniform_real_distribution<float> angle =
+        std::uniform_real_distribution(-1.5f, 1.5f);
+
+    for (int i = 0; i < 100; i++) {
+        // A rectangle 3 m in front of the origin that is rotated around the y axis
+        const float a = angle(random);
+        const glm::vec3 x = glm::vec3(std::cos(a), 0.f, -std::sin(a));
+        const glm::vec3 y = glm::vec3(0.f, 1.f, 0.f);
+        const glm::vec3 center = glm::vec3(3.f * std::sin(a), 0.f, 3.f * -std::cos(a));
+        const glm::vec3 ll = center - 1.5f * x - y;
+        const glm::vec3 ul = center - 1.5f * x + y;
+        const glm::vec3 ur = center + 1.5f * x + y;
+
+        sgct::ProjectionPlane plane;
+        plane.setCoordinates(
+            sgct::vec3(ll.x, ll.y, ll.z),
+            sgct::vec3(ul.x, ul.y, ul.z),
+            sgct::vec3(ur.x, ur.y, ur.z)
+        );
+
+        const sgct::vec3 eye = sgct::vec3(pos(random), pos(random), pos(random) * 0.25f);
+        const sgct::vec3 offset = sgct::vec3(0.03f, 0.f, 0.f);
+
+        sgct::Projection projection;
+        projection.calculateProjection(eye, plane, 0.1f, 100.f, offset);
+        const Matrices ref = reference(
+            glm::make_vec3(&eye.x),
+            plane,
+            0.1f,
+            100.f,
+            glm::make_vec3(&offset.x)
+        );
+        CHECK(isEqual(projection, ref));
+    }
+}
+
+TEST_CASE("Projection: Cube Faces", "[projection]") {
+    const std::array<sgct::ProjectionPlane, 6> faces = cubeFaces();
+    std::array<sgct::Projection, 6> projections;
+    std::array<sgct::Projection*, 6> p;
+    std::array<const sgct::ProjectionPlane*, 6> planes;
+    for (size_t i = 0; i < faces.size(); i++) {
+        p[i] = &projections[i];
+        planes[i] = &faces[i];
+    }
+
+    const sgct::vec3 eye = sgct::vec3(0.1f, 1.7f, -0.2f);
+    sgct::Projection::calculateProjections(p, planes, eye, 0.1f, 100.f);
+
+    for (size_t i = 0; i < faces.size(); i++) {
+        CHECK(isEqual(projections[i], reference(eye, faces[i], 0.1f, 100.f)));
+    }
+}
+
+TEST_CASE("Projection: Changed Inputs", "[projection]") {
+    sgct::ProjectionPlane plane;
+    plane.setCoordinates(
+        sgct::vec3(-1.f, -1.f, -2.f),
+        sgct::vec3(-1.f, 1.f, -2.f),
+        sgct::vec3(1.f, 1.f, -2.f)
+    );
+
+    sgct::Projection projection;
+    const sgct::vec3 eye = sgct::vec3(0.f, 0.f, 0.f);
+    projection.calculateProjection(eye, plane, 0.1f, 100.f);
+    CHECK(isEqual(projection, reference(eye, plane, 0.1f, 100.f)));
+
+    // Moving the plane has to be picked up even though the eye did not move
+    const uint64_t version = plane.version();
+    plane.offset(sgct::vec3(0.5f, 0.f, 0.f));
+    CHECK(plane.version() != version);
+    projection.calculateProjection(eye, plane, 0.1f, 100.f);
+    CHECK(isEqual(projection, reference(eye, plane, 0.1f, 100.f)));
+
+    // Another plane with the same coordinates as the first one
+    sgct::ProjectionPlane other;
+    other.setCoordinates(
+        sgct::vec3(-1.f, -1.f, -2.f),
+        sgct::vec3(-1.f, 1.f, -2.f),
+        sgct::vec3(1.f, 1.f, -2.f)
+    );
+    projection.calculateProjection(eye, other, 0.1f, 100.f);
+    CHECK(isEqual(projection, reference(eye, other, 0.1f, 100.f)));
+
+    // Changing only the clipping planes
+    projection.calculateProjection(eye, other, 1.f, 10.f);
+    CHECK(isEqual(projection, reference(eye, other, 1.f, 10.f)));
+
+    // Changing only the eye
+    const sgct::vec3 moved = sgct::vec3(0.2f, 0.1f, 0.f);
+    projection.calculateProjection(moved, other, 1.f, 10.f);
+    CHECK(isEqual(projection, reference(moved, other, 1.f, 10.f)));
+}
+
+TEST_CASE("Projection: Benchmark", "[.][projection][benchmark]") {
+    const std::array<sgct::ProjectionPlane, 6> faces = cubeFaces();
+    std::array<sgct::Projection, 6> projections;
+    std::array<sgct::Projection*, 6> p;
+    std::array<const sgct::ProjectionPlane*, 6> planes;
+    for (size_t i = 0; i < faces.size(); i++) {
+        p[i] = &projections[i];
+        planes[i] = &faces[i];
+    }
+
+    // The eye moves every frame, like a head-tracked user
+    float t = 0.f;
+    BENCHMARK("Cube map, glm per face") {
+        t += 0.001f;
+        float sum = 0.f;
+        for (const sgct::ProjectionPlane& face : faces) {
+            const Matrices m = reference(sgct::vec3(t, t, t), face, 0.1f, 100.f);
+            sum += m.viewProjection[0][0];
+        }
+        return sum;
+    };
+
+    BENCHMARK("Cube map, cached per face") {
+        t += 0.001f;
+        float sum = 0.f;
+        for (size_t i = 0; i < faces.size(); i++) {
+            const sgct::vec3 eye = sgct::vec3(t, t, t);
+            projections[i].calculateProjection(eye, faces[i], 0.1f, 100.f);
+            sum += projections[i].viewProjectionMatrix().values[0];
+        }
+        return sum;
+    };
+
+    BENCHMARK("Cube map, batched") {
+        t += 0.001f;
+        sgct::Projection::calculateProjections(
+            p,
+            planes,
+            sgct::vec3(t, t, t),
+            0.1f,
+            100.f
+        );
+        return projections[0].viewProjectionMatrix().values[0];
+    };
+
+    BENCHMARK("Cube map, unchanged eye") {
+        sgct::Projection::calculateProjections(
+            p,
+            planes,
+            sgct::vec3(1.f, 1.f, 1.f),
+            0.1f,
+            100.f
+        );
+        return projections[0].viewProjectionMatrix().values[0];
+    };
+}
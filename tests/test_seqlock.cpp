@@ -0,0 +1,187 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/math.h>
+#include <sgct/seqlock.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Has the same size as the pose of a tracking device
+    struct Pose {
+        sgct::mat4 worldTransform = sgct::mat4(1.f);
+        sgct::mat4 worldTransformPrevious = sgct::mat4(1.f);
+        sgct::quat sensorRotation;
+        sgct::quat sensorRotationPrevious;
+        sgct::vec3 sensorPosition;
+        sgct::vec3 sensorPositionPrevious;
+        double time = 0.0;
+        double timePrevious = 0.0;
+    };
+
+    // A sample in which all values are derived from the same counter, so that a torn read
+    // can be detected
+    Pose createPose(int i) {
+        const float v = static_cast<float>(i);
+        Pose pose;
+        pose.worldTransform = sgct::mat4(v);
+        pose.worldTransformPrevious = sgct::mat4(v - 1.f);
+        pose.sensorRotation = sgct::quat(v, v, v, v);
+        pose.sensorRotationPrevious = sgct::quat(v - 1.f, v - 1.f, v - 1.f, v - 1.f);
+        pose.sensorPosition = sgct::vec3(v, v, v);
+        pose.sensorPositionPrevious = sgct::vec3(v - 1.f, v - 1.f, v - 1.f);
+        pose.time = static_cast<double>(i);
+        pose.timePrevious = static_cast<double>(i - 1);
+        return pose;
+    }
+
+    bool isConsistent(const Pose& pose) {
+        const float v = static_cast<float>(pose.time);
+        for (int i = 0; i < 16; i++) {
+            const bool isDiagonal = i % 5 == 0;
+            if (pose.worldTransform.values[i] != (isDiagonal ? v : 0.f) ||
+                pose.worldTransformPrevious.values[i] != (isDiagonal ? v - 1.f : 0.f))
+            {
+                return false;
+            }
+        }
+        return pose.sensorRotation.x == v && pose.sensorRotation.w == v &&
+            pose.sensorRotationPrevious.y == v - 1.f &&
+            pose.sensorPosition.z == v && pose.sensorPositionPrevious.x == v - 1.f &&
+            pose.timePrevious == pose.time - 1.0;
+    }
+} // namespace
+
+TEST_CASE("SeqLock: Store and Load", "[seqlock]") {
+    sgct::SeqLock<Pose> lock = sgct::SeqLock<Pose>(createPose(1));
+    CHECK(isConsistent(lock.load()));
+    CHECK(lock.load().time == 1.0);
+
+    lock.store(createPose(5));
+    CHECK(lock.load().time == 5.0);
+
+    lock.update([](Pose& pose) { pose = createPose(static_cast<int>(pose.time) + 1); });
+    CHECK(isConsistent(lock.load()));
+    CHECK(lock.load().time == 6.0);
+}
+
+TEST_CASE("SeqLock: Concurrent", "[seqlock]") {
+    sgct::SeqLock<Pose> lock = sgct::SeqLock<Pose>(createPose(1));
+    std::atomic_bool isDone = false;
+
+    std::thread writer = std::thread([&]() {
+        for (int i = 2; i < 20000; i++) {
+            lock.store(createPose(i));
+        }
+        isDone = true;
+    });
+
+    int nInconsistent = 0;
+    double lastTime = 0.0;
+    bool isMonotonic = true;
+    while (!isDone) {
+        const Pose pose = lock.load();
+        nInconsistent += isConsistent(pose) ? 0 : 1;
+        isMonotonic &= pose.time >= lastTime;
+        lastTime = pose.time;
+    }
+    writer.join();
+
+    CHECK(nInconsistent == 0);
+    CHECK(isMonotonic);
+    CHECK(lock.load().time == 19999.0);
+}
+
+TEST_CASE("SeqLock: Concurrent Writers", "[seqlock]") {
+    sgct::SeqLock<Pose> lock = sgct::SeqLock<Pose>(createPose(0));
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; i++) {
+        writers.emplace_back([&lock]() {
+            for (int j = 0; j < 5000; j++) {
+                lock.update([](Pose& p) {
+                    p = createPose(static_cast<int>(p.time) + 1);
+                });
+            }
+        });
+    }
+    for (std::thread& writer : writers) {
+        writer.join();
+    }
+
+    // No update was lost
+    const Pose pose = lock.load();
+    CHECK(isConsistent(pose));
+    CHECK(pose.time == 20000.0);
+}
+
+TEST_CASE("SeqLock: Contention Benchmark", "[.][seqlock][benchmark]") {
+    // A sampling thread writes the poses of many devices as fast as possible while the
+    // render thread reads all of them, once with a single mutex for all devices as the
+    // tracking devices used to do and once with a SeqLock per device
+    constexpr int NDevices = 64;
+
+    SECTION("Global mutex") {
+        std::mutex mutex;
+        std::vector<Pose> poses = std::vector<Pose>(NDevices, createPose(1));
+        std::atomic_bool isDone = false;
+        std::thread sampling = std::thread([&]() {
+            for (int i = 2; !isDone; i++) {
+                for (Pose& pose : poses) {
+                    const Pose p = createPose(i);
+                    const std::unique_lock l(mutex);
+                    pose = p;
+                }
+            }
+        });
+
+        BENCHMARK("Read 64 devices") {
+            double sum = 0.0;
+            for (const Pose& pose : poses) {
+                const std::unique_lock l(mutex);
+                sum += pose.worldTransform.values[0];
+            }
+            return sum;
+        };
+
+        isDone = true;
+        sampling.join();
+    }
+
+    SECTION("SeqLock per device") {
+        std::vector<std::unique_ptr<sgct::SeqLock<Pose>>> poses;
+        for (int i = 0; i < NDevices; i++) {
+            poses.push_back(std::make_unique<sgct::SeqLock<Pose>>(createPose(1)));
+        }
+        std::atomic_bool isDone = false;
+        std::thread sampling = std::thread([&]() {
+            for (int i = 2; !isDone; i++) {
+                for (std::unique_ptr<sgct::SeqLock<Pose>>& pose : poses) {
+                    pose->store(createPose(i));
+                }
+            }
+        });
+
+        BENCHMARK("Read 64 devices") {
+            double sum = 0.0;
+            for (const std::unique_ptr<sgct::SeqLock<Pose>>& pose : poses) {
+                sum += pose->load().worldTransform.values[0];
+            }
+            return sum;
+        };
+
+        isDone = true;
+        sampling.join();
+    }
+}
@@ -0,0 +1,108 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/trackingdevice.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+    constexpr float Epsilon = 1e-4f;
+
+    // Rotation around the y axis by the angle in radians
+    sgct::quat rotationY(float angle) {
+        return sgct::quat(0.f, std::sin(angle / 2.f), 0.f, std::cos(angle / 2.f));
+    }
+
+    // The difference between the receive and the source times that the device uses to
+    // convert between the clocks
+    double clockOffset(const sgct::TrackingDevice& device) {
+        double offset = std::numeric_limits<double>::max();
+        for (const sgct::TrackingDevice::Sample& s : device.history()) {
+            offset = std::min(offset, s.receiveTime - s.sourceTime);
+        }
+        return offset;
+    }
+} // namespace
+
+TEST_CASE("TrackingDevice: History", "[trackingdevice]") {
+    sgct::TrackingDevice device = sgct::TrackingDevice(0, "device");
+    CHECK(device.history().empty());
+    CHECK_FALSE(device.sampleAt(0.0).has_value());
+
+    for (int i = 0; i < 10; i++) {
+        const float v = static_cast<float>(i);
+        device.setSensorTransform(sgct::vec3(v, 0.f, 0.f), rotationY(0.f), 100.0 + i);
+    }
+
+    const std::vector<sgct::TrackingDevice::Sample> history = device.history();
+    REQUIRE(history.size() == 10);
+    for (size_t i = 0; i < history.size(); i++) {
+        CHECK(history[i].sensorPosition.x == static_cast<float>(i));
+        CHECK(history[i].sourceTime == 100.0 + static_cast<double>(i));
+    }
+}
+
+TEST_CASE("TrackingDevice: History Wraps Around", "[trackingdevice]") {
+    sgct::TrackingDevice device = sgct::TrackingDevice(0, "device");
+
+    constexpr int N = sgct::TrackingDevice::HistorySize + 20;
+    for (int i = 0; i < N; i++) {
+        const float v = static_cast<float>(i);
+        device.setSensorTransform(sgct::vec3(v, 0.f, 0.f), rotationY(0.f), 10.0 + i);
+    }
+
+    // Only the newest samples are kept
+    const std::vector<sgct::TrackingDevice::Sample> history = device.history();
+    REQUIRE(history.size() == sgct::TrackingDevice::HistorySize);
+    CHECK(history.front().sensorPosition.x == 20.f);
+    CHECK(history.back().sensorPosition.x == static_cast<float>(N - 1));
+}
+
+TEST_CASE("TrackingDevice: Sample At", "[trackingdevice]") {
+    sgct::TrackingDevice device = sgct::TrackingDevice(0, "device");
+    device.setSensorTransform(sgct::vec3(0.f, 0.f, 0.f), rotationY(0.f), 50.0);
+    device.setSensorTransform(sgct::vec3(2.f, 4.f, 0.f), rotationY(1.f), 50.1);
+    device.setSensorTransform(sgct::vec3(4.f, 4.f, 0.f), rotationY(1.f), 50.2);
+    const double offset = clockOffset(device);
+
+    SECTION("Between samples") {
+        const std::optional<sgct::TrackingDevice::Sample> s =
+            device.sampleAt(50.05 + offset);
+        REQUIRE(s.has_value());
+        CHECK(std::abs(s->sensorPosition.x - 1.f) < Epsilon);
+        CHECK(std::abs(s->sensorPosition.y - 2.f) < Epsilon);
+        CHECK(std::abs(s->sourceTime - 50.05) < Epsilon);
+        // Halfway between the rotations by 0 and 1 radians
+        CHECK(std::abs(s->sensorRotation.y - std::sin(0.25f)) < Epsilon);
+        CHECK(std::abs(s->sensorRotation.w - std::cos(0.25f)) < Epsilon);
+    }
+
+    SECTION("At a sample") {
+        const std::optional<sgct::TrackingDevice::Sample> s =
+            device.sampleAt(50.1 + offset);
+        REQUIRE(s.has_value());
+        CHECK(std::abs(s->sensorPosition.x - 2.f) < Epsilon);
+        CHECK(std::abs(s->sensorPosition.y - 4.f) < Epsilon);
+    }
+
+    SECTION("Clamped") {
+        const std::optional<sgct::TrackingDevice::Sample> before =
+            device.sampleAt(40.0 + offset);
+        REQUIRE(before.has_value());
+        CHECK(before->sensorPosition.x == 0.f);
+
+        const std::optional<sgct::TrackingDevice::Sample> after =
+            device.sampleAt(60.0 + offset);
+        REQUIRE(after.has_value());
+        CHECK(after->sensorPosition.x == 4.f);
+    }
+}
@@ -0,0 +1,179 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/error.h>
+#include <sgct/tracker.h>
+#include <sgct/trackingdevice.h>
+#include <sgct/trackinglog.h>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+namespace {
+    std::filesystem::path tempFile() {
+        return std::filesystem::temp_directory_path() / "sgct_test_trackinglog.bin";
+    }
+
+    // A tracker with a head and a wand device, where the wand has two buttons and three
+    // axes like the devices in the example configurations
+    std::vector<std::unique_ptr<sgct::Tracker>> createTrackers() {
+        std::vector<std::unique_ptr<sgct::Tracker>> trackers;
+        trackers.push_back(std::make_unique<sgct::Tracker>("tracker"));
+        trackers[0]->addDevice("head", 0);
+        trackers[0]->addDevice("wand", 0);
+        sgct::TrackingDevice* wand = trackers[0]->device("wand");
+        wand->setNumberOfButtons(2);
+        wand->setNumberOfAxes(3);
+        return trackers;
+    }
+
+    void record(const std::filesystem::path& path,
+                const std::vector<std::unique_ptr<sgct::Tracker>>& trackers)
+    {
+        const sgct::TrackingDevice& head = *trackers[0]->device("head");
+        const sgct::TrackingDevice& wand = *trackers[0]->device("wand");
+
+        sgct::TrackingRecorder recorder = sgct::TrackingRecorder(path, trackers);
+        recorder.recordSensor(
+            head,
+            sgct::vec3(1.f, 2.f, 3.f),
+            sgct::quat(0.f, 0.f, 0.f, 1.f),
+            10.0
+        );
+        recorder.recordButton(wand, 1, true);
+        const double axes[] = { 0.25, -0.5, 1.0 };
+        recorder.recordAnalog(wand, axes, 3);
+        recorder.recordSensor(
+            head,
+            sgct::vec3(4.f, 5.f, 6.f),
+            sgct::quat(0.f, 1.f, 0.f, 0.f),
+            10.1
+        );
+    }
+} // namespace
+
+TEST_CASE("TrackingLog: Record and Read", "[trackinglog]") {
+    const std::filesystem::path path = tempFile();
+    record(path, createTrackers());
+
+    const sgct::TrackingLog log = sgct::readTrackingLog(path);
+    REQUIRE(log.devices.size() == 2);
+    CHECK(log.devices[0].tracker == "tracker");
+    CHECK(log.devices[0].device == "head");
+    CHECK(log.devices[1].device == "wand");
+
+    REQUIRE(log.events.size() == 4);
+    CHECK(log.events[0].device == 0);
+    const auto* s = std::get_if<sgct::TrackingLog::Sensor>(&log.events[0].data);
+    REQUIRE(s);
+    CHECK(s->position.x == 1.f);
+    CHECK(s->position.z == 3.f);
+    CHECK(s->rotation.w == 1.f);
+    CHECK(s->sourceTime == 10.0);
+
+    CHECK(log.events[1].device == 1);
+    const auto* b = std::get_if<sgct::TrackingLog::Button>(&log.events[1].data);
+    REQUIRE(b);
+    CHECK(b->index == 1);
+    CHECK(b->value);
+
+    const auto* a = std::get_if<sgct::TrackingLog::Analog>(&log.events[2].data);
+    REQUIRE(a);
+    CHECK(a->values == std::vector<double>({ 0.25, -0.5, 1.0 }));
+
+    for (size_t i = 1; i < log.events.size(); i++) {
+        CHECK(log.events[i].time >= log.events[i - 1].time);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("TrackingLog: Replay", "[trackinglog]") {
+    const std::filesystem::path path = tempFile();
+    record(path, createTrackers());
+
+    // The log is replayed into a different set of devices with the same names
+    std::vector<std::unique_ptr<sgct::Tracker>> trackers = createTrackers();
+    sgct::TrackingPlayer player = sgct::TrackingPlayer(
+        sgct::readTrackingLog(path),
+        trackers
+    );
+    while (!player.isDone()) {
+        player.step();
+    }
+
+    const sgct::TrackingDevice& head = *trackers[0]->device("head");
+    const std::vector<sgct::TrackingDevice::Sample> history = head.history();
+    REQUIRE(history.size() == 2);
+    CHECK(history[0].sensorPosition.y == 2.f);
+    CHECK(history[1].sensorPosition.y == 5.f);
+    CHECK(history[1].sourceTime == 10.1);
+
+    const sgct::TrackingDevice& wand = *trackers[0]->device("wand");
+    CHECK_FALSE(wand.button(0));
+    CHECK(wand.button(1));
+    CHECK(wand.analog(0) == 0.25);
+    CHECK(wand.analog(1) == -0.5);
+    CHECK(wand.analog(2) == 1.0);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("TrackingLog: Advance", "[trackinglog]") {
+    sgct::TrackingLog log;
+    log.devices.push_back({ "tracker", "wand" });
+    log.devices.push_back({ "tracker", "missing" });
+    log.events.push_back({ 0, 0.0, sgct::TrackingLog::Button{ 0, true } });
+    log.events.push_back({ 1, 0.05, sgct::TrackingLog::Button{ 0, true } });
+    log.events.push_back({ 0, 0.1, sgct::TrackingLog::Button{ 1, true } });
+    log.events.push_back({ 0, 0.2, sgct::TrackingLog::Button{ 0, false } });
+
+    std::vector<std::unique_ptr<sgct::Tracker>> trackers = createTrackers();
+    const sgct::TrackingDevice& wand = *trackers[0]->device("wand");
+    sgct::TrackingPlayer player = sgct::TrackingPlayer(std::move(log), trackers);
+    CHECK(player.duration() == 0.2);
+    CHECK(player.nextEventTime() == 0.0);
+
+    player.advance(0.15);
+    CHECK(wand.button(0));
+    CHECK(wand.button(1));
+    CHECK(player.nextEventTime() == 0.2);
+    CHECK_FALSE(player.isDone());
+
+    player.advance(1.0);
+    CHECK_FALSE(wand.button(0));
+    CHECK(player.isDone());
+}
+
+TEST_CASE("TrackingLog: Truncated", "[trackinglog]") {
+    const std::filesystem::path path = tempFile();
+    record(path, createTrackers());
+
+    // A recording that was interrupted while the last event was written
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 5);
+    const sgct::TrackingLog log = sgct::readTrackingLog(path);
+    CHECK(log.events.size() == 3);
+
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("TrackingLog: Invalid", "[trackinglog]") {
+    const std::filesystem::path path = tempFile();
+    {
+        std::ofstream file = std::ofstream(path, std::ios::out | std::ios::binary);
+        file << "not a tracking log";
+    }
+
+    CHECK_THROWS_AS(sgct::readTrackingLog(path), sgct::Error);
+
+    std::filesystem::remove(path);
+    CHECK_THROWS_AS(sgct::readTrackingLog(path), sgct::Error);
+}
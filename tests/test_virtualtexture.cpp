@@ -0,0 +1,259 @@
+/*****************************************************************************************
+ * SGCT                                                                                  *
+ * Simple Graphics Cluster Toolkit                                                       *
+ *                                                                                       *
+ * Copyright (c) 2012-2024                                                               *
+ * For conditions of distribution and use, see copyright notice in LICENSE.md            *
+ ****************************************************************************************/
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <sgct/image.h>
+#include <sgct/virtualtexture.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+namespace {
+    std::filesystem::path buildTestPyramid(sgct::ivec2 size, int tileSize) {
+        sgct::Image img;
+        img.setSize(size);
+        img.setChannels(3);
+        img.setBytesPerChannel(1);
+        img.allocateOrResizeData();
+        for (int y = 0; y < size.y; y++) {
+            for (int x = 0; x < size.x; x++) {
+                unsigned char* p = img.data() + (y * size.x + x) * 3;
+                p[0] = static_cast<unsigned char>(x % 256);
+                p[1] = static_cast<unsigned char>(y % 256);
+                p[2] = static_cast<unsigned char>((x + y) % 256);
+            }
+        }
+
+        const std::filesystem::path path =
+            std::filesystem::temp_directory_path() / "sgct-test-pyramid.sgctvt";
+        sgct::TilePyramid::build(img, path, tileSize);
+        return path;
+    }
+
+    sgct::mat4 viewProjection(glm::vec3 direction, glm::vec3 up, float fov) {
+        const glm::mat4 proj = glm::perspective(glm::radians(fov), 1.f, 0.1f, 100.f);
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.f), direction, up);
+        sgct::mat4 res;
+        std::memcpy(res.values, glm::value_ptr(proj * view), sizeof(res.values));
+        return res;
+    }
+
+    std::vector<sgct::TileCache::LoadedTile> waitForTiles(sgct::TileCache& cache) {
+        using namespace std::chrono;
+
+        std::vector<sgct::TileCache::LoadedTile> res;
+        const steady_clock::time_point start = steady_clock::now();
+        while (cache.numberOfPendingTiles() > 0 && steady_clock::now() - start < 10s) {
+            std::vector<sgct::TileCache::LoadedTile> tiles = cache.collectLoadedTiles(64);
+            std::move(tiles.begin(), tiles.end(), std::back_inserter(res));
+            std::this_thread::sleep_for(1ms);
+        }
+        return res;
+    }
+
+    int entryLevel(uint32_t entry) {
+        return static_cast<int>((entry >> 16) & 0xFF);
+    }
+} // namespace
+
+TEST_CASE("VirtualTexture: Layout", "[virtualtexture]") {
+    using namespace sgct;
+
+    const TileLayout layout = TileLayout::create(ivec2(1000, 600), 256);
+    REQUIRE(layout.nLevels == 3);
+    CHECK(layout.tiles(0).x == 4);
+    CHECK(layout.tiles(0).y == 3);
+    CHECK(layout.tiles(1).x == 2);
+    CHECK(layout.tiles(1).y == 2);
+    CHECK(layout.tiles(2).x == 1);
+    CHECK(layout.tiles(2).y == 1);
+    CHECK(layout.levelSize(2).x == 250);
+    CHECK(layout.levelSize(2).y == 150);
+    CHECK(layout.tileBytes() == 258 * 258 * 4);
+}
+
+TEST_CASE("VirtualTexture: Build and Read Pyramid", "[virtualtexture]") {
+    using namespace sgct;
+
+    const std::filesystem::path path = buildTestPyramid(ivec2(300, 200), 64);
+    {
+        const TilePyramid pyramid = TilePyramid(path);
+        const TileLayout& layout = pyramid.layout();
+        REQUIRE(layout.nLevels == 4);
+        REQUIRE(layout.border == 1);
+
+        const int slotSize = layout.tileSize + 2 * layout.border;
+        std::vector<std::byte> tile(layout.tileBytes());
+
+        // Interior tile, the first pixel after the border is the first pixel of the tile
+        pyramid.readTile({ 0, 1, 2 }, tile.data());
+        const size_t first = (static_cast<size_t>(1) * slotSize + 1) * 4;
+        CHECK(static_cast<int>(tile[first + 0]) == 64);
+        CHECK(static_cast<int>(tile[first + 1]) == 128);
+        CHECK(static_cast<int>(tile[first + 2]) == 192);
+        CHECK(static_cast<int>(tile[first + 3]) == 255);
+        // The border contains the neighboring pixels
+        CHECK(static_cast<int>(tile[0]) == 63);
+        CHECK(static_cast<int>(tile[1]) == 127);
+
+        // The border of the first tile is clamped to the edge of the image
+        pyramid.readTile({ 0, 0, 0 }, tile.data());
+        CHECK(static_cast<int>(tile[0]) == 0);
+        CHECK(static_cast<int>(tile[1]) == 0);
+
+        CHECK_THROWS(pyramid.readTile({ 0, 5, 0 }, tile.data()));
+        CHECK_THROWS(pyramid.readTile({ 4, 0, 0 }, tile.data()));
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("VirtualTexture: Select Visible Tiles Fisheye", "[virtualtexture]") {
+    using namespace sgct;
+
+    const TileLayout layout = TileLayout::create(ivec2(8192, 8192), 256);
+
+    // Looking at the zenith only sees the center of the fisheye image
+    const mat4 zenith =
+        viewProjection(glm::vec3(0.f, 1.f, 0.f), glm::vec3(0.f, 0.f, -1.f), 30.f);
+    const std::vector<TileId> up =
+        selectVisibleTiles(layout, { &zenith, 1 }, ivec2(512, 512));
+    REQUIRE_FALSE(up.empty());
+    for (const TileId& tile : up) {
+        const ivec2 tiles = layout.tiles(tile.level);
+        const float u = (tile.x + 0.5f) / tiles.x;
+        const float v = (tile.y + 0.5f) / tiles.y;
+        // 15 degrees from the zenith with a 180 degree fisheye plus the tile size
+        const float maxDistance = 15.f / 180.f + 1.f / tiles.x;
+        CHECK(std::abs(u - 0.5f) < maxDistance);
+        CHECK(std::abs(v - 0.5f) < maxDistance);
+    }
+
+    // A higher resolution requires more detailed levels
+    const std::vector<TileId> upHigh =
+        selectVisibleTiles(layout, { &zenith, 1 }, ivec2(4096, 4096));
+    const auto minLevel = [](const std::vector<TileId>& tiles) {
+        return std::min_element(
+            tiles.begin(),
+            tiles.end(),
+            [](const TileId& a, const TileId& b) { return a.level < b.level; }
+        )->level;
+    };
+    CHECK(minLevel(upHigh) < minLevel(up));
+    CHECK(upHigh.size() > up.size());
+
+    // Looking at the nadir sees nothing of a 180 degree fisheye
+    const mat4 nadir =
+        viewProjection(glm::vec3(0.f, -1.f, 0.f), glm::vec3(0.f, 0.f, -1.f), 60.f);
+    CHECK(selectVisibleTiles(layout, { &nadir, 1 }, ivec2(512, 512)).empty());
+}
+
+TEST_CASE("VirtualTexture: Select Visible Tiles Equirectangular", "[virtualtexture]") {
+    using namespace sgct;
+
+    const TileLayout layout = TileLayout::create(ivec2(8192, 4096), 256);
+
+    // Looking backwards crosses the seam of the panorama, which must select the tiles at
+    // both edges but not the ones in the middle
+    const mat4 back =
+        viewProjection(glm::vec3(0.f, 0.f, 1.f), glm::vec3(0.f, 1.f, 0.f), 40.f);
+    const std::vector<TileId> tiles = selectVisibleTiles(
+        layout,
+        { &back, 1 },
+        ivec2(512, 512),
+        TextureMapping::Equirectangular
+    );
+    REQUIRE_FALSE(tiles.empty());
+    bool hasLeft = false;
+    bool hasRight = false;
+    for (const TileId& tile : tiles) {
+        const int nTiles = layout.tiles(tile.level).x;
+        hasLeft |= tile.x == 0;
+        hasRight |= tile.x == nTiles - 1;
+        CHECK((tile.x < nTiles / 4 || tile.x >= 3 * nTiles / 4));
+    }
+    CHECK(hasLeft);
+    CHECK(hasRight);
+}
+
+TEST_CASE("VirtualTexture: Tile Cache Streaming", "[virtualtexture]") {
+    using namespace sgct;
+
+    const std::filesystem::path path = buildTestPyramid(ivec2(300, 200), 64);
+    {
+        TileCache cache = TileCache(path, 4, 2);
+        const TileLayout& layout = cache.pyramid().layout();
+
+        // The coarsest level is loaded without being requested
+        std::vector<TileCache::LoadedTile> loaded = waitForTiles(cache);
+        REQUIRE(loaded.size() == 1);
+        CHECK(cache.isResident({ 3, 0, 0 }));
+        for (uint32_t entry : cache.pageTable(0)) {
+            CHECK(entry >> 24 == 255);
+            CHECK(entryLevel(entry) == 3);
+        }
+
+        const std::array<TileId, 1> request = { TileId{ 0, 1, 1 } };
+        cache.request(request);
+        loaded = waitForTiles(cache);
+        // The tile and its ancestors on levels 1 and 2
+        REQUIRE(loaded.size() == 3);
+        CHECK(cache.isResident({ 0, 1, 1 }));
+        CHECK(cache.isResident({ 1, 0, 0 }));
+        CHECK(cache.isResident({ 2, 0, 0 }));
+
+        // The data in the loaded tiles is the data from the pyramid
+        std::vector<std::byte> expected(layout.tileBytes());
+        for (const TileCache::LoadedTile& tile : loaded) {
+            cache.pyramid().readTile(tile.id, expected.data());
+            CHECK(tile.data == expected);
+        }
+
+        // Tiles that are not resident point to their closest resident ancestor
+        const int tilesX = layout.tiles(0).x;
+        CHECK(entryLevel(cache.pageTable(0)[1 * tilesX + 1]) == 0);
+        CHECK(entryLevel(cache.pageTable(0)[0]) == 1);
+        CHECK(entryLevel(cache.pageTable(0)[3 * tilesX + 4]) == 3);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("VirtualTexture: Tile Cache Eviction", "[virtualtexture]") {
+    using namespace sgct;
+
+    const std::filesystem::path path = buildTestPyramid(ivec2(300, 200), 64);
+    {
+        // Only four slots, which fit one tile of each level
+        TileCache cache = TileCache(path, 2, 1);
+        waitForTiles(cache);
+
+        const std::array<TileId, 1> first = { TileId{ 0, 0, 0 } };
+        cache.request(first);
+        waitForTiles(cache);
+        CHECK(cache.isResident({ 0, 0, 0 }));
+        CHECK(cache.isResident({ 1, 0, 0 }));
+
+        // The tiles of the previous frame are evicted for the newly requested tiles, but
+        // the coarsest level stays resident
+        const std::array<TileId, 1> second = { TileId{ 0, 4, 3 } };
+        cache.request(second);
+        waitForTiles(cache);
+        CHECK(cache.isResident({ 0, 4, 3 }));
+        CHECK(cache.isResident({ 1, 2, 1 }));
+        CHECK(cache.isResident({ 2, 1, 0 }));
+        CHECK(cache.isResident({ 3, 0, 0 }));
+        CHECK_FALSE(cache.isResident({ 0, 0, 0 }));
+        CHECK_FALSE(cache.isResident({ 1, 0, 0 }));
+    }
+    std::filesystem::remove(path);
+}